@@ -19,3 +19,6 @@ set_target_properties(onnxruntime_session PROPERTIES FOLDER "ONNXRuntime")
 if(onnxruntime_USE_EIGEN_THREADPOOL)
     target_compile_definitions(onnxruntime_session PUBLIC USE_EIGEN_THREADPOOL)
 endif()
+
+# part of the key of cached optimized models
+target_compile_definitions(onnxruntime_session PRIVATE ORT_VERSION="${VERSION_NUMBER}")
@@ -157,6 +157,30 @@ namespace Microsoft.ML.OnnxRuntime
         [DllImport(nativeLib, CharSet = charSet)]
         public static extern int OrtSetSessionThreadPoolSize(IntPtr /* OrtSessionOptions* */ options, int sessionThreadPoolSize);
 
+        [DllImport(nativeLib, CharSet = charSet)]
+        public static extern int OrtSetSessionIntraOpNumThreads(IntPtr /* OrtSessionOptions* */ options, int intraOpNumThreads);
+
+        [DllImport(nativeLib, CharSet = charSet)]
+        public static extern void OrtEnableSharedIntraOpThreadPool(IntPtr /* OrtSessionOptions* */ options);
+
+        [DllImport(nativeLib, CharSet = charSet)]
+        public static extern void OrtDisableSharedIntraOpThreadPool(IntPtr /* OrtSessionOptions* */ options);
+
+        [DllImport(nativeLib, CharSet = charSet)]
+        public static extern void OrtEnableMemoryMappedInitializers(IntPtr /* OrtSessionOptions* */ options);
+
+        [DllImport(nativeLib, CharSet = charSet)]
+        public static extern void OrtDisableMemoryMappedInitializers(IntPtr /* OrtSessionOptions* */ options);
+
+        [DllImport(nativeLib, CharSet = charSet)]
+        public static extern void OrtEnableSharedInitializers(IntPtr /* OrtSessionOptions* */ options);
+
+        [DllImport(nativeLib, CharSet = charSet)]
+        public static extern void OrtDisableSharedInitializers(IntPtr /* OrtSessionOptions* */ options);
+
+        [DllImport(nativeLib, CharSet = charSet)]
+        public static extern void OrtSetOptimizedModelCacheDir(IntPtr /* OrtSessionOptions* */ options, string cacheDir);
+
 
         ///**
         //  * The order of invocation indicates the preference order as well. In other words call this method
@@ -9,6 +9,8 @@
 #include "core/common/status.h"
 
 namespace onnxruntime {
+class WorkStealingThreadPool;
+
 /**
    Provides the runtime environment for onnxruntime.
    Create one instance for the duration of execution.
@@ -30,6 +32,15 @@ class Environment {
   */
   static bool IsInitialized() { return is_initialized_; }
 
+  /**
+     Returns the intra-op thread pool shared by all sessions that use it, see
+     SessionOptions::use_shared_intra_op_thread_pool. The pool is created on first use,
+     sized to the number of hardware threads, and lives as long as the Environment instance.
+     Returns nullptr if the machine has a single hardware thread, as kernels then run single threaded.
+     Throws if no Environment instance exists.
+  */
+  static WorkStealingThreadPool* GetSharedIntraOpThreadPool();
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(Environment);
 
@@ -37,5 +48,7 @@ class Environment {
   Status Initialize();
 
   static std::atomic<bool> is_initialized_;
+
+  std::unique_ptr<WorkStealingThreadPool> shared_intra_op_thread_pool_;
 };
 }  // namespace onnxruntime
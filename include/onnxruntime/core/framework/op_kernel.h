@@ -23,6 +23,7 @@ namespace onnxruntime {
 class IExecutionFrame;
 class OpKernelContext;
 class OpKernelWrapper;
+class WorkStealingThreadPool;
 
 class OpKernel {
  public:
@@ -46,6 +47,21 @@ class OpKernel {
     ORT_NOT_IMPLEMENTED(__FUNCTION__, " is not implemented");
   }
 
+  /**
+  Called once for every input of the kernel that is a constant initializer, after the kernel is created and before
+  it is first run, so the kernel can convert the constant input into a layout that is faster to compute with.
+  @param tensor The constant initializer. It stays valid, and is passed to Compute as usual, for the lifetime of
+  the kernel.
+  @param input_idx The index of the input.
+  @param is_packed Set to true if the kernel keeps a converted copy of the input.
+  */
+  virtual Status PrePack(const Tensor& tensor, int input_idx, bool& is_packed) {
+    ORT_UNUSED_PARAMETER(tensor);
+    ORT_UNUSED_PARAMETER(input_idx);
+    is_packed = false;
+    return Status::OK();
+  }
+
   const OrtAllocatorInfo& Allocator(int id, OrtMemType mem_type) const {
     return op_kernel_info_.GetAllocatorInfo(id, mem_type);
   }
@@ -63,7 +79,8 @@ class OpKernelContext {
 
   explicit OpKernelContext(IExecutionFrame* frame,
                            const OpKernel* kernel,
-                           const logging::Logger& logger);
+                           const logging::Logger& logger,
+                           WorkStealingThreadPool* threadpool = nullptr);
 
   virtual ~OpKernelContext() = default;
 
@@ -145,6 +162,12 @@ class OpKernelContext {
   */
   Fence_t OutputFence(int index) const;
 
+  /**
+  Return the intra-op thread pool that kernels should use to parallelize their own work.
+  It is nullptr if the session runs operators single threaded, in which case work should be done inline.
+  */
+  WorkStealingThreadPool* GetOperatorThreadPool() const { return threadpool_; }
+
  protected:
   onnxruntime::NodeIndex GetNodeIndex() const;
 
@@ -165,6 +188,7 @@ class OpKernelContext {
   IExecutionFrame* execution_frame_{nullptr};
   const OpKernel* kernel_{nullptr};
   const logging::Logger* logger_{nullptr};
+  WorkStealingThreadPool* threadpool_{nullptr};
 
   // The argument starting index in ExecutionFrame.
   int node_input_start_index_{-1};
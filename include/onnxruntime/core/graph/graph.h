@@ -483,6 +483,10 @@ class Graph {
   /** Gets all the initializer tensors in this Graph. */
   const InitializedTensorSet& GetAllInitializedTensors() const noexcept;
 
+  /** Releases the memory used by the raw_data of the initializer tensor with the provided name, once its data is
+  held elsewhere. The initializer stays in the Graph but its data must not be read any more. */
+  void ReleaseInitializedTensorData(const std::string& tensor_name);
+
   /** Removes all initializer tensors from this Graph and releases the memory they were using. */
   void CleanAllInitializedTensors() noexcept;
 
@@ -917,7 +921,8 @@ class Graph {
   ONNX_NAMESPACE::GraphProto* graph_proto_;
 
   InitializedTensorSet name_to_initial_tensor_;
-  std::vector<int> removed_initializer_indexes_;
+  // initializers no longer in name_to_initial_tensor_. They are deleted from graph_proto_ on the next sync.
+  std::unordered_set<const ONNX_NAMESPACE::TensorProto*> removed_initializers_;
 
   Type graph_type_ = Type::Main;
 
@@ -11,6 +11,8 @@ enum class TransformerLevel : uint32_t {
   Default = 0,
   Level1,
   Level2,
+  // layout transformations that are only profitable for specific execution providers
+  Level3,
   // Convenience enum to always get the max available value. 
   // This way when we add more levels code which iterates over this enum does not need to change.
   MaxTransformerLevel
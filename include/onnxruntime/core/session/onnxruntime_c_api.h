@@ -194,6 +194,36 @@ ORT_API_STATUS(OrtRun, _Inout_ OrtSession* sess,
                _In_ const char* const* input_names, _In_ const OrtValue* const* input, size_t input_len,
                _In_ const char* const* output_names, size_t output_names_len, _Out_ OrtValue** output);
 
+/**
+ * Called once a run started by OrtRunAsync has finished, on a thread owned by the session.
+ * On success 'status' is NULL and 'outputs' holds the 'num_outputs' outputs in the order of the output names. They
+ * must be freed by OrtReleaseValue, while the array itself is only valid during the call.
+ * On failure 'outputs' is NULL and 'status' must be freed by OrtReleaseStatus.
+ * The callback must not release the session.
+ */
+typedef void(ORT_API_CALL* OrtRunAsyncCallback)(void* user_data, _In_opt_ OrtValue** outputs, size_t num_outputs,
+                                                 _In_opt_ OrtStatus* status);
+
+/**
+ * Queue a run on a thread pool owned by the session and return without waiting for it. 'callback' receives the
+ * outputs once the run has finished. Up to OrtSetSessionRunAsyncThreadPoolSize runs execute concurrently.
+ * Releasing the session waits for the queued runs.
+ * \param run_options NULL to use the defaults. Otherwise it must stay alive until the callback is invoked.
+ * \return An error if the run couldn't be queued. Errors of the run itself are passed to the callback.
+ */
+ORT_API_STATUS(OrtRunAsync, _Inout_ OrtSession* sess,
+               _In_opt_ OrtRunOptions* run_options,
+               _In_ const char* const* input_names, _In_ const OrtValue* const* input, size_t input_len,
+               _In_ const char* const* output_names, size_t output_names_len,
+               _In_ OrtRunAsyncCallback callback, _In_opt_ void* user_data);
+
+/**
+ * Return the memory of the arenas of the session that is not in use to the system, e.g. after a burst of large
+ * requests. Memory in use by runs in progress is kept.
+ * \param released_bytes If not NULL, receives the number of bytes released.
+ */
+ORT_API_STATUS(OrtShrinkSessionArenas, _Inout_ OrtSession* sess, _Out_opt_ size_t* released_bytes);
+
 /**
  * \return A pointer of the newly created object. The pointer should be freed by OrtReleaseSessionOptions after use
  */
@@ -219,6 +249,10 @@ ORT_API(void, OrtDisableMemPattern, _In_ OrtSessionOptions* options);
 ORT_API(void, OrtEnableCpuMemArena, _In_ OrtSessionOptions* options);
 ORT_API(void, OrtDisableCpuMemArena, _In_ OrtSessionOptions* options);
 
+// After a run, when no other run is in progress, return unused memory of an arena to the system until the arena
+// holds at most 'high_water_mark' bytes. 0 shrinks the arenas after every run. SIZE_MAX, the default, never does.
+ORT_API(void, OrtSetSessionArenaShrinkHighWaterMark, _In_ OrtSessionOptions* options, size_t high_water_mark);
+
 // < logger id to use for session output
 ORT_API(void, OrtSetSessionLogId, _In_ OrtSessionOptions* options, const char* logid);
 
@@ -227,15 +261,49 @@ ORT_API(void, OrtSetSessionLogVerbosityLevel, _In_ OrtSessionOptions* options, u
 
 // Set Graph optimization level.
 // Return 0 on success and -1 otherwise
-// Available options are : 0, 1, 2.
+// Available options are : 0, 1, 2, 3.
 // 0 -> Disable all optimizations
 // 1 -> Enable basic optimizations
-// 2 -> Enable all optimizations
+// 2 -> Enable extended optimizations
+// 3 -> Enable all optimizations, including layout transformations such as the NCHWc convolution layout
 ORT_API(int, OrtSetSessionGraphOptimizationLevel, _In_ OrtSessionOptions* options, uint32_t graph_optimization_level);
 
 // How many threads in the session thread pool.
 ORT_API(int, OrtSetSessionThreadPoolSize, _In_ OrtSessionOptions* options, int session_thread_pool_size);
 
+// How many threads, including the calling thread, a kernel may use to parallelize a single node.
+// The session then creates its own intra-op thread pool. 1 runs every kernel single threaded.
+// 0, the default, uses the intra-op thread pool shared between sessions, see OrtEnableSharedIntraOpThreadPool.
+// Return 0 on success and -1 otherwise
+ORT_API(int, OrtSetSessionIntraOpNumThreads, _In_ OrtSessionOptions* options, int intra_op_num_threads);
+
+// How many OrtRunAsync calls run concurrently. Further calls are queued. 0, the default, uses the number of hardware
+// threads divided by the intra-op number of threads, as each run also uses that many intra-op threads, but at least 2.
+// Return 0 on success and -1 otherwise
+ORT_API(int, OrtSetSessionRunAsyncThreadPoolSize, _In_ OrtSessionOptions* options, int run_async_thread_pool_size);
+
+// Share one intra-op thread pool, owned by the OrtEnv, between all sessions that enable it. This is the default.
+// It only applies to sessions that don't set OrtSetSessionIntraOpNumThreads. Disabling it makes such a session
+// create a pool with a thread per hardware thread of its own.
+ORT_API(void, OrtEnableSharedIntraOpThreadPool, _In_ OrtSessionOptions* options);
+ORT_API(void, OrtDisableSharedIntraOpThreadPool, _In_ OrtSessionOptions* options);
+
+// Use CPU initializers in place from read-only memory mappings of the model file or of their external data files,
+// instead of copying them. Sessions of the same model in one process share the mapped pages.
+ORT_API(void, OrtEnableMemoryMappedInitializers, _In_ OrtSessionOptions* options);
+ORT_API(void, OrtDisableMemoryMappedInitializers, _In_ OrtSessionOptions* options);
+
+// Share CPU initializers with the other sessions in the process that enable this and have initializers with the
+// same name and content, e.g. sessions of the same model, so the weights are held once.
+ORT_API(void, OrtEnableSharedInitializers, _In_ OrtSessionOptions* options);
+ORT_API(void, OrtDisableSharedInitializers, _In_ OrtSessionOptions* options);
+
+// Save models after graph optimization in 'cache_dir', and load them from there in later sessions of the same model
+// with the same execution providers and optimization settings instead of optimizing them again.
+// Only used for sessions created from a model file without custom op domains. nullptr or an empty string disables
+// the cache.
+ORT_API(void, OrtSetOptimizedModelCacheDir, _In_ OrtSessionOptions* options, _In_opt_ const ORTCHAR_T* cache_dir);
+
 /**
   * To use additional providers, you must build ORT with the extra providers enabled. Then call one of these
   * functions to enable them in the session:
@@ -94,6 +94,12 @@ class SessionOptionsWrapper {
   ORT_REDIRECT_SIMPLE_FUNCTION_CALL(DisableMemPattern)
   ORT_REDIRECT_SIMPLE_FUNCTION_CALL(EnableCpuMemArena)
   ORT_REDIRECT_SIMPLE_FUNCTION_CALL(DisableCpuMemArena)
+  ORT_REDIRECT_SIMPLE_FUNCTION_CALL(EnableSharedIntraOpThreadPool)
+  ORT_REDIRECT_SIMPLE_FUNCTION_CALL(DisableSharedIntraOpThreadPool)
+  ORT_REDIRECT_SIMPLE_FUNCTION_CALL(EnableMemoryMappedInitializers)
+  ORT_REDIRECT_SIMPLE_FUNCTION_CALL(DisableMemoryMappedInitializers)
+  ORT_REDIRECT_SIMPLE_FUNCTION_CALL(EnableSharedInitializers)
+  ORT_REDIRECT_SIMPLE_FUNCTION_CALL(DisableSharedInitializers)
   void EnableProfiling(_In_ const ORTCHAR_T* profile_file_prefix) {
     OrtEnableProfiling(value.get(), profile_file_prefix);
   }
@@ -110,6 +116,18 @@ class SessionOptionsWrapper {
   void SetSessionThreadPoolSize(int session_thread_pool_size) {
     OrtSetSessionThreadPoolSize(value.get(), session_thread_pool_size);
   }
+  int SetIntraOpNumThreads(int intra_op_num_threads) {
+    return OrtSetSessionIntraOpNumThreads(value.get(), intra_op_num_threads);
+  }
+  int SetRunAsyncThreadPoolSize(int run_async_thread_pool_size) {
+    return OrtSetSessionRunAsyncThreadPoolSize(value.get(), run_async_thread_pool_size);
+  }
+  void SetArenaShrinkHighWaterMark(size_t high_water_mark) {
+    OrtSetSessionArenaShrinkHighWaterMark(value.get(), high_water_mark);
+  }
+  void SetOptimizedModelCacheDir(_In_opt_ const ORTCHAR_T* cache_dir) {
+    OrtSetOptimizedModelCacheDir(value.get(), cache_dir);
+  }
 
   SessionOptionsWrapper clone() const {
     OrtSessionOptions* p = OrtCloneSessionOptions(value.get());
@@ -0,0 +1,288 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/nchwc_ops.h"
+#include "core/mlas/inc/mlas.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+#define ONNX_CPU_OPERATOR_NCHWC_KERNEL(name, ver, builder, ...) \
+  ONNX_OPERATOR_KERNEL_EX(name, kMSNchwcDomain, ver, kCpuExecutionProvider, builder, __VA_ARGS__)
+
+ONNX_CPU_OPERATOR_NCHWC_KERNEL(
+    ReorderInput,
+    1,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    ReorderInput);
+
+ONNX_CPU_OPERATOR_NCHWC_KERNEL(
+    ReorderOutput,
+    1,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    ReorderOutput);
+
+ONNX_CPU_OPERATOR_NCHWC_KERNEL(
+    Conv,
+    1,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    NchwcConv);
+
+ONNX_CPU_OPERATOR_NCHWC_KERNEL(
+    MaxPool,
+    1,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    NchwcMaxPool);
+
+ONNX_CPU_OPERATOR_NCHWC_KERNEL(
+    GlobalMaxPool,
+    1,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    NchwcMaxPool);
+
+ONNX_CPU_OPERATOR_NCHWC_KERNEL(
+    AveragePool,
+    1,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    NchwcAveragePool);
+
+ONNX_CPU_OPERATOR_NCHWC_KERNEL(
+    GlobalAveragePool,
+    1,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    NchwcAveragePool);
+
+namespace {
+
+int64_t NchwcChannels(int64_t channels) {
+  const auto block_size = static_cast<int64_t>(MlasNchwcGetBlockSize());
+  return (channels + block_size - 1) / block_size * block_size;
+}
+
+}  // namespace
+
+Status ReorderInput::Compute(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  const auto& X_shape = X->Shape();
+  ORT_RETURN_IF_NOT(X_shape.NumDimensions() == 4, "Input must be a 4D tensor.");
+
+  Tensor* Y = context->Output(0, {X_shape[0], NchwcChannels(X_shape[1]), X_shape[2], X_shape[3]});
+
+  MlasReorderInput(X_shape.GetDims().data(), X->template Data<float>(), Y->template MutableData<float>());
+
+  return Status::OK();
+}
+
+Status ReorderOutput::Compute(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  const auto& X_shape = X->Shape();
+  ORT_RETURN_IF_NOT(X_shape.NumDimensions() == 4, "Input must be a 4D tensor.");
+  ORT_RETURN_IF_NOT(X_shape[1] == NchwcChannels(channels_), "Input channels do not match the channels attribute.");
+
+  Tensor* Y = context->Output(0, {X_shape[0], channels_, X_shape[2], X_shape[3]});
+
+  MlasReorderOutput(Y->Shape().GetDims().data(), X->template Data<float>(), Y->template MutableData<float>());
+
+  return Status::OK();
+}
+
+Status NchwcConv::PrePack(const Tensor& tensor, int input_idx, bool& is_packed) {
+  is_packed = false;
+
+  const auto& shape = tensor.Shape();
+  auto alloc = Info().GetAllocator(0, OrtMemTypeDefault);
+
+  if (input_idx == 1) {
+    // only a single group or a depthwise convolution is supported by the NCHWc kernels
+    if (shape.NumDimensions() != 4 || (group_ != 1 && shape[1] != 1)) {
+      return Status::OK();
+    }
+
+    const int64_t nchwc_output_channels = NchwcChannels(shape[0]);
+    const int64_t kernel_size = shape[2] * shape[3];
+
+    if (group_ == 1) {
+      const size_t packed_size = static_cast<size_t>(nchwc_output_channels * NchwcChannels(shape[1]) * kernel_size);
+      packed_w_ = BufferUniquePtr(alloc->Alloc(sizeof(float) * packed_size), BufferDeleter(alloc));
+      MlasReorderFilterOIHWBiBo(shape.GetDims().data(), tensor.Data<float>(), static_cast<float*>(packed_w_.get()));
+    } else {
+      const size_t packed_size = static_cast<size_t>(nchwc_output_channels * shape[1] * kernel_size);
+      packed_w_ = BufferUniquePtr(alloc->Alloc(sizeof(float) * packed_size), BufferDeleter(alloc));
+      MlasReorderFilterOIHWBo(shape.GetDims().data(), tensor.Data<float>(), static_cast<float*>(packed_w_.get()));
+    }
+
+    packed_w_source_ = tensor.DataRaw();
+    is_packed = true;
+
+  } else if (input_idx == 2) {
+    if (shape.NumDimensions() != 1) {
+      return Status::OK();
+    }
+
+    const size_t output_channels = static_cast<size_t>(shape[0]);
+    const size_t nchwc_output_channels = static_cast<size_t>(NchwcChannels(shape[0]));
+    packed_b_ = BufferUniquePtr(alloc->Alloc(sizeof(float) * nchwc_output_channels), BufferDeleter(alloc));
+    float* packed_b_data = static_cast<float*>(packed_b_.get());
+    std::copy_n(tensor.Data<float>(), output_channels, packed_b_data);
+    std::fill_n(packed_b_data + output_channels, nchwc_output_channels - output_channels, 0.0f);
+
+    packed_b_source_ = tensor.DataRaw();
+    is_packed = true;
+  }
+
+  return Status::OK();
+}
+
+Status NchwcConv::Compute(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  const Tensor* W = context->Input<Tensor>(1);
+  const Tensor* B = context->Input<Tensor>(2);
+  const auto& X_shape = X->Shape();
+  const auto& W_shape = W->Shape();
+  ORT_RETURN_IF_NOT(X_shape.NumDimensions() == 4, "Input must be a 4D tensor.");
+  ORT_RETURN_IF_NOT(W_shape.NumDimensions() == 4, "Filter must be a 4D tensor.");
+
+  const int64_t N = X_shape[0];
+  const int64_t M = W_shape[0];
+  const int64_t nchwc_output_channels = NchwcChannels(M);
+
+  if (group_ == 1) {
+    ORT_RETURN_IF_NOT(X_shape[1] == NchwcChannels(W_shape[1]),
+                      "Input channels do not match the filter channels.",
+                      " X: ", X_shape.ToString(), " W: ", W_shape.ToString());
+  } else {
+    ORT_RETURN_IF_NOT(W_shape[1] == 1 && group_ == M && X_shape[1] == nchwc_output_channels,
+                      "Grouped convolution must be depthwise.",
+                      " X: ", X_shape.ToString(), " W: ", W_shape.ToString(), " group: ", group_);
+  }
+
+  if (B != nullptr) {
+    ORT_RETURN_IF_NOT(B->Shape().NumDimensions() == 1 && B->Shape()[0] == M, "Invalid bias shape: ", B->Shape().ToString());
+  }
+
+  std::vector<int64_t> kernel_shape;
+  ORT_RETURN_IF_ERROR(ComputeKernelShape(W_shape, kernel_shape));
+
+  std::vector<int64_t> pads(pads_);
+  if (pads.empty()) {
+    pads.resize(kernel_shape.size() * 2, 0);
+  }
+  std::vector<int64_t> dilations(dilations_);
+  if (dilations.empty()) {
+    dilations.resize(kernel_shape.size(), 1);
+  }
+  std::vector<int64_t> strides(strides_);
+  if (strides.empty()) {
+    strides.resize(kernel_shape.size(), 1);
+  }
+
+  std::vector<int64_t> Y_dims;
+  Y_dims.insert(Y_dims.begin(), {N, nchwc_output_channels});
+  TensorShape input_shape = X_shape.Slice(2);
+  ORT_RETURN_IF_ERROR(InferOutputShape(input_shape, kernel_shape, strides, dilations, &pads, &Y_dims));
+  Tensor* Y = context->Output(0, TensorShape(Y_dims));
+
+  AllocatorPtr alloc;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
+
+  // use the filter and bias packed at session initialization, otherwise convert them here
+  BufferUniquePtr reordered_w;
+  const float* filter_data = static_cast<const float*>(packed_w_.get());
+  if (packed_w_ == nullptr || W->DataRaw() != packed_w_source_) {
+    const int64_t kernel_size = W_shape[2] * W_shape[3];
+    if (group_ == 1) {
+      const size_t reordered_size = static_cast<size_t>(nchwc_output_channels * X_shape[1] * kernel_size);
+      reordered_w = BufferUniquePtr(alloc->Alloc(sizeof(float) * reordered_size), BufferDeleter(alloc));
+      MlasReorderFilterOIHWBiBo(W_shape.GetDims().data(), W->template Data<float>(), static_cast<float*>(reordered_w.get()));
+    } else {
+      const size_t reordered_size = static_cast<size_t>(nchwc_output_channels * kernel_size);
+      reordered_w = BufferUniquePtr(alloc->Alloc(sizeof(float) * reordered_size), BufferDeleter(alloc));
+      MlasReorderFilterOIHWBo(W_shape.GetDims().data(), W->template Data<float>(), static_cast<float*>(reordered_w.get()));
+    }
+    filter_data = static_cast<const float*>(reordered_w.get());
+  }
+
+  BufferUniquePtr padded_b;
+  const float* bias_data = nullptr;
+  if (B != nullptr) {
+    if (packed_b_ != nullptr && B->DataRaw() == packed_b_source_) {
+      bias_data = static_cast<const float*>(packed_b_.get());
+    } else {
+      padded_b = BufferUniquePtr(alloc->Alloc(sizeof(float) * static_cast<size_t>(nchwc_output_channels)), BufferDeleter(alloc));
+      float* padded_b_data = static_cast<float*>(padded_b.get());
+      std::copy_n(B->template Data<float>(), static_cast<size_t>(M), padded_b_data);
+      std::fill_n(padded_b_data + M, static_cast<size_t>(nchwc_output_channels - M), 0.0f);
+      bias_data = padded_b_data;
+    }
+  }
+
+  MLAS_ACTIVATION Activation;
+  if (activation_.empty()) {
+    Activation.ActivationKind = MlasIdentityActivation;
+  } else if (activation_ == "Relu") {
+    Activation.ActivationKind = MlasReluActivation;
+  } else if (activation_ == "LeakyRelu") {
+    Activation.ActivationKind = MlasLeakyReluActivation;
+    Activation.alpha = alpha_;
+  } else if (activation_ == "Tanh") {
+    Activation.ActivationKind = MlasTanhActivation;
+  } else if (activation_ == "Sigmoid") {
+    Activation.ActivationKind = MlasLogisticActivation;
+  } else {
+    ORT_NOT_IMPLEMENTED("Not implemented fused activation: ", activation_);
+  }
+
+  MlasNchwcConv(X_shape.GetDims().data(),
+                kernel_shape.data(),
+                dilations.data(),
+                pads.data(),
+                strides.data(),
+                Y_dims.data(),
+                static_cast<size_t>(group_),
+                X->template Data<float>(),
+                filter_data,
+                bias_data,
+                Y->template MutableData<float>(),
+                &Activation,
+                context->GetOperatorThreadPool());
+
+  return Status::OK();
+}
+
+Status NchwcPoolBase::NchwcPool(OpKernelContext* context, MLAS_POOLING_KIND kind) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  const auto& X_shape = X->Shape();
+  ORT_RETURN_IF_NOT(X_shape.NumDimensions() == 4, "Input must be a 4D tensor.");
+  ORT_RETURN_IF_NOT(X_shape[1] % static_cast<int64_t>(MlasNchwcGetBlockSize()) == 0,
+                    "Input channels must be a multiple of the block size.");
+  if (!global_pooling_) {
+    ORT_RETURN_IF_NOT(kernel_shape_.size() == 2, "kernel_shape num_dims is not compatible with X num_dims.");
+  }
+
+  std::vector<int64_t> pads = pads_;
+  std::vector<int64_t> output_dims = PoolBase::SetOutputSize(X_shape, X_shape[1], &pads);
+  Tensor* Y = context->Output(0, TensorShape(output_dims));
+
+  MlasNchwcPool(kind,
+                X_shape.GetDims().data(),
+                global_pooling_ ? nullptr : kernel_shape_.data(),
+                global_pooling_ ? nullptr : pads.data(),
+                global_pooling_ ? nullptr : strides_.data(),
+                output_dims.data(),
+                X->template Data<float>(),
+                Y->template MutableData<float>(),
+                context->GetOperatorThreadPool());
+
+  return Status::OK();
+}
+
+Status NchwcMaxPool::Compute(OpKernelContext* context) const {
+  return NchwcPool(context, MlasMaximumPooling);
+}
+
+Status NchwcAveragePool::Compute(OpKernelContext* context) const {
+  return NchwcPool(context, count_include_pad_ ? MlasAveragePoolingIncludePad : MlasAveragePoolingExcludePad);
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,85 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+#include "core/providers/cpu/nn/conv_base.h"
+#include "core/providers/cpu/nn/pool_base.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Kernels for the com.microsoft.nchwc domain. A NCHWc tensor has the shape of its NCHW source with the
+// channel count rounded up to a multiple of the MLAS block size (MlasNchwcGetBlockSize), and stores each
+// block of channels contiguously for every spatial position.
+
+class ReorderInput final : public OpKernel {
+ public:
+  ReorderInput(const OpKernelInfo& info) : OpKernel(info) {
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+};
+
+class ReorderOutput final : public OpKernel {
+ public:
+  ReorderOutput(const OpKernelInfo& info) : OpKernel(info) {
+    ORT_ENFORCE(info.GetAttr<int64_t>("channels", &channels_).IsOK());
+    ORT_ENFORCE(channels_ > 0, "invalid channel count");
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  int64_t channels_;
+};
+
+class NchwcConv final : public OpKernel, public ConvBase {
+ public:
+  NchwcConv(const OpKernelInfo& info) : OpKernel(info), ConvBase(info) {
+    activation_ = info.GetAttrOrDefault<std::string>("activation", "");
+    alpha_ = info.GetAttrOrDefault("alpha", 0.01f);
+  }
+
+  // reorders a constant filter or pads a constant bias to the layout of the NCHWc kernels
+  Status PrePack(const Tensor& tensor, int input_idx, bool& is_packed) override;
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  BufferUniquePtr packed_w_;
+  BufferUniquePtr packed_b_;
+  // the constant inputs that were packed. An initializer that is also a graph input can be overridden by a feed.
+  const void* packed_w_source_ = nullptr;
+  const void* packed_b_source_ = nullptr;
+};
+
+class NchwcPoolBase : public OpKernel, public PoolBase {
+ public:
+  NchwcPoolBase(const OpKernelInfo& info) : OpKernel(info), PoolBase(info) {
+  }
+
+ protected:
+  Status NchwcPool(OpKernelContext* context, MLAS_POOLING_KIND kind) const;
+};
+
+class NchwcMaxPool final : public NchwcPoolBase {
+ public:
+  NchwcMaxPool(const OpKernelInfo& info) : NchwcPoolBase(info) {
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+};
+
+class NchwcAveragePool final : public NchwcPoolBase {
+ public:
+  NchwcAveragePool(const OpKernelInfo& info) : NchwcPoolBase(info) {
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
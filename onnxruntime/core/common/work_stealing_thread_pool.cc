@@ -0,0 +1,212 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/common/work_stealing_thread_pool.h"
+
+#include <algorithm>
+#include <exception>
+
+#include "core/common/logging/logging.h"
+
+namespace onnxruntime {
+
+namespace {
+// the pool and worker index of the current thread. a thread belongs to at most one pool.
+struct WorkerIdentity {
+  const WorkStealingThreadPool* pool = nullptr;
+  int index = -1;
+};
+
+thread_local WorkerIdentity current_worker;
+}  // namespace
+
+WorkStealingThreadPool::WorkStealingThreadPool(int num_threads) {
+  ORT_ENFORCE(num_threads >= 0, "Invalid number of threads: ", num_threads);
+
+  queues_.reserve(num_threads + 1);
+  for (int i = 0; i <= num_threads; ++i) {
+    queues_.push_back(std::make_unique<TaskQueue>());
+  }
+
+  threads_.reserve(num_threads);
+  for (int i = 0; i < num_threads; ++i) {
+    threads_.emplace_back(&WorkStealingThreadPool::WorkerLoop, this, i);
+  }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+  {
+    std::lock_guard<OrtMutex> lock(sleep_mutex_);
+    running_ = false;
+  }
+  sleep_cv_.notify_all();
+
+  try {
+    for (auto& t : threads_) {
+      t.join();
+    }
+  } catch (const std::exception& ex) {
+    LOGS_DEFAULT(ERROR) << "Exception joining threads in WorkStealingThreadPool: " << ex.what();
+  }
+}
+
+int WorkStealingThreadPool::CurrentThreadId() const noexcept {
+  return current_worker.pool == this ? current_worker.index : -1;
+}
+
+void WorkStealingThreadPool::Schedule(Task task) {
+  int index = CurrentThreadId();
+  auto& queue = index >= 0 ? *queues_[index] : *queues_.back();
+  {
+    std::lock_guard<OrtMutex> lock(queue.mutex);
+    queue.tasks.push_back(std::move(task));
+  }
+
+  // pending_tasks_ is published before num_sleeping_ is read, and a worker increments num_sleeping_
+  // before it re-checks pending_tasks_ under sleep_mutex_, so a wakeup can't be lost.
+  pending_tasks_.fetch_add(1);
+  if (num_sleeping_.load() > 0) {
+    std::lock_guard<OrtMutex> lock(sleep_mutex_);
+    sleep_cv_.notify_one();
+  }
+}
+
+bool WorkStealingThreadPool::RunPendingTask() {
+  Task task;
+  if (!TryGetTask(CurrentThreadId(), task)) {
+    return false;
+  }
+
+  try {
+    task();
+  } catch (const std::exception& ex) {
+    LOGS_DEFAULT(ERROR) << "Exception running WorkStealingThreadPool task: " << ex.what();
+  }
+
+  return true;
+}
+
+void WorkStealingThreadPool::ParallelFor(int32_t total, const std::function<void(int32_t)>& fn) {
+  if (total <= 0) {
+    return;
+  }
+
+  const int32_t num_helpers = std::min<int32_t>(total, NumThreads() + 1) - 1;
+  if (num_helpers == 0) {
+    for (int32_t i = 0; i < total; ++i) {
+      fn(i);
+    }
+    return;
+  }
+
+  // state shared with the helper tasks. it lives on this stack frame, so we must not return until every
+  // scheduled helper has finished with it, even the ones that found no iterations left.
+  std::atomic<int32_t> next_iteration{0};
+  std::atomic<int32_t> running_helpers{num_helpers};
+  std::exception_ptr first_exception;
+  OrtMutex exception_mutex;
+
+  auto run_iterations = [&]() {
+    try {
+      for (int32_t i = next_iteration++; i < total; i = next_iteration++) {
+        fn(i);
+      }
+    } catch (...) {
+      // stop handing out further iterations
+      next_iteration = total;
+      std::lock_guard<OrtMutex> lock(exception_mutex);
+      if (!first_exception) {
+        first_exception = std::current_exception();
+      }
+    }
+  };
+
+  for (int32_t i = 0; i < num_helpers; ++i) {
+    Schedule([&run_iterations, &running_helpers]() {
+      run_iterations();
+      running_helpers--;
+    });
+  }
+
+  run_iterations();
+
+  // help with queued work (which is most likely our own helpers) until all helpers have returned.
+  while (running_helpers > 0) {
+    if (!RunPendingTask()) {
+      std::this_thread::yield();
+    }
+  }
+
+  if (first_exception) {
+    std::rethrow_exception(first_exception);
+  }
+}
+
+bool WorkStealingThreadPool::TryPopBack(TaskQueue& queue, Task& task) {
+  std::lock_guard<OrtMutex> lock(queue.mutex);
+  if (queue.tasks.empty()) {
+    return false;
+  }
+
+  task = std::move(queue.tasks.back());
+  queue.tasks.pop_back();
+  return true;
+}
+
+bool WorkStealingThreadPool::TryPopFront(TaskQueue& queue, Task& task) {
+  std::lock_guard<OrtMutex> lock(queue.mutex);
+  if (queue.tasks.empty()) {
+    return false;
+  }
+
+  task = std::move(queue.tasks.front());
+  queue.tasks.pop_front();
+  return true;
+}
+
+bool WorkStealingThreadPool::TryGetTask(int index, Task& task) {
+  if (pending_tasks_.load(std::memory_order_relaxed) == 0) {
+    return false;
+  }
+
+  bool found = (index >= 0 && TryPopBack(*queues_[index], task)) ||
+               TryPopFront(*queues_.back(), task);
+
+  // steal from the other workers, starting at a rotating victim to spread contention
+  const int num_workers = NumThreads();
+  if (!found && num_workers > 0) {
+    const int start = static_cast<int>(next_victim_.fetch_add(1, std::memory_order_relaxed) % num_workers);
+    for (int i = 0; i < num_workers && !found; ++i) {
+      int victim = (start + i) % num_workers;
+      if (victim != index) {
+        found = TryPopFront(*queues_[victim], task);
+      }
+    }
+  }
+
+  if (found) {
+    pending_tasks_.fetch_sub(1);
+  }
+
+  return found;
+}
+
+void WorkStealingThreadPool::WorkerLoop(int index) {
+  current_worker.pool = this;
+  current_worker.index = index;
+
+  while (running_) {
+    if (RunPendingTask()) {
+      continue;
+    }
+
+    std::unique_lock<OrtMutex> lock(sleep_mutex_);
+    num_sleeping_.fetch_add(1);
+    while (running_ && pending_tasks_.load() == 0) {
+      sleep_cv_.wait(lock);
+    }
+    num_sleeping_.fetch_sub(1);
+  }
+}
+
+}  // namespace onnxruntime
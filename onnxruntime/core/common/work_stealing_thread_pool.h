@@ -0,0 +1,114 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+/**
+ * Thread pool with one task deque per worker thread.
+ *
+ * Tasks scheduled from a worker thread go to the back of that worker's own deque and are
+ * popped again from the back (LIFO), so a producer usually runs the work it just created
+ * while the data is still in cache. Idle workers steal from the front of other deques.
+ * Tasks scheduled from outside the pool go to a shared injection queue.
+ *
+ * Threads that are not part of the pool (e.g. the thread calling InferenceSession::Run)
+ * can take part in execution by calling RunPendingTask() while they wait for a result.
+ *
+ * Exceptions thrown by a task are not propagated; tasks are expected to capture and
+ * report their own errors.
+ */
+class WorkStealingThreadPool {
+ public:
+  using Task = std::function<void()>;
+
+  explicit WorkStealingThreadPool(int num_threads);
+  ~WorkStealingThreadPool();
+
+  /// Number of worker threads owned by the pool.
+  int NumThreads() const noexcept { return static_cast<int>(threads_.size()); }
+
+  /// Index of the calling thread within this pool, or -1 if the caller is not one of its workers.
+  int CurrentThreadId() const noexcept;
+
+  /// Queue a task for execution.
+  void Schedule(Task task);
+
+  /**
+   * Run at most one queued task on the calling thread.
+   * @returns true if a task was run.
+   */
+  bool RunPendingTask();
+
+  /**
+   * Run fn(0) ... fn(total - 1) across the worker threads and the calling thread, and return once all
+   * iterations have completed. Iterations are handed out dynamically so uneven work balances itself.
+   * The first exception thrown by fn is rethrown on the calling thread.
+   * Safe to call from within a task running on this pool.
+   */
+  void ParallelFor(int32_t total, const std::function<void(int32_t)>& fn);
+
+  /**
+   * Run fn(0) ... fn(total - 1) on the thread pool if one is provided, or serially on the calling thread
+   * if thread_pool is nullptr.
+   */
+  static void TryParallelFor(WorkStealingThreadPool* thread_pool, int32_t total,
+                             const std::function<void(int32_t)>& fn) {
+    if (thread_pool != nullptr) {
+      thread_pool->ParallelFor(total, fn);
+    } else {
+      for (int32_t i = 0; i < total; ++i) {
+        fn(i);
+      }
+    }
+  }
+
+  /**
+   * Number of threads that can work on a ParallelFor, including the calling thread.
+   * Returns 1 if thread_pool is nullptr.
+   */
+  static int DegreeOfParallelism(const WorkStealingThreadPool* thread_pool) {
+    return thread_pool != nullptr ? thread_pool->NumThreads() + 1 : 1;
+  }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(WorkStealingThreadPool);
+
+  struct TaskQueue {
+    OrtMutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  void WorkerLoop(int index);
+
+  // Pop from the back of the worker's own deque, then the injection queue, then steal from the
+  // front of the other workers' deques. index is -1 for threads outside the pool.
+  bool TryGetTask(int index, Task& task);
+  bool TryPopBack(TaskQueue& queue, Task& task);
+  bool TryPopFront(TaskQueue& queue, Task& task);
+
+  // queues_[0..NumThreads()) belong to the workers. queues_[NumThreads()] is the injection queue.
+  std::vector<std::unique_ptr<TaskQueue>> queues_;
+  std::vector<std::thread> threads_;
+
+  std::atomic<int> pending_tasks_{0};
+  std::atomic<int> num_sleeping_{0};
+  std::atomic<bool> running_{true};
+  std::atomic<unsigned> next_victim_{0};
+
+  OrtMutex sleep_mutex_;
+  OrtCondVar sleep_cv_;
+};
+
+}  // namespace onnxruntime
@@ -3,6 +3,7 @@
 
 #include "core/framework/allocation_planner.h"
 #include <list>
+#include <limits>
 #include <unordered_map>
 #include <algorithm>
 #include <sstream>
@@ -137,6 +138,8 @@ class PlannerImpl {
     const onnxruntime::NodeArg* p_def_site;  // the (unique) NodeArg corresponding to the MLValue
     int usecount = 0;                        // static reference-count
     MLValueIndex reused_buffer_index;        // index of original buffer to reuse
+    // parallel execution only: the nodes that read or write the buffer, if this ml-value is an original buffer
+    std::vector<onnxruntime::NodeIndex> users;
   };
 
   // ml_value_info_ is indexed by an MLValueIndex
@@ -155,6 +158,13 @@ class PlannerImpl {
   // they became free (more recently freed earlier in the list).
   std::list<FreeBufferInfo> freelist_;
 
+  // deallocate_point of a buffer that no step of a parallel execution can release. it's released with the frame.
+  static constexpr size_t kNoDeallocatePoint = std::numeric_limits<size_t>::max();
+
+  // parallel execution only: ancestors_[n] is the set of nodes that complete before node n starts, that is the
+  // nodes n transitively depends on, as a bitset indexed by NodeIndex.
+  std::vector<std::vector<uint64_t>> ancestors_;
+
   MLValueIndex Index(const MLValueName& name) {
     MLValueIndex result;
     auto status = mlvalue_name_idx_map_.GetIdx(name, result);
@@ -175,6 +185,14 @@ class PlannerImpl {
     return AllocPlan(Index(name));
   }
 
+  // Feeds, initializers and graph outputs are owned by the caller or the session. Views of them are fine, but
+  // they must never be updated in place.
+  bool IsReadOnlyBuffer(MLValueIndex buffer) {
+    auto alloc_kind = AllocPlan(buffer).alloc_kind;
+    return alloc_kind == AllocKind::kPreExisting || alloc_kind == AllocKind::kAllocateStatically ||
+           alloc_kind == AllocKind::kAllocateOutput;
+  }
+
   // Initialize state for a given ml-value at its definition site:
   void ProcessDef(MLValueIndex id, const onnxruntime::NodeArg* p_def_site) {
     MLValueInfo& info = ml_value_info_.at(id);
@@ -199,6 +217,53 @@ class PlannerImpl {
     symplan.reused_buffer = original;
   }
 
+  // Compute the happens-before relation of the parallel schedule. A node is run once all the nodes at the
+  // other end of its input edges have completed, see ParallelExecutor.
+  void ComputeAncestors() {
+    const size_t num_nodes = static_cast<size_t>(graph_viewer_.MaxNodeIndex());
+    const size_t num_words = (num_nodes + 63) / 64;
+    ancestors_.assign(num_nodes, std::vector<uint64_t>(num_words, 0));
+
+    for (const auto& step : plan_.execution_plan) {
+      auto pnode = graph_viewer_.GetNode(step.node_index);
+      auto& ancestors = ancestors_[step.node_index];
+      for (auto it = pnode->InputEdgesBegin(), end = pnode->InputEdgesEnd(); it != end; ++it) {
+        const onnxruntime::NodeIndex input_node = it->GetNode().Index();
+        const auto& input_ancestors = ancestors_[input_node];
+        for (size_t i = 0; i < num_words; ++i) {
+          ancestors[i] |= input_ancestors[i];
+        }
+        ancestors[input_node / 64] |= uint64_t{1} << (input_node % 64);
+      }
+    }
+  }
+
+  bool HappensBefore(onnxruntime::NodeIndex before, onnxruntime::NodeIndex after) const {
+    return ((ancestors_[after][before / 64] >> (before % 64)) & 1) != 0;
+  }
+
+  // Returns true if all the users of the buffer have completed by the time node runs, or node is the only one
+  // that may still run. Always true for sequential execution, where the users ran at earlier steps.
+  bool BufferUsersPrecede(MLValueIndex buffer, onnxruntime::NodeIndex node) {
+    if (!context_.EnableParallelExecution()) return true;
+    const auto& users = ml_value_info_.at(buffer).users;
+    return std::all_of(users.cbegin(), users.cend(), [this, node](onnxruntime::NodeIndex user) {
+      return user == node || HappensBefore(user, node);
+    });
+  }
+
+  // The step after which a buffer whose last use in the execution order is at program_counter can be released.
+  // Under parallel execution that is the first step from there on that all the users of the buffer precede.
+  size_t DeallocatePoint(MLValueIndex buffer, size_t program_counter) {
+    const auto& execution_plan = plan_.execution_plan;
+    for (size_t step = program_counter; step < execution_plan.size(); ++step) {
+      if (BufferUsersPrecede(buffer, execution_plan[step].node_index)) {
+        return step;
+      }
+    }
+    return kNoDeallocatePoint;
+  }
+
   // Find if there exists some input tensor that we can use in-place for output_arg
   bool FindReusableInput(const onnxruntime::Node& node, int output_arg_num, MLValueIndex* reusable_input) {
     auto p_output_arg = node.OutputDefs()[output_arg_num];
@@ -213,6 +278,8 @@ class PlannerImpl {
     for (auto pair : alias_map) {
       if (pair.second == output_arg_num) {
         // we _must_ reuse this input to satisfy aliasing requirement: (e.g., for reshape)
+        // this also holds for feeds and initializers: the kernel only reinterprets the shape, so the output is a
+        // read-only view of the input buffer
         if ((0 <= pair.first) && (static_cast<size_t>(pair.first) < input_args.size())) {
           auto p_input_arg = input_args[pair.first];
           if (p_input_arg->Exists()) {
@@ -231,7 +298,9 @@ class PlannerImpl {
           if (p_input_arg->Exists()) {
             auto input_arg_index = Index(p_input_arg->Name());
             auto original = Buffer(input_arg_index);
-            if (1 == UseCount(original)) {
+            // under parallel execution the other readers of the input must have completed too
+            if (1 == UseCount(original) && !IsReadOnlyBuffer(original) &&
+                BufferUsersPrecede(original, node.Index())) {
               if (SameSize(*p_input_arg, *p_output_arg)) {
                 // we can reuse this input since it is its last use and permitted for in-place update
                 *reusable_input = input_arg_index;  // or original; both should be okay
@@ -299,8 +368,9 @@ class PlannerImpl {
     return SameSize(*p_shape1, arg1.Type(), *p_shape2, arg2.Type());
   }
 
-  // Find if freelist contains a buffer of the same size as output_arg
-  bool FindReusableTensor(const onnxruntime::NodeArg& output_arg, MLValueIndex* reusable_tensor) {
+  // Find if freelist contains a buffer of the same size as output_arg, that is no longer used when node runs
+  bool FindReusableTensor(const onnxruntime::Node& node, const onnxruntime::NodeArg& output_arg,
+                          MLValueIndex* reusable_tensor) {
     auto p_required_buffer_shape = context_.GetShape(output_arg);
     if (nullptr == p_required_buffer_shape) return false;
     auto required_buffer_type = output_arg.Type();
@@ -308,6 +378,7 @@ class PlannerImpl {
 
     for (auto it = freelist_.begin(); it != freelist_.end(); ++it) {
       auto reusable = it->ml_value;
+      if (!BufferUsersPrecede(reusable, node.Index())) continue;
       auto p_node_arg = ml_value_info_.at(reusable).p_def_site;
       auto& available_allocator_info = AllocPlan(p_node_arg->Name()).location;
       if (!(available_allocator_info == required_allocator_info)) continue;
@@ -526,8 +597,8 @@ class PlannerImpl {
         } else if (FindReusableInput(*pnode, output_arg_num, &reused)) {
           // Reuse one of this node's input buffers as the output buffer (for in-place update)
           Reuse(reused, current, AllocKind::kReuse);
-        } else if (!context_.EnableParallelExecution() && FindReusableTensor(*node_output, &reused)) {
-          // Reuse an available (dead) buffer for this output, this is only for sequential execution.
+        } else if (FindReusableTensor(*pnode, *node_output, &reused)) {
+          // Reuse an available (dead) buffer for this output
           Reuse(reused, current, AllocKind::kReuse);
         } else {
           // otherwise: allocate a new buffer for this output
@@ -535,13 +606,21 @@ class PlannerImpl {
         }
         output_arg_num++;
       }
+
+      // record the nodes using each buffer, so that it's only reused or released once they all have completed
+      if (context_.EnableParallelExecution()) {
+        pnode->ForEachDef([this, pnode](const onnxruntime::NodeArg& arg, bool /*is_input*/) {
+          ml_value_info_.at(Buffer(Index(arg.Name()))).users.push_back(pnode->Index());
+        });
+      }
+
       // determine if inputs of *pnode can be freed:
       for (auto node_input : pnode->InputDefs()) {
         if (node_input->Exists()) {
           auto& sym = node_input->Name();
           auto original = Buffer(Index(sym));
           if (0 == --UseCount(original))
-            freelist_.push_front(FreeBufferInfo(original, program_counter));
+            freelist_.push_front(FreeBufferInfo(original, DeallocatePoint(original, program_counter)));
         }
       }
 
@@ -550,7 +629,7 @@ class PlannerImpl {
           auto& sym = node_input->Name();
           auto original = Buffer(Index(sym));
           if (0 == --UseCount(original))
-            freelist_.push_front(FreeBufferInfo(original, program_counter));
+            freelist_.push_front(FreeBufferInfo(original, DeallocatePoint(original, program_counter)));
         }
       }
 
@@ -560,7 +639,7 @@ class PlannerImpl {
           auto& sym = node_output->Name();
           auto original = Buffer(Index(sym));
           if (0 == --UseCount(original))
-            freelist_.push_front(FreeBufferInfo(original, program_counter));
+            freelist_.push_front(FreeBufferInfo(original, DeallocatePoint(original, program_counter)));
         }
       }
     }
@@ -579,8 +658,14 @@ class PlannerImpl {
     //TODO: should be size_t
     int current = 0;  // current index into the to_be_freed vector
 
-    // Copy all items from freelist to to_be_freed in reverse order
-    for (auto it = freelist_.rbegin(), end = freelist_.rend(); it != end; ++it) {
+    // Copy all items from freelist to to_be_freed in reverse order. Under parallel execution a buffer may be
+    // released at a later step than the one it became free at, so order them by their deallocation point.
+    std::vector<FreeBufferInfo> freed(freelist_.rbegin(), freelist_.rend());
+    std::stable_sort(freed.begin(), freed.end(), [](const FreeBufferInfo& a, const FreeBufferInfo& b) {
+      return a.deallocate_point < b.deallocate_point;
+    });
+
+    for (auto it = freed.cbegin(), end = freed.cend(); it != end && it->deallocate_point != kNoDeallocatePoint; ++it) {
       plan_.to_be_freed.push_back(it->ml_value);
       //
       if (it->deallocate_point != prev_dealloc_point) {
@@ -621,6 +706,11 @@ Status PlannerImpl::CreatePlan() {
   // compute use counts for all ml-values
   ORT_RETURN_IF_ERROR(ComputeUseCounts());
 
+  // a buffer can only be reused by a node that runs after all its users in any parallel schedule
+  if (context_.EnableParallelExecution()) {
+    ComputeAncestors();
+  }
+
   // determine sharing/reuse among ml-values
   ORT_RETURN_IF_ERROR(ComputeReusePlan());
 
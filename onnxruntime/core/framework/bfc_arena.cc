@@ -4,12 +4,50 @@
 #include "core/framework/bfc_arena.h"
 
 namespace onnxruntime {
+namespace {
+// The arenas with thread caches by id, so that an exiting thread only releases its caches of arenas that exist
+struct ThreadCacheArenas {
+  OrtMutex lock;
+  std::unordered_map<uint64_t, BFCArena*> arenas;
+};
+
+ThreadCacheArenas& GetThreadCacheArenas() {
+  static ThreadCacheArenas thread_cache_arenas;
+  return thread_cache_arenas;
+}
+
+uint64_t NextArenaId() {
+  static std::atomic<uint64_t> next_arena_id{1};
+  return next_arena_id++;
+}
+}  // namespace
+
+// The thread caches of a thread, by arena id. Releases them when the thread exits.
+struct BFCArena::ThreadCacheOwner {
+  std::vector<std::pair<uint64_t, ThreadCache*>> caches;
+
+  ~ThreadCacheOwner() {
+    auto& thread_cache_arenas = GetThreadCacheArenas();
+    std::lock_guard<OrtMutex> arenas_lock(thread_cache_arenas.lock);
+    for (auto& entry : caches) {
+      auto it = thread_cache_arenas.arenas.find(entry.first);
+      if (it != thread_cache_arenas.arenas.end()) {
+        std::lock_guard<OrtMutex> lock(it->second->lock_);
+        it->second->ReleaseThreadCache(entry.second);
+      }
+    }
+  }
+};
+
 BFCArena::BFCArena(std::unique_ptr<IDeviceAllocator> resource_allocator,
-                   size_t total_memory)
+                   size_t total_memory,
+                   bool enable_thread_caches)
     : device_allocator_(std::move(resource_allocator)),
       free_chunks_list_(kInvalidChunkHandle),
       next_allocation_id_(1),
-      info_(device_allocator_->Info().name, OrtAllocatorType::OrtArenaAllocator, device_allocator_->Info().id, device_allocator_->Info().mem_type) {
+      info_(device_allocator_->Info().name, OrtAllocatorType::OrtArenaAllocator, device_allocator_->Info().id, device_allocator_->Info().mem_type),
+      enable_thread_caches_(enable_thread_caches),
+      arena_id_(NextArenaId()) {
   curr_region_allocation_bytes_ = RoundedBytes(std::min(total_memory, size_t{1048576}));
 
   // Allocate the requested amount of memory.
@@ -32,9 +70,21 @@ BFCArena::BFCArena(std::unique_ptr<IDeviceAllocator> resource_allocator,
       ORT_ENFORCE(BinForSize(bin_size * 2) != BinFromIndex(b));
     }
   }
+
+  if (enable_thread_caches_) {
+    auto& thread_cache_arenas = GetThreadCacheArenas();
+    std::lock_guard<OrtMutex> arenas_lock(thread_cache_arenas.lock);
+    thread_cache_arenas.arenas[arena_id_] = this;
+  }
 }
 
 BFCArena::~BFCArena() {
+  if (enable_thread_caches_) {
+    auto& thread_cache_arenas = GetThreadCacheArenas();
+    std::lock_guard<OrtMutex> arenas_lock(thread_cache_arenas.lock);
+    thread_cache_arenas.arenas.erase(arena_id_);
+  }
+
   for (const auto& region : region_manager_.regions()) {
     device_allocator_->Free(region.ptr());
   }
@@ -160,9 +210,199 @@ size_t BFCArena::RoundedBytes(size_t bytes) {
 }
 
 void* BFCArena::Alloc(size_t size) {
+  if (enable_thread_caches_ && size > 0 && size <= kThreadCacheMaxChunkSize) {
+    return AllocateFromThreadCache(size);
+  }
   return AllocateRawInternal(size, false);
 }
 
+BFCArena::ThreadCache* BFCArena::GetThreadCache(bool create) {
+  static thread_local ThreadCacheOwner owner;
+  for (auto& entry : owner.caches) {
+    if (entry.first == arena_id_) {
+      return entry.second;
+    }
+  }
+  if (!create) {
+    return nullptr;
+  }
+
+  // forget the caches of arenas that were destroyed
+  {
+    auto& thread_cache_arenas = GetThreadCacheArenas();
+    std::lock_guard<OrtMutex> arenas_lock(thread_cache_arenas.lock);
+    owner.caches.erase(std::remove_if(owner.caches.begin(), owner.caches.end(),
+                                      [&thread_cache_arenas](const std::pair<uint64_t, ThreadCache*>& entry) {
+                                        return thread_cache_arenas.arenas.count(entry.first) == 0;
+                                      }),
+                       owner.caches.end());
+  }
+
+  ThreadCache* cache;
+  {
+    std::lock_guard<OrtMutex> lock(lock_);
+    if (!idle_thread_caches_.empty()) {
+      cache = idle_thread_caches_.back();
+      idle_thread_caches_.pop_back();
+      cache->idle = false;
+    } else {
+      thread_caches_.push_back(std::make_unique<ThreadCache>());
+      cache = thread_caches_.back().get();
+      cache->free_chunks.resize(kThreadCacheMaxChunkSize / kMinAllocationSize);
+    }
+  }
+  owner.caches.emplace_back(arena_id_, cache);
+  return cache;
+}
+
+void* BFCArena::AllocateFromThreadCache(size_t num_bytes) {
+  ThreadCache* cache = GetThreadCache(true);
+  if (cache->has_remote_frees.load(std::memory_order_acquire)) {
+    TakeBackRemoteFrees(cache);
+  }
+
+  const size_t rounded_bytes = RoundedBytes(num_bytes);
+  const size_t size_class = rounded_bytes / kMinAllocationSize - 1;
+  auto& free_chunks = cache->free_chunks[size_class];
+  void* ptr;
+  if (!free_chunks.empty()) {
+    ptr = free_chunks.back();
+    free_chunks.pop_back();
+    cache->cached_bytes.fetch_sub(rounded_bytes, std::memory_order_relaxed);
+    cache->num_hits.fetch_add(1, std::memory_order_relaxed);
+  } else {
+    cache->num_misses.fetch_add(1, std::memory_order_relaxed);
+    ptr = AllocateRawInternal(rounded_bytes, false, cache);
+    if (ptr == nullptr) {
+      return nullptr;
+    }
+  }
+  cache->in_use[ptr] = size_class;
+  return ptr;
+}
+
+bool BFCArena::FreeToThreadCache(void* ptr) {
+  ThreadCache* cache = GetThreadCache(false);
+  if (cache == nullptr) {
+    return false;
+  }
+  auto it = cache->in_use.find(ptr);
+  if (it == cache->in_use.end()) {
+    return false;
+  }
+  const size_t size_class = it->second;
+  cache->in_use.erase(it);
+  CacheFreeChunk(cache, ptr, size_class);
+  return true;
+}
+
+void BFCArena::CacheFreeChunk(ThreadCache* cache, void* ptr, size_t size_class) {
+  const size_t size = (size_class + 1) * kMinAllocationSize;
+  auto& free_chunks = cache->free_chunks[size_class];
+  if (free_chunks.size() < kThreadCacheMaxChunksPerSize &&
+      cache->cached_bytes.load(std::memory_order_relaxed) + static_cast<int64_t>(size) <=
+          static_cast<int64_t>(kThreadCacheMaxBytes)) {
+    free_chunks.push_back(ptr);
+    cache->cached_bytes.fetch_add(size, std::memory_order_relaxed);
+    return;
+  }
+
+  std::lock_guard<OrtMutex> lock(lock_);
+  thread_cache_chunks_.erase(ptr);
+  DeallocateRawInternal(ptr);
+}
+
+void BFCArena::TakeBackRemoteFrees(ThreadCache* cache) {
+  std::vector<void*> remote_frees;
+  {
+    std::lock_guard<OrtMutex> remote_lock(cache->remote_frees_lock);
+    remote_frees.swap(cache->remote_frees);
+    cache->has_remote_frees.store(false, std::memory_order_relaxed);
+  }
+  for (void* ptr : remote_frees) {
+    auto it = cache->in_use.find(ptr);
+    ORT_ENFORCE(it != cache->in_use.end());
+    const size_t size_class = it->second;
+    cache->in_use.erase(it);
+    CacheFreeChunk(cache, ptr, size_class);
+  }
+}
+
+void BFCArena::FlushThreadCache(ThreadCache* cache) {
+  {
+    std::lock_guard<OrtMutex> remote_lock(cache->remote_frees_lock);
+    for (void* ptr : cache->remote_frees) {
+      cache->in_use.erase(ptr);
+      thread_cache_chunks_.erase(ptr);
+      DeallocateRawInternal(ptr);
+    }
+    cache->remote_frees.clear();
+    cache->has_remote_frees.store(false, std::memory_order_relaxed);
+  }
+  for (auto& free_chunks : cache->free_chunks) {
+    for (void* ptr : free_chunks) {
+      thread_cache_chunks_.erase(ptr);
+      DeallocateRawInternal(ptr);
+    }
+    free_chunks.clear();
+  }
+  cache->cached_bytes.store(0, std::memory_order_relaxed);
+}
+
+void BFCArena::ReleaseThreadCache(ThreadCache* cache) {
+  FlushThreadCache(cache);
+
+  // the chunks of the cache that are still handed out are freed right away from now on
+  cache->idle = true;
+  idle_thread_caches_.push_back(cache);
+}
+
+size_t BFCArena::Shrink(size_t target_bytes) {
+  ThreadCache* cache = enable_thread_caches_ ? GetThreadCache(false) : nullptr;
+
+  std::lock_guard<OrtMutex> lock(lock_);
+  if (cache != nullptr) {
+    FlushThreadCache(cache);
+  }
+
+  // a region is unused when it holds a single free chunk
+  std::vector<std::pair<size_t, void*>> unused_regions;
+  for (const auto& region : region_manager_.regions()) {
+    const Chunk* c = ChunkFromHandle(region_manager_.get_handle(region.ptr()));
+    if (!c->in_use() && c->size == region.memory_size()) {
+      unused_regions.emplace_back(region.memory_size(), region.ptr());
+    }
+  }
+
+  // release the largest regions first, so that as few regions as possible are given up to reach the target
+  std::sort(unused_regions.begin(), unused_regions.end(),
+            [](const std::pair<size_t, void*>& lhs, const std::pair<size_t, void*>& rhs) {
+              return lhs.first > rhs.first;
+            });
+
+  size_t released_bytes = 0;
+  for (const auto& region : unused_regions) {
+    if (static_cast<size_t>(stats_.total_allocated_bytes) <= target_bytes) {
+      break;
+    }
+    void* ptr = region.second;
+    ChunkHandle h = region_manager_.get_handle(ptr);
+    const size_t size = ChunkFromHandle(h)->size;
+    RemoveFreeChunkFromBin(h);
+    DeleteChunk(h);
+    region_manager_.RemoveAllocationRegion(ptr);
+    device_allocator_->Free(ptr);
+    stats_.total_allocated_bytes -= size;
+    released_bytes += size;
+  }
+
+  // grow again from the initial region size, so that a few small allocations don't bring back a large region
+  if (released_bytes > 0) {
+    curr_region_allocation_bytes_ = RoundedBytes(std::min(memory_limit_, size_t{1048576}));
+  }
+  return released_bytes;
+}
+
 void* BFCArena::Reserve(size_t size) {
   if (size == 0)
     return nullptr;
@@ -196,7 +436,8 @@ size_t BFCArena::AllocatedSize(const void* ptr) {
 }
 
 void* BFCArena::AllocateRawInternal(size_t num_bytes,
-                                    bool dump_log_on_failure) {
+                                    bool dump_log_on_failure,
+                                    ThreadCache* thread_cache) {
   if (num_bytes == 0) {
     LOGS_DEFAULT(WARNING) << "tried to allocate 0 bytes";
     return nullptr;
@@ -211,16 +452,15 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
 
   std::lock_guard<OrtMutex> lock(lock_);
   void* ptr = FindChunkPtr(bin_num, rounded_bytes, num_bytes);
-  if (ptr != nullptr) {
-    return ptr;
-  }
-
-  // Try to extend
-  if (Extend(rounded_bytes)) {
+  if (ptr == nullptr && Extend(rounded_bytes)) {
+    // Try to extend
     ptr = FindChunkPtr(bin_num, rounded_bytes, num_bytes);
-    if (ptr != nullptr) {
-      return ptr;
+  }
+  if (ptr != nullptr) {
+    if (thread_cache != nullptr) {
+      thread_cache_chunks_[ptr] = thread_cache;
     }
+    return ptr;
   }
 
   // We searched all bins for an existing free chunk to use and
@@ -235,9 +475,24 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
   return nullptr;
 }
 
-void BFCArena::GetStats(AllocatorStats* stats) {
+void BFCArena::GetStats(AllocatorStats* stats) const {
   std::lock_guard<OrtMutex> lock(lock_);
   *stats = stats_;
+
+  // the free chunks of a bin are sorted by size
+  for (BinNum b = kNumBins - 1; b >= 0; b--) {
+    const Bin* bin = reinterpret_cast<const Bin*>(&(bins_space_[b * sizeof(Bin)]));
+    if (!bin->free_chunks.empty()) {
+      stats->largest_free_block = static_cast<int64_t>(chunks_[*bin->free_chunks.rbegin()].size);
+      break;
+    }
+  }
+
+  for (const auto& cache : thread_caches_) {
+    stats->num_cache_hits += cache->num_hits.load(std::memory_order_relaxed);
+    stats->num_cache_misses += cache->num_misses.load(std::memory_order_relaxed);
+    stats->bytes_in_thread_caches += cache->cached_bytes.load(std::memory_order_relaxed);
+  }
 }
 
 void* BFCArena::FindChunkPtr(BinNum bin_num, size_t rounded_bytes,
@@ -328,7 +583,30 @@ void BFCArena::Free(void* p) {
   if (p == nullptr) {
     return;
   }
+  if (enable_thread_caches_ && FreeToThreadCache(p)) {
+    return;
+  }
+
   std::lock_guard<OrtMutex> lock(lock_);
+  if (enable_thread_caches_) {
+    auto cache_it = thread_cache_chunks_.find(p);
+    if (cache_it != thread_cache_chunks_.end()) {
+      ThreadCache* cache = cache_it->second;
+      if (cache->idle) {
+        cache->in_use.erase(p);
+        thread_cache_chunks_.erase(cache_it);
+        DeallocateRawInternal(p);
+        return;
+      }
+
+      // hand the chunk back to the thread cache it was allocated from
+      std::lock_guard<OrtMutex> remote_lock(cache->remote_frees_lock);
+      cache->remote_frees.push_back(p);
+      cache->has_remote_frees.store(true, std::memory_order_release);
+      return;
+    }
+  }
+
   auto it = reserved_chunks_.find(p);
   if (it != reserved_chunks_.end()) {
     device_allocator_->Free(it->first);
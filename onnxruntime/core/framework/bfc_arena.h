@@ -16,9 +16,12 @@ limitations under the License.
 
 #pragma once
 #include <array>
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <sstream>
+#include <unordered_map>
+#include <vector>
 
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
@@ -49,6 +52,10 @@ struct AllocatorStats {
                                   // is known. Certain allocator may return 0 to indicate the limit is
                                   // unknown.
   int64_t bytes_limit;
+  int64_t largest_free_block;      // The largest free chunk in the bins.
+  int64_t num_cache_hits;          // Number of allocations served by thread caches.
+  int64_t num_cache_misses;        // Number of cacheable allocations that thread caches passed on.
+  int64_t bytes_in_thread_caches;  // Free bytes held by thread caches, which count as in use.
 
   AllocatorStats() { Clear(); }
 
@@ -59,6 +66,16 @@ struct AllocatorStats {
     this->max_alloc_size = 0;
     this->bytes_limit = 0;
     this->total_allocated_bytes = 0;
+    this->largest_free_block = 0;
+    this->num_cache_hits = 0;
+    this->num_cache_misses = 0;
+    this->bytes_in_thread_caches = 0;
+  }
+
+  // The fraction of the free bytes that can't be handed out as a single allocation.
+  double Fragmentation() const {
+    const int64_t free_bytes = total_allocated_bytes - bytes_in_use;
+    return free_bytes > 0 ? 1.0 - static_cast<double>(largest_free_block) / free_bytes : 0.0;
   }
 
   std::string DebugString() const {
@@ -68,7 +85,11 @@ struct AllocatorStats {
        << "TotalAllocated: " << this->total_allocated_bytes << "\n"
        << "MaxInUse:       " << this->max_bytes_in_use << "\n"
        << "NumAllocs:      " << this->num_allocs << "\n"
-       << "MaxAllocSize:   " << this->max_alloc_size << "\n";
+       << "MaxAllocSize:   " << this->max_alloc_size << "\n"
+       << "LargestFree:    " << this->largest_free_block << "\n"
+       << "CacheHits:      " << this->num_cache_hits << "\n"
+       << "CacheMisses:    " << this->num_cache_misses << "\n"
+       << "InThreadCaches: " << this->bytes_in_thread_caches << "\n";
     return ss.str();
   }
 };
@@ -81,9 +102,15 @@ struct AllocatorStats {
 // coalescing.  One assumption we make is that the process using this
 // allocator owns pretty much all of the memory, and that nearly
 // all requests to allocate memory go through this interface.
+//
+// With thread caches enabled, each thread keeps a few free chunks of every small size in front of the bins, so
+// that it can allocate and free them without taking the arena lock. Chunks in a thread cache stay in use as far
+// as the bins are concerned. A chunk freed by another thread than the one that allocated it is handed back to the
+// cache of that thread.
 class BFCArena : public IArenaAllocator {
  public:
-  BFCArena(std::unique_ptr<IDeviceAllocator> resource_allocator, size_t total_memory);
+  BFCArena(std::unique_ptr<IDeviceAllocator> resource_allocator, size_t total_memory,
+           bool enable_thread_caches = false);
 
   ~BFCArena() override;
 
@@ -114,16 +141,60 @@ class BFCArena : public IArenaAllocator {
     return device_allocator_->CreateFence(session_state);
   }
 
-  void GetStats(AllocatorStats* stats);
+  void GetStats(AllocatorStats* stats) const;
+
+  // Returns the regions that have no chunk in use to the device allocator, largest first, until the arena holds
+  // at most target_bytes. The free chunks in the thread cache of the calling thread are returned to the bins
+  // first. Returns the number of bytes released.
+  size_t Shrink(size_t target_bytes = 0);
 
   size_t RequestedSize(const void* ptr);
 
   size_t AllocatedSize(const void* ptr);
 
  private:
-  void* AllocateRawInternal(size_t num_bytes, bool dump_log_on_failure);
+  struct ThreadCache;
+  struct ThreadCacheOwner;
+
+  void* AllocateRawInternal(size_t num_bytes, bool dump_log_on_failure, ThreadCache* thread_cache = nullptr);
   void DeallocateRawInternal(void* ptr);
 
+  // Allocations up to this size are served by thread caches
+  static const size_t kThreadCacheMaxChunkSize = 64 << 10;
+  static const size_t kThreadCacheMaxChunksPerSize = 16;
+  static const size_t kThreadCacheMaxBytes = 4 << 20;
+
+  struct ThreadCache {
+    // free chunks by size class. Class i holds chunks of at least (i + 1) * kMinAllocationSize bytes.
+    std::vector<std::vector<void*>> free_chunks;
+    // chunks of this cache that are handed out, and their size class. Only used by the owning thread.
+    std::unordered_map<void*, size_t> in_use;
+
+    // chunks of this cache that other threads freed, for the owning thread to take back
+    OrtMutex remote_frees_lock;
+    std::vector<void*> remote_frees;
+    std::atomic<bool> has_remote_frees{false};
+
+    std::atomic<int64_t> cached_bytes{0};
+    std::atomic<int64_t> num_hits{0};
+    std::atomic<int64_t> num_misses{0};
+
+    // whether no thread uses the cache. Guarded by lock_.
+    bool idle = false;
+  };
+
+  // Returns the cache of the calling thread, creating it if create is true.
+  ThreadCache* GetThreadCache(bool create);
+  void* AllocateFromThreadCache(size_t num_bytes);
+  // Returns false if ptr wasn't handed out by the cache of the calling thread.
+  bool FreeToThreadCache(void* ptr);
+  void CacheFreeChunk(ThreadCache* cache, void* ptr, size_t size_class);
+  void TakeBackRemoteFrees(ThreadCache* cache);
+  // Returns the free chunks of a cache to the bins. Requires lock_.
+  void FlushThreadCache(ThreadCache* cache);
+  // Flushes the cache of a thread that exits, and keeps it for reuse by another thread. Requires lock_.
+  void ReleaseThreadCache(ThreadCache* cache);
+
   // A ChunkHandle is an index into the chunks_ vector in BFCAllocator
   // kInvalidChunkHandle means an invalid chunk
   using ChunkHandle = size_t;
@@ -306,6 +377,13 @@ class BFCArena : public IArenaAllocator {
       regions_.insert(entry, AllocationRegion(ptr, memory_size));
     }
 
+    void RemoveAllocationRegion(void* ptr) {
+      auto entry =
+          std::upper_bound(regions_.begin(), regions_.end(), ptr, &Comparator);
+      ORT_ENFORCE(entry != regions_.end() && entry->ptr() == ptr);
+      regions_.erase(entry);
+    }
+
     ChunkHandle get_handle(const void* p) const {
       return RegionFor(p)->get_handle(p);
     }
@@ -480,6 +558,15 @@ class BFCArena : public IArenaAllocator {
 
   std::unordered_map<void*, size_t> reserved_chunks_;
 
+  const bool enable_thread_caches_;
+  // identifies the arena to the threads that have a cache for it, as an address may be reused by a later arena
+  const uint64_t arena_id_;
+  // All thread caches. Caches of exited threads are reused by new threads.
+  std::vector<std::unique_ptr<ThreadCache>> thread_caches_;
+  std::vector<ThreadCache*> idle_thread_caches_;
+  // the thread cache that owns each chunk taken from the bins by a thread cache
+  std::unordered_map<void*, ThreadCache*> thread_cache_chunks_;
+
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(BFCArena);
 };
 #ifdef __GNUC__
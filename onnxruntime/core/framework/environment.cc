@@ -2,6 +2,8 @@
 // Licensed under the MIT License.
 
 #include "core/framework/environment.h"
+#include <thread>
+#include "core/common/work_stealing_thread_pool.h"
 #include "core/framework/allocatormgr.h"
 #include "core/graph/constants.h"
 #include "core/graph/contrib_ops/contrib_defs.h"
@@ -17,6 +19,12 @@ std::once_flag schemaRegistrationOnceFlag;
 
 std::atomic<bool> Environment::is_initialized_{false};
 
+namespace {
+// the Environment instance that owns the shared intra-op thread pool
+OrtMutex instance_mutex;
+Environment* instance = nullptr;
+}  // namespace
+
 Status Environment::Create(std::unique_ptr<Environment>& environment) {
   environment = std::unique_ptr<Environment>(new Environment());
   auto status = environment->Initialize();
@@ -27,9 +35,10 @@ Status Environment::Initialize() {
   auto status = Status::OK();
 
   try {
-    // Register Microsoft domain with min/max op_set version as 1/1.
+    // Register Microsoft domains with min/max op_set version as 1/1.
     std::call_once(schemaRegistrationOnceFlag, []() {
       ONNX_NAMESPACE::OpSchemaRegistry::DomainToVersionRange::Instance().AddDomainToVersion(onnxruntime::kMSDomain, 1, 1);
+      ONNX_NAMESPACE::OpSchemaRegistry::DomainToVersionRange::Instance().AddDomainToVersion(onnxruntime::kMSNchwcDomain, 1, 1);
       // Register contributed schemas.
       // The corresponding kernels are registered inside the appropriate execution provider.
       contrib::RegisterContribSchemas();
@@ -95,6 +104,11 @@ Internal copy node
 Internal copy node
 )DOC");
 
+    {
+      std::lock_guard<OrtMutex> lock(instance_mutex);
+      instance = this;
+    }
+
     is_initialized_ = true;
   } catch (std::exception& ex) {
     status = Status{ONNXRUNTIME, common::RUNTIME_EXCEPTION, std::string{"Exception caught: "} + ex.what()};
@@ -105,7 +119,31 @@ Internal copy node
   return status;
 }
 
+WorkStealingThreadPool* Environment::GetSharedIntraOpThreadPool() {
+  std::lock_guard<OrtMutex> lock(instance_mutex);
+  ORT_ENFORCE(instance != nullptr, "Environment must be initialized before using its shared intra-op thread pool.");
+
+  if (!instance->shared_intra_op_thread_pool_) {
+    // the thread calling into a kernel also does work, so one less worker than the hardware threads.
+    int num_threads = static_cast<int>(std::thread::hardware_concurrency()) - 1;
+    if (num_threads <= 0) {
+      return nullptr;
+    }
+
+    instance->shared_intra_op_thread_pool_ = std::make_unique<WorkStealingThreadPool>(num_threads);
+  }
+
+  return instance->shared_intra_op_thread_pool_.get();
+}
+
 Environment::~Environment() {
+  {
+    std::lock_guard<OrtMutex> lock(instance_mutex);
+    if (instance == this) {
+      instance = nullptr;
+    }
+  }
+
   ::google::protobuf::ShutdownProtobufLibrary();
 }
 
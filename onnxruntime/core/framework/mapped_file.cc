@@ -0,0 +1,196 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/mapped_file.h"
+
+#include <cstring>
+#include <mutex>
+
+namespace onnxruntime {
+
+namespace {
+
+// Field numbers in onnx.proto of the messages leading to the raw data of an initializer.
+constexpr uint64_t kModelGraphField = 7;          // ModelProto.graph
+constexpr uint64_t kGraphInitializerField = 5;    // GraphProto.initializer
+constexpr uint64_t kTensorNameField = 8;          // TensorProto.name
+constexpr uint64_t kTensorRawDataField = 9;       // TensorProto.raw_data
+
+// Protobuf wire types
+constexpr uint64_t kWireTypeVarint = 0;
+constexpr uint64_t kWireTypeFixed64 = 1;
+constexpr uint64_t kWireTypeLengthDelimited = 2;
+constexpr uint64_t kWireTypeFixed32 = 5;
+
+/**
+Minimal reader of the protobuf wire format, just enough to walk the fields of a serialized message without parsing
+it. Unlike the protobuf parser, it doesn't copy anything and isn't limited to 2GB messages.
+*/
+class WireReader {
+ public:
+  WireReader(const char* data, size_t begin, size_t end) : data_(data), pos_(begin), end_(end) {}
+
+  bool AtEnd() const { return pos_ >= end_; }
+
+  // Read the next field. For length delimited fields, [offset, offset + length) is the range of its payload.
+  bool Next(uint64_t& field, uint64_t& wire_type, size_t& offset, size_t& length) {
+    uint64_t tag;
+    if (!ReadVarint(tag)) return false;
+    field = tag >> 3;
+    wire_type = tag & 7;
+    switch (wire_type) {
+      case kWireTypeVarint: {
+        uint64_t value;
+        return ReadVarint(value);
+      }
+      case kWireTypeFixed64:
+        return Skip(8);
+      case kWireTypeFixed32:
+        return Skip(4);
+      case kWireTypeLengthDelimited: {
+        uint64_t size;
+        if (!ReadVarint(size) || size > end_ - pos_) return false;
+        offset = pos_;
+        length = static_cast<size_t>(size);
+        pos_ += length;
+        return true;
+      }
+      default:
+        // groups are not used by onnx.proto
+        return false;
+    }
+  }
+
+ private:
+  bool ReadVarint(uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && pos_ < end_; shift += 7) {
+      const uint8_t byte = static_cast<uint8_t>(data_[pos_++]);
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0) return true;
+    }
+    return false;
+  }
+
+  bool Skip(size_t n) {
+    if (n > end_ - pos_) return false;
+    pos_ += n;
+    return true;
+  }
+
+  const char* data_;
+  size_t pos_;
+  size_t end_;
+};
+
+// Mapped files by path. Entries expire when the last session using the file releases it.
+OrtMutex& MappedFilesMutex() {
+  static OrtMutex mutex;
+  return mutex;
+}
+
+std::unordered_map<std::basic_string<ORTCHAR_T>, std::weak_ptr<const MappedFile>>& MappedFiles() {
+  static std::unordered_map<std::basic_string<ORTCHAR_T>, std::weak_ptr<const MappedFile>> files;
+  return files;
+}
+
+void ORT_API_CALL ReleaseMappedFile(void* param) noexcept {
+  delete reinterpret_cast<std::shared_ptr<const MappedFile>*>(param);
+}
+
+}  // namespace
+
+common::Status MappedFile::Open(const Env& env, const std::basic_string<ORTCHAR_T>& path,
+                                std::shared_ptr<const MappedFile>& file) {
+  std::lock_guard<OrtMutex> lock(MappedFilesMutex());
+  auto& files = MappedFiles();
+  auto it = files.find(path);
+  if (it != files.end()) {
+    file = it->second.lock();
+    if (file != nullptr) {
+      return Status::OK();
+    }
+  }
+
+  std::shared_ptr<MappedFile> new_file(new MappedFile());
+  void* data = nullptr;
+  size_t length = 0;  // the whole file
+  ORT_RETURN_IF_ERROR(env.ReadFileAsString(path.c_str(), 0, data, length, new_file->unmap_));
+  new_file->data_ = reinterpret_cast<const char*>(data);
+  new_file->length_ = length;
+
+  files[path] = new_file;
+  file = std::move(new_file);
+  return Status::OK();
+}
+
+MappedFile::~MappedFile() {
+  if (unmap_.f != nullptr) {
+    unmap_.f(unmap_.param);
+  }
+}
+
+void MappedFile::AddReference(const std::shared_ptr<const MappedFile>& file, OrtCallback& deleter) {
+  deleter.f = ReleaseMappedFile;
+  deleter.param = new std::shared_ptr<const MappedFile>(file);
+}
+
+void MappedFile::BuildRawDataIndex() const {
+  // Anything that doesn't look like a well formed ModelProto just ends the scan, leaving the index incomplete.
+  // That only means fewer initializers can be used in place.
+  WireReader model(data_, 0, length_);
+  uint64_t field, wire_type;
+  size_t offset = 0, length = 0;
+  while (!model.AtEnd() && model.Next(field, wire_type, offset, length)) {
+    if (field != kModelGraphField || wire_type != kWireTypeLengthDelimited) continue;
+
+    WireReader graph(data_, offset, offset + length);
+    while (!graph.AtEnd() && graph.Next(field, wire_type, offset, length)) {
+      if (field != kGraphInitializerField || wire_type != kWireTypeLengthDelimited) continue;
+
+      WireReader tensor(data_, offset, offset + length);
+      const char* name = nullptr;
+      size_t name_length = 0;
+      size_t raw_data_offset = 0, raw_data_length = 0;
+      bool has_raw_data = false;
+      while (!tensor.AtEnd() && tensor.Next(field, wire_type, offset, length)) {
+        if (wire_type != kWireTypeLengthDelimited) continue;
+        if (field == kTensorNameField) {
+          name = data_ + offset;
+          name_length = length;
+        } else if (field == kTensorRawDataField) {
+          raw_data_offset = offset;
+          raw_data_length = length;
+          has_raw_data = true;
+        }
+      }
+      if (name != nullptr && has_raw_data) {
+        raw_data_index_[std::string(name, name_length)] = std::make_pair(raw_data_offset, raw_data_length);
+      }
+    }
+  }
+}
+
+const void* MappedFile::FindInitializerRawData(const std::string& name, const std::string& expected) const {
+  std::pair<size_t, size_t> location;
+  {
+    std::lock_guard<OrtMutex> lock(index_mutex_);
+    if (!index_built_) {
+      BuildRawDataIndex();
+      index_built_ = true;
+    }
+    auto it = raw_data_index_.find(name);
+    if (it == raw_data_index_.end()) {
+      return nullptr;
+    }
+    location = it->second;
+  }
+
+  const char* raw_data = data_ + location.first;
+  if (location.second != expected.size() || memcmp(raw_data, expected.data(), expected.size()) != 0) {
+    return nullptr;
+  }
+  return raw_data;
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,62 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "core/common/common.h"
+#include "core/common/callback.h"
+#include "core/platform/env.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+/**
+A whole file mapped read-only into memory.
+
+Mappings are shared within the process: opening a path that is already mapped returns the existing mapping, so
+all sessions loading the same model, or the same external data file, use the same pages. The mapping is released
+when the last reference to it goes away.
+*/
+class MappedFile {
+ public:
+  static common::Status Open(const Env& env, const std::basic_string<ORTCHAR_T>& path,
+                             std::shared_ptr<const MappedFile>& file);
+
+  ~MappedFile();
+
+  const char* Data() const { return data_; }
+  size_t Length() const { return length_; }
+
+  /**
+  Treat the file as a serialized ModelProto and find the raw_data bytes of the main graph initializer 'name'.
+  Returns nullptr unless they are found and equal to 'expected'. The comparison guards against initializers that
+  were replaced after the model was loaded, e.g. by graph optimizations.
+  */
+  const void* FindInitializerRawData(const std::string& name, const std::string& expected) const;
+
+  /**
+  Set 'deleter' to release a reference to 'file', so that the mapping outlives tensors pointing into it.
+  */
+  static void AddReference(const std::shared_ptr<const MappedFile>& file, OrtCallback& deleter);
+
+ private:
+  MappedFile() = default;
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(MappedFile);
+
+  void BuildRawDataIndex() const;
+
+  const char* data_ = nullptr;
+  size_t length_ = 0;
+  OrtCallback unmap_{nullptr, nullptr};
+
+  // initializer name -> (offset, length) of its raw_data in the file. Built on first use.
+  mutable OrtMutex index_mutex_;
+  mutable bool index_built_ = false;
+  mutable std::unordered_map<std::string, std::pair<size_t, size_t>> raw_data_index_;
+};
+
+}  // namespace onnxruntime
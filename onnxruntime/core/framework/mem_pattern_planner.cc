@@ -0,0 +1,92 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/mem_pattern_planner.h"
+
+#include <algorithm>
+
+namespace onnxruntime {
+
+size_t MemPatternPlanner::ComputeLowerBoundSize() const {
+  // the total size in use only changes at the trace steps, so the maximum is reached right after an allocation
+  std::vector<std::pair<size_t, ptrdiff_t>> events;
+  events.reserve(allocs_.size() * 2);
+  for (auto& alloc : allocs_) {
+    if (alloc.block_.size_ == 0)
+      continue;
+    events.emplace_back(alloc.alloc_step_, static_cast<ptrdiff_t>(alloc.block_.size_));
+    if (alloc.free_step_ != std::numeric_limits<size_t>::max())
+      events.emplace_back(alloc.free_step_, -static_cast<ptrdiff_t>(alloc.block_.size_));
+  }
+  std::sort(events.begin(), events.end());
+
+  ptrdiff_t live_size = 0;
+  size_t lower_bound_size = 0;
+  for (auto& event : events) {
+    live_size += event.second;
+    lower_bound_size = std::max(lower_bound_size, static_cast<size_t>(live_size));
+  }
+  return lower_bound_size;
+}
+
+MemoryPattern MemPatternPlanner::GenerateOfflineMemPattern() const {
+  std::vector<size_t> order(allocs_.size());
+  for (size_t i = 0; i < order.size(); i++)
+    order[i] = i;
+  std::stable_sort(order.begin(), order.end(), [this](size_t lhs, size_t rhs) {
+    return allocs_[lhs].block_.size_ > allocs_[rhs].block_.size_;
+  });
+
+  std::vector<MemoryBlock> placed_blocks(allocs_.size());
+  // indices of the placed blocks, sorted in order of their offset
+  std::vector<size_t> placed;
+  placed.reserve(allocs_.size());
+  size_t peak_size = 0;
+
+  for (size_t i : order) {
+    const auto& alloc = allocs_[i];
+    const size_t size = alloc.block_.size_;
+    if (size == 0)
+      continue;
+
+    size_t current = 0;
+    size_t waste_bytes = std::numeric_limits<size_t>::max();
+    size_t best_offset = 0;
+    bool found_gap = false;
+    for (size_t j : placed) {
+      if (!alloc.OverlapsWith(allocs_[j]))
+        continue;
+      const MemoryBlock& block = placed_blocks[j];
+      if (block.offset_ >= current) {
+        auto gap = block.offset_ - current;
+        if (gap >= size && (gap - size) < waste_bytes) {
+          waste_bytes = gap - size;
+          best_offset = current;
+          found_gap = true;
+        }
+      }
+      current = std::max(current, block.offset_ + block.size_);
+    }
+    if (!found_gap)
+      best_offset = current;
+
+    placed_blocks[i] = MemoryBlock(best_offset, size);
+    peak_size = std::max(peak_size, best_offset + size);
+    auto insert_it = std::upper_bound(placed.begin(), placed.end(), best_offset,
+                                      [&placed_blocks](size_t offset, size_t j) {
+                                        return offset < placed_blocks[j].offset_;
+                                      });
+    placed.insert(insert_it, i);
+  }
+
+  MemoryPattern pattern;
+  pattern.peak_size_ = peak_size;
+  pattern.lower_bound_size_ = ComputeLowerBoundSize();
+  for (size_t i = 0; i < allocs_.size(); i++) {
+    pattern.patterns_[allocs_[i].index_] = placed_blocks[i];
+  }
+
+  return pattern;
+}
+
+}  // namespace onnxruntime
@@ -24,13 +24,15 @@ namespace onnxruntime {
 // MemPatternPlanner is used to trace allocation/free steps
 // in a single iteration, record the pattern and cached for
 // future request if they have the same input shape.
+// TraceAllocation places each block online with best fit. The traced lifetimes are also recorded so that
+// GenerateOfflineMemPattern can place the blocks with the whole iteration known.
 class MemPatternPlanner {
  public:
   MemPatternPlanner() = default;
 
   void TraceAllocation(int ml_value_idx, size_t size) {
     if (size == 0) {
-      allocs_.emplace_back(ml_value_idx, MemoryBlock(0, 0));
+      allocs_.emplace_back(ml_value_idx, MemoryBlock(0, 0), current_step_++);
       return;
     }
 
@@ -55,7 +57,7 @@ class MemPatternPlanner {
       current = allocs_[*it].block_.offset_ + allocs_[*it].block_.size_;
     }
 
-    allocs_.emplace_back(ml_value_idx, MemoryBlock(best_offset, size));
+    allocs_.emplace_back(ml_value_idx, MemoryBlock(best_offset, size), current_step_++);
     buffer_size = std::max(buffer_size, best_offset + size);
     blocks_.insert(best_fit_it, (static_cast<int>(allocs_.size()) - 1));
   }
@@ -63,6 +65,7 @@ class MemPatternPlanner {
   void TraceFree(int ml_value_index) {
     for (auto it = blocks_.begin(); it != blocks_.end(); it++) {
       if (allocs_[*it].index_ == ml_value_index) {
+        allocs_[*it].free_step_ = current_step_++;
         blocks_.erase(it);
         break;
       }
@@ -72,6 +75,7 @@ class MemPatternPlanner {
   MemoryPattern GenerateMemPattern() const {
     MemoryPattern pattern;
     pattern.peak_size_ = buffer_size;
+    pattern.lower_bound_size_ = ComputeLowerBoundSize();
     for (auto& alloc : allocs_) {
       pattern.patterns_[alloc.index_] = alloc.block_;
     }
@@ -79,19 +83,35 @@ class MemPatternPlanner {
     return pattern;
   }
 
+  // Place the traced blocks from the largest to the smallest, each at the offset that best fits among the
+  // already placed blocks whose lifetimes overlap with its own. Unlike the online placement, a large block
+  // allocated late in the iteration doesn't end up above smaller blocks that were placed before it.
+  MemoryPattern GenerateOfflineMemPattern() const;
+
  protected:
   struct MLValueAllocationBlock {
     int index_{-1};
     MemoryBlock block_;
+    // the block is in use for the trace steps [alloc_step_, free_step_)
+    size_t alloc_step_{0};
+    size_t free_step_{std::numeric_limits<size_t>::max()};
 
     MLValueAllocationBlock() = default;
-    MLValueAllocationBlock(int index, MemoryBlock block) : index_(index), block_(block) {}
+    MLValueAllocationBlock(int index, MemoryBlock block, size_t alloc_step)
+        : index_(index), block_(block), alloc_step_(alloc_step) {}
+
+    bool OverlapsWith(const MLValueAllocationBlock& other) const {
+      return alloc_step_ < other.free_step_ && other.alloc_step_ < free_step_;
+    }
   };
 
+  size_t ComputeLowerBoundSize() const;
+
   std::vector<MLValueAllocationBlock> allocs_;
   // blocks_ the list of currently allocated memory blocks, sorted in order of their offset
   std::list<int> blocks_;
   size_t buffer_size{0};
+  size_t current_step_{0};
 };
 
 }  // namespace onnxruntime
@@ -48,7 +48,12 @@ class MLValuePatternPlanner {
     std::lock_guard<OrtMutex> lock(lock_);
     for (auto& it : planner_map_) {
       out->locations.push_back(it.first);
-      out->patterns.push_back(it.second->GenerateMemPattern());
+      // keep the online placement when the offline one is no better, as the online one is what the
+      // traced iteration actually used
+      MemoryPattern pattern = it.second->GenerateMemPattern();
+      MemoryPattern offline_pattern = it.second->GenerateOfflineMemPattern();
+      out->patterns.push_back(offline_pattern.PeakSize() < pattern.PeakSize() ? std::move(offline_pattern)
+                                                                              : std::move(pattern));
     }
 
     return common::Status::OK();
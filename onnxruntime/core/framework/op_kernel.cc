@@ -11,10 +11,12 @@ namespace onnxruntime {
 
 OpKernelContext::OpKernelContext(IExecutionFrame* frame,
                                  const OpKernel* kernel,
-                                 const logging::Logger& logger)
+                                 const logging::Logger& logger,
+                                 WorkStealingThreadPool* threadpool)
     : execution_frame_(frame),
       kernel_(kernel),
-      logger_(&logger) {
+      logger_(&logger),
+      threadpool_(threadpool) {
   ORT_ENFORCE(frame != nullptr, "Execution frame was null");
   ORT_ENFORCE(kernel != nullptr, "OpKernel was null");
 
@@ -11,7 +11,7 @@
 #include "core/common/logging/logging.h"
 
 #ifndef USE_EIGEN_THREADPOOL
-#include "core/common/task_thread_pool.h"
+#include "core/common/work_stealing_thread_pool.h"
 #endif
 
 #include "core/framework/allocation_planner.h"
@@ -25,9 +25,17 @@ namespace onnxruntime {
 ParallelExecutor::ParallelExecutor(const SessionState& session_state, const bool& terminate_flag)
     : out_standings_(0), terminate_flag_{terminate_flag} {
   auto graph_viewer = session_state.GetGraphViewer();
-  node_refs_.resize(graph_viewer->MaxNodeIndex());
+  node_refs_ = std::vector<std::atomic<int>>(graph_viewer->MaxNodeIndex());
   for (auto& node : graph_viewer->Nodes()) {
-    node_refs_[node.Index()] = node.GetInputEdgesCount();
+    node_refs_[node.Index()] = static_cast<int>(node.GetInputEdgesCount());
+  }
+
+  const SequentialExecutionPlan* plan = session_state.GetExecutionPlan();
+  if (plan != nullptr) {
+    node_exec_plans_ = std::vector<const SequentialExecutionPlan::NodeExecutionPlan*>(graph_viewer->MaxNodeIndex());
+    for (const auto& node_exec_plan : plan->execution_plan) {
+      node_exec_plans_[node_exec_plan.node_index] = &node_exec_plan;
+    }
   }
 }
 
@@ -56,11 +64,8 @@ Status ParallelExecutor::Execute(const SessionState& session_state,
     EnqueueNode(node_index, session_state, logger);
   }
 
-  // Wait for finish.
-  {
-    std::unique_lock<OrtMutex> lock(complete_mutex_);
-    while (out_standings_ > 0) complete_cv_.wait(lock);
-  }
+  WaitForCompletion(session_state);
+  ORT_RETURN_IF_ERROR(error_status_);
 
   VLOGS(logger, 1) << "Fetching output.";
   // ExecutionFrame::Finalize will update 'fetches' with the final output
@@ -95,11 +100,15 @@ Status ParallelExecutor::Execute(const SessionState& session_state,
 void ParallelExecutor::RunNodeAsync(size_t p_node_index,
                                     const SessionState& session_state,
                                     const logging::Logger& logger) {
+  // the thread pool doesn't propagate exceptions, so record the failure for Execute to return.
   try {
     RunNodeAsyncInternal(p_node_index, session_state, logger);
+  } catch (const std::exception& ex) {
+    RecordError(ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what()));
+    FinishNodeRun();
   } catch (...) {
+    RecordError(ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, "Unknown exception running node ", p_node_index));
     FinishNodeRun();
-    throw;
   }
 }
 
@@ -185,7 +194,7 @@ void ParallelExecutor::RunNodeAsyncInternal(size_t p_node_index,
     // Execute the kernel.
     auto status = p_op_kernel->Compute(&op_kernel_context);
     if (!status.IsOK()) {
-      ORT_THROW("Compute failed for node: ", graph_viewer->GetNode(node_index)->Name());
+      ORT_THROW("Compute failed for node: ", graph_viewer->GetNode(node_index)->Name(), ". ", status.ErrorMessage());
     }
     if (f_profiler_enabled) {
       session_state.Profiler().EndTimeAndRecordEvent(profiling::NODE_EVENT,
@@ -224,17 +233,25 @@ void ParallelExecutor::RunNodeAsyncInternal(size_t p_node_index,
     }
     //std::cout << "Run async node finish: " << p_node_index << std::endl;
 
+    // the planner only frees a value after a node that all the nodes using its buffer have completed before.
+    // while memory patterns are traced the values are kept, as the order of the allocations and frees
+    // differs between runs and the traced pattern would only be valid for this one.
+    if (!root_frame_->HasMemoryPatternPlanner() && !node_exec_plans_.empty()) {
+      ReleaseNodeMLValues(*session_state.GetExecutionPlan(), *node_exec_plans_[node_index], logger);
+    }
+
     keep_running = false;
 
     // Checking which output nodes ready for running.
+    // The first ready successor is run inline on this thread; the rest are pushed to this worker's queue
+    // where idle workers can steal them.
     {
       auto begin = p_op_kernel->Node().OutputEdgesBegin();
       auto end = p_op_kernel->Node().OutputEdgesEnd();
 
-      std::lock_guard<OrtMutex> lock(ref_mutex_);
       for (auto it = begin; it != end; it++) {
         auto idx = (*it).GetNode().Index();
-        if ((--node_refs_[idx]) == 0) {
+        if (node_refs_[idx].fetch_sub(1) == 1) {
           if (!keep_running) {
             node_index = idx;
             keep_running = true;
@@ -253,23 +270,61 @@ void ParallelExecutor::RunNodeAsyncInternal(size_t p_node_index,
   FinishNodeRun();
 }
 
+void ParallelExecutor::ReleaseNodeMLValues(const SequentialExecutionPlan& seq_exec_plan,
+                                           const SequentialExecutionPlan::NodeExecutionPlan& node_exec_plan,
+                                           const logging::Logger& logger) {
+  for (auto i = node_exec_plan.free_from_index; i <= node_exec_plan.free_to_index; ++i) {
+    auto mlvalue_idx = seq_exec_plan.to_be_freed[i];
+    VLOGS(logger, 1) << "Releasing mlvalue with index: " << mlvalue_idx;
+    auto status = root_frame_->ReleaseMLValue(mlvalue_idx);
+    if (!status.IsOK()) {
+      ORT_THROW("Failed to release mlvalue with index ", mlvalue_idx, ". ", status.ErrorMessage());
+    }
+  }
+}
+
 void ParallelExecutor::EnqueueNode(size_t p_node_index, const SessionState& session_state, const logging::Logger& logger) {
   {
-    std::unique_lock<OrtMutex> lock(complete_mutex_);
+    std::lock_guard<OrtMutex> lock(complete_mutex_);
     out_standings_++;
   }
 
-#ifdef USE_EIGEN_THREADPOOL
   session_state.GetThreadPool()->Schedule([this, p_node_index, &session_state, &logger]() {
-    try {
-      ParallelExecutor::RunNodeAsync(p_node_index, std::cref(session_state), std::cref(logger));
-    } catch (...) {
-      // catch node processing failure exceptions here to prevent app crash.
-    }
+    ParallelExecutor::RunNodeAsync(p_node_index, session_state, logger);
   });
+
+  // wake the waiting caller so that it can take part in running the node. nodes are enqueued by the caller or by
+  // a node that hasn't finished yet, so the executor is still alive.
+  std::lock_guard<OrtMutex> lock(complete_mutex_);
+  num_enqueued_++;
+  complete_cv_.notify_all();
+}
+
+void ParallelExecutor::WaitForCompletion(const SessionState& session_state) {
+#ifndef USE_EIGEN_THREADPOOL
+  auto* thread_pool = session_state.GetThreadPool();
 #else
-  std::packaged_task<void()> task{std::bind(&ParallelExecutor::RunNodeAsync, this, p_node_index, std::cref(session_state), std::cref(logger))};
-  session_state.GetThreadPool()->RunTask(std::move(task));
+  ORT_UNUSED_PARAMETER(session_state);
+#endif
+
+  // out_standings_ is only checked with the mutex held, see FinishNodeRun.
+  std::unique_lock<OrtMutex> lock(complete_mutex_);
+  while (out_standings_ > 0) {
+    const uint64_t num_enqueued = num_enqueued_;
+#ifndef USE_EIGEN_THREADPOOL
+    // take part in execution while there are queued nodes instead of blocking the calling thread.
+    lock.unlock();
+    const bool ran_task = thread_pool->RunPendingTask();
+    lock.lock();
+    if (ran_task) {
+      continue;
+    }
 #endif
+
+    // nothing to steal. sleep until a node is enqueued, which may be ours to run, or all of them completed.
+    complete_cv_.wait(lock, [this, num_enqueued]() {
+      return out_standings_ == 0 || num_enqueued_ != num_enqueued;
+    });
+  }
 }
 }  // namespace onnxruntime
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <vector>
 #include <condition_variable>
 #include "core/common/common.h"
@@ -21,7 +22,7 @@ class ExecutionFrame;
 
 class ParallelExecutor : public IExecutor {
  public:
-  ParallelExecutor(const bool& terminate_flag = false) : terminate_flag_{terminate_flag} {}
+  ParallelExecutor(const bool& terminate_flag = false) : out_standings_(0), terminate_flag_{terminate_flag} {}
   ParallelExecutor(const SessionState& session_state, const bool& terminate_flag = false);
 
   common::Status Execute(const SessionState& session_state,
@@ -40,26 +41,46 @@ class ParallelExecutor : public IExecutor {
 
   void EnqueueNode(size_t p_node_index, const SessionState& session_state, const logging::Logger& logger);
 
+  // Release the values the plan frees after the node. All the users of the buffer of such a value have completed
+  // by then, and each value is freed after a single node.
+  void ReleaseNodeMLValues(const SequentialExecutionPlan& seq_exec_plan,
+                           const SequentialExecutionPlan::NodeExecutionPlan& node_exec_plan,
+                           const logging::Logger& logger);
+
+  // Block the calling thread until all enqueued nodes have completed. If the session thread pool supports it
+  // the caller executes queued nodes while it waits, and only sleeps until a node is enqueued or all completed.
+  void WaitForCompletion(const SessionState& session_state);
+
   void FinishNodeRun() {
-    bool finished = false;
-    {
-      //Because we have a mutex here, it's not possible another thread is doing the test("while (out_standings_ > 0)"
-      std::lock_guard<OrtMutex> lock(complete_mutex_);
-      finished = --out_standings_ == 0;
-    }
-    if (finished) {
-      //std::cout << "all out standing nodes are completed." << std::endl;
+    // the waiter only sees the count reach zero once this has notified and released the mutex, so the executor
+    // can't be destroyed while it is still used here.
+    std::lock_guard<OrtMutex> lock(complete_mutex_);
+    if (--out_standings_ == 0) {
       complete_cv_.notify_all();
     }
   }
 
+  void RecordError(const Status& status) {
+    std::lock_guard<OrtMutex> lock(error_mutex_);
+    if (error_status_.IsOK()) {
+      error_status_ = status;
+    }
+  }
+
   std::unique_ptr<ExecutionFrame> root_frame_;
-  std::vector<size_t> node_refs_;
-  OrtMutex ref_mutex_;
-  int out_standings_;  //protected by complete_mutex_
+  // remaining number of unfinished input edges per node. a node is ready when it reaches zero.
+  std::vector<std::atomic<int>> node_refs_;
+  // execution plan step of each node, indexed by node index
+  std::vector<const SequentialExecutionPlan::NodeExecutionPlan*> node_exec_plans_;
+  int out_standings_;       // GUARDED_BY(complete_mutex_)
+  uint64_t num_enqueued_{};  // GUARDED_BY(complete_mutex_)
   OrtMutex complete_mutex_;
   OrtCondVar complete_cv_;
 
+  // first error hit by any node. later nodes are still drained so that Execute returns cleanly.
+  OrtMutex error_mutex_;
+  Status error_status_;
+
   const bool& terminate_flag_;
 };
 }  // namespace onnxruntime
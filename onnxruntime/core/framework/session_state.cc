@@ -66,36 +66,87 @@ void SessionState::SetProfiler(profiling::Profiler& profiler) { profiler_ = &pro
 
 ::onnxruntime::profiling::Profiler& SessionState::Profiler() const { return *profiler_; }
 
-static int64_t CalculateMemoryPatternsKey(const std::vector<TensorShape>& shapes) {
-  int64_t key = 0;
+// Rounds every dimension up to a power of two, so that inputs whose shapes only vary a little, like sequence
+// lengths, share one memory pattern. The rank of every shape is kept to tell apart shapes like {2, 3} and {6}.
+static std::vector<int64_t> CalculateMemoryPatternsBucket(const std::vector<TensorShape>& shapes) {
+  std::vector<int64_t> bucket;
   for (auto& shape : shapes) {
-    for (auto dim : shape.GetDims()) key ^= dim;
+    bucket.push_back(static_cast<int64_t>(shape.NumDimensions()));
+    for (auto dim : shape.GetDims()) {
+      int64_t bucket_dim = 1;
+      while (bucket_dim < dim) bucket_dim <<= 1;
+      bucket.push_back(dim > 0 ? bucket_dim : dim);
+    }
+  }
+  return bucket;
+}
+
+// Returns true if every dimension of shapes is no larger than the one of covering_shapes.
+static bool ShapesCoveredBy(const std::vector<TensorShape>& shapes, const std::vector<TensorShape>& covering_shapes) {
+  if (shapes.size() != covering_shapes.size()) return false;
+  for (size_t i = 0; i < shapes.size(); i++) {
+    if (shapes[i].NumDimensions() != covering_shapes[i].NumDimensions()) return false;
+    for (size_t j = 0; j < shapes[i].NumDimensions(); j++) {
+      if (shapes[i][j] > covering_shapes[i][j]) return false;
+    }
   }
-  return key;
+  return true;
 }
 
-const MemoryPatternGroup* SessionState::GetMemoryPatternGroup(const std::vector<TensorShape>& input_shapes) const {
+std::shared_ptr<const MemoryPatternGroup> SessionState::GetMemoryPatternGroup(
+    const std::vector<TensorShape>& input_shapes) const {
+  std::vector<int64_t> bucket = CalculateMemoryPatternsBucket(input_shapes);
+
   std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
-  int64_t key = CalculateMemoryPatternsKey(input_shapes);
-  auto it = mem_patterns_.find(key);
-  if (it == mem_patterns_.end()) return nullptr;
+  auto it = mem_patterns_index_.find(bucket);
+  if (it == mem_patterns_index_.end()) return nullptr;
 
-  return it->second.get();
+  // larger inputs than the pattern was generated for need a new pattern for the bucket
+  if (!ShapesCoveredBy(input_shapes, it->second->input_shapes)) return nullptr;
+
+  mem_patterns_.splice(mem_patterns_.begin(), mem_patterns_, it->second);
+  return it->second->mem_patterns;
 }
 
 Status SessionState::UpdateMemoryPatternGroupCache(const std::vector<TensorShape>& input_shape,
                                                    std::unique_ptr<MemoryPatternGroup> mem_patterns) const {
-  int64_t key = CalculateMemoryPatternsKey(input_shape);
+  std::vector<int64_t> bucket = CalculateMemoryPatternsBucket(input_shape);
 
   std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
-  auto it = mem_patterns_.find(key);
-  if (it == mem_patterns_.end()) {
-    mem_patterns_[key] = std::move(mem_patterns);
+  auto it = mem_patterns_index_.find(bucket);
+  if (it != mem_patterns_index_.end()) {
+    // keep the cached pattern if a concurrent run already generated one that serves these inputs
+    if (ShapesCoveredBy(input_shape, it->second->input_shapes)) return Status::OK();
+    mem_patterns_.erase(it->second);
+    mem_patterns_index_.erase(it);
+  }
+
+  for (size_t i = 0; i < mem_patterns->locations.size(); i++) {
+    const MemoryPattern& pattern = mem_patterns->patterns[i];
+    LOGS(Logger(), INFO) << "Memory pattern for " << mem_patterns->locations[i].ToString()
+                         << ": peak size " << pattern.PeakSize() << " bytes, lower bound "
+                         << pattern.LowerBoundSize() << " bytes";
+  }
+
+  mem_patterns_.push_front(MemoryPatternCacheEntry{bucket, input_shape, std::move(mem_patterns)});
+  mem_patterns_index_[std::move(bucket)] = mem_patterns_.begin();
+
+  while (max_num_memory_patterns_ > 0 && mem_patterns_.size() > max_num_memory_patterns_) {
+    mem_patterns_index_.erase(mem_patterns_.back().bucket);
+    mem_patterns_.pop_back();
   }
 
   return Status::OK();
 }
 
+void SessionState::SetMaxNumMemoryPatterns(size_t max_num_memory_patterns) {
+  std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
+  max_num_memory_patterns_ = max_num_memory_patterns;
+  while (max_num_memory_patterns_ > 0 && mem_patterns_.size() > max_num_memory_patterns_) {
+    mem_patterns_index_.erase(mem_patterns_.back().bucket);
+    mem_patterns_.pop_back();
+  }
+}
 
 common::Status SessionState::AddInputNameToNodeInfoMapping(const std::string& input_name, const NodeInfo& node_info) {
   // in the future we could support multiple nodes on difference devices using an input, however right now
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <list>
 #include <memory>
 #include <map>
 #include <unordered_map>
@@ -37,10 +38,7 @@ class OpKernel;
 class NodeIndexInfo;
 struct SequentialExecutionPlan;
 struct MemoryPatternGroup;
-
-#ifndef USE_EIGEN_THREADPOOL
-class TaskThreadPool;
-#endif
+class WorkStealingThreadPool;
 
 /**
  * SessionState should be modified by the inference session class only.
@@ -117,9 +115,11 @@ class SessionState {
   profiling::Profiler& Profiler() const;
 
   /**
-  Get cached memory pattern based on input shapes
+  Get cached memory pattern based on input shapes.
+  Input shapes are grouped into buckets by rounding each dimension up to a power of two. The pattern of a bucket
+  was generated for the largest input shapes seen in it, and serves any input shapes that are no larger.
   */
-  const MemoryPatternGroup* GetMemoryPatternGroup(const std::vector<TensorShape>& input_shapes) const;
+  std::shared_ptr<const MemoryPatternGroup> GetMemoryPatternGroup(const std::vector<TensorShape>& input_shapes) const;
 
   /**
   Set generated memory pattern with a given input shapes. 
@@ -128,6 +128,12 @@ class SessionState {
   Status UpdateMemoryPatternGroupCache(const std::vector<TensorShape>& input_shape,
                                        std::unique_ptr<MemoryPatternGroup> mem_patterns) const;
 
+  /**
+  Set the maximum number of cached memory patterns. The least recently used pattern is dropped to make room for
+  a new one. 0 means no limit.
+  */
+  void SetMaxNumMemoryPatterns(size_t max_num_memory_patterns);
+
   struct NodeInfo {
     /**
      *
@@ -172,10 +178,15 @@ class SessionState {
   Eigen::NonBlockingThreadPool* GetThreadPool() const { return thread_pool_; }
   void SetThreadPool(Eigen::NonBlockingThreadPool* p_pool) { thread_pool_ = p_pool; }
 #else
-  TaskThreadPool* GetThreadPool() const { return thread_pool_; }
-  void SetThreadPool(TaskThreadPool* p_pool) { thread_pool_ = p_pool; }
+  WorkStealingThreadPool* GetThreadPool() const { return thread_pool_; }
+  void SetThreadPool(WorkStealingThreadPool* p_pool) { thread_pool_ = p_pool; }
 #endif
 
+  /// Thread pool used by kernels to parallelize work within a single node. nullptr if operators run single threaded.
+  /// The pool is owned by the InferenceSession, or by the Environment if it is shared across sessions.
+  WorkStealingThreadPool* GetIntraOpThreadPool() const { return intra_op_thread_pool_; }
+  void SetIntraOpThreadPool(WorkStealingThreadPool* p_pool) { intra_op_thread_pool_ = p_pool; }
+
   bool ExportDll() const { return export_fused_dll_; }
   void SetExportDllFlag(bool flag) { export_fused_dll_ = flag; }
 
@@ -209,10 +220,20 @@ class SessionState {
   const logging::Logger* logger_ = nullptr;
   profiling::Profiler* profiler_;
 
+  struct MemoryPatternCacheEntry {
+    std::vector<int64_t> bucket;
+    // the input shapes the patterns were generated for
+    std::vector<TensorShape> input_shapes;
+    std::shared_ptr<const MemoryPatternGroup> mem_patterns;
+  };
+
   // lock for the mem_patterns_
   mutable OrtMutex mem_patterns_lock_;
-  // cache for the generated mem_patterns. key is calculated based on input shapes.
-  mutable std::map<int64_t, std::unique_ptr<MemoryPatternGroup>> mem_patterns_;
+  // cache for the generated mem_patterns, ordered from the most to the least recently used
+  mutable std::list<MemoryPatternCacheEntry> mem_patterns_;
+  // index of mem_patterns_ by the bucket of the input shapes
+  mutable std::map<std::vector<int64_t>, std::list<MemoryPatternCacheEntry>::iterator> mem_patterns_index_;
+  size_t max_num_memory_patterns_ = 0;
 
   NameNodeInfoMapType input_names_to_nodeinfo_mapping_;
   NameNodeInfoMapType output_names_to_nodeinfo_mapping_;
@@ -226,8 +247,9 @@ class SessionState {
 #ifdef USE_EIGEN_THREADPOOL
   Eigen::NonBlockingThreadPool* thread_pool_ = nullptr;
 #else
-  TaskThreadPool* thread_pool_ = nullptr;
+  WorkStealingThreadPool* thread_pool_ = nullptr;
 #endif
+  WorkStealingThreadPool* intra_op_thread_pool_ = nullptr;
 
   bool export_fused_dll_ = false;
   FuncManager fused_funcs_mgr_;
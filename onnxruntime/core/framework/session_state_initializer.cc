@@ -18,6 +18,7 @@
 #include "core/framework/mlvalue_name_idx_map.h"
 #include "core/framework/sequential_execution_plan.h"
 #include "core/framework/session_state.h"
+#include "core/framework/shared_initializers.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/utils.h"
 #include "core/framework/mem_buffer.h"
@@ -31,11 +32,12 @@ static common::Status SaveMLValueNameIndexMapping(const GraphViewer& graph_viewe
 // T should have signature of '(int idx, const onnxruntime::MLValue& value, const OrtCallback& d) -> Status'
 template <typename T>
 static common::Status SaveInitializedTensors(const Env& env, const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
-                                             const onnxruntime::Graph& graph,
+                                             onnxruntime::Graph& graph,
                                              const SequentialExecutionPlan& execution_plan,
                                              const ExecutionProviders& exec_providers,
                                              const MLValueNameIdxMap& mlvalue_name_idx_map,
                                              std::map<OrtAllocatorInfo, BufferUniquePtr>& weights_buffers,
+                                             bool map_initializers, bool share_initializers,
                                              const T& save_tensor_func, const logging::Logger& logger);
 
 static common::Status SaveKernels(const ExecutionProviders& execution_providers,
@@ -89,7 +91,8 @@ common::Status SessionStateInitializer::CreatePlan(const Node* parent_node,
 
     session_state_.SetExecutionPlan(std::move(exec_plan));
   } else {
-    // Parallel execution still uses same allocation plan, but has limitation of memory buffer reuse.
+    // Parallel execution uses an allocation plan that only reuses a buffer across nodes that are ordered by the
+    // graph edges, so that it's valid for any schedule of the parallel executor.
     SequentialPlannerContext context(true /* enable parallel execution */);
     ORT_RETURN_IF_ERROR(
         SequentialPlanner::CreatePlan(parent_node, *graph_viewer, valid_outer_scope_node_args, execution_providers_,
@@ -103,7 +106,8 @@ common::Status SessionStateInitializer::CreatePlan(const Node* parent_node,
   return Status::OK();
 }
 
-common::Status SessionStateInitializer::InitializeAndSave(const std::vector<NodeArg*>* implicit_inputs) {
+common::Status SessionStateInitializer::InitializeAndSave(const std::vector<NodeArg*>* implicit_inputs,
+                                                          bool map_initializers, bool share_initializers) {
   const auto* exec_plan_ptr = session_state_.GetExecutionPlan();
   ORT_ENFORCE(exec_plan_ptr, "Execution plan was not found in SessionState. CreatePlan must be called first.");
 
@@ -115,7 +119,7 @@ common::Status SessionStateInitializer::InitializeAndSave(const std::vector<Node
   ORT_RETURN_IF_ERROR(
       SaveInitializedTensors(
           env, graph_loc_, graph_, exec_plan, execution_providers_, mlvalue_name_idx_map,
-          session_state_.GetMutableWeightsBuffers(),
+          session_state_.GetMutableWeightsBuffers(), map_initializers, share_initializers,
           [this](int idx, const onnxruntime::MLValue& value, const OrtCallback& d) -> Status {
             return session_state_.AddInitializedTensor(idx, value, &d);
           },
@@ -307,10 +311,11 @@ static common::Status GetPreallocatedBuffer(const MemoryPatternGroup& mem_patter
 
 template <typename T>
 common::Status SaveInitializedTensors(const Env& env, const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
-                                      const Graph& graph, const SequentialExecutionPlan& execution_plan,
+                                      Graph& graph, const SequentialExecutionPlan& execution_plan,
                                       const ExecutionProviders& exec_providers,
                                       const MLValueNameIdxMap& mlvalue_name_idx_map,
                                       std::map<OrtAllocatorInfo, BufferUniquePtr>& weights_buffers,
+                                      bool map_initializers, bool share_initializers,
                                       const T& save_tensor_func, const logging::Logger& logger) {
   LOGS(logger, INFO) << "Saving initialized tensors.";
   static constexpr int alignment = 256;
@@ -326,6 +331,41 @@ common::Status SaveInitializedTensors(const Env& env, const std::basic_string<PA
     ORT_RETURN_IF_ERROR(mlvalue_name_idx_map.GetIdx(entry.first, mlvalue_index));
     id_to_initialized_tensor[mlvalue_index] = entry.second;
   }
+  if (map_initializers || share_initializers) {
+    // CPU tensors whose data can be used in place from a mapped file, or is shared with other sessions, are saved
+    // right away and need no planned buffer
+    for (auto it = id_to_initialized_tensor.begin(); it != id_to_initialized_tensor.end();) {
+      const int mlvalue_index = it->first;
+      const OrtAllocatorInfo& location = execution_plan.allocation_plan[mlvalue_index].location;
+      if (strcmp(location.name, CPU) != 0 && location.mem_type != OrtMemTypeCPUOutput) {
+        ++it;
+        continue;
+      }
+
+      MLValue mlvalue;
+      OrtCallback deleter;
+      bool mapped = false;
+      bool shared = false;
+      if (map_initializers) {
+        ORT_RETURN_IF_ERROR(utils::TensorProtoToMappedMLValue(env, graph_loc.c_str(), *it->second, location, mlvalue,
+                                                              deleter, mapped));
+      }
+      if (!mapped && share_initializers) {
+        ORT_RETURN_IF_ERROR(SharedInitializers::GetOrCreate(env, graph_loc, *it->second, location, mlvalue, deleter,
+                                                            shared));
+      }
+      if (!mapped && !shared) {
+        ++it;
+        continue;
+      }
+      ORT_RETURN_IF_ERROR(save_tensor_func(mlvalue_index, mlvalue, deleter));
+      VLOGS(logger, 1) << (mapped ? "Mapped" : "Shared") << " weight with name : " << it->second->name()
+                       << " with index: " << mlvalue_index;
+      // the data is held by the tensor now, don't keep a second copy of it in the model until all are saved
+      graph.ReleaseInitializedTensorData(it->second->name());
+      it = id_to_initialized_tensor.erase(it);
+    }
+  }
   for (const auto& entry : id_to_initialized_tensor) {
     size_t len = 0;
     ORT_RETURN_IF_ERROR(utils::GetSizeInBytesFromTensorProto<alignment>(*entry.second, &len));
@@ -365,6 +405,7 @@ common::Status SaveInitializedTensors(const Env& env, const std::basic_string<PA
     ORT_RETURN_IF_ERROR(save_tensor_func(mlvalue_index, mlvalue, deleter));
 
     VLOGS(logger, 1) << "Added weight with name : " << name << " with index: " << mlvalue_index;
+    graph.ReleaseInitializedTensorData(name);
   }
 
   LOGS(logger, INFO) << "Done saving initialized tensors";
@@ -399,14 +440,29 @@ common::Status SaveKernels(const ExecutionProviders& execution_providers,
                            const logging::Logger& logger) {
   LOGS(logger, INFO) << "Saving kernels.";
 
+  size_t num_packed_inputs = 0;
   for (auto& node : session_state.GetGraphViewer()->Nodes()) {
     // construct and save the kernels
     std::unique_ptr<OpKernel> op_kernel;
     ORT_RETURN_IF_ERROR(CreateOpKernel(node, execution_providers, session_state, custom_registry_manager, op_kernel));
+
+    // let the kernel pack its constant inputs once, instead of on every run
+    const OpKernelInfo& info = op_kernel->Info();
+    for (int input_idx = 0, end = static_cast<int>(node.InputDefs().size()); input_idx < end; ++input_idx) {
+      const Tensor* constant_input = nullptr;
+      if (info.TryGetConstantInput(input_idx, &constant_input)) {
+        bool is_packed = false;
+        ORT_RETURN_IF_ERROR(op_kernel->PrePack(*constant_input, input_idx, is_packed));
+        if (is_packed) {
+          ++num_packed_inputs;
+        }
+      }
+    }
+
     session_state.AddKernel(node.Index(), std::move(op_kernel));
   }
 
-  LOGS(logger, INFO) << "Done saving kernels.";
+  LOGS(logger, INFO) << "Done saving kernels. Pre-packed " << num_packed_inputs << " constant inputs.";
 
   return Status::OK();
 }
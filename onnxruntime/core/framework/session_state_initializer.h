@@ -40,7 +40,12 @@ class SessionStateInitializer {
 
   // initialize tensors, and save. save kernels and input/output node mappings
   // \param implicit_inputs could be NULL
-  common::Status InitializeAndSave(const std::vector<NodeArg*>* implicit_inputs);
+  // \param map_initializers use CPU initializers in place from read-only mappings of the files they are stored in
+  //                         where possible, instead of copying them into buffers allocated for the session
+  // \param share_initializers use CPU initializers from the process-wide SharedInitializers store, so sessions with
+  //                           the same initializers hold one copy of them
+  common::Status InitializeAndSave(const std::vector<NodeArg*>* implicit_inputs, bool map_initializers = false,
+                                   bool share_initializers = false);
 
  private:
   const std::basic_string<PATH_CHAR_TYPE>& graph_loc_;
@@ -0,0 +1,210 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/shared_initializers.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+
+#include "core/framework/allocator.h"
+#include "core/framework/mem_buffer.h"
+#include "core/framework/tensor.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/platform/ort_mutex.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+
+struct SharedInitializers::Entry {
+  Entry() = default;
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(Entry);
+
+  ~Entry() {
+    if (deleter.f != nullptr) {
+      deleter.f(deleter.param);
+    }
+  }
+
+  int data_type = 0;
+  std::vector<int64_t> dims;
+  // hash of the data as stored in the model, 0 for external data
+  size_t content_hash = 0;
+
+  // where external data was loaded from, empty for data stored in the model
+  std::basic_string<ORTCHAR_T> model_path;
+  std::string external_data;
+
+  BufferUniquePtr buffer;
+  MLValue value;
+  OrtCallback deleter{nullptr, nullptr};
+};
+
+namespace {
+
+// The external data entries of a tensor, which together with the model path identify the data.
+std::string GetExternalDataKey(const TensorProto& tensor_proto) {
+  std::string key;
+  for (const auto& entry : tensor_proto.external_data()) {
+    key.append(entry.key()).append("=").append(entry.value()).append("\n");
+  }
+  return key;
+}
+
+void ORT_API_CALL ReleaseEntry(void* param) noexcept {
+  // the entry type is private, but releasing a reference needs no access to it
+  delete reinterpret_cast<std::shared_ptr<void>*>(param);
+}
+
+}  // namespace
+
+common::Status SharedInitializers::GetOrCreate(const Env& env, const std::basic_string<ORTCHAR_T>& model_path,
+                                               const TensorProto& tensor_proto, const OrtAllocatorInfo& alloc_info,
+                                               MLValue& value, OrtCallback& deleter, bool& shared) {
+  shared = false;
+  if (tensor_proto.data_type() == TensorProto_DataType_STRING) {
+    return Status::OK();
+  }
+
+  // The mutex only guards the map. Hashing, comparing and deserializing the data happen outside of it, so that
+  // sessions created concurrently don't wait for each other's initializers.
+  static OrtMutex mutex;
+  // by initializer name. Entries expire when the last session using them is gone.
+  static std::unordered_multimap<std::string, std::weak_ptr<Entry>> entries;
+  static AllocatorPtr allocator = std::make_shared<CPUAllocator>();
+
+  const bool is_external = tensor_proto.data_location() == TensorProto_DataLocation_EXTERNAL;
+  const std::string external_data = is_external ? GetExternalDataKey(tensor_proto) : std::string();
+  const std::vector<int64_t> dims(tensor_proto.dims().begin(), tensor_proto.dims().end());
+  size_t size_in_bytes;
+  ORT_RETURN_IF_ERROR(utils::GetSizeInBytesFromTensorProto<0>(tensor_proto, &size_in_bytes));
+
+  const bool compare_raw_data = !is_external && tensor_proto.has_raw_data() && utils::IsLittleEndianOrder();
+  if (compare_raw_data && tensor_proto.raw_data().size() != size_in_bytes) {
+    // leave reporting the mismatch to TensorProtoToMLValue
+    return Status::OK();
+  }
+
+  // Data stored in the model is told apart by a hash of its bytes in the proto first, so that it is only compared,
+  // and unpacked if it isn't raw_data, when it very likely is a duplicate.
+  const size_t content_hash = is_external ? 0
+                                          : std::hash<std::string>()(tensor_proto.has_raw_data()
+                                                                         ? tensor_proto.raw_data()
+                                                                         : tensor_proto.SerializeAsString());
+
+  // the entries that may hold the same data. Called with the mutex held.
+  auto find_candidates = [&](std::vector<std::shared_ptr<Entry>>& candidates) {
+    auto range = entries.equal_range(tensor_proto.name());
+    for (auto it = range.first; it != range.second;) {
+      auto candidate = it->second.lock();
+      if (candidate == nullptr) {
+        it = entries.erase(it);
+        continue;
+      }
+      ++it;
+
+      if (candidate->data_type == tensor_proto.data_type() && candidate->dims == dims &&
+          candidate->external_data == external_data && candidate->content_hash == content_hash &&
+          (!is_external || candidate->model_path == model_path)) {
+        candidates.push_back(std::move(candidate));
+      }
+    }
+  };
+
+  // Compare the data with that of the candidates, external data is identified by its file and position.
+  std::unique_ptr<char[]> unpacked;
+  auto find_match = [&](const std::vector<std::shared_ptr<Entry>>& candidates,
+                        std::shared_ptr<Entry>& entry) -> Status {
+    for (const auto& candidate : candidates) {
+      if (is_external || size_in_bytes == 0) {
+        entry = candidate;
+        return Status::OK();
+      }
+
+      const void* data = tensor_proto.raw_data().data();
+      if (!compare_raw_data) {
+        if (unpacked == nullptr) {
+          unpacked.reset(new char[size_in_bytes]);
+          MLValue unpacked_value;
+          OrtCallback unpacked_deleter;
+          ORT_RETURN_IF_ERROR(utils::TensorProtoToMLValue(env, model_path.c_str(), tensor_proto,
+                                                          MemBuffer(unpacked.get(), size_in_bytes, allocator->Info()),
+                                                          unpacked_value, unpacked_deleter));
+        }
+        data = unpacked.get();
+      }
+      if (memcmp(candidate->value.Get<Tensor>().DataRaw(), data, size_in_bytes) == 0) {
+        entry = candidate;
+        return Status::OK();
+      }
+    }
+    return Status::OK();
+  };
+
+  std::vector<std::shared_ptr<Entry>> candidates;
+  {
+    std::lock_guard<OrtMutex> lock(mutex);
+    find_candidates(candidates);
+  }
+
+  std::shared_ptr<Entry> entry;
+  ORT_RETURN_IF_ERROR(find_match(candidates, entry));
+
+  if (entry == nullptr) {
+    auto new_entry = std::make_shared<Entry>();
+    new_entry->data_type = tensor_proto.data_type();
+    new_entry->dims = dims;
+    new_entry->content_hash = content_hash;
+    if (is_external) {
+      new_entry->model_path = model_path;
+      new_entry->external_data = external_data;
+    }
+
+    void* buffer = size_in_bytes == 0 ? nullptr : allocator->Alloc(size_in_bytes);
+    new_entry->buffer = BufferUniquePtr(buffer, BufferDeleter(allocator));
+    ORT_RETURN_IF_ERROR(utils::TensorProtoToMLValue(env, model_path.c_str(), tensor_proto,
+                                                    MemBuffer(buffer, size_in_bytes, allocator->Info()),
+                                                    new_entry->value, new_entry->deleter));
+    if (new_entry->value.Get<Tensor>().DataRaw() != buffer) {
+      // external data used in place from a mapping of its file
+      new_entry->buffer.reset();
+    }
+
+    // Another session may have stored the same data while this one deserialized it. Use that copy then, so that
+    // the sessions still end up sharing one.
+    while (entry == nullptr) {
+      std::vector<std::shared_ptr<Entry>> added;
+      {
+        std::lock_guard<OrtMutex> lock(mutex);
+        std::vector<std::shared_ptr<Entry>> current;
+        find_candidates(current);
+        for (auto& candidate : current) {
+          if (std::find(candidates.begin(), candidates.end(), candidate) == candidates.end()) {
+            added.push_back(std::move(candidate));
+          }
+        }
+        if (added.empty()) {
+          entries.emplace(tensor_proto.name(), new_entry);
+          entry = std::move(new_entry);
+          break;
+        }
+      }
+
+      ORT_RETURN_IF_ERROR(find_match(added, entry));
+      candidates.insert(candidates.end(), added.begin(), added.end());
+    }
+  }
+
+  const Tensor& tensor = entry->value.Get<Tensor>();
+  value.Init(new Tensor(tensor.DataType(), tensor.Shape(), const_cast<void*>(tensor.DataRaw()), alloc_info),
+             DataTypeImpl::GetType<Tensor>(), DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+  deleter.f = ReleaseEntry;
+  deleter.param = new std::shared_ptr<void>(std::move(entry));
+  shared = true;
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
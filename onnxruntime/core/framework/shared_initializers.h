@@ -0,0 +1,44 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "core/common/common.h"
+#include "core/common/callback.h"
+#include "core/framework/ml_value.h"
+#include "core/graph/onnx_protobuf.h"
+#include "core/platform/env.h"
+
+namespace onnxruntime {
+
+/**
+Process-wide store of CPU initializers shared between sessions.
+
+The first session loading an initializer deserializes it into a buffer owned by the store. Later sessions asking
+for an initializer with the same name, type, shape and content get tensors using the same data, so N sessions of
+the same weights hold one copy of them. Content is compared byte for byte, or by file and position for external data, so
+initializers that differ between sessions, e.g. because of different graph optimizations, are never mixed up.
+The data is released once the last session using it is gone.
+*/
+class SharedInitializers {
+ public:
+  /**
+  Get a CPU tensor for 'tensor_proto' using the shared data, creating the data if no session holds it yet.
+  \param model_path The path the model was loaded from, or empty. Used to locate external data.
+  \param alloc_info The location the tensor reports. Must be a CPU location.
+  \param[out] shared false if the tensor can't be shared, i.e. it is a string tensor. value and deleter are left
+                     untouched then.
+  \param[out] deleter keeps the tensor alive and must be called once it is no longer used.
+  */
+  static common::Status GetOrCreate(const Env& env, const std::basic_string<ORTCHAR_T>& model_path,
+                                    const ONNX_NAMESPACE::TensorProto& tensor_proto, const OrtAllocatorInfo& alloc_info,
+                                    MLValue& value, OrtCallback& deleter, bool& shared);
+
+ private:
+  struct Entry;
+};
+
+}  // namespace onnxruntime
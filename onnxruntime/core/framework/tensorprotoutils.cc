@@ -16,6 +16,7 @@
 #include "core/framework/allocator.h"
 #include "core/common/callback.h"
 #include "core/framework/data_types.h"
+#include "core/framework/mapped_file.h"
 #include "core/framework/path_lib.h"
 
 using namespace ONNX_NAMESPACE;
@@ -23,16 +24,7 @@ using namespace ::onnxruntime::common;
 
 namespace {
 
-#ifdef __GNUC__
-constexpr inline bool IsLittleEndianOrder() noexcept { return __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__; }
-#else
-// On Windows and Mac, this function should always return true
-GSL_SUPPRESS(type .1)  // allow use of reinterpret_cast for this special case
-inline bool IsLittleEndianOrder() noexcept {
-  static int n = 1;
-  return (*reinterpret_cast<char*>(&n) == 1);
-}
-#endif
+using onnxruntime::utils::IsLittleEndianOrder;
 
 std::vector<int64_t> GetTensorShapeFromTensorProto(const ONNX_NAMESPACE::TensorProto& tensor_proto) {
   const auto& dims = tensor_proto.dims();
@@ -474,6 +466,87 @@ Status TensorProtoToMLValue(const Env& env, const ORTCHAR_T* tensor_proto_path,
   return Status::OK();
 }
 
+Status TensorProtoToMappedMLValue(const Env& env, const ORTCHAR_T* tensor_proto_path,
+                                  const ONNX_NAMESPACE::TensorProto& tensor_proto, const OrtAllocatorInfo& alloc_info,
+                                  MLValue& value, OrtCallback& deleter, bool& mapped) {
+  mapped = false;
+  // the data is used as stored, so it must already be in the machine's byte order
+  if (!IsLittleEndianOrder() || tensor_proto.data_type() == TensorProto_DataType_STRING) {
+    return Status::OK();
+  }
+  const bool is_external = tensor_proto.data_location() == TensorProto_DataLocation_EXTERNAL;
+  const bool is_raw_data_in_model = !is_external && tensor_proto.has_raw_data() && tensor_proto.has_name() &&
+                                    tensor_proto_path != nullptr && tensor_proto_path[0] != 0;
+  if (!is_external && !is_raw_data_in_model) {
+    return Status::OK();
+  }
+
+  const DataTypeImpl* const type = DataTypeImpl::TensorTypeFromONNXEnum(tensor_proto.data_type())->GetElementType();
+  std::vector<int64_t> tensor_shape_vec = GetTensorShapeFromTensorProto(tensor_proto);
+  int64_t tensor_size = 1;
+  for (auto i : tensor_shape_vec) {
+    if (i < 0) return Status(common::ONNXRUNTIME, common::FAIL, "tensor can't contain negative dims");
+    tensor_size *= i;
+  }
+  size_t size_in_bytes;
+  if (static_cast<uint64_t>(tensor_size) > SIZE_MAX ||
+      !IAllocator::CalcMemSizeForArrayWithAlignment<0>(static_cast<size_t>(tensor_size), type->Size(),
+                                                       &size_in_bytes)) {
+    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "size overflow");
+  }
+  if (size_in_bytes == 0) {
+    return Status::OK();
+  }
+
+  std::shared_ptr<const MappedFile> file;
+  const char* data = nullptr;
+  if (is_external) {
+    std::unique_ptr<ExternalDataInfo> external_data_info;
+    ORT_RETURN_IF_ERROR(ExternalDataInfo::Create(tensor_proto.external_data(), external_data_info));
+    std::basic_string<ORTCHAR_T> full_path;
+    if (tensor_proto_path != nullptr) {
+      ORT_RETURN_IF_ERROR(GetDirNameFromFilePath(tensor_proto_path, full_path));
+      full_path = ConcatPathComponent<ORTCHAR_T>(full_path, external_data_info->GetRelPath());
+    } else {
+      full_path = external_data_info->GetRelPath();
+    }
+    ORT_RETURN_IF_ERROR(MappedFile::Open(env, full_path, file));
+
+    const auto offset = external_data_info->GetOffset();
+    if (offset < 0 || static_cast<uint64_t>(offset) > file->Length()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "External data offset ", offset, " is beyond the end of the file");
+    }
+    const size_t available = file->Length() - static_cast<size_t>(offset);
+    const size_t length = external_data_info->GetLength() == 0 ? available : external_data_info->GetLength();
+    if (length != size_in_bytes || length > available) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "External data of ", length, " bytes doesn't match the ",
+                             size_in_bytes, " bytes of the tensor or exceeds the ", available, " bytes in the file");
+    }
+    data = file->Data() + offset;
+  } else {
+    if (tensor_proto.raw_data().size() != size_in_bytes) {
+      // leave reporting the mismatch to TensorProtoToMLValue
+      return Status::OK();
+    }
+    // The model may not be a plain file, e.g. a pipe. Failing to map it only means it has to be copied.
+    if (!MappedFile::Open(env, tensor_proto_path, file).IsOK()) {
+      return Status::OK();
+    }
+    data = static_cast<const char*>(file->FindInitializerRawData(tensor_proto.name(), tensor_proto.raw_data()));
+  }
+
+  if (data == nullptr || reinterpret_cast<uintptr_t>(data) % type->Size() != 0) {
+    return Status::OK();
+  }
+
+  MappedFile::AddReference(file, deleter);
+  TensorShape tensor_shape{tensor_shape_vec};
+  value.Init(new Tensor(type, tensor_shape, const_cast<char*>(data), alloc_info), DataTypeImpl::GetType<Tensor>(),
+             DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+  mapped = true;
+  return Status::OK();
+}
+
 #define CASE_TYPE(X)                             \
   case ONNX_NAMESPACE::TensorProto_DataType_##X: \
     return ONNX_TENSOR_ELEMENT_DATA_TYPE_##X;
@@ -24,6 +24,17 @@ class TensorShapeProto;
 namespace onnxruntime {
 class Tensor;
 namespace utils {
+#ifdef __GNUC__
+constexpr inline bool IsLittleEndianOrder() noexcept { return __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__; }
+#else
+// On Windows and Mac, this function should always return true
+GSL_SUPPRESS(type .1)  // allow use of reinterpret_cast for this special case
+inline bool IsLittleEndianOrder() noexcept {
+  static int n = 1;
+  return (*reinterpret_cast<char*>(&n) == 1);
+}
+#endif
+
 std::vector<int64_t> GetTensorShapeFromTensorShapeProto(const ONNX_NAMESPACE::TensorShapeProto& tensor_shape_proto);
 /**
  * deserialize a TensorProto into a preallocated memory buffer.
@@ -34,6 +45,20 @@ std::vector<int64_t> GetTensorShapeFromTensorShapeProto(const ONNX_NAMESPACE::Te
 common::Status TensorProtoToMLValue(const Env& env, const ORTCHAR_T* tensor_proto_path,
                                     const ONNX_NAMESPACE::TensorProto& input, const MemBuffer& m, MLValue& value,
                                     OrtCallback& deleter);
+
+/**
+ * Create a CPU tensor that points straight into a read-only mapping of the file the tensor data is stored in,
+ * instead of copying it. Mappings are shared by every tensor, and every session, using the same file.
+ * Data stored externally is mapped from its external file. raw_data is mapped from the model file at
+ * tensor_proto_path when the tensor is a main graph initializer whose bytes are stored there unchanged.
+ * \param[out] mapped false if the tensor can't be used in place, e.g. because it is a string tensor, its data isn't
+ *                    stored in a file or isn't suitably aligned. value and deleter are left untouched then.
+ * \param[out] deleter keeps the mapping alive and must be called once the tensor is no longer used.
+ */
+common::Status TensorProtoToMappedMLValue(const Env& env, const ORTCHAR_T* tensor_proto_path,
+                                          const ONNX_NAMESPACE::TensorProto& input, const OrtAllocatorInfo& alloc_info,
+                                          MLValue& value, OrtCallback& deleter, bool& mapped);
+
 // This function doesn't support string tensors
 ONNX_NAMESPACE::TensorProto::DataType GetTensorProtoType(const Tensor& tensor);
 
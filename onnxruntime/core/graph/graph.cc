@@ -1910,6 +1910,8 @@ void Graph::AddInitializedTensor(const TensorProto& tensor) {
 void Graph::RemoveInitializedTensor(const std::string& tensor_name) {
   auto iter = name_to_initial_tensor_.find(tensor_name);
   if (name_to_initial_tensor_.end() != iter) {
+    // the TensorProto is dropped from graph_proto_ on the next sync
+    removed_initializers_.insert(iter->second);
     name_to_initial_tensor_.erase(tensor_name);
     SetGraphProtoSyncNeeded();
     SetGraphResolveNeeded();
@@ -1926,9 +1928,17 @@ bool Graph::GetInitializedTensor(const std::string& tensor_name, const TensorPro
   return true;
 }
 
+void Graph::ReleaseInitializedTensorData(const std::string& tensor_name) {
+  auto iter = name_to_initial_tensor_.find(tensor_name);
+  if (name_to_initial_tensor_.end() != iter) {
+    // the TensorProto is owned by graph_proto_. Clearing raw_data would keep its memory.
+    delete const_cast<TensorProto*>(iter->second)->release_raw_data();
+  }
+}
+
 void Graph::CleanAllInitializedTensors() noexcept {
   name_to_initial_tensor_.clear();
-  removed_initializer_indexes_.clear();
+  removed_initializers_.clear();
 
   // Clearing RepeatedPtrFields does not free objects' memory. The memory is retained
   // and can be reused. Need to explicitly release the cleared objects and free the
@@ -2111,32 +2121,23 @@ const GraphProto& Graph::ToGraphProto() {
     p_node->ToProto(*node_proto);
   }
 
-  if (!removed_initializer_indexes_.empty()) {
-    // Move initializers.
-    std::sort(removed_initializer_indexes_.begin(), removed_initializer_indexes_.end());
-    int lastInUseInitializerIndex = graph_proto_->initializer_size() - 1;
-    int start = 0, end = gsl::narrow_cast<int>(removed_initializer_indexes_.size()) - 1;
-    int lastRemovedInitializerIndex = removed_initializer_indexes_[end];
-
-    for (; start <= end; start++) {
-      // Find a lastInUseInitializer.
-      while (start <= end && lastInUseInitializerIndex == lastRemovedInitializerIndex) {
-        graph_proto_->mutable_initializer()->RemoveLast();
-        lastInUseInitializerIndex--;
-        end--;
-        if (start <= end) {
-          lastRemovedInitializerIndex = removed_initializer_indexes_[end];
-        }
+  if (!removed_initializers_.empty()) {
+    // Move the removed initializers to the end, keeping the order of the others, and delete them.
+    // SwapElements only swaps pointers, so the TensorProto instances name_to_initial_tensor_ refers to stay valid.
+    auto* initializers = graph_proto_->mutable_initializer();
+    const int num_initializers = initializers->size();
+    int num_kept = 0;
+    for (int i = 0; i < num_initializers; ++i) {
+      if (removed_initializers_.count(&initializers->Get(i)) != 0) {
+        continue;
       }
-
-      if (start <= end) {
-        // Copy the <lastInUseInitializerIndex> initializer in use to the <start> slot which is removed.
-        *graph_proto_->mutable_initializer(removed_initializer_indexes_[start]) = graph_proto_->initializer(lastInUseInitializerIndex);
-        graph_proto_->mutable_initializer()->RemoveLast();
-        lastInUseInitializerIndex--;
+      if (num_kept != i) {
+        initializers->SwapElements(num_kept, i);
       }
+      ++num_kept;
     }
-    removed_initializer_indexes_.clear();
+    initializers->DeleteSubrange(num_kept, num_initializers - num_kept);
+    removed_initializers_.clear();
   }
 
   // Sync graph inputs/outputs/valueInfo.
@@ -2206,8 +2207,10 @@ void Graph::CleanUnusedInitializers() {
     }
   }
 
-  std::for_each(erase_list.cbegin(), erase_list.cend(),
-                [this](const std::string& name) { name_to_initial_tensor_.erase(name); });
+  std::for_each(erase_list.cbegin(), erase_list.cend(), [this](const std::string& name) {
+    removed_initializers_.insert(name_to_initial_tensor_[name]);
+    name_to_initial_tensor_.erase(name);
+  });
 }
 
 GSL_SUPPRESS(es .84)  // warning about ignoring return value from insert(...)
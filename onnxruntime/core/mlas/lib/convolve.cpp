@@ -736,6 +736,217 @@ Return Value:
     }
 }
 
+void
+MlasConvDepthwiseOperation(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    float* Output
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the convolution of a single input channel with a
+    single filter, for the depthwise convolution where each group has one
+    input channel.
+
+    The output is computed directly a row at a time: each element of the
+    kernel is multiplied by a row of the input image and accumulated to the
+    output row. This is vectorized across the output pixels for unit strides.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input image.
+
+    Filter - Supplies the filter.
+
+    Output - Supplies the output image.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t InputHeight = Parameters->InputShape[0];
+    const size_t InputWidth = Parameters->InputShape[1];
+    const size_t OutputHeight = Parameters->OutputShape[0];
+    const size_t OutputWidth = Parameters->OutputShape[1];
+
+    const size_t KernelHeight = Parameters->KernelShape[0];
+    const size_t KernelWidth = Parameters->KernelShape[1];
+    const size_t DilationHeight = Parameters->DilationShape[0];
+    const size_t DilationWidth = Parameters->DilationShape[1];
+    const size_t PaddingLeftY = Parameters->Padding[0];
+    const size_t PaddingLeftX = Parameters->Padding[1];
+    const size_t StrideHeight = Parameters->StrideShape[0];
+    const size_t StrideWidth = Parameters->StrideShape[1];
+
+    for (size_t oh = 0; oh < OutputHeight; oh++) {
+
+        float* output = Output + oh * OutputWidth;
+
+        std::fill_n(output, OutputWidth, 0.0f);
+
+        for (size_t kh = 0; kh < KernelHeight; kh++) {
+
+            //
+            // Skip the kernel rows that sample the padding, which is zero.
+            //
+
+            size_t ih = oh * StrideHeight + kh * DilationHeight - PaddingLeftY;
+
+            if (ih >= InputHeight) {
+                continue;
+            }
+
+            const float* input = Input + ih * InputWidth;
+
+            for (size_t kw = 0; kw < KernelWidth; kw++) {
+
+                const float FilterValue = Filter[kh * KernelWidth + kw];
+
+                //
+                // Compute the range of output pixels that sample the input
+                // row for this element of the kernel, excluding the padding.
+                //
+
+                const ptrdiff_t Offset = ptrdiff_t(kw * DilationWidth) - ptrdiff_t(PaddingLeftX);
+
+                size_t ow = 0;
+
+                if (Offset < 0) {
+                    ow = (size_t(-Offset) + StrideWidth - 1) / StrideWidth;
+                }
+
+                if (ptrdiff_t(InputWidth) <= Offset) {
+                    continue;
+                }
+
+                size_t OutputEnd = (size_t(ptrdiff_t(InputWidth) - 1 - Offset)) / StrideWidth + 1;
+
+                if (OutputEnd > OutputWidth) {
+                    OutputEnd = OutputWidth;
+                }
+
+                if (StrideWidth == 1) {
+
+                    const float* in = input + Offset;
+                    MLAS_FLOAT32X4 FilterVector = MlasBroadcastFloat32x4(FilterValue);
+
+                    for (; ow + 4 <= OutputEnd; ow += 4) {
+                        MLAS_FLOAT32X4 Accumulator = MlasLoadFloat32x4(&output[ow]);
+                        Accumulator = MlasMultiplyAddFloat32x4(FilterVector, MlasLoadFloat32x4(&in[ow]), Accumulator);
+                        MlasStoreFloat32x4(&output[ow], Accumulator);
+                    }
+
+                    for (; ow < OutputEnd; ow++) {
+                        output[ow] += FilterValue * in[ow];
+                    }
+
+                } else {
+
+                    for (; ow < OutputEnd; ow++) {
+                        output[ow] += FilterValue * input[ptrdiff_t(ow * StrideWidth) + Offset];
+                    }
+                }
+            }
+        }
+    }
+}
+
+void
+MlasConvDepthwiseThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    depthwise convolution operation.
+
+    The operation is partitioned by output image: each batch, group and
+    filter produces one output image from one input image.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_CONV_WORK_BLOCK* WorkBlock = (MLAS_CONV_WORK_BLOCK*)Context;
+
+    const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
+
+    //
+    // Compute the range of output images to use for this thread.
+    //
+
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t GroupFilterCount = Parameters->GroupCount * FilterCount;
+    const size_t ImageCount = Parameters->BatchCount * GroupFilterCount;
+
+    const size_t TargetThreadCount = WorkBlock->TargetThreadCount;
+
+    const size_t ImageCountPerThread = ImageCount / TargetThreadCount;
+    const size_t ImageCountExtra = ImageCount % TargetThreadCount;
+
+    size_t ImageStart;
+    size_t ImageEnd;
+
+    if (uint32_t(Index) < ImageCountExtra) {
+        ImageStart = (ImageCountPerThread + 1) * Index;
+        ImageEnd = ImageStart + ImageCountPerThread + 1;
+    } else {
+        ImageStart = ImageCountPerThread * Index + ImageCountExtra;
+        ImageEnd = ImageStart + ImageCountPerThread;
+    }
+
+    //
+    // Iterate over the output images allocated to this thread.
+    //
+
+    const size_t InputSize = Parameters->InputSize;
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t K = Parameters->K;
+
+    for (size_t image = ImageStart; image < ImageEnd; image++) {
+
+        const size_t filter = image % GroupFilterCount;
+
+        const float* input = WorkBlock->Input + (image / FilterCount) * InputSize;
+        float* output = WorkBlock->Output + image * OutputSize;
+
+        MlasConvDepthwiseOperation(Parameters, input, WorkBlock->Filter + filter * K, output);
+
+        //
+        // Apply the activation with optional bias while the output image is
+        // still in the cache.
+        //
+
+        const float* bias = WorkBlock->Bias;
+
+        if (bias != nullptr) {
+            bias += filter;
+        }
+
+        MlasActivation(Parameters->Activation, output, bias, 1, output, OutputSize,
+            OutputSize);
+    }
+}
+
 inline
 bool
 MlasConvTryMultithread(
@@ -820,7 +1031,7 @@ Return Value:
         Index++;
     }
 
-    MlasExecuteThreaded(MlasConvOperationThreaded, &WorkBlock, Index);
+    MlasExecuteThreaded(MlasConvOperationThreaded, &WorkBlock, Index, Parameters->ThreadPool);
 
     return true;
 
@@ -894,6 +1105,54 @@ Return Value:
 
     const MLAS_CONV_ALGORITHM Algorithm = Parameters->Algorithm;
 
+    //
+    // Schedule the output images of a depthwise convolution across multiple
+    // threads.
+    //
+
+    if (Algorithm == MlasConvAlgorithmDepthwise) {
+
+        const size_t ImageCount = BatchCount * GroupCount * FilterCount;
+
+        int32_t TargetThreadCount;
+        double Complexity = double(ImageCount) * double(OutputSize) * double(K);
+
+        if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
+            TargetThreadCount = int32_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+        } else {
+            TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+        }
+
+        int32_t MaximumThreadCount = MlasGetMaximumThreadCount(Parameters->ThreadPool);
+
+        if (TargetThreadCount >= MaximumThreadCount) {
+            TargetThreadCount = MaximumThreadCount;
+        }
+
+        if (size_t(TargetThreadCount) >= ImageCount) {
+            TargetThreadCount = int32_t(ImageCount);
+        }
+
+        MLAS_CONV_WORK_BLOCK WorkBlock;
+
+        WorkBlock.Parameters = Parameters;
+        WorkBlock.Input = Input;
+        WorkBlock.Filter = Filter;
+        WorkBlock.Bias = Bias;
+        WorkBlock.WorkingBuffer = nullptr;
+        WorkBlock.Output = Output;
+        WorkBlock.TargetThreadCount = TargetThreadCount;
+
+        if (TargetThreadCount == 1) {
+            MlasConvDepthwiseThreaded(&WorkBlock, 0);
+        } else {
+            MlasExecuteThreaded(MlasConvDepthwiseThreaded, &WorkBlock, TargetThreadCount,
+                Parameters->ThreadPool);
+        }
+
+        return;
+    }
+
 #if defined(MLAS_HAS_THREADING_SUPPORT)
 
     //
@@ -904,7 +1163,7 @@ Return Value:
 
         const size_t BatchGroupCount = BatchCount * GroupCount;
 
-        int32_t TargetThreadCount = MlasPlatform.GetMaximumThreadCount();
+        int32_t TargetThreadCount = MlasGetMaximumThreadCount(Parameters->ThreadPool);
 
         if (size_t(TargetThreadCount) >= BatchGroupCount) {
             TargetThreadCount = int32_t(BatchGroupCount);
@@ -920,7 +1179,8 @@ Return Value:
         WorkBlock.Output = Output;
         WorkBlock.TargetThreadCount = TargetThreadCount;
 
-        MlasExecuteThreaded(MlasConvGemmDirectThreaded, &WorkBlock, TargetThreadCount);
+        MlasExecuteThreaded(MlasConvGemmDirectThreaded, &WorkBlock, TargetThreadCount,
+            Parameters->ThreadPool);
 
         return;
     }
@@ -952,7 +1212,7 @@ Return Value:
 
                     MlasSgemm(CblasNoTrans, Parameters->u.GemmDirect.TransB, FilterCount,
                         OutputSize, K, 1.0f, filter, K, Input, Parameters->u.GemmDirect.ldb, 0.0f,
-                        Output, OutputSize);
+                        Output, OutputSize, Parameters->ThreadPool);
 
                     //
                     // Apply the activation with optional bias.
@@ -978,7 +1238,8 @@ Return Value:
                     }
 
                     MlasSgemm(CblasNoTrans, CblasNoTrans, FilterCount, OutputSize, K, 1.0f, filter,
-                        K, WorkingBuffer, OutputSize, 0.0f, Output, OutputSize);
+                        K, WorkingBuffer, OutputSize, 0.0f, Output, OutputSize,
+                        Parameters->ThreadPool);
 
                     //
                     // Apply the activation with optional bias.
@@ -1005,6 +1266,16 @@ Return Value:
 
                     break;
                 }
+
+                case MlasConvAlgorithmDepthwise:
+                {
+                    //
+                    // Depthwise convolutions are scheduled across all batches
+                    // and groups above.
+                    //
+
+                    break;
+                }
             }
 
             //
@@ -1038,7 +1309,8 @@ MlasConvPrepare(
     const int64_t* OutputShape,
     size_t FilterCount,
     const MLAS_ACTIVATION* Activation,
-    size_t* WorkingBufferSize
+    size_t* WorkingBufferSize,
+    MLAS_THREADPOOL* ThreadPool
     )
 /*++
 
@@ -1082,6 +1354,9 @@ Arguments:
     WorkingBufferSize - Receives the number of elements to allocate for the
         working buffer for intermediate results.
 
+    ThreadPool - Optionally supplies the thread pool to execute the
+        convolution. If nullptr, the platform threading model is used.
+
 Return Value:
 
     None.
@@ -1098,6 +1373,7 @@ Return Value:
     Parameters->GroupCount = GroupCount;
     Parameters->InputChannels = InputChannels;
     Parameters->FilterCount = FilterCount;
+    Parameters->ThreadPool = ThreadPool;
 
     size_t InputSize = 1;
     size_t OutputSize = 1;
@@ -1136,6 +1412,19 @@ Return Value:
 
     *WorkingBufferSize = 0;
 
+    //
+    // Detect a depthwise convolution, where each group has a single input
+    // channel. Expanding the input would create a tiny GEMM per group, so
+    // compute the output images directly instead.
+    //
+
+    if (Dimensions == 2 && GroupCount > 1 && InputChannels == 1) {
+
+        Parameters->Algorithm = MlasConvAlgorithmDepthwise;
+
+        return;
+    }
+
     if (AllStridesAreOne && AllPaddingIsZero) {
 
         //
@@ -1210,7 +1499,7 @@ Return Value:
             TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
         }
 
-        int32_t MaximumThreadCount = MlasPlatform.GetMaximumThreadCount();
+        int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
 
         if (TargetThreadCount >= MaximumThreadCount) {
             TargetThreadCount = MaximumThreadCount;
@@ -79,12 +79,18 @@ Abstract:
 #if defined(_OPENMP)
 #include <omp.h>
 #define MLAS_USE_OPENMP
-#define MLAS_HAS_THREADING_SUPPORT
 #elif defined(_WIN32)
 #define MLAS_USE_WIN32_THREADPOOL
-#define MLAS_HAS_THREADING_SUPPORT
 #endif
 
+//
+// Threaded work can always be dispatched to a caller supplied thread pool, so
+// the threading support is available regardless of the platform threading
+// model.
+//
+
+#define MLAS_HAS_THREADING_SUPPORT
+
 //
 // Define the maximum number of threads supported by this implementation.
 //
@@ -109,6 +115,22 @@ Abstract:
 
 #define MLAS_SGEMM_STRIDEN_THREAD_ALIGN             16
 
+//
+// Define the alignment of a packed matrix B buffer. The packing routines use
+// aligned stores and the SGEMM kernels use aligned loads of matrix B.
+//
+
+#define MLAS_SGEMM_PACKED_B_ALIGNMENT               64
+
+//
+// Define the default strides to step through slices of the input matrices of
+// a QGEMM operation and the number of rows of matrix A packed at a time.
+//
+
+#define MLAS_QGEMM_STRIDEN                          128
+#define MLAS_QGEMM_STRIDEK                          256
+#define MLAS_QGEMM_PACKA_ROWS                       16
+
 //
 // Define the prototypes of the platform optimized routines.
 //
@@ -173,6 +195,44 @@ void
 
 typedef MLAS_TANH_KERNEL_ROUTINE* PMLAS_TANH_KERNEL_ROUTINE;
 
+typedef
+size_t
+(MLASCALL MLAS_QGEMM_KERNEL_ROUTINE)(
+    const int16_t* A,
+    const int16_t* B,
+    int32_t* C,
+    size_t PairCountK,
+    size_t CountM,
+    size_t CountN,
+    size_t lda,
+    size_t ldc,
+    bool ZeroMode
+    );
+
+typedef MLAS_QGEMM_KERNEL_ROUTINE* PMLAS_QGEMM_KERNEL_ROUTINE;
+
+typedef
+void
+(MLASCALL MLAS_CONV_NCHWC_KERNEL_ROUTINE)(
+    const float* Input,
+    const float* Filter,
+    float* Output,
+    size_t StrideWidth,
+    size_t DilationWidth,
+    size_t InputChannelBlocks,
+    size_t InputBlockStride,
+    size_t InputRowStride,
+    size_t FilterBlockStride,
+    size_t FilterStride,
+    size_t OutputStride,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    size_t FilterCount,
+    size_t OutputCount
+    );
+
+typedef MLAS_CONV_NCHWC_KERNEL_ROUTINE* PMLAS_CONV_NCHWC_KERNEL_ROUTINE;
+
 extern "C" {
 
     MLAS_SGEMM_KERNEL_ROUTINE MlasSgemmKernelZero;
@@ -209,6 +269,36 @@ extern "C" {
 
 }
 
+#if defined(MLAS_TARGET_AMD64_IX86)
+MLAS_QGEMM_KERNEL_ROUTINE MlasQgemmKernelSse2;
+#else
+MLAS_QGEMM_KERNEL_ROUTINE MlasQgemmKernel;
+#endif
+#if defined(MLAS_TARGET_AMD64)
+MLAS_QGEMM_KERNEL_ROUTINE MlasQgemmKernelAvx2;
+#endif
+
+MLAS_CONV_NCHWC_KERNEL_ROUTINE MlasConvNchwcKernel;
+#if defined(MLAS_TARGET_AMD64)
+MLAS_CONV_NCHWC_KERNEL_ROUTINE MlasConvNchwcKernelFma3;
+#endif
+
+//
+// Define the number of channels in a block of the NCHWc tensor layout.
+//
+// A block is two 4-element vectors, or a single AVX vector.
+//
+
+#define MLAS_NCHWC_BLOCK_SIZE                       8
+
+//
+// Define the maximum number of blocks of output channels computed by a single
+// invocation of the NCHWc convolution kernel. The input elements loaded by
+// the kernel are reused across the set of filter blocks.
+//
+
+#define MLAS_NCHWC_FILTER_SET_SIZE                  3
+
 //
 // Define the target number of per-thread multiplies before using another
 // thread to perform additional work.
@@ -228,6 +318,17 @@ extern "C" {
 #endif
 #endif
 
+//
+// The QGEMM kernels complete more multiplies per cycle than the SGEMM kernels,
+// so each thread is given proportionally more work.
+//
+
+#if defined(MLAS_USE_OPENMP)
+#define MLAS_QGEMM_THREAD_COMPLEXITY                (64 * 1024)
+#else
+#define MLAS_QGEMM_THREAD_COMPLEXITY                (4 * 1024 * 1024)
+#endif
+
 //
 // Single-threaded single precision matrix/matrix multiply operation.
 //
@@ -260,6 +361,11 @@ struct MLAS_PLATFORM {
 #if defined(MLAS_TARGET_AMD64_IX86)
     PMLAS_SGEMM_KERNEL_ROUTINE KernelZeroRoutine;
     PMLAS_SGEMM_KERNEL_ROUTINE KernelAddRoutine;
+    PMLAS_QGEMM_KERNEL_ROUTINE QgemmKernelRoutine;
+#endif
+
+#if defined(MLAS_TARGET_AMD64)
+    PMLAS_CONV_NCHWC_KERNEL_ROUTINE ConvNchwcKernelRoutine;
 #endif
 
 #if defined(MLAS_TARGET_AMD64)
@@ -295,20 +401,19 @@ extern MLAS_PLATFORM MlasPlatform;
 // Threading support.
 //
 
-typedef
-void
-(MLAS_THREADED_ROUTINE)(
-    void* Context,
-    int32_t Index
-    );
-
 typedef MLAS_THREADED_ROUTINE* PMLAS_THREADED_ROUTINE;
 
 void
 MlasExecuteThreaded(
     PMLAS_THREADED_ROUTINE ThreadedRoutine,
     void* Context,
-    int32_t Iterations
+    int32_t Iterations,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+int32_t
+MlasGetMaximumThreadCount(
+    MLAS_THREADPOOL* ThreadPool
     );
 
 //
@@ -86,10 +86,12 @@ Return Value:
 
     this->KernelZeroRoutine = MlasSgemmKernelZeroSse;
     this->KernelAddRoutine = MlasSgemmKernelAddSse;
+    this->QgemmKernelRoutine = MlasQgemmKernelSse2;
 #if defined(MLAS_TARGET_AMD64)
     this->TransposePackB16x4Routine = MlasSgemmTransposePackB16x4Sse;
     this->LogisticKernelRoutine = MlasLogisticKernel;
     this->TanhKernelRoutine = MlasTanhKernel;
+    this->ConvNchwcKernelRoutine = MlasConvNchwcKernel;
 #endif
 
     //
@@ -144,6 +146,8 @@ Return Value:
 
                 this->LogisticKernelRoutine = MlasLogisticKernelFma3;
                 this->TanhKernelRoutine = MlasTanhKernelFma3;
+                this->QgemmKernelRoutine = MlasQgemmKernelAvx2;
+                this->ConvNchwcKernelRoutine = MlasConvNchwcKernelFma3;
 
             } else {
 
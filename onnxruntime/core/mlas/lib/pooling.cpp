@@ -46,6 +46,22 @@ void
 
 typedef MLAS_POOL_KERNEL_ROUTINE* PMLAS_POOL_KERNEL_ROUTINE;
 
+//
+// Define the parameters to partition the channels of a pooling operation
+// across worker threads.
+//
+
+struct MLAS_POOL_THREADED_WORK_BLOCK {
+    const MLAS_WORK_BLOCK* WorkBlock;
+    PMLAS_POOL_KERNEL_ROUTINE PoolKernelRoutine;
+    const float* Input;
+    float* Output;
+    size_t InputSize;
+    size_t OutputSize;
+    size_t TotalChannelCount;
+    int32_t TargetThreadCount;
+};
+
 //
 // Define the number of elements to allocate on the stack for the reduction
 // buffer in the vectorized kernels.
@@ -1171,6 +1187,62 @@ static const PMLAS_POOL_KERNEL_ROUTINE MlasPoolVectorKernels[][2] =
     },
 };
 
+void
+MlasPoolThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of the
+    channels of a pooling operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* ThreadedWorkBlock = (MLAS_POOL_THREADED_WORK_BLOCK*)Context;
+
+    const size_t TotalChannelCount = ThreadedWorkBlock->TotalChannelCount;
+    const size_t TargetThreadCount = size_t(ThreadedWorkBlock->TargetThreadCount);
+
+    //
+    // Compute the range of channels for this thread, spreading the remainder
+    // over the leading threads.
+    //
+
+    const size_t ChannelsPerThread = TotalChannelCount / TargetThreadCount;
+    const size_t ChannelsExtra = TotalChannelCount % TargetThreadCount;
+
+    size_t ChannelStart;
+    size_t ChannelCount = ChannelsPerThread;
+
+    if (size_t(Index) < ChannelsExtra) {
+        ChannelCount++;
+        ChannelStart = size_t(Index) * ChannelCount;
+    } else {
+        ChannelStart = size_t(Index) * ChannelsPerThread + ChannelsExtra;
+    }
+
+    if (ChannelCount == 0) {
+        return;
+    }
+
+    ThreadedWorkBlock->PoolKernelRoutine(ThreadedWorkBlock->WorkBlock, ChannelCount,
+        ThreadedWorkBlock->Input + ChannelStart * ThreadedWorkBlock->InputSize,
+        ThreadedWorkBlock->Output + ChannelStart * ThreadedWorkBlock->OutputSize);
+}
+
 void
 MLASCALL
 MlasPool(
@@ -1182,7 +1254,8 @@ MlasPool(
     const int64_t* StrideShape,
     const int64_t* OutputShape,
     const float* Input,
-    float* Output
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
     )
 /*++
 
@@ -1211,6 +1284,9 @@ Arguments:
 
     Output - Supplies the output tensor.
 
+    ThreadPool - Optionally supplies the thread pool to execute the pooling
+        operation. If nullptr, the platform threading model is used.
+
 Return Value:
 
     None.
@@ -1319,6 +1395,33 @@ Return Value:
     // Execute the pooling kernel routine.
     //
 
+    if (ThreadPool != nullptr) {
+
+        int32_t TargetThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+        if (size_t(TargetThreadCount) >= TotalChannelCount) {
+            TargetThreadCount = int32_t(TotalChannelCount);
+        }
+
+        if (TargetThreadCount > 1) {
+
+            MLAS_POOL_THREADED_WORK_BLOCK ThreadedWorkBlock;
+
+            ThreadedWorkBlock.WorkBlock = &WorkBlock;
+            ThreadedWorkBlock.PoolKernelRoutine = PoolKernelRoutine;
+            ThreadedWorkBlock.Input = Input;
+            ThreadedWorkBlock.Output = Output;
+            ThreadedWorkBlock.InputSize = InputSize;
+            ThreadedWorkBlock.OutputSize = OutputSize;
+            ThreadedWorkBlock.TotalChannelCount = TotalChannelCount;
+            ThreadedWorkBlock.TargetThreadCount = TargetThreadCount;
+
+            MlasExecuteThreaded(MlasPoolThreaded, &ThreadedWorkBlock, TargetThreadCount, ThreadPool);
+
+            return;
+        }
+    }
+
 #if defined(MLAS_USE_OPENMP)
 
     #pragma omp parallel for
@@ -0,0 +1,974 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    qgemm.cpp
+
+Abstract:
+
+    This module implements the quantized integer matrix/matrix multiply
+    operation (QGEMM) and the requantization of its output.
+
+    The zero point offsets of matrix A and matrix B are subtracted while the
+    matrices are packed into 16-bit buffers, so the kernels compute exact
+    products using 16-bit multiplies with 32-bit accumulation.
+
+--*/
+
+#include "mlasi.h"
+
+#include <algorithm>
+
+//
+// Define the parameters to execute segments of a QGEMM operation on worker
+// threads.
+//
+
+struct MLAS_QGEMM_WORK_BLOCK {
+    size_t K;
+    size_t lda;
+    size_t ldb;
+    size_t ldc;
+    int16_t offa;
+    int16_t offb;
+    struct SEGMENT {
+        size_t M;
+        size_t N;
+        const uint8_t* A;
+        const uint8_t* B;
+        int32_t* C;
+    } Segments[MLAS_MAXIMUM_THREAD_COUNT];
+};
+
+void
+MlasQgemmCopyPackA(
+    int16_t* D,
+    const uint8_t* A,
+    size_t lda,
+    size_t CountM,
+    size_t CountK,
+    int16_t offa
+    )
+/*++
+
+Routine Description:
+
+    This routine copies elements from the source matrix to the destination
+    packed buffer, subtracting the zero point offset of the matrix.
+
+    Each row of the packed buffer holds an even number of elements, so that
+    the kernels can load pairs of elements. An odd row is zero-padded.
+
+Arguments:
+
+    D - Supplies the address of the destination packed buffer.
+
+    A - Supplies the address of the source matrix.
+
+    lda - Supplies the number of elements per row of the source matrix.
+
+    CountM - Supplies the number of rows of the source matrix to copy.
+
+    CountK - Supplies the number of columns of the source matrix to copy.
+
+    offa - Supplies the zero point offset of the source matrix.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t PackedCountK = (CountK + 1) & ~size_t(1);
+
+    do {
+
+        const uint8_t* a = A;
+        int16_t* d = D;
+        size_t k = CountK;
+
+#if defined(MLAS_SSE2_INTRINSICS)
+
+        const __m128i ZeroVector = _mm_setzero_si128();
+        const __m128i OffsetVector = _mm_set1_epi16(offa);
+
+        while (k >= 16) {
+
+            __m128i Bytes = _mm_loadu_si128((const __m128i*)a);
+
+            _mm_storeu_si128((__m128i*)&d[0], _mm_sub_epi16(_mm_unpacklo_epi8(Bytes, ZeroVector), OffsetVector));
+            _mm_storeu_si128((__m128i*)&d[8], _mm_sub_epi16(_mm_unpackhi_epi8(Bytes, ZeroVector), OffsetVector));
+
+            a += 16;
+            d += 16;
+            k -= 16;
+        }
+
+#endif
+
+        while (k > 0) {
+            *d++ = int16_t(*a++) - offa;
+            k--;
+        }
+
+        if (PackedCountK != CountK) {
+            *d = 0;
+        }
+
+        A += lda;
+        D += PackedCountK;
+        CountM--;
+
+    } while (CountM > 0);
+}
+
+void
+MlasQgemmCopyPackB(
+    int16_t* D,
+    const uint8_t* B,
+    size_t ldb,
+    size_t CountN,
+    size_t CountK,
+    int16_t offb
+    )
+/*++
+
+Routine Description:
+
+    This routine copies elements from the source matrix to the destination
+    packed buffer, subtracting the zero point offset of the matrix.
+
+    Columns of 16 elements from the source matrix are unrolled to be physically
+    contiguous for better locality inside the QGEMM kernels. The elements of
+    each pair of rows are interleaved, so that a kernel multiplies a pair of
+    elements from matrix A by a pair of rows with one instruction. Any
+    remaining columns less than 16 elements wide and an odd row are
+    zero-padded.
+
+Arguments:
+
+    D - Supplies the address of the destination packed buffer.
+
+    B - Supplies the address of the source matrix.
+
+    ldb - Supplies the number of elements per row of the source matrix.
+
+    CountN - Supplies the number of columns of the source matrix to copy.
+
+    CountK - Supplies the number of rows of the source matrix to copy.
+
+    offb - Supplies the zero point offset of the source matrix.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (CountN > 0) {
+
+        const size_t CountX = std::min(CountN, size_t(16));
+        const uint8_t* b = B;
+        size_t k = CountK;
+
+        while (k > 0) {
+
+            const uint8_t* b0 = b;
+            const uint8_t* b1 = (k >= 2) ? b + ldb : nullptr;
+
+#if defined(MLAS_SSE2_INTRINSICS)
+
+            if (CountX == 16) {
+
+                const __m128i ZeroVector = _mm_setzero_si128();
+                const __m128i OffsetVector = _mm_set1_epi16(offb);
+
+                __m128i Row0 = _mm_loadu_si128((const __m128i*)b0);
+                __m128i Row0Low = _mm_sub_epi16(_mm_unpacklo_epi8(Row0, ZeroVector), OffsetVector);
+                __m128i Row0High = _mm_sub_epi16(_mm_unpackhi_epi8(Row0, ZeroVector), OffsetVector);
+
+                __m128i Row1Low = ZeroVector;
+                __m128i Row1High = ZeroVector;
+
+                if (b1 != nullptr) {
+                    __m128i Row1 = _mm_loadu_si128((const __m128i*)b1);
+                    Row1Low = _mm_sub_epi16(_mm_unpacklo_epi8(Row1, ZeroVector), OffsetVector);
+                    Row1High = _mm_sub_epi16(_mm_unpackhi_epi8(Row1, ZeroVector), OffsetVector);
+                }
+
+                _mm_store_si128((__m128i*)&D[0], _mm_unpacklo_epi16(Row0Low, Row1Low));
+                _mm_store_si128((__m128i*)&D[8], _mm_unpackhi_epi16(Row0Low, Row1Low));
+                _mm_store_si128((__m128i*)&D[16], _mm_unpacklo_epi16(Row0High, Row1High));
+                _mm_store_si128((__m128i*)&D[24], _mm_unpackhi_epi16(Row0High, Row1High));
+
+            } else
+
+#endif
+
+            {
+                for (size_t n = 0; n < 16; n++) {
+                    if (n < CountX) {
+                        D[n * 2] = int16_t(b0[n]) - offb;
+                        D[n * 2 + 1] = (b1 != nullptr) ? int16_t(b1[n]) - offb : 0;
+                    } else {
+                        D[n * 2] = 0;
+                        D[n * 2 + 1] = 0;
+                    }
+                }
+            }
+
+            D += 32;
+            b += ldb * 2;
+            k -= (k >= 2) ? 2 : 1;
+        }
+
+        B += CountX;
+        CountN -= CountX;
+    }
+}
+
+#if defined(MLAS_SSE2_INTRINSICS)
+
+inline
+void
+MlasQgemmMultiplyAccumulateSse2(
+    const int16_t* A,
+    const __m128i BElements[4],
+    __m128i Accumulators[4]
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies a pair of elements from a row of matrix A by a
+    pair of rows of 16 columns from matrix B and accumulates the products.
+
+Arguments:
+
+    A - Supplies the address of the pair of elements of matrix A.
+
+    BElements - Supplies the pairs of elements for the 16 columns of matrix B.
+
+    Accumulators - Supplies the accumulators for the 16 columns.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    int32_t APair;
+    memcpy(&APair, A, sizeof(APair));
+    __m128i ABroadcast = _mm_set1_epi32(APair);
+
+    Accumulators[0] = _mm_add_epi32(Accumulators[0], _mm_madd_epi16(ABroadcast, BElements[0]));
+    Accumulators[1] = _mm_add_epi32(Accumulators[1], _mm_madd_epi16(ABroadcast, BElements[1]));
+    Accumulators[2] = _mm_add_epi32(Accumulators[2], _mm_madd_epi16(ABroadcast, BElements[2]));
+    Accumulators[3] = _mm_add_epi32(Accumulators[3], _mm_madd_epi16(ABroadcast, BElements[3]));
+}
+
+inline
+void
+MlasQgemmStoreOutputSse2(
+    int32_t* C,
+    const __m128i Accumulators[4],
+    size_t CountN,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine stores or accumulates up to 16 columns of a row of the
+    output matrix.
+
+Arguments:
+
+    C - Supplies the address of the row of matrix C.
+
+    Accumulators - Supplies the accumulators for the 16 columns.
+
+    CountN - Supplies the number of columns to store.
+
+    ZeroMode - Supplies true if the output matrix is overwritten, else false
+        if the accumulators are added to the output matrix.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (CountN >= 16) {
+
+        for (size_t i = 0; i < 4; i++) {
+            __m128i Output = Accumulators[i];
+            if (!ZeroMode) {
+                Output = _mm_add_epi32(Output, _mm_loadu_si128((const __m128i*)&C[i * 4]));
+            }
+            _mm_storeu_si128((__m128i*)&C[i * 4], Output);
+        }
+
+    } else {
+
+        int32_t Buffer[16];
+
+        for (size_t i = 0; i < 4; i++) {
+            _mm_storeu_si128((__m128i*)&Buffer[i * 4], Accumulators[i]);
+        }
+
+        for (size_t n = 0; n < CountN; n++) {
+            C[n] = ZeroMode ? Buffer[n] : C[n] + Buffer[n];
+        }
+    }
+}
+
+template<size_t RowCount>
+void
+MlasQgemmKernelSse2Rows(
+    const int16_t* A,
+    const int16_t* B,
+    int32_t* C,
+    size_t PairCountK,
+    size_t CountN,
+    size_t lda,
+    size_t ldc,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine computes RowCount rows of the output matrix using SSE2
+    instructions.
+
+Arguments:
+
+    See MlasQgemmKernelSse2.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    static_assert(RowCount == 1 || RowCount == 2, "unsupported row count");
+
+    while (CountN > 0) {
+
+        __m128i Accumulators0[4];
+        __m128i Accumulators1[4];
+
+        for (size_t i = 0; i < 4; i++) {
+            Accumulators0[i] = _mm_setzero_si128();
+            Accumulators1[i] = _mm_setzero_si128();
+        }
+
+        const int16_t* a = A;
+        const int16_t* b = B;
+
+        for (size_t k = 0; k < PairCountK; k++) {
+
+            __m128i BElements[4];
+
+            for (size_t i = 0; i < 4; i++) {
+                BElements[i] = _mm_load_si128((const __m128i*)&b[i * 8]);
+            }
+
+            MlasQgemmMultiplyAccumulateSse2(a, BElements, Accumulators0);
+
+            if (RowCount >= 2) {
+                MlasQgemmMultiplyAccumulateSse2(a + lda, BElements, Accumulators1);
+            }
+
+            a += 2;
+            b += 32;
+        }
+
+        MlasQgemmStoreOutputSse2(C, Accumulators0, CountN, ZeroMode);
+
+        if (RowCount >= 2) {
+            MlasQgemmStoreOutputSse2(C + ldc, Accumulators1, CountN, ZeroMode);
+        }
+
+        if (CountN <= 16) {
+            break;
+        }
+
+        B += PairCountK * 32;
+        C += 16;
+        CountN -= 16;
+    }
+}
+
+size_t
+MLASCALL
+MlasQgemmKernelSse2(
+    const int16_t* A,
+    const int16_t* B,
+    int32_t* C,
+    size_t PairCountK,
+    size_t CountM,
+    size_t CountN,
+    size_t lda,
+    size_t ldc,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine is an inner kernel to compute matrix multiplication for a
+    set of rows using SSE2 instructions.
+
+Arguments:
+
+    A - Supplies the address of matrix A, packed by MlasQgemmCopyPackA.
+
+    B - Supplies the address of matrix B, packed by MlasQgemmCopyPackB.
+
+    C - Supplies the address of matrix C.
+
+    PairCountK - Supplies the number of pairs of columns from matrix A and
+        the number of pairs of rows from matrix B to iterate over.
+
+    CountM - Supplies the maximum number of rows that can be processed for
+        matrix A and matrix C. The actual number of rows handled for this
+        invocation depends on the kernel implementation.
+
+    CountN - Supplies the number of columns from matrix B and matrix C to
+        iterate over.
+
+    lda - Supplies the first dimension of the packed matrix A.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ZeroMode - Supplies true if the output matrix must be zero initialized,
+        else false if the output matrix is accumulated into.
+
+Return Value:
+
+    Returns the number of rows handled.
+
+--*/
+{
+    if (CountM >= 2) {
+        MlasQgemmKernelSse2Rows<2>(A, B, C, PairCountK, CountN, lda, ldc, ZeroMode);
+        return 2;
+    }
+
+    MlasQgemmKernelSse2Rows<1>(A, B, C, PairCountK, CountN, lda, ldc, ZeroMode);
+    return 1;
+}
+
+#else
+
+size_t
+MLASCALL
+MlasQgemmKernel(
+    const int16_t* A,
+    const int16_t* B,
+    int32_t* C,
+    size_t PairCountK,
+    size_t CountM,
+    size_t CountN,
+    size_t lda,
+    size_t ldc,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine is an inner kernel to compute matrix multiplication for a
+    single row using portable code.
+
+Arguments:
+
+    See MlasQgemmKernelSse2.
+
+Return Value:
+
+    Returns the number of rows handled.
+
+--*/
+{
+    MLAS_UNREFERENCED_PARAMETER(CountM);
+    MLAS_UNREFERENCED_PARAMETER(lda);
+    MLAS_UNREFERENCED_PARAMETER(ldc);
+
+    while (CountN > 0) {
+
+        int32_t Accumulators[16] = { 0 };
+
+        const int16_t* a = A;
+        const int16_t* b = B;
+
+        for (size_t k = 0; k < PairCountK; k++) {
+
+            for (size_t n = 0; n < 16; n++) {
+                Accumulators[n] += int32_t(a[0]) * b[n * 2] + int32_t(a[1]) * b[n * 2 + 1];
+            }
+
+            a += 2;
+            b += 32;
+        }
+
+        const size_t CountX = std::min(CountN, size_t(16));
+
+        for (size_t n = 0; n < CountX; n++) {
+            C[n] = ZeroMode ? Accumulators[n] : C[n] + Accumulators[n];
+        }
+
+        B += PairCountK * 32;
+        C += CountX;
+        CountN -= CountX;
+    }
+
+    return 1;
+}
+
+#endif
+
+void
+MlasQgemmOperation(
+    size_t M,
+    size_t N,
+    size_t K,
+    const uint8_t* A,
+    size_t lda,
+    int16_t offa,
+    const uint8_t* B,
+    size_t ldb,
+    int16_t offb,
+    int32_t* C,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the quantized integer matrix/matrix multiply
+    operation (QGEMM).
+
+Arguments:
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    offa - Supplies the zero point offset of matrix A.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    offb - Supplies the zero point offset of matrix B.
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_DECLSPEC_ALIGN(int16_t PanelA[MLAS_QGEMM_PACKA_ROWS * MLAS_QGEMM_STRIDEK], 64);
+    MLAS_DECLSPEC_ALIGN(int16_t PanelB[MLAS_QGEMM_STRIDEN * MLAS_QGEMM_STRIDEK], 64);
+
+    //
+    // Step through each slice of matrix B along the N dimension.
+    //
+
+    size_t CountN;
+    size_t CountK;
+    size_t CountM;
+
+    for (size_t n = 0; n < N; n += CountN) {
+
+        CountN = std::min(N - n, size_t(MLAS_QGEMM_STRIDEN));
+
+        //
+        // Step through each slice of matrix B along the K dimension.
+        //
+
+        for (size_t k = 0; k < K; k += CountK) {
+
+            CountK = std::min(K - k, size_t(MLAS_QGEMM_STRIDEK));
+
+            const size_t PairCountK = (CountK + 1) / 2;
+
+            MlasQgemmCopyPackB(PanelB, B + n + k * ldb, ldb, CountN, CountK, offb);
+
+            //
+            // Step through each slice of matrix A along the M dimension.
+            //
+
+            for (size_t m = 0; m < M; m += CountM) {
+
+                CountM = std::min(M - m, size_t(MLAS_QGEMM_PACKA_ROWS));
+
+                MlasQgemmCopyPackA(PanelA, A + k + m * lda, lda, CountM, CountK, offa);
+
+                const int16_t* pa = PanelA;
+                int32_t* c = C + n + m * ldc;
+                size_t RowsRemaining = CountM;
+
+                do {
+
+#if defined(MLAS_TARGET_AMD64_IX86)
+                    size_t RowsHandled = MlasPlatform.QgemmKernelRoutine(pa, PanelB, c, PairCountK,
+                        RowsRemaining, CountN, PairCountK * 2, ldc, k == 0);
+#else
+                    size_t RowsHandled = MlasQgemmKernel(pa, PanelB, c, PairCountK,
+                        RowsRemaining, CountN, PairCountK * 2, ldc, k == 0);
+#endif
+
+                    pa += PairCountK * 2 * RowsHandled;
+                    c += ldc * RowsHandled;
+                    RowsRemaining -= RowsHandled;
+
+                } while (RowsRemaining > 0);
+            }
+        }
+    }
+}
+
+void
+MlasQgemmOperationThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    QGEMM operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_QGEMM_WORK_BLOCK* WorkBlock = (MLAS_QGEMM_WORK_BLOCK*)Context;
+
+    MLAS_QGEMM_WORK_BLOCK::SEGMENT* Segment = &WorkBlock->Segments[Index];
+
+    MlasQgemmOperation(Segment->M, Segment->N, WorkBlock->K, Segment->A,
+        WorkBlock->lda, WorkBlock->offa, Segment->B, WorkBlock->ldb,
+        WorkBlock->offb, Segment->C, WorkBlock->ldc);
+}
+
+void
+MLASCALL
+MlasQgemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const uint8_t* A,
+    size_t lda,
+    uint8_t offa,
+    const uint8_t* B,
+    size_t ldb,
+    uint8_t offb,
+    int32_t* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the quantized integer matrix/matrix multiply
+    operation (QGEMM):
+
+        C[m][n] = sum over k of (A[m][k] - offa) * (B[k][n] - offb)
+
+Arguments:
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    offa - Supplies the zero point offset of matrix A.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    offb - Supplies the zero point offset of matrix B.
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ThreadPool - Optionally supplies the thread pool to execute the operation.
+        If nullptr, the platform threading model is used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (M == 0 || N == 0) {
+        return;
+    }
+
+    //
+    // The product of empty matrices is zero.
+    //
+
+    if (K == 0) {
+
+        for (size_t m = 0; m < M; m++) {
+            std::fill_n(C + m * ldc, N, 0);
+        }
+
+        return;
+    }
+
+    MLAS_QGEMM_WORK_BLOCK WorkBlock;
+    int32_t TargetThreadCount;
+
+    //
+    // Compute the number of target threads given the complexity of the QGEMM
+    // operation. Small requests should run using the single threaded path.
+    //
+
+    double Complexity = double(M) * double(N) * double(K);
+
+    if (Complexity < double(MLAS_QGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_QGEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    }
+
+    int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (TargetThreadCount == 1) {
+        MlasQgemmOperation(M, N, K, A, lda, offa, B, ldb, offb, C, ldc);
+        return;
+    }
+
+    //
+    // Initialize the common fields of the work block.
+    //
+
+    WorkBlock.K = K;
+    WorkBlock.lda = lda;
+    WorkBlock.ldb = ldb;
+    WorkBlock.ldc = ldc;
+    WorkBlock.offa = offa;
+    WorkBlock.offb = offb;
+
+    //
+    // Segment the operation across multiple threads.
+    //
+
+    int32_t Index = 0;
+
+    if (N > M) {
+
+        size_t StrideN = N / TargetThreadCount;
+
+        if ((StrideN * TargetThreadCount) != N) {
+            StrideN++;
+        }
+
+        StrideN = (StrideN + 15) & ~size_t(15);
+
+        for (size_t CountN, n = 0; n < N; n += CountN) {
+
+            CountN = std::min(N - n, StrideN);
+
+            WorkBlock.Segments[Index].M = M;
+            WorkBlock.Segments[Index].N = CountN;
+            WorkBlock.Segments[Index].A = A;
+            WorkBlock.Segments[Index].B = B + n;
+            WorkBlock.Segments[Index].C = C + n;
+
+            Index++;
+        }
+
+    } else {
+
+        size_t StrideM = M / TargetThreadCount;
+
+        if ((StrideM * TargetThreadCount) != M) {
+            StrideM++;
+        }
+
+        for (size_t CountM, m = 0; m < M; m += CountM) {
+
+            CountM = std::min(M - m, StrideM);
+
+            WorkBlock.Segments[Index].M = CountM;
+            WorkBlock.Segments[Index].N = N;
+            WorkBlock.Segments[Index].A = A + m * lda;
+            WorkBlock.Segments[Index].B = B;
+            WorkBlock.Segments[Index].C = C + m * ldc;
+
+            Index++;
+        }
+    }
+
+    MlasExecuteThreaded(MlasQgemmOperationThreaded, &WorkBlock, Index, ThreadPool);
+}
+
+inline
+int32_t
+MlasRequantizeValue(
+    int32_t Value,
+    int32_t Multiplier,
+    int32_t RightShift
+    )
+/*++
+
+Routine Description:
+
+    This routine scales a 32-bit value by a fixed point multiplier and a power
+    of two with rounding, matching the gemmlowp output stage that quantizes
+    down by a fixed point multiplier.
+
+Arguments:
+
+    Value - Supplies the value to scale.
+
+    Multiplier - Supplies the fixed point multiplier with 31 fractional bits.
+
+    RightShift - Supplies the number of bits to shift the product right by.
+        A negative value shifts the product left.
+
+Return Value:
+
+    Returns the scaled value.
+
+--*/
+{
+    //
+    // Compute the rounded high 32 bits of the doubled 64-bit product.
+    //
+
+    int32_t Product;
+
+    if (Value == Multiplier && Value == std::numeric_limits<int32_t>::min()) {
+        Product = std::numeric_limits<int32_t>::max();
+    } else {
+        int64_t Wide = int64_t(Value) * int64_t(Multiplier);
+        int64_t Nudge = (Wide >= 0) ? (int64_t(1) << 30) : (1 - (int64_t(1) << 30));
+        Product = int32_t((Wide + Nudge) / (int64_t(1) << 31));
+    }
+
+    if (RightShift <= 0) {
+        return int32_t(uint32_t(Product) << -RightShift);
+    }
+
+    //
+    // Divide by the power of two, rounding half away from zero.
+    //
+
+    const int32_t Mask = int32_t((int64_t(1) << RightShift) - 1);
+    const int32_t Remainder = Product & Mask;
+    const int32_t Threshold = (Mask >> 1) + ((Product < 0) ? 1 : 0);
+
+    return (Product >> RightShift) + ((Remainder > Threshold) ? 1 : 0);
+}
+
+void
+MLASCALL
+MlasRequantizeOutput(
+    const int32_t* Input,
+    uint8_t* Output,
+    const int32_t* Bias,
+    size_t M,
+    size_t N,
+    int32_t Multiplier,
+    int32_t RightShift,
+    uint8_t ZeroPoint
+    )
+/*++
+
+Routine Description:
+
+    This routine requantizes the 32-bit output of a QGEMM operation to 8-bit
+    values, as the output stages of gemmlowp do: the optional bias is added,
+    the sum is scaled by a fixed point multiplier and a power of two, offset by
+    the zero point and saturated to the range of an 8-bit unsigned value.
+
+Arguments:
+
+    Input - Supplies the address of the input matrix.
+
+    Output - Supplies the address of the output matrix.
+
+    Bias - Optionally supplies the address of the bias vector, with one value
+        per row of the input matrix.
+
+    M - Supplies the number of rows of the input and output matrices.
+
+    N - Supplies the number of columns of the input and output matrices.
+
+    Multiplier - Supplies the fixed point multiplier with 31 fractional bits.
+
+    RightShift - Supplies the number of bits to shift the scaled value right
+        by.
+
+    ZeroPoint - Supplies the zero point offset of the output matrix.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    for (size_t m = 0; m < M; m++) {
+
+        const int32_t RowBias = (Bias != nullptr) ? Bias[m] : 0;
+
+        for (size_t n = 0; n < N; n++) {
+
+            int32_t Value = MlasRequantizeValue(Input[n] + RowBias, Multiplier, RightShift) + ZeroPoint;
+
+            Value = std::max(Value, int32_t(0));
+            Value = std::min(Value, int32_t(255));
+
+            Output[n] = uint8_t(Value);
+        }
+
+        Input += N;
+        Output += N;
+    }
+}
@@ -0,0 +1,274 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    qgemm_kernel_avx2.cpp
+
+Abstract:
+
+    This module implements the kernel for the quantized integer matrix/matrix
+    multiply operation (QGEMM) using AVX2 instructions.
+
+    This module must be compiled with AVX2 code generation enabled.
+
+--*/
+
+#include "mlasi.h"
+
+inline
+void
+MlasQgemmMultiplyAccumulateAvx2(
+    const int16_t* A,
+    __m256i BElements0,
+    __m256i BElements1,
+    __m256i& Accumulator0,
+    __m256i& Accumulator1
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies a pair of elements from a row of matrix A by a
+    pair of rows of 16 columns from matrix B and accumulates the products.
+
+Arguments:
+
+    A - Supplies the address of the pair of elements of matrix A.
+
+    BElements0 - Supplies the pairs of elements for the first 8 columns of
+        matrix B.
+
+    BElements1 - Supplies the pairs of elements for the last 8 columns of
+        matrix B.
+
+    Accumulator0 - Supplies the accumulator for the first 8 columns.
+
+    Accumulator1 - Supplies the accumulator for the last 8 columns.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    int32_t APair;
+    memcpy(&APair, A, sizeof(APair));
+    __m256i ABroadcast = _mm256_set1_epi32(APair);
+
+    Accumulator0 = _mm256_add_epi32(Accumulator0, _mm256_madd_epi16(ABroadcast, BElements0));
+    Accumulator1 = _mm256_add_epi32(Accumulator1, _mm256_madd_epi16(ABroadcast, BElements1));
+}
+
+inline
+void
+MlasQgemmStoreOutputAvx2(
+    int32_t* C,
+    __m256i Accumulator0,
+    __m256i Accumulator1,
+    size_t CountN,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine stores or accumulates up to 16 columns of a row of the
+    output matrix.
+
+Arguments:
+
+    C - Supplies the address of the row of matrix C.
+
+    Accumulator0 - Supplies the accumulator for the first 8 columns.
+
+    Accumulator1 - Supplies the accumulator for the last 8 columns.
+
+    CountN - Supplies the number of columns to store.
+
+    ZeroMode - Supplies true if the output matrix is overwritten, else false
+        if the accumulators are added to the output matrix.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (CountN >= 16) {
+
+        if (!ZeroMode) {
+            Accumulator0 = _mm256_add_epi32(Accumulator0, _mm256_loadu_si256((const __m256i*)&C[0]));
+            Accumulator1 = _mm256_add_epi32(Accumulator1, _mm256_loadu_si256((const __m256i*)&C[8]));
+        }
+
+        _mm256_storeu_si256((__m256i*)&C[0], Accumulator0);
+        _mm256_storeu_si256((__m256i*)&C[8], Accumulator1);
+
+    } else {
+
+        int32_t Buffer[16];
+
+        _mm256_storeu_si256((__m256i*)&Buffer[0], Accumulator0);
+        _mm256_storeu_si256((__m256i*)&Buffer[8], Accumulator1);
+
+        for (size_t n = 0; n < CountN; n++) {
+            C[n] = ZeroMode ? Buffer[n] : C[n] + Buffer[n];
+        }
+    }
+}
+
+template<size_t RowCount>
+void
+MlasQgemmKernelAvx2Rows(
+    const int16_t* A,
+    const int16_t* B,
+    int32_t* C,
+    size_t PairCountK,
+    size_t CountN,
+    size_t lda,
+    size_t ldc,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine computes RowCount rows of the output matrix using AVX2
+    instructions. The accumulators for each row are named explicitly so that
+    they stay in registers.
+
+Arguments:
+
+    See MlasQgemmKernelAvx2.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    static_assert(RowCount == 1 || RowCount == 2 || RowCount == 4, "unsupported row count");
+
+    while (CountN > 0) {
+
+        __m256i Accumulator00 = _mm256_setzero_si256();
+        __m256i Accumulator01 = _mm256_setzero_si256();
+        __m256i Accumulator10 = _mm256_setzero_si256();
+        __m256i Accumulator11 = _mm256_setzero_si256();
+        __m256i Accumulator20 = _mm256_setzero_si256();
+        __m256i Accumulator21 = _mm256_setzero_si256();
+        __m256i Accumulator30 = _mm256_setzero_si256();
+        __m256i Accumulator31 = _mm256_setzero_si256();
+
+        const int16_t* a = A;
+        const int16_t* b = B;
+
+        for (size_t k = 0; k < PairCountK; k++) {
+
+            __m256i BElements0 = _mm256_load_si256((const __m256i*)&b[0]);
+            __m256i BElements1 = _mm256_load_si256((const __m256i*)&b[16]);
+
+            MlasQgemmMultiplyAccumulateAvx2(a, BElements0, BElements1, Accumulator00, Accumulator01);
+
+            if (RowCount >= 2) {
+                MlasQgemmMultiplyAccumulateAvx2(a + lda, BElements0, BElements1, Accumulator10, Accumulator11);
+            }
+
+            if (RowCount >= 4) {
+                MlasQgemmMultiplyAccumulateAvx2(a + lda * 2, BElements0, BElements1, Accumulator20, Accumulator21);
+                MlasQgemmMultiplyAccumulateAvx2(a + lda * 3, BElements0, BElements1, Accumulator30, Accumulator31);
+            }
+
+            a += 2;
+            b += 32;
+        }
+
+        MlasQgemmStoreOutputAvx2(C, Accumulator00, Accumulator01, CountN, ZeroMode);
+
+        if (RowCount >= 2) {
+            MlasQgemmStoreOutputAvx2(C + ldc, Accumulator10, Accumulator11, CountN, ZeroMode);
+        }
+
+        if (RowCount >= 4) {
+            MlasQgemmStoreOutputAvx2(C + ldc * 2, Accumulator20, Accumulator21, CountN, ZeroMode);
+            MlasQgemmStoreOutputAvx2(C + ldc * 3, Accumulator30, Accumulator31, CountN, ZeroMode);
+        }
+
+        if (CountN <= 16) {
+            break;
+        }
+
+        B += PairCountK * 32;
+        C += 16;
+        CountN -= 16;
+    }
+}
+
+size_t
+MLASCALL
+MlasQgemmKernelAvx2(
+    const int16_t* A,
+    const int16_t* B,
+    int32_t* C,
+    size_t PairCountK,
+    size_t CountM,
+    size_t CountN,
+    size_t lda,
+    size_t ldc,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine is an inner kernel to compute matrix multiplication for a
+    set of rows using AVX2 instructions.
+
+Arguments:
+
+    A - Supplies the address of matrix A, packed by MlasQgemmCopyPackA.
+
+    B - Supplies the address of matrix B, packed by MlasQgemmCopyPackB.
+
+    C - Supplies the address of matrix C.
+
+    PairCountK - Supplies the number of pairs of columns from matrix A and
+        the number of pairs of rows from matrix B to iterate over.
+
+    CountM - Supplies the maximum number of rows that can be processed for
+        matrix A and matrix C. The actual number of rows handled for this
+        invocation depends on the kernel implementation.
+
+    CountN - Supplies the number of columns from matrix B and matrix C to
+        iterate over.
+
+    lda - Supplies the first dimension of the packed matrix A.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ZeroMode - Supplies true if the output matrix must be zero initialized,
+        else false if the output matrix is accumulated into.
+
+Return Value:
+
+    Returns the number of rows handled.
+
+--*/
+{
+    if (CountM >= 4) {
+        MlasQgemmKernelAvx2Rows<4>(A, B, C, PairCountK, CountN, lda, ldc, ZeroMode);
+        return 4;
+    }
+
+    if (CountM >= 2) {
+        MlasQgemmKernelAvx2Rows<2>(A, B, C, PairCountK, CountN, lda, ldc, ZeroMode);
+        return 2;
+    }
+
+    MlasQgemmKernelAvx2Rows<1>(A, B, C, PairCountK, CountN, lda, ldc, ZeroMode);
+    return 1;
+}
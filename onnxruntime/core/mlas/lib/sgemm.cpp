@@ -34,15 +34,18 @@ Abstract:
 struct MLAS_SGEMM_WORK_BLOCK {
     CBLAS_TRANSPOSE TransA;
     CBLAS_TRANSPOSE TransB;
+    size_t N;
     size_t K;
     size_t lda;
     size_t ldb;
     size_t ldc;
     float alpha;
     float beta;
+    const float* PackedB;
     struct SEGMENT {
         size_t M;
         size_t N;
+        size_t StartN;
         const float* A;
         const float* B;
         float* C;
@@ -772,6 +775,158 @@ Return Value:
     }
 }
 
+void
+MlasSgemmMultiplyPanelB(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t CountN,
+    size_t CountK,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* PanelB,
+    float* C,
+    size_t ldc,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies a slice of matrix A by a packed panel of matrix B
+    and stores or accumulates the product into the output matrix.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    CountN - Supplies the number of columns of the packed panel and of matrix
+        C.
+
+    CountK - Supplies the number of rows of the packed panel and the number of
+        columns of the slice of matrix A.
+
+    alpha - Supplies the scaler alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of the slice of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PanelB - Supplies the address of the packed panel of matrix B.
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ZeroMode - Supplies true if the product is stored to the output matrix,
+        else false if the product is accumulated into the output matrix.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    float PanelA[MLAS_SGEMM_TRANSA_ROWS * MLAS_SGEMM_STRIDEK];
+
+    //
+    // Select the kernel routine to use for this panel.
+    //
+
+#if defined(MLAS_TARGET_AMD64_IX86)
+    PMLAS_SGEMM_KERNEL_ROUTINE SgemmKernelRoutine =
+        ZeroMode ? MlasPlatform.KernelZeroRoutine : MlasPlatform.KernelAddRoutine;
+#endif
+
+    //
+    // Step through each slice of matrix A along the M dimension.
+    //
+
+    float* c = C;
+
+    size_t RowsRemaining = M;
+    size_t RowsHandled;
+
+    if (TransA == CblasNoTrans) {
+
+        const float* a = A;
+
+        //
+        // Step through the rows of matrix A.
+        //
+
+        do {
+
+#if defined(MLAS_TARGET_AMD64_IX86)
+            RowsHandled = SgemmKernelRoutine(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha);
+#else
+            if (ZeroMode) {
+                RowsHandled = MlasSgemmKernelZero(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha);
+            } else {
+                RowsHandled = MlasSgemmKernelAdd(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha);
+            }
+#endif
+
+            c += ldc * RowsHandled;
+            a += lda * RowsHandled;
+
+            RowsRemaining -= RowsHandled;
+
+        } while (RowsRemaining > 0);
+
+    } else {
+
+        const float* a = A;
+
+        do {
+
+            //
+            // Transpose elements from matrix A into a local buffer.
+            //
+
+            size_t RowsTransposed = RowsRemaining;
+
+            if (RowsTransposed > MLAS_SGEMM_TRANSA_ROWS) {
+                RowsTransposed = MLAS_SGEMM_TRANSA_ROWS;
+            }
+
+            RowsRemaining -= RowsTransposed;
+
+            MlasSgemmTransposeA(PanelA, a, lda, RowsTransposed, CountK);
+
+            a += RowsTransposed;
+
+            //
+            // Step through the rows of the local buffer.
+            //
+
+            const float* pa = PanelA;
+
+            do {
+
+#if defined(MLAS_TARGET_AMD64_IX86)
+                RowsHandled = SgemmKernelRoutine(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha);
+#else
+                if (ZeroMode) {
+                    RowsHandled = MlasSgemmKernelZero(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha);
+                } else {
+                    RowsHandled = MlasSgemmKernelAdd(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha);
+                }
+#endif
+
+                c += ldc * RowsHandled;
+                pa += CountK * RowsHandled;
+
+                RowsTransposed -= RowsHandled;
+
+            } while (RowsTransposed > 0);
+
+        } while (RowsRemaining > 0);
+    }
+}
+
 void
 MlasSgemmOperation(
     CBLAS_TRANSPOSE TransA,
@@ -830,7 +985,6 @@ Return Value:
 
 --*/
 {
-    float PanelA[MLAS_SGEMM_TRANSA_ROWS * MLAS_SGEMM_STRIDEK];
     MLAS_DECLSPEC_ALIGN(float PanelB[MLAS_SGEMM_STRIDEN * MLAS_SGEMM_STRIDEK], 16 * sizeof(float));
 
     //
@@ -932,101 +1086,123 @@ Return Value:
             }
 
             //
-            // Select the kernel routine to use for this panel.
+            // Multiply the slice of matrix A by the panel of matrix B.
             //
 
-            bool UseKernelZeroRoutine = (k == 0 && beta == 0.0f);
+            MlasSgemmMultiplyPanelB(TransA, M, CountN, CountK, alpha,
+                (TransA == CblasNoTrans) ? A + k : A + k * lda, lda, PanelB,
+                C + n, ldc, k == 0 && beta == 0.0f);
+        }
+    }
+}
 
-#if defined(MLAS_TARGET_AMD64_IX86)
-            PMLAS_SGEMM_KERNEL_ROUTINE SgemmKernelRoutine =
-                UseKernelZeroRoutine ? MlasPlatform.KernelZeroRoutine : MlasPlatform.KernelAddRoutine;
-#endif
+void
+MlasSgemmPackedOperation(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t StartN,
+    size_t CountN,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* PackedB,
+    float beta,
+    float* C,
+    size_t ldc
+    )
+/*++
 
-            //
-            // Step through each slice of matrix A along the M dimension.
-            //
+Routine Description:
 
-            float* c = C + n;
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) for a range of columns of a packed matrix B.
 
-            size_t RowsRemaining = M;
-            size_t RowsHandled;
+    Matrix B was packed by MlasSgemmPackB in slices of MLAS_SGEMM_STRIDEK rows.
+    Each slice holds the columns of matrix B in packed panels of 16 columns, so
+    the panel for any column that is a multiple of 16 is directly addressable.
+
+Arguments:
 
-            if (TransA == CblasNoTrans) {
+    TransA - Supplies the transpose operation for matrix A.
 
-                const float* a = A + k;
+    M - Supplies the number of rows of matrix A and matrix C.
 
-                //
-                // Step through the rows of matrix A.
-                //
+    StartN - Supplies the first column of the packed matrix B to multiply. The
+        value must be a multiple of 16.
 
-                do {
+    CountN - Supplies the number of columns of the packed matrix B to multiply
+        and the number of columns of matrix C.
 
-#if defined(MLAS_TARGET_AMD64_IX86)
-                    RowsHandled = SgemmKernelRoutine(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha);
-#else
-                    if (UseKernelZeroRoutine) {
-                        RowsHandled = MlasSgemmKernelZero(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha);
-                    } else {
-                        RowsHandled = MlasSgemmKernelAdd(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha);
-                    }
-#endif
+    N - Supplies the number of columns of the packed matrix B.
 
-                    c += ldc * RowsHandled;
-                    a += lda * RowsHandled;
+    K - Supplies the number of columns of matrix A and the number of rows of
+        the packed matrix B.
 
-                    RowsRemaining -= RowsHandled;
+    alpha - Supplies the scaler alpha multiplier (see SGEMM definition).
 
-                } while (RowsRemaining > 0);
+    A - Supplies the address of matrix A.
 
-            } else {
+    lda - Supplies the first dimension of matrix A.
 
-                const float* a = A + k * lda;
+    PackedB - Supplies the address of the aligned packed matrix B.
 
-                do {
+    beta - Supplies the scaler beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of matrix C, starting at column StartN.
 
-                    //
-                    // Transpose elements from matrix A into a local buffer.
-                    //
+    ldc - Supplies the first dimension of matrix C.
+
+Return Value:
 
-                    size_t RowsTransposed = RowsRemaining;
+    None.
 
-                    if (RowsTransposed > MLAS_SGEMM_TRANSA_ROWS) {
-                        RowsTransposed = MLAS_SGEMM_TRANSA_ROWS;
-                    }
+--*/
+{
+    const size_t AlignedN = (N + 15) & ~size_t(15);
 
-                    RowsRemaining -= RowsTransposed;
+    //
+    // Step through each slice of matrix B along the N dimension.
+    //
 
-                    MlasSgemmTransposeA(PanelA, a, lda, RowsTransposed, CountK);
+    size_t StrideN;
+    size_t CountK;
 
-                    a += RowsTransposed;
+    for (size_t n = 0; n < CountN; n += StrideN) {
 
-                    //
-                    // Step through the rows of the local buffer.
-                    //
+        StrideN = MLAS_SGEMM_STRIDEN;
 
-                    const float* pa = PanelA;
+        if (StrideN > (CountN - n)) {
+            StrideN = CountN - n;
+        }
 
-                    do {
+        //
+        // Multiply the output matrix by beta as needed.
+        //
 
-#if defined(MLAS_TARGET_AMD64_IX86)
-                        RowsHandled = SgemmKernelRoutine(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha);
-#else
-                        if (UseKernelZeroRoutine) {
-                            RowsHandled = MlasSgemmKernelZero(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha);
-                        } else {
-                            RowsHandled = MlasSgemmKernelAdd(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha);
-                        }
-#endif
+        if (beta != 0.0f && beta != 1.0f) {
+            MlasSgemmMultiplyBeta(C + n, M, StrideN, ldc, beta);
+        }
 
-                        c += ldc * RowsHandled;
-                        pa += CountK * RowsHandled;
+        //
+        // Step through each slice of matrix B along the K dimension. The K
+        // stride must match the stride used to pack matrix B.
+        //
 
-                        RowsTransposed -= RowsHandled;
+        for (size_t k = 0; k < K; k += CountK) {
 
-                    } while (RowsTransposed > 0);
+            CountK = MLAS_SGEMM_STRIDEK;
 
-                } while (RowsRemaining > 0);
+            if (CountK > (K - k)) {
+                CountK = K - k;
             }
+
+            const float* PanelB = PackedB + k * AlignedN + (StartN + n) * CountK;
+
+            MlasSgemmMultiplyPanelB(TransA, M, StrideN, CountK, alpha,
+                (TransA == CblasNoTrans) ? A + k : A + k * lda, lda, PanelB,
+                C + n, ldc, k == 0 && beta == 0.0f);
         }
     }
 }
@@ -1059,6 +1235,14 @@ Return Value:
 
     MLAS_SGEMM_WORK_BLOCK::SEGMENT* Segment = &WorkBlock->Segments[Index];
 
+    if (WorkBlock->PackedB != nullptr) {
+        MlasSgemmPackedOperation(WorkBlock->TransA, Segment->M, Segment->StartN,
+            Segment->N, WorkBlock->N, WorkBlock->K, WorkBlock->alpha, Segment->A,
+            WorkBlock->lda, WorkBlock->PackedB, WorkBlock->beta, Segment->C,
+            WorkBlock->ldc);
+        return;
+    }
+
     MlasSgemmOperation(WorkBlock->TransA, WorkBlock->TransB, Segment->M,
         Segment->N, WorkBlock->K, WorkBlock->alpha, Segment->A, WorkBlock->lda,
         Segment->B, WorkBlock->ldb, WorkBlock->beta, Segment->C,
@@ -1080,7 +1264,9 @@ MlasSgemmTryMultithread(
     size_t ldb,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    bool PackedB,
+    MLAS_THREADPOOL* ThreadPool
     )
 /*++
 
@@ -1118,6 +1304,12 @@ Arguments:
 
     ldc - Supplies the first dimension of matrix C.
 
+    PackedB - Supplies true if matrix B was packed by MlasSgemmPackB, in which
+        case TransB and ldb are ignored.
+
+    ThreadPool - Optionally supplies the thread pool to execute the operation.
+        If nullptr, the platform threading model is used.
+
 Return Value:
 
     Returns true if the operation was completed across multiple threads, else
@@ -1144,7 +1336,7 @@ Return Value:
         TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
     }
 
-    int32_t MaximumThreadCount = MlasPlatform.GetMaximumThreadCount();
+    int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
 
     if (TargetThreadCount >= MaximumThreadCount) {
         TargetThreadCount = MaximumThreadCount;
@@ -1160,12 +1352,14 @@ Return Value:
 
     WorkBlock.TransA = TransA;
     WorkBlock.TransB = TransB;
+    WorkBlock.N = N;
     WorkBlock.K = K;
     WorkBlock.lda = lda;
     WorkBlock.ldb = ldb;
     WorkBlock.ldc = ldc;
     WorkBlock.alpha = alpha;
     WorkBlock.beta = beta;
+    WorkBlock.PackedB = PackedB ? B : nullptr;
 
     //
     // Segment the operation across multiple threads.
@@ -1196,6 +1390,7 @@ Return Value:
 
             WorkBlock.Segments[Index].M = M;
             WorkBlock.Segments[Index].N = CountN;
+            WorkBlock.Segments[Index].StartN = n;
             WorkBlock.Segments[Index].A = A;
             WorkBlock.Segments[Index].B = B + n * pldb;
             WorkBlock.Segments[Index].C = C + n;
@@ -1223,6 +1418,7 @@ Return Value:
 
             WorkBlock.Segments[Index].M = CountM;
             WorkBlock.Segments[Index].N = N;
+            WorkBlock.Segments[Index].StartN = 0;
             WorkBlock.Segments[Index].A = A + m * plda;
             WorkBlock.Segments[Index].B = B;
             WorkBlock.Segments[Index].C = C + m * ldc;
@@ -1231,7 +1427,7 @@ Return Value:
         }
     }
 
-    MlasExecuteThreaded(MlasSgemmOperationThreaded, &WorkBlock, Index);
+    MlasExecuteThreaded(MlasSgemmOperationThreaded, &WorkBlock, Index, ThreadPool);
 
     return true;
 
@@ -1254,6 +1450,8 @@ Return Value:
     MLAS_UNREFERENCED_PARAMETER(beta);
     MLAS_UNREFERENCED_PARAMETER(C);
     MLAS_UNREFERENCED_PARAMETER(ldc);
+    MLAS_UNREFERENCED_PARAMETER(PackedB);
+    MLAS_UNREFERENCED_PARAMETER(ThreadPool);
 
     return false;
 
@@ -1276,7 +1474,8 @@ MlasSgemm(
     size_t ldb,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
     )
 /*++
 
@@ -1314,6 +1513,9 @@ Arguments:
 
     ldc - Supplies the first dimension of matrix C.
 
+    ThreadPool - Optionally supplies the thread pool to execute the operation.
+        If nullptr, the platform threading model is used.
+
 Return Value:
 
     None.
@@ -1325,7 +1527,208 @@ Return Value:
     // single thread based on the GEMM parameters and system configuration.
     //
 
-    if (!MlasSgemmTryMultithread(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc)) {
+    if (!MlasSgemmTryMultithread(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc, false, ThreadPool)) {
         MlasSgemmOperation(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
     }
 }
+
+size_t
+MLASCALL
+MlasSgemmPackBSize(
+    size_t N,
+    size_t K
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the size of the buffer needed to pack matrix B with
+    MlasSgemmPackB.
+
+Arguments:
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+Return Value:
+
+    Returns the size in bytes of the packed buffer. The size includes padding
+    to align the packed data inside the buffer.
+
+--*/
+{
+    const size_t AlignedN = (N + 15) & ~size_t(15);
+
+    return AlignedN * K * sizeof(float) + MLAS_SGEMM_PACKED_B_ALIGNMENT - 1;
+}
+
+inline
+float*
+MlasSgemmAlignPackedB(
+    void* PackedB
+    )
+/*++
+
+Routine Description:
+
+    This routine aligns the address of a buffer for a packed matrix B.
+
+    N.B. The packed data starts at an offset from the buffer that depends on
+    the address of the buffer, so a packed buffer cannot be moved.
+
+Arguments:
+
+    PackedB - Supplies the address of the buffer.
+
+Return Value:
+
+    Returns the aligned address of the packed data.
+
+--*/
+{
+    uintptr_t Address = reinterpret_cast<uintptr_t>(PackedB);
+
+    Address = (Address + MLAS_SGEMM_PACKED_B_ALIGNMENT - 1) & ~uintptr_t(MLAS_SGEMM_PACKED_B_ALIGNMENT - 1);
+
+    return reinterpret_cast<float*>(Address);
+}
+
+void
+MLASCALL
+MlasSgemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    )
+/*++
+
+Routine Description:
+
+    This routine packs matrix B into the layout used by the SGEMM kernels, so
+    that a matrix B used by many SGEMM operations is packed once.
+
+    Matrix B is packed in slices of MLAS_SGEMM_STRIDEK rows. Each slice holds
+    all of the columns of matrix B, unrolled in panels of 16 columns that are
+    zero-padded as needed.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    PackedB - Supplies the address of the buffer to receive the packed matrix
+        B. The buffer must be at least MlasSgemmPackBSize bytes.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t AlignedN = (N + 15) & ~size_t(15);
+
+    float* D = MlasSgemmAlignPackedB(PackedB);
+
+    if (N == 0) {
+        return;
+    }
+
+    size_t CountK;
+
+    for (size_t k = 0; k < K; k += CountK) {
+
+        CountK = MLAS_SGEMM_STRIDEK;
+
+        if (CountK > (K - k)) {
+            CountK = K - k;
+        }
+
+        if (TransB == CblasNoTrans) {
+            MlasSgemmCopyPackB(D, B + k * ldb, ldb, N, CountK);
+        } else {
+            MlasSgemmTransposePackB(D, B + k, ldb, N, CountK);
+        }
+
+        D += AlignedN * CountK;
+    }
+}
+
+void
+MLASCALL
+MlasSgemm(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float beta,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) with a matrix B packed by MlasSgemmPackB.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scaler alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PackedB - Supplies the address of the buffer holding the packed matrix B.
+
+    beta - Supplies the scaler beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ThreadPool - Optionally supplies the thread pool to execute the operation.
+        If nullptr, the platform threading model is used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const float* B = MlasSgemmAlignPackedB(const_cast<void*>(PackedB));
+
+    //
+    // Try to run the operation across multiple threads or fall back to a
+    // single thread based on the GEMM parameters and system configuration.
+    //
+
+    if (!MlasSgemmTryMultithread(TransA, CblasNoTrans, M, N, K, alpha, A, lda, B, 0, beta, C, ldc, true, ThreadPool)) {
+        MlasSgemmPackedOperation(TransA, M, 0, N, N, K, alpha, A, lda, B, beta, C, ldc);
+    }
+}
@@ -0,0 +1,1375 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    snchwc.cpp
+
+Abstract:
+
+    This module implements the single precision operations using the NCHWc
+    blocking format.
+
+    An NCHWc tensor stores the channels in blocks of MLAS_NCHWC_BLOCK_SIZE:
+    the tensor is laid out as [N][C/Block][H][W][Block], with the final
+    channel block padded with zeros. The block of channels for a single
+    spatial position is a contiguous vector, so the convolution and pooling
+    kernels operate directly on whole vectors without expanding the input.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the parameters to execute segments of a NCHWc convolution operation
+// on worker threads.
+//
+
+struct MLAS_NCHWC_CONV_WORK_BLOCK {
+    const float* Input;
+    const float* Filter;
+    const float* Bias;
+    float* Output;
+    const MLAS_ACTIVATION* Activation;
+    size_t BatchCount;
+    size_t InputChannelBlocks;
+    size_t OutputChannelBlocks;
+    size_t InputShape[2];
+    size_t KernelShape[2];
+    size_t DilationShape[2];
+    size_t Padding[4];
+    size_t StrideShape[2];
+    size_t OutputShape[2];
+    bool Depthwise;
+    int32_t TargetThreadCount;
+};
+
+//
+// Define the parameters to execute segments of a NCHWc pooling operation on
+// worker threads.
+//
+
+struct MLAS_NCHWC_POOL_WORK_BLOCK {
+    MLAS_POOLING_KIND PoolingKind;
+    const float* Input;
+    float* Output;
+    size_t ChannelBlockCount;
+    size_t InputShape[2];
+    size_t KernelShape[2];
+    size_t Padding[4];
+    size_t StrideShape[2];
+    size_t OutputShape[2];
+    int32_t TargetThreadCount;
+};
+
+size_t
+MLASCALL
+MlasNchwcGetBlockSize(
+    void
+    )
+/*++
+
+Routine Description:
+
+    This routine returns the number of channels in a block of the NCHWc
+    tensor layout.
+
+Arguments:
+
+    None.
+
+Return Value:
+
+    Returns the NCHWc block size.
+
+--*/
+{
+    return MLAS_NCHWC_BLOCK_SIZE;
+}
+
+void
+MLASCALL
+MlasReorderInput(
+    const int64_t* InputShape,
+    const float* S,
+    float* D
+    )
+/*++
+
+Routine Description:
+
+    This routine reorders an input tensor from the NCHW format to the NCHWc
+    format.
+
+Arguments:
+
+    InputShape - Supplies the NCHW shape of the input tensor.
+
+    S - Supplies the address of the source tensor.
+
+    D - Supplies the address of the destination tensor. The channel count is
+        rounded up to a multiple of the block size.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t BlockSize = MLAS_NCHWC_BLOCK_SIZE;
+
+    const size_t BatchCount = size_t(InputShape[0]);
+    const size_t InputChannels = size_t(InputShape[1]);
+    const size_t InputSize = size_t(InputShape[2]) * size_t(InputShape[3]);
+
+    for (size_t batch = 0; batch < BatchCount; batch++) {
+
+        for (size_t c = 0; c < InputChannels; c += BlockSize) {
+
+            const size_t ChannelCount = (std::min)(InputChannels - c, BlockSize);
+
+            for (size_t i = 0; i < InputSize; i++) {
+
+                for (size_t bc = 0; bc < ChannelCount; bc++) {
+                    D[bc] = S[bc * InputSize + i];
+                }
+
+                for (size_t bc = ChannelCount; bc < BlockSize; bc++) {
+                    D[bc] = 0.0f;
+                }
+
+                D += BlockSize;
+            }
+
+            S += ChannelCount * InputSize;
+        }
+    }
+}
+
+void
+MLASCALL
+MlasReorderOutput(
+    const int64_t* OutputShape,
+    const float* S,
+    float* D
+    )
+/*++
+
+Routine Description:
+
+    This routine reorders an output tensor from the NCHWc format to the NCHW
+    format.
+
+Arguments:
+
+    OutputShape - Supplies the NCHW shape of the output tensor.
+
+    S - Supplies the address of the source tensor.
+
+    D - Supplies the address of the destination tensor.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t BlockSize = MLAS_NCHWC_BLOCK_SIZE;
+
+    const size_t BatchCount = size_t(OutputShape[0]);
+    const size_t OutputChannels = size_t(OutputShape[1]);
+    const size_t OutputSize = size_t(OutputShape[2]) * size_t(OutputShape[3]);
+
+    for (size_t batch = 0; batch < BatchCount; batch++) {
+
+        for (size_t c = 0; c < OutputChannels; c += BlockSize) {
+
+            const size_t ChannelCount = (std::min)(OutputChannels - c, BlockSize);
+
+            for (size_t i = 0; i < OutputSize; i++) {
+
+                for (size_t bc = 0; bc < ChannelCount; bc++) {
+                    D[bc * OutputSize + i] = S[bc];
+                }
+
+                S += BlockSize;
+            }
+
+            D += ChannelCount * OutputSize;
+        }
+    }
+}
+
+void
+MLASCALL
+MlasReorderFilterOIHWBiBo(
+    const int64_t* FilterShape,
+    const float* S,
+    float* D
+    )
+/*++
+
+Routine Description:
+
+    This routine reorders a filter from the OIHW format to the format used
+    by MlasNchwcConv for a convolution with a single group. Both the output
+    and input channels are blocked: the filter is laid out as
+    [O/Block][I/Block][H][W][BlockI][BlockO].
+
+Arguments:
+
+    FilterShape - Supplies the OIHW shape of the filter.
+
+    S - Supplies the address of the source filter.
+
+    D - Supplies the address of the destination filter. The output and input
+        channel counts are rounded up to a multiple of the block size.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t BlockSize = MLAS_NCHWC_BLOCK_SIZE;
+
+    const size_t OutputChannels = size_t(FilterShape[0]);
+    const size_t InputChannels = size_t(FilterShape[1]);
+    const size_t KernelSize = size_t(FilterShape[2]) * size_t(FilterShape[3]);
+
+    for (size_t o = 0; o < OutputChannels; o += BlockSize) {
+
+        const size_t OutputCount = (std::min)(OutputChannels - o, BlockSize);
+
+        for (size_t i = 0; i < InputChannels; i += BlockSize) {
+
+            const size_t InputCount = (std::min)(InputChannels - i, BlockSize);
+
+            for (size_t k = 0; k < KernelSize; k++) {
+
+                for (size_t bi = 0; bi < BlockSize; bi++) {
+
+                    for (size_t bo = 0; bo < BlockSize; bo++) {
+
+                        if (bi < InputCount && bo < OutputCount) {
+                            D[bo] = S[((o + bo) * InputChannels + (i + bi)) * KernelSize + k];
+                        } else {
+                            D[bo] = 0.0f;
+                        }
+                    }
+
+                    D += BlockSize;
+                }
+            }
+        }
+    }
+}
+
+void
+MLASCALL
+MlasReorderFilterOIHWBo(
+    const int64_t* FilterShape,
+    const float* S,
+    float* D
+    )
+/*++
+
+Routine Description:
+
+    This routine reorders a filter from the OIHW format to the format used
+    by MlasNchwcConv for a depthwise convolution. The output channels are
+    blocked: the filter is laid out as [O/Block][I][H][W][BlockO].
+
+Arguments:
+
+    FilterShape - Supplies the OIHW shape of the filter.
+
+    S - Supplies the address of the source filter.
+
+    D - Supplies the address of the destination filter. The output channel
+        count is rounded up to a multiple of the block size.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t BlockSize = MLAS_NCHWC_BLOCK_SIZE;
+
+    const size_t OutputChannels = size_t(FilterShape[0]);
+    const size_t InputSize = size_t(FilterShape[1]) * size_t(FilterShape[2]) * size_t(FilterShape[3]);
+
+    for (size_t o = 0; o < OutputChannels; o += BlockSize) {
+
+        const size_t OutputCount = (std::min)(OutputChannels - o, BlockSize);
+
+        for (size_t k = 0; k < InputSize; k++) {
+
+            for (size_t bo = 0; bo < BlockSize; bo++) {
+
+                if (bo < OutputCount) {
+                    D[bo] = S[(o + bo) * InputSize + k];
+                } else {
+                    D[bo] = 0.0f;
+                }
+            }
+
+            D += BlockSize;
+        }
+    }
+}
+
+template<size_t OutputCount>
+inline
+void
+MlasConvNchwcKernelBlock(
+    const float* Input,
+    const float* Filter,
+    float* Output,
+    size_t StrideWidth,
+    size_t DilationWidth,
+    size_t InputChannelBlocks,
+    size_t InputBlockStride,
+    size_t InputRowStride,
+    size_t FilterBlockStride,
+    size_t KernelHeight,
+    size_t KernelWidth
+    )
+/*++
+
+Routine Description:
+
+    This routine computes OutputCount output positions of a block of output
+    channels. The accumulators are named explicitly so that they stay in
+    registers.
+
+Arguments:
+
+    See MlasConvNchwcKernel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    static_assert(OutputCount >= 1 && OutputCount <= 4, "unsupported output count");
+
+    MLAS_FLOAT32X4 Accumulator00 = MlasZeroFloat32x4();
+    MLAS_FLOAT32X4 Accumulator01 = MlasZeroFloat32x4();
+    MLAS_FLOAT32X4 Accumulator10 = MlasZeroFloat32x4();
+    MLAS_FLOAT32X4 Accumulator11 = MlasZeroFloat32x4();
+    MLAS_FLOAT32X4 Accumulator20 = MlasZeroFloat32x4();
+    MLAS_FLOAT32X4 Accumulator21 = MlasZeroFloat32x4();
+    MLAS_FLOAT32X4 Accumulator30 = MlasZeroFloat32x4();
+    MLAS_FLOAT32X4 Accumulator31 = MlasZeroFloat32x4();
+
+    for (size_t icb = 0; icb < InputChannelBlocks; icb++) {
+
+        const float* input_row = Input + icb * InputBlockStride;
+        const float* filter = Filter + icb * FilterBlockStride;
+
+        for (size_t kh = 0; kh < KernelHeight; kh++) {
+
+            const float* input = input_row;
+
+            for (size_t kw = 0; kw < KernelWidth; kw++) {
+
+                for (size_t bi = 0; bi < MLAS_NCHWC_BLOCK_SIZE; bi++) {
+
+                    MLAS_FLOAT32X4 FilterElements0 = MlasLoadFloat32x4(filter);
+                    MLAS_FLOAT32X4 FilterElements1 = MlasLoadFloat32x4(filter + 4);
+
+                    MLAS_FLOAT32X4 InputElement = MlasBroadcastFloat32x4(input + bi);
+                    Accumulator00 = MlasMultiplyAddFloat32x4(InputElement, FilterElements0, Accumulator00);
+                    Accumulator01 = MlasMultiplyAddFloat32x4(InputElement, FilterElements1, Accumulator01);
+
+                    if (OutputCount >= 2) {
+                        InputElement = MlasBroadcastFloat32x4(input + StrideWidth + bi);
+                        Accumulator10 = MlasMultiplyAddFloat32x4(InputElement, FilterElements0, Accumulator10);
+                        Accumulator11 = MlasMultiplyAddFloat32x4(InputElement, FilterElements1, Accumulator11);
+                    }
+
+                    if (OutputCount >= 3) {
+                        InputElement = MlasBroadcastFloat32x4(input + StrideWidth * 2 + bi);
+                        Accumulator20 = MlasMultiplyAddFloat32x4(InputElement, FilterElements0, Accumulator20);
+                        Accumulator21 = MlasMultiplyAddFloat32x4(InputElement, FilterElements1, Accumulator21);
+                    }
+
+                    if (OutputCount >= 4) {
+                        InputElement = MlasBroadcastFloat32x4(input + StrideWidth * 3 + bi);
+                        Accumulator30 = MlasMultiplyAddFloat32x4(InputElement, FilterElements0, Accumulator30);
+                        Accumulator31 = MlasMultiplyAddFloat32x4(InputElement, FilterElements1, Accumulator31);
+                    }
+
+                    filter += MLAS_NCHWC_BLOCK_SIZE;
+                }
+
+                input += DilationWidth;
+            }
+
+            input_row += InputRowStride;
+        }
+    }
+
+    MlasStoreFloat32x4(Output, Accumulator00);
+    MlasStoreFloat32x4(Output + 4, Accumulator01);
+
+    if (OutputCount >= 2) {
+        MlasStoreFloat32x4(Output + 8, Accumulator10);
+        MlasStoreFloat32x4(Output + 12, Accumulator11);
+    }
+
+    if (OutputCount >= 3) {
+        MlasStoreFloat32x4(Output + 16, Accumulator20);
+        MlasStoreFloat32x4(Output + 20, Accumulator21);
+    }
+
+    if (OutputCount >= 4) {
+        MlasStoreFloat32x4(Output + 24, Accumulator30);
+        MlasStoreFloat32x4(Output + 28, Accumulator31);
+    }
+}
+
+inline
+void
+MlasConvNchwcKernelOutputs(
+    const float* Input,
+    const float* Filter,
+    float* Output,
+    size_t StrideWidth,
+    size_t DilationWidth,
+    size_t InputChannelBlocks,
+    size_t InputBlockStride,
+    size_t InputRowStride,
+    size_t FilterBlockStride,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    size_t OutputCount
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a run of output positions of a block of output
+    channels.
+
+Arguments:
+
+    See MlasConvNchwcKernel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (OutputCount >= 4) {
+
+        MlasConvNchwcKernelBlock<4>(Input, Filter, Output, StrideWidth, DilationWidth,
+            InputChannelBlocks, InputBlockStride, InputRowStride, FilterBlockStride,
+            KernelHeight, KernelWidth);
+
+        Input += StrideWidth * 4;
+        Output += MLAS_NCHWC_BLOCK_SIZE * 4;
+        OutputCount -= 4;
+    }
+
+    switch (OutputCount) {
+
+        case 3:
+        {
+            MlasConvNchwcKernelBlock<3>(Input, Filter, Output, StrideWidth, DilationWidth,
+                InputChannelBlocks, InputBlockStride, InputRowStride, FilterBlockStride,
+                KernelHeight, KernelWidth);
+            break;
+        }
+
+        case 2:
+        {
+            MlasConvNchwcKernelBlock<2>(Input, Filter, Output, StrideWidth, DilationWidth,
+                InputChannelBlocks, InputBlockStride, InputRowStride, FilterBlockStride,
+                KernelHeight, KernelWidth);
+            break;
+        }
+
+        case 1:
+        {
+            MlasConvNchwcKernelBlock<1>(Input, Filter, Output, StrideWidth, DilationWidth,
+                InputChannelBlocks, InputBlockStride, InputRowStride, FilterBlockStride,
+                KernelHeight, KernelWidth);
+            break;
+        }
+    }
+}
+
+void
+MLASCALL
+MlasConvNchwcKernel(
+    const float* Input,
+    const float* Filter,
+    float* Output,
+    size_t StrideWidth,
+    size_t DilationWidth,
+    size_t InputChannelBlocks,
+    size_t InputBlockStride,
+    size_t InputRowStride,
+    size_t FilterBlockStride,
+    size_t FilterStride,
+    size_t OutputStride,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    size_t FilterCount,
+    size_t OutputCount
+    )
+/*++
+
+Routine Description:
+
+    This routine is the inner kernel to compute a run of output positions of
+    a set of output channel blocks for a NCHWc convolution. Every input
+    position read by the kernel must lie inside the input tensor: the
+    positions that overlap the padding are computed by the caller.
+
+Arguments:
+
+    Input - Supplies the address of the input block for the first output
+        position, at the first kernel row and column to process.
+
+    Filter - Supplies the address of the filter block for the first kernel
+        row to process.
+
+    Output - Supplies the address of the output block for the first output
+        position. The output is overwritten.
+
+    StrideWidth - Supplies the distance in elements between the inputs of
+        adjacent output positions.
+
+    DilationWidth - Supplies the distance in elements between the inputs of
+        adjacent kernel columns.
+
+    InputChannelBlocks - Supplies the number of input channel blocks to
+        accumulate over.
+
+    InputBlockStride - Supplies the distance in elements between input
+        channel blocks.
+
+    InputRowStride - Supplies the distance in elements between the inputs of
+        adjacent kernel rows.
+
+    FilterBlockStride - Supplies the distance in elements between the filter
+        blocks for adjacent input channel blocks.
+
+    FilterStride - Supplies the distance in elements between the filters for
+        adjacent output channel blocks.
+
+    OutputStride - Supplies the distance in elements between adjacent output
+        channel blocks.
+
+    KernelHeight - Supplies the number of kernel rows to process.
+
+    KernelWidth - Supplies the number of kernel columns.
+
+    FilterCount - Supplies the number of output channel blocks to compute, up
+        to MLAS_NCHWC_FILTER_SET_SIZE.
+
+    OutputCount - Supplies the number of output positions to compute.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    //
+    // The input elements are reloaded for each block of output channels:
+    // the 4-element vector registers cannot hold the accumulators for a set
+    // of output channel blocks.
+    //
+
+    for (size_t f = 0; f < FilterCount; f++) {
+        MlasConvNchwcKernelOutputs(Input, Filter + f * FilterStride, Output + f * OutputStride,
+            StrideWidth, DilationWidth, InputChannelBlocks, InputBlockStride, InputRowStride,
+            FilterBlockStride, KernelHeight, KernelWidth, OutputCount);
+    }
+}
+
+void
+MlasConvNchwcEdgeOutput(
+    const MLAS_NCHWC_CONV_WORK_BLOCK* WorkBlock,
+    const float* Input,
+    const float* Filter,
+    float* Output,
+    int64_t ihStart,
+    int64_t iwStart
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a single output position of a block of output
+    channels where the kernel overlaps the padding of the input tensor.
+
+Arguments:
+
+    WorkBlock - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the address of the input image, at the first channel
+        block to process.
+
+    Filter - Supplies the address of the filter for the block of output
+        channels.
+
+    Output - Supplies the address of the output block.
+
+    ihStart - Supplies the input row of the first kernel row.
+
+    iwStart - Supplies the input column of the first kernel column.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t BlockSize = MLAS_NCHWC_BLOCK_SIZE;
+
+    const int64_t InputHeight = int64_t(WorkBlock->InputShape[0]);
+    const int64_t InputWidth = int64_t(WorkBlock->InputShape[1]);
+    const size_t KernelHeight = WorkBlock->KernelShape[0];
+    const size_t KernelWidth = WorkBlock->KernelShape[1];
+    const int64_t DilationHeight = int64_t(WorkBlock->DilationShape[0]);
+    const int64_t DilationWidth = int64_t(WorkBlock->DilationShape[1]);
+
+    const size_t InputBlockStride = size_t(InputHeight * InputWidth) * BlockSize;
+    const size_t InputChannelBlocks = WorkBlock->Depthwise ? 1 : WorkBlock->InputChannelBlocks;
+
+    MLAS_FLOAT32X4 Accumulator0 = MlasZeroFloat32x4();
+    MLAS_FLOAT32X4 Accumulator1 = MlasZeroFloat32x4();
+
+    for (size_t icb = 0; icb < InputChannelBlocks; icb++) {
+
+        for (size_t kh = 0; kh < KernelHeight; kh++) {
+
+            const int64_t ih = ihStart + int64_t(kh) * DilationHeight;
+
+            if (ih < 0 || ih >= InputHeight) {
+                continue;
+            }
+
+            for (size_t kw = 0; kw < KernelWidth; kw++) {
+
+                const int64_t iw = iwStart + int64_t(kw) * DilationWidth;
+
+                if (iw < 0 || iw >= InputWidth) {
+                    continue;
+                }
+
+                const float* input = Input + icb * InputBlockStride + size_t(ih * InputWidth + iw) * BlockSize;
+
+                if (WorkBlock->Depthwise) {
+
+                    const float* filter = Filter + (kh * KernelWidth + kw) * BlockSize;
+
+                    Accumulator0 = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(input), MlasLoadFloat32x4(filter), Accumulator0);
+                    Accumulator1 = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(input + 4), MlasLoadFloat32x4(filter + 4), Accumulator1);
+
+                } else {
+
+                    const float* filter = Filter + ((icb * KernelHeight + kh) * KernelWidth + kw) * BlockSize * BlockSize;
+
+                    for (size_t bi = 0; bi < BlockSize; bi++) {
+
+                        MLAS_FLOAT32X4 InputElement = MlasBroadcastFloat32x4(input + bi);
+
+                        Accumulator0 = MlasMultiplyAddFloat32x4(InputElement, MlasLoadFloat32x4(filter), Accumulator0);
+                        Accumulator1 = MlasMultiplyAddFloat32x4(InputElement, MlasLoadFloat32x4(filter + 4), Accumulator1);
+
+                        filter += BlockSize;
+                    }
+                }
+            }
+        }
+    }
+
+    MlasStoreFloat32x4(Output, Accumulator0);
+    MlasStoreFloat32x4(Output + 4, Accumulator1);
+}
+
+void
+MlasConvNchwcDepthwiseOutputs(
+    const float* Input,
+    const float* Filter,
+    float* Output,
+    size_t StrideWidth,
+    size_t DilationWidth,
+    size_t InputRowStride,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    size_t OutputCount
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a run of output positions of a block of channels
+    for a depthwise NCHWc convolution. Every input position read must lie
+    inside the input tensor.
+
+Arguments:
+
+    Input - Supplies the address of the input block for the first output
+        position, at the first kernel row and column to process.
+
+    Filter - Supplies the address of the filter block for the first kernel
+        row to process.
+
+    Output - Supplies the address of the output block for the first output
+        position. The output is overwritten.
+
+    StrideWidth - Supplies the distance in elements between the inputs of
+        adjacent output positions.
+
+    DilationWidth - Supplies the distance in elements between the inputs of
+        adjacent kernel columns.
+
+    InputRowStride - Supplies the distance in elements between the inputs of
+        adjacent kernel rows.
+
+    KernelHeight - Supplies the number of kernel rows to process.
+
+    KernelWidth - Supplies the number of kernel columns.
+
+    OutputCount - Supplies the number of output positions to compute.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    for (size_t o = 0; o < OutputCount; o++) {
+
+        MLAS_FLOAT32X4 Accumulator0 = MlasZeroFloat32x4();
+        MLAS_FLOAT32X4 Accumulator1 = MlasZeroFloat32x4();
+
+        const float* input_row = Input;
+        const float* filter = Filter;
+
+        for (size_t kh = 0; kh < KernelHeight; kh++) {
+
+            const float* input = input_row;
+
+            for (size_t kw = 0; kw < KernelWidth; kw++) {
+
+                Accumulator0 = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(input), MlasLoadFloat32x4(filter), Accumulator0);
+                Accumulator1 = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(input + 4), MlasLoadFloat32x4(filter + 4), Accumulator1);
+
+                input += DilationWidth;
+                filter += MLAS_NCHWC_BLOCK_SIZE;
+            }
+
+            input_row += InputRowStride;
+        }
+
+        MlasStoreFloat32x4(Output, Accumulator0);
+        MlasStoreFloat32x4(Output + 4, Accumulator1);
+
+        Input += StrideWidth;
+        Output += MLAS_NCHWC_BLOCK_SIZE;
+    }
+}
+
+void
+MlasNchwcConvThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    NCHWc convolution operation.
+
+    The operation is partitioned by output row: each batch, set of output
+    channel blocks and output row is an independent unit of work.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t BlockSize = MLAS_NCHWC_BLOCK_SIZE;
+
+    const auto* WorkBlock = (MLAS_NCHWC_CONV_WORK_BLOCK*)Context;
+
+    const size_t InputHeight = WorkBlock->InputShape[0];
+    const size_t InputWidth = WorkBlock->InputShape[1];
+    const size_t KernelHeight = WorkBlock->KernelShape[0];
+    const size_t KernelWidth = WorkBlock->KernelShape[1];
+    const size_t DilationHeight = WorkBlock->DilationShape[0];
+    const size_t DilationWidth = WorkBlock->DilationShape[1];
+    const size_t PaddingLeftHeight = WorkBlock->Padding[0];
+    const size_t PaddingLeftWidth = WorkBlock->Padding[1];
+    const size_t StrideHeight = WorkBlock->StrideShape[0];
+    const size_t StrideWidth = WorkBlock->StrideShape[1];
+    const size_t OutputHeight = WorkBlock->OutputShape[0];
+    const size_t OutputWidth = WorkBlock->OutputShape[1];
+
+    const size_t InputBlockStride = InputHeight * InputWidth * BlockSize;
+    const size_t OutputBlockStride = OutputHeight * OutputWidth * BlockSize;
+    const size_t InputChannelBlocks = WorkBlock->InputChannelBlocks;
+    const size_t OutputChannelBlocks = WorkBlock->OutputChannelBlocks;
+    const bool Depthwise = WorkBlock->Depthwise;
+
+    //
+    // The filter for a block of output channels holds every input channel
+    // block for a regular convolution or a single block for a depthwise
+    // convolution.
+    //
+
+    const size_t FilterBlockStride = KernelHeight * KernelWidth * BlockSize * (Depthwise ? 1 : BlockSize);
+    const size_t FilterOutputBlockStride = FilterBlockStride * (Depthwise ? 1 : InputChannelBlocks);
+    const size_t FilterRowStride = KernelWidth * BlockSize * (Depthwise ? 1 : BlockSize);
+
+    //
+    // A regular convolution computes a set of output channel blocks for each
+    // input element loaded.
+    //
+
+    const size_t FilterSetSize = Depthwise ? 1 : MLAS_NCHWC_FILTER_SET_SIZE;
+    const size_t FilterSetCount = (OutputChannelBlocks + FilterSetSize - 1) / FilterSetSize;
+
+    //
+    // Compute the range of output columns where the kernel does not overlap
+    // the left or right padding.
+    //
+
+    const size_t SpanWidth = (KernelWidth - 1) * DilationWidth + 1;
+
+    size_t OutputWidthStart = (PaddingLeftWidth + StrideWidth - 1) / StrideWidth;
+    size_t OutputWidthEnd = 0;
+
+    if (InputWidth + PaddingLeftWidth >= SpanWidth) {
+        OutputWidthEnd = (InputWidth + PaddingLeftWidth - SpanWidth) / StrideWidth + 1;
+    }
+
+    OutputWidthEnd = (std::min)(OutputWidthEnd, OutputWidth);
+    OutputWidthStart = (std::min)(OutputWidthStart, OutputWidthEnd);
+
+    //
+    // Compute the range of output rows to use for this thread.
+    //
+
+    const size_t TotalRowCount = WorkBlock->BatchCount * FilterSetCount * OutputHeight;
+    const size_t TargetThreadCount = size_t(WorkBlock->TargetThreadCount);
+
+    const size_t RowCountPerThread = TotalRowCount / TargetThreadCount;
+    const size_t RowCountExtra = TotalRowCount % TargetThreadCount;
+
+    size_t RowStart;
+    size_t RowEnd;
+
+    if (size_t(Index) < RowCountExtra) {
+        RowStart = (RowCountPerThread + 1) * Index;
+        RowEnd = RowStart + RowCountPerThread + 1;
+    } else {
+        RowStart = RowCountPerThread * Index + RowCountExtra;
+        RowEnd = RowStart + RowCountPerThread;
+    }
+
+#if defined(MLAS_TARGET_AMD64)
+    PMLAS_CONV_NCHWC_KERNEL_ROUTINE ConvNchwcKernelRoutine = MlasPlatform.ConvNchwcKernelRoutine;
+#else
+    PMLAS_CONV_NCHWC_KERNEL_ROUTINE ConvNchwcKernelRoutine = MlasConvNchwcKernel;
+#endif
+
+    for (size_t row = RowStart; row < RowEnd; row++) {
+
+        const size_t oh = row % OutputHeight;
+        const size_t ocb = ((row / OutputHeight) % FilterSetCount) * FilterSetSize;
+        const size_t batch = row / (OutputHeight * FilterSetCount);
+        const size_t FilterCount = (std::min)(OutputChannelBlocks - ocb, FilterSetSize);
+
+        const float* input = WorkBlock->Input + batch * InputChannelBlocks * InputBlockStride;
+
+        if (Depthwise) {
+            input += ocb * InputBlockStride;
+        }
+
+        const float* filter = WorkBlock->Filter + ocb * FilterOutputBlockStride;
+        float* output = WorkBlock->Output + (batch * OutputChannelBlocks + ocb) * OutputBlockStride +
+            oh * OutputWidth * BlockSize;
+
+        //
+        // Compute the range of kernel rows that lie inside the input image.
+        //
+
+        const int64_t ihStart = int64_t(oh * StrideHeight) - int64_t(PaddingLeftHeight);
+
+        size_t khStart = 0;
+        size_t khEnd = KernelHeight;
+
+        while (khStart < khEnd && ihStart + int64_t(khStart * DilationHeight) < 0) {
+            khStart++;
+        }
+
+        while (khEnd > khStart && ihStart + int64_t((khEnd - 1) * DilationHeight) >= int64_t(InputHeight)) {
+            khEnd--;
+        }
+
+        //
+        // Compute the output columns that overlap the padding one at a time
+        // and the interior output columns with the kernel.
+        //
+
+        for (size_t f = 0; f < FilterCount; f++) {
+            for (size_t ow = 0; ow < OutputWidthStart; ow++) {
+                MlasConvNchwcEdgeOutput(WorkBlock, input, filter + f * FilterOutputBlockStride,
+                    output + f * OutputBlockStride + ow * BlockSize, ihStart,
+                    int64_t(ow * StrideWidth) - int64_t(PaddingLeftWidth));
+            }
+        }
+
+        if (OutputWidthStart < OutputWidthEnd) {
+
+            const size_t ih = (khStart < khEnd) ? size_t(ihStart + int64_t(khStart * DilationHeight)) : 0;
+            const size_t iw = OutputWidthStart * StrideWidth - PaddingLeftWidth;
+
+            const float* input_interior = input + (ih * InputWidth + iw) * BlockSize;
+            const float* filter_interior = filter + khStart * FilterRowStride;
+            float* output_interior = output + OutputWidthStart * BlockSize;
+
+            if (Depthwise) {
+
+                MlasConvNchwcDepthwiseOutputs(input_interior, filter_interior, output_interior,
+                    StrideWidth * BlockSize, DilationWidth * BlockSize,
+                    DilationHeight * InputWidth * BlockSize, khEnd - khStart, KernelWidth,
+                    OutputWidthEnd - OutputWidthStart);
+
+            } else {
+
+                ConvNchwcKernelRoutine(input_interior, filter_interior, output_interior,
+                    StrideWidth * BlockSize, DilationWidth * BlockSize, InputChannelBlocks,
+                    InputBlockStride, DilationHeight * InputWidth * BlockSize, FilterBlockStride,
+                    FilterOutputBlockStride, OutputBlockStride, khEnd - khStart, KernelWidth,
+                    FilterCount, OutputWidthEnd - OutputWidthStart);
+            }
+        }
+
+        for (size_t f = 0; f < FilterCount; f++) {
+            for (size_t ow = OutputWidthEnd; ow < OutputWidth; ow++) {
+                MlasConvNchwcEdgeOutput(WorkBlock, input, filter + f * FilterOutputBlockStride,
+                    output + f * OutputBlockStride + ow * BlockSize, ihStart,
+                    int64_t(ow * StrideWidth) - int64_t(PaddingLeftWidth));
+            }
+        }
+
+        //
+        // Add the bias and apply the activation to the output rows.
+        //
+
+        for (size_t f = 0; f < FilterCount; f++) {
+
+            float* output_row = output + f * OutputBlockStride;
+
+            if (WorkBlock->Bias != nullptr) {
+
+                const float* bias = WorkBlock->Bias + (ocb + f) * BlockSize;
+
+                MLAS_FLOAT32X4 BiasElements0 = MlasLoadFloat32x4(bias);
+                MLAS_FLOAT32X4 BiasElements1 = MlasLoadFloat32x4(bias + 4);
+
+                for (size_t ow = 0; ow < OutputWidth; ow++) {
+                    float* o = output_row + ow * BlockSize;
+                    MlasStoreFloat32x4(o, MlasAddFloat32x4(MlasLoadFloat32x4(o), BiasElements0));
+                    MlasStoreFloat32x4(o + 4, MlasAddFloat32x4(MlasLoadFloat32x4(o + 4), BiasElements1));
+                }
+            }
+
+            if (WorkBlock->Activation->ActivationKind != MlasIdentityActivation) {
+                MlasActivation(WorkBlock->Activation, output_row, nullptr, 1, output_row,
+                    OutputWidth * BlockSize, OutputWidth * BlockSize);
+            }
+        }
+    }
+}
+
+void
+MLASCALL
+MlasNchwcConv(
+    const int64_t* InputShape,
+    const int64_t* KernelShape,
+    const int64_t* DilationShape,
+    const int64_t* Padding,
+    const int64_t* StrideShape,
+    const int64_t* OutputShape,
+    size_t GroupCount,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* Output,
+    const MLAS_ACTIVATION* Activation,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the two dimensional convolution operation for
+    tensors in the NCHWc format.
+
+Arguments:
+
+    InputShape - Supplies the shape of the input tensor. The channel count is
+        a multiple of the block size.
+
+    KernelShape - Supplies the height and width of the kernel.
+
+    DilationShape - Supplies the height and width of the dilation.
+
+    Padding - Supplies the number of padding elements at the top, left,
+        bottom and right edges of the input tensor.
+
+    StrideShape - Supplies the height and width of the stride.
+
+    OutputShape - Supplies the shape of the output tensor. The channel count
+        is a multiple of the block size.
+
+    GroupCount - Supplies the number of channel groups. The convolution must
+        have a single group or be a depthwise convolution where every group
+        has a single input and output channel.
+
+    Input - Supplies the input tensor.
+
+    Filter - Supplies the filter tensor, reordered by MlasReorderFilterOIHWBiBo
+        for a single group or by MlasReorderFilterOIHWBo for a depthwise
+        convolution.
+
+    Bias - Optionally supplies the bias vector. The length of the vector is
+        the padded output channel count.
+
+    Output - Supplies the output tensor.
+
+    Activation - Supplies the parameters for the activation to apply to the
+        convolution output.
+
+    ThreadPool - Optionally supplies the thread pool to execute the operation.
+        If nullptr, the platform threading model is used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t BlockSize = MLAS_NCHWC_BLOCK_SIZE;
+
+    MLAS_NCHWC_CONV_WORK_BLOCK WorkBlock;
+
+    WorkBlock.Input = Input;
+    WorkBlock.Filter = Filter;
+    WorkBlock.Bias = Bias;
+    WorkBlock.Output = Output;
+    WorkBlock.Activation = Activation;
+    WorkBlock.BatchCount = size_t(InputShape[0]);
+    WorkBlock.InputChannelBlocks = size_t(InputShape[1]) / BlockSize;
+    WorkBlock.OutputChannelBlocks = size_t(OutputShape[1]) / BlockSize;
+    WorkBlock.Depthwise = (GroupCount > 1);
+
+    for (size_t dim = 0; dim < 2; dim++) {
+        WorkBlock.InputShape[dim] = size_t(InputShape[dim + 2]);
+        WorkBlock.KernelShape[dim] = size_t(KernelShape[dim]);
+        WorkBlock.DilationShape[dim] = size_t(DilationShape[dim]);
+        WorkBlock.Padding[dim] = size_t(Padding[dim]);
+        WorkBlock.Padding[dim + 2] = size_t(Padding[dim + 2]);
+        WorkBlock.StrideShape[dim] = size_t(StrideShape[dim]);
+        WorkBlock.OutputShape[dim] = size_t(OutputShape[dim + 2]);
+    }
+
+    //
+    // Compute the number of threads from the number of multiplies.
+    //
+
+    const size_t FilterSetSize = WorkBlock.Depthwise ? 1 : MLAS_NCHWC_FILTER_SET_SIZE;
+    const size_t FilterSetCount = (WorkBlock.OutputChannelBlocks + FilterSetSize - 1) / FilterSetSize;
+    const size_t TotalRowCount = WorkBlock.BatchCount * FilterSetCount * WorkBlock.OutputShape[0];
+
+    if (TotalRowCount == 0 || WorkBlock.OutputShape[1] == 0) {
+        return;
+    }
+
+    double Complexity = double(WorkBlock.BatchCount * WorkBlock.OutputChannelBlocks * BlockSize) *
+        double(WorkBlock.OutputShape[0] * WorkBlock.OutputShape[1]) *
+        double(WorkBlock.KernelShape[0] * WorkBlock.KernelShape[1]);
+
+    if (!WorkBlock.Depthwise) {
+        Complexity *= double(WorkBlock.InputChannelBlocks * BlockSize);
+    }
+
+    int32_t TargetThreadCount;
+
+    if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    }
+
+    int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (size_t(TargetThreadCount) >= TotalRowCount) {
+        TargetThreadCount = int32_t(TotalRowCount);
+    }
+
+    WorkBlock.TargetThreadCount = TargetThreadCount;
+
+    if (TargetThreadCount == 1) {
+        MlasNchwcConvThreaded(&WorkBlock, 0);
+    } else {
+        MlasExecuteThreaded(MlasNchwcConvThreaded, &WorkBlock, TargetThreadCount, ThreadPool);
+    }
+}
+
+void
+MlasNchwcPoolThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    NCHWc pooling operation.
+
+    The operation is partitioned by output row: each batch, channel block and
+    output row is an independent unit of work.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t BlockSize = MLAS_NCHWC_BLOCK_SIZE;
+
+    const auto* WorkBlock = (MLAS_NCHWC_POOL_WORK_BLOCK*)Context;
+
+    const MLAS_POOLING_KIND PoolingKind = WorkBlock->PoolingKind;
+
+    const int64_t InputHeight = int64_t(WorkBlock->InputShape[0]);
+    const int64_t InputWidth = int64_t(WorkBlock->InputShape[1]);
+    const int64_t KernelHeight = int64_t(WorkBlock->KernelShape[0]);
+    const int64_t KernelWidth = int64_t(WorkBlock->KernelShape[1]);
+    const int64_t PaddingLeftHeight = int64_t(WorkBlock->Padding[0]);
+    const int64_t PaddingLeftWidth = int64_t(WorkBlock->Padding[1]);
+    const int64_t StrideHeight = int64_t(WorkBlock->StrideShape[0]);
+    const int64_t StrideWidth = int64_t(WorkBlock->StrideShape[1]);
+    const size_t OutputHeight = WorkBlock->OutputShape[0];
+    const size_t OutputWidth = WorkBlock->OutputShape[1];
+
+    const size_t InputBlockStride = size_t(InputHeight * InputWidth) * BlockSize;
+
+    //
+    // Compute the range of output rows to use for this thread.
+    //
+
+    const size_t TotalRowCount = WorkBlock->ChannelBlockCount * OutputHeight;
+    const size_t TargetThreadCount = size_t(WorkBlock->TargetThreadCount);
+
+    const size_t RowCountPerThread = TotalRowCount / TargetThreadCount;
+    const size_t RowCountExtra = TotalRowCount % TargetThreadCount;
+
+    size_t RowStart;
+    size_t RowEnd;
+
+    if (size_t(Index) < RowCountExtra) {
+        RowStart = (RowCountPerThread + 1) * Index;
+        RowEnd = RowStart + RowCountPerThread + 1;
+    } else {
+        RowStart = RowCountPerThread * Index + RowCountExtra;
+        RowEnd = RowStart + RowCountPerThread;
+    }
+
+    const MLAS_FLOAT32X4 InitialValue = (PoolingKind == MlasMaximumPooling) ?
+        MlasBroadcastFloat32x4(std::numeric_limits<float>::lowest()) : MlasZeroFloat32x4();
+
+    for (size_t row = RowStart; row < RowEnd; row++) {
+
+        const size_t oh = row % OutputHeight;
+        const size_t cb = row / OutputHeight;
+
+        const float* input = WorkBlock->Input + cb * InputBlockStride;
+        float* output = WorkBlock->Output + row * OutputWidth * BlockSize;
+
+        const int64_t ihStart64 = int64_t(oh) * StrideHeight - PaddingLeftHeight;
+        const int64_t ihEnd64 = ihStart64 + KernelHeight;
+
+        const int64_t ihStart = (std::max)(ihStart64, int64_t(0));
+        const int64_t ihEnd = (std::min)(ihEnd64, InputHeight);
+
+        for (size_t ow = 0; ow < OutputWidth; ow++) {
+
+            const int64_t iwStart64 = int64_t(ow) * StrideWidth - PaddingLeftWidth;
+            const int64_t iwEnd64 = iwStart64 + KernelWidth;
+
+            const int64_t iwStart = (std::max)(iwStart64, int64_t(0));
+            const int64_t iwEnd = (std::min)(iwEnd64, InputWidth);
+
+            MLAS_FLOAT32X4 Reduction0 = InitialValue;
+            MLAS_FLOAT32X4 Reduction1 = InitialValue;
+
+            for (int64_t ih = ihStart; ih < ihEnd; ih++) {
+
+                const float* input_row = input + size_t(ih * InputWidth) * BlockSize;
+
+                for (int64_t iw = iwStart; iw < iwEnd; iw++) {
+
+                    MLAS_FLOAT32X4 InputElements0 = MlasLoadFloat32x4(input_row + iw * BlockSize);
+                    MLAS_FLOAT32X4 InputElements1 = MlasLoadFloat32x4(input_row + iw * BlockSize + 4);
+
+                    if (PoolingKind == MlasMaximumPooling) {
+                        Reduction0 = MlasMaximumFloat32x4(Reduction0, InputElements0);
+                        Reduction1 = MlasMaximumFloat32x4(Reduction1, InputElements1);
+                    } else {
+                        Reduction0 = MlasAddFloat32x4(Reduction0, InputElements0);
+                        Reduction1 = MlasAddFloat32x4(Reduction1, InputElements1);
+                    }
+                }
+            }
+
+            if (PoolingKind != MlasMaximumPooling) {
+
+                float KernelSize;
+
+                if (PoolingKind == MlasAveragePoolingExcludePad) {
+                    KernelSize = float((ihEnd - ihStart) * (iwEnd - iwStart));
+                } else {
+                    KernelSize = float(KernelHeight * KernelWidth);
+                }
+
+                MLAS_FLOAT32X4 Divisor = MlasBroadcastFloat32x4(KernelSize);
+
+                Reduction0 = MlasDivideFloat32x4(Reduction0, Divisor);
+                Reduction1 = MlasDivideFloat32x4(Reduction1, Divisor);
+            }
+
+            MlasStoreFloat32x4(output, Reduction0);
+            MlasStoreFloat32x4(output + 4, Reduction1);
+
+            output += BlockSize;
+        }
+    }
+}
+
+void
+MLASCALL
+MlasNchwcPool(
+    MLAS_POOLING_KIND PoolingKind,
+    const int64_t* InputShape,
+    const int64_t* KernelShape,
+    const int64_t* Padding,
+    const int64_t* StrideShape,
+    const int64_t* OutputShape,
+    const float* Input,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the two dimensional pooling operation for tensors
+    in the NCHWc format.
+
+Arguments:
+
+    PoolingKind - Supplies the kind of pooling operation to perform.
+
+    InputShape - Supplies the shape of the input tensor. The channel count is
+        a multiple of the block size.
+
+    KernelShape - Optionally supplies the height and width of the kernel. If
+        nullptr, the kernel covers the input image (global pooling).
+
+    Padding - Optionally supplies the number of padding elements at the top,
+        left, bottom and right edges of the input tensor.
+
+    StrideShape - Optionally supplies the height and width of the stride.
+
+    OutputShape - Supplies the shape of the output tensor.
+
+    Input - Supplies the input tensor.
+
+    Output - Supplies the output tensor.
+
+    ThreadPool - Optionally supplies the thread pool to execute the operation.
+        If nullptr, the platform threading model is used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t BlockSize = MLAS_NCHWC_BLOCK_SIZE;
+
+    MLAS_NCHWC_POOL_WORK_BLOCK WorkBlock;
+
+    WorkBlock.PoolingKind = PoolingKind;
+    WorkBlock.Input = Input;
+    WorkBlock.Output = Output;
+    WorkBlock.ChannelBlockCount = size_t(InputShape[0]) * (size_t(InputShape[1]) / BlockSize);
+
+    for (size_t dim = 0; dim < 2; dim++) {
+        WorkBlock.InputShape[dim] = size_t(InputShape[dim + 2]);
+        WorkBlock.KernelShape[dim] = (KernelShape != nullptr) ? size_t(KernelShape[dim]) : WorkBlock.InputShape[dim];
+        WorkBlock.Padding[dim] = (Padding != nullptr) ? size_t(Padding[dim]) : 0;
+        WorkBlock.Padding[dim + 2] = (Padding != nullptr) ? size_t(Padding[dim + 2]) : 0;
+        WorkBlock.StrideShape[dim] = (StrideShape != nullptr) ? size_t(StrideShape[dim]) : 1;
+        WorkBlock.OutputShape[dim] = size_t(OutputShape[dim + 2]);
+    }
+
+    const size_t TotalRowCount = WorkBlock.ChannelBlockCount * WorkBlock.OutputShape[0];
+
+    if (TotalRowCount == 0) {
+        return;
+    }
+
+    int32_t TargetThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (size_t(TargetThreadCount) >= TotalRowCount) {
+        TargetThreadCount = int32_t(TotalRowCount);
+    }
+
+    WorkBlock.TargetThreadCount = TargetThreadCount;
+
+    if (TargetThreadCount == 1) {
+        MlasNchwcPoolThreaded(&WorkBlock, 0);
+    } else {
+        MlasExecuteThreaded(MlasNchwcPoolThreaded, &WorkBlock, TargetThreadCount, ThreadPool);
+    }
+}
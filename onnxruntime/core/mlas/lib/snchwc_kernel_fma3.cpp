@@ -0,0 +1,377 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    snchwc_kernel_fma3.cpp
+
+Abstract:
+
+    This module implements the kernel for the single precision NCHWc
+    convolution operation using FMA3 instructions.
+
+    A block of output channels fits exactly in a single AVX register.
+
+    This module must be compiled with AVX2 and FMA3 code generation enabled.
+
+--*/
+
+#include "mlasi.h"
+
+static_assert(MLAS_NCHWC_BLOCK_SIZE == 8, "block size must match the AVX vector width");
+
+template<size_t FilterCount>
+inline
+void
+MlasConvNchwcMultiplyAccumulateFma3(
+    const float* Input,
+    __m256 FilterElements0,
+    __m256 FilterElements1,
+    __m256 FilterElements2,
+    __m256& Accumulator0,
+    __m256& Accumulator1,
+    __m256& Accumulator2
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies an input element by the filter elements for a set
+    of output channel blocks and accumulates the products.
+
+Arguments:
+
+    Input - Supplies the address of the input element.
+
+    FilterElements0 - Supplies the filter elements for the first block.
+
+    FilterElements1 - Supplies the filter elements for the second block.
+
+    FilterElements2 - Supplies the filter elements for the third block.
+
+    Accumulator0 - Supplies the accumulator for the first block.
+
+    Accumulator1 - Supplies the accumulator for the second block.
+
+    Accumulator2 - Supplies the accumulator for the third block.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    __m256 InputElement = _mm256_broadcast_ss(Input);
+
+    Accumulator0 = _mm256_fmadd_ps(InputElement, FilterElements0, Accumulator0);
+
+    if (FilterCount >= 2) {
+        Accumulator1 = _mm256_fmadd_ps(InputElement, FilterElements1, Accumulator1);
+    }
+
+    if (FilterCount >= 3) {
+        Accumulator2 = _mm256_fmadd_ps(InputElement, FilterElements2, Accumulator2);
+    }
+}
+
+template<size_t FilterCount>
+inline
+void
+MlasConvNchwcStoreOutputFma3(
+    float* Output,
+    size_t OutputStride,
+    __m256 Accumulator0,
+    __m256 Accumulator1,
+    __m256 Accumulator2
+    )
+/*++
+
+Routine Description:
+
+    This routine stores an output position for a set of output channel
+    blocks.
+
+Arguments:
+
+    Output - Supplies the address of the output position for the first block.
+
+    OutputStride - Supplies the distance in elements between output blocks.
+
+    Accumulator0 - Supplies the accumulator for the first block.
+
+    Accumulator1 - Supplies the accumulator for the second block.
+
+    Accumulator2 - Supplies the accumulator for the third block.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    _mm256_storeu_ps(Output, Accumulator0);
+
+    if (FilterCount >= 2) {
+        _mm256_storeu_ps(Output + OutputStride, Accumulator1);
+    }
+
+    if (FilterCount >= 3) {
+        _mm256_storeu_ps(Output + OutputStride * 2, Accumulator2);
+    }
+}
+
+template<size_t FilterCount, size_t OutputCount>
+void
+MlasConvNchwcKernelFma3Block(
+    const float* Input,
+    const float* Filter,
+    float* Output,
+    size_t StrideWidth,
+    size_t DilationWidth,
+    size_t InputChannelBlocks,
+    size_t InputBlockStride,
+    size_t InputRowStride,
+    size_t FilterBlockStride,
+    size_t FilterStride,
+    size_t OutputStride,
+    size_t KernelHeight,
+    size_t KernelWidth
+    )
+/*++
+
+Routine Description:
+
+    This routine computes OutputCount output positions of FilterCount blocks
+    of output channels using FMA3 instructions. The accumulators are named
+    explicitly so that they stay in registers.
+
+Arguments:
+
+    See MlasConvNchwcKernel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    static_assert(FilterCount >= 1 && FilterCount <= MLAS_NCHWC_FILTER_SET_SIZE, "unsupported filter count");
+    static_assert(OutputCount >= 1 && OutputCount <= 4, "unsupported output count");
+
+    __m256 Accumulator00 = _mm256_setzero_ps();
+    __m256 Accumulator01 = _mm256_setzero_ps();
+    __m256 Accumulator02 = _mm256_setzero_ps();
+    __m256 Accumulator10 = _mm256_setzero_ps();
+    __m256 Accumulator11 = _mm256_setzero_ps();
+    __m256 Accumulator12 = _mm256_setzero_ps();
+    __m256 Accumulator20 = _mm256_setzero_ps();
+    __m256 Accumulator21 = _mm256_setzero_ps();
+    __m256 Accumulator22 = _mm256_setzero_ps();
+    __m256 Accumulator30 = _mm256_setzero_ps();
+    __m256 Accumulator31 = _mm256_setzero_ps();
+    __m256 Accumulator32 = _mm256_setzero_ps();
+
+    for (size_t icb = 0; icb < InputChannelBlocks; icb++) {
+
+        const float* input_row = Input + icb * InputBlockStride;
+        const float* filter = Filter + icb * FilterBlockStride;
+
+        for (size_t kh = 0; kh < KernelHeight; kh++) {
+
+            const float* input = input_row;
+
+            for (size_t kw = 0; kw < KernelWidth; kw++) {
+
+                for (size_t bi = 0; bi < MLAS_NCHWC_BLOCK_SIZE; bi++) {
+
+                    __m256 FilterElements0 = _mm256_loadu_ps(filter);
+                    __m256 FilterElements1 = _mm256_setzero_ps();
+                    __m256 FilterElements2 = _mm256_setzero_ps();
+
+                    if (FilterCount >= 2) {
+                        FilterElements1 = _mm256_loadu_ps(filter + FilterStride);
+                    }
+
+                    if (FilterCount >= 3) {
+                        FilterElements2 = _mm256_loadu_ps(filter + FilterStride * 2);
+                    }
+
+                    MlasConvNchwcMultiplyAccumulateFma3<FilterCount>(input + bi,
+                        FilterElements0, FilterElements1, FilterElements2,
+                        Accumulator00, Accumulator01, Accumulator02);
+
+                    if (OutputCount >= 2) {
+                        MlasConvNchwcMultiplyAccumulateFma3<FilterCount>(input + StrideWidth + bi,
+                            FilterElements0, FilterElements1, FilterElements2,
+                            Accumulator10, Accumulator11, Accumulator12);
+                    }
+
+                    if (OutputCount >= 3) {
+                        MlasConvNchwcMultiplyAccumulateFma3<FilterCount>(input + StrideWidth * 2 + bi,
+                            FilterElements0, FilterElements1, FilterElements2,
+                            Accumulator20, Accumulator21, Accumulator22);
+                    }
+
+                    if (OutputCount >= 4) {
+                        MlasConvNchwcMultiplyAccumulateFma3<FilterCount>(input + StrideWidth * 3 + bi,
+                            FilterElements0, FilterElements1, FilterElements2,
+                            Accumulator30, Accumulator31, Accumulator32);
+                    }
+
+                    filter += MLAS_NCHWC_BLOCK_SIZE;
+                }
+
+                input += DilationWidth;
+            }
+
+            input_row += InputRowStride;
+        }
+    }
+
+    MlasConvNchwcStoreOutputFma3<FilterCount>(Output, OutputStride,
+        Accumulator00, Accumulator01, Accumulator02);
+
+    if (OutputCount >= 2) {
+        MlasConvNchwcStoreOutputFma3<FilterCount>(Output + MLAS_NCHWC_BLOCK_SIZE, OutputStride,
+            Accumulator10, Accumulator11, Accumulator12);
+    }
+
+    if (OutputCount >= 3) {
+        MlasConvNchwcStoreOutputFma3<FilterCount>(Output + MLAS_NCHWC_BLOCK_SIZE * 2, OutputStride,
+            Accumulator20, Accumulator21, Accumulator22);
+    }
+
+    if (OutputCount >= 4) {
+        MlasConvNchwcStoreOutputFma3<FilterCount>(Output + MLAS_NCHWC_BLOCK_SIZE * 3, OutputStride,
+            Accumulator30, Accumulator31, Accumulator32);
+    }
+}
+
+template<size_t FilterCount>
+void
+MlasConvNchwcKernelFma3Filters(
+    const float* Input,
+    const float* Filter,
+    float* Output,
+    size_t StrideWidth,
+    size_t DilationWidth,
+    size_t InputChannelBlocks,
+    size_t InputBlockStride,
+    size_t InputRowStride,
+    size_t FilterBlockStride,
+    size_t FilterStride,
+    size_t OutputStride,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    size_t OutputCount
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a run of output positions of FilterCount blocks of
+    output channels using FMA3 instructions.
+
+Arguments:
+
+    See MlasConvNchwcKernel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (OutputCount >= 4) {
+
+        MlasConvNchwcKernelFma3Block<FilterCount, 4>(Input, Filter, Output, StrideWidth,
+            DilationWidth, InputChannelBlocks, InputBlockStride, InputRowStride,
+            FilterBlockStride, FilterStride, OutputStride, KernelHeight, KernelWidth);
+
+        Input += StrideWidth * 4;
+        Output += MLAS_NCHWC_BLOCK_SIZE * 4;
+        OutputCount -= 4;
+    }
+
+    switch (OutputCount) {
+
+        case 3:
+        {
+            MlasConvNchwcKernelFma3Block<FilterCount, 3>(Input, Filter, Output, StrideWidth,
+                DilationWidth, InputChannelBlocks, InputBlockStride, InputRowStride,
+                FilterBlockStride, FilterStride, OutputStride, KernelHeight, KernelWidth);
+            break;
+        }
+
+        case 2:
+        {
+            MlasConvNchwcKernelFma3Block<FilterCount, 2>(Input, Filter, Output, StrideWidth,
+                DilationWidth, InputChannelBlocks, InputBlockStride, InputRowStride,
+                FilterBlockStride, FilterStride, OutputStride, KernelHeight, KernelWidth);
+            break;
+        }
+
+        case 1:
+        {
+            MlasConvNchwcKernelFma3Block<FilterCount, 1>(Input, Filter, Output, StrideWidth,
+                DilationWidth, InputChannelBlocks, InputBlockStride, InputRowStride,
+                FilterBlockStride, FilterStride, OutputStride, KernelHeight, KernelWidth);
+            break;
+        }
+    }
+}
+
+void
+MLASCALL
+MlasConvNchwcKernelFma3(
+    const float* Input,
+    const float* Filter,
+    float* Output,
+    size_t StrideWidth,
+    size_t DilationWidth,
+    size_t InputChannelBlocks,
+    size_t InputBlockStride,
+    size_t InputRowStride,
+    size_t FilterBlockStride,
+    size_t FilterStride,
+    size_t OutputStride,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    size_t FilterCount,
+    size_t OutputCount
+    )
+/*++
+
+Routine Description:
+
+    This routine is the inner kernel to compute a run of output positions of
+    a set of output channel blocks for a NCHWc convolution using FMA3
+    instructions.
+
+Arguments:
+
+    See MlasConvNchwcKernel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (FilterCount >= 3) {
+        MlasConvNchwcKernelFma3Filters<3>(Input, Filter, Output, StrideWidth, DilationWidth,
+            InputChannelBlocks, InputBlockStride, InputRowStride, FilterBlockStride,
+            FilterStride, OutputStride, KernelHeight, KernelWidth, OutputCount);
+    } else if (FilterCount == 2) {
+        MlasConvNchwcKernelFma3Filters<2>(Input, Filter, Output, StrideWidth, DilationWidth,
+            InputChannelBlocks, InputBlockStride, InputRowStride, FilterBlockStride,
+            FilterStride, OutputStride, KernelHeight, KernelWidth, OutputCount);
+    } else {
+        MlasConvNchwcKernelFma3Filters<1>(Input, Filter, Output, StrideWidth, DilationWidth,
+            InputChannelBlocks, InputBlockStride, InputRowStride, FilterBlockStride,
+            FilterStride, OutputStride, KernelHeight, KernelWidth, OutputCount);
+    }
+}
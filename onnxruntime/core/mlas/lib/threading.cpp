@@ -15,6 +15,48 @@ Abstract:
 --*/
 
 #include "mlasi.h"
+#include <atomic>
+
+//
+// Routines supplied by the host to run threaded work on its thread pool. Until
+// they are set, the platform threading model is used even if a thread pool is
+// given.
+//
+
+static std::atomic<MLAS_THREADPOOL_GET_THREAD_COUNT*> MlasThreadPoolGetThreadCount{nullptr};
+static std::atomic<MLAS_THREADPOOL_PARALLEL_FOR*> MlasThreadPoolParallelFor{nullptr};
+
+void
+MLASCALL
+MlasSetThreadPoolRoutines(
+    MLAS_THREADPOOL_GET_THREAD_COUNT* GetThreadCount,
+    MLAS_THREADPOOL_PARALLEL_FOR* ParallelFor
+    )
+/*++
+
+Routine Description:
+
+    This routine sets the routines used to execute threaded work on a caller
+    supplied thread pool.
+
+Arguments:
+
+    GetThreadCount - Supplies the routine returning the number of threads of
+        the thread pool, excluding the calling thread.
+
+    ParallelFor - Supplies the routine executing the iterations of a threaded
+        routine on the thread pool and the calling thread. It returns once
+        all iterations completed.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasThreadPoolGetThreadCount.store(GetThreadCount);
+    MlasThreadPoolParallelFor.store(ParallelFor);
+}
 
 #if defined(MLAS_USE_WIN32_THREADPOOL)
 
@@ -69,12 +111,74 @@ Return Value:
 
 #endif
 
+int32_t
+MlasGetMaximumThreadCount(
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine returns the maximum number of threads that can be used to
+    execute a threaded operation.
+
+Arguments:
+
+    ThreadPool - Optionally supplies the thread pool to execute the threaded
+        operation. If nullptr, the platform threading model is used.
+
+Return Value:
+
+    Returns the maximum number of threads including the calling thread.
+
+--*/
+{
+    MLAS_THREADPOOL_GET_THREAD_COUNT* GetThreadCount = MlasThreadPoolGetThreadCount.load();
+
+    if (ThreadPool != nullptr && GetThreadCount != nullptr) {
+
+        int32_t MaximumThreadCount = GetThreadCount(ThreadPool) + 1;
+
+        if (MaximumThreadCount > MLAS_MAXIMUM_THREAD_COUNT) {
+            MaximumThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+        }
+
+        return MaximumThreadCount;
+    }
+
+    return MlasPlatform.GetMaximumThreadCount();
+}
+
 void
 MlasExecuteThreaded(
     MLAS_THREADED_ROUTINE ThreadedRoutine,
     void* Context,
-    int32_t Iterations
+    int32_t Iterations,
+    MLAS_THREADPOOL* ThreadPool
     )
+/*++
+
+Routine Description:
+
+    This routine executes the threaded routine for the specified number of
+    iterations.
+
+Arguments:
+
+    ThreadedRoutine - Supplies the routine to execute for each iteration.
+
+    Context - Supplies the context passed to the threaded routine.
+
+    Iterations - Supplies the number of iterations to execute.
+
+    ThreadPool - Optionally supplies the thread pool to execute the
+        iterations. If nullptr, the platform threading model is used.
+
+Return Value:
+
+    None.
+
+--*/
 {
     //
     // Execute the routine directly if only one iteration is specified.
@@ -85,6 +189,18 @@ MlasExecuteThreaded(
         return;
     }
 
+    //
+    // Schedule the threaded iterations using the caller supplied thread pool.
+    // The calling thread participates in the work.
+    //
+
+    MLAS_THREADPOOL_PARALLEL_FOR* ParallelFor = MlasThreadPoolParallelFor.load();
+
+    if (ThreadPool != nullptr && ParallelFor != nullptr) {
+        ParallelFor(ThreadPool, Iterations, ThreadedRoutine, Context);
+        return;
+    }
+
 #if defined(MLAS_USE_WIN32_THREADPOOL)
 
     //
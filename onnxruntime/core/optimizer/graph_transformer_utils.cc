@@ -5,6 +5,7 @@
 #include "core/optimizer/conv_mul_fusion.h"
 #include "core/optimizer/conv_bn_fusion.h"
 #include "core/optimizer/conv_add_fusion.h"
+#include "core/optimizer/nchwc_transformer.h"
 #include "core/optimizer/unsqueeze_elimination.h"
 
 namespace onnxruntime {
@@ -22,6 +23,10 @@ std::vector<std::unique_ptr<RewriteRule>> GenerateRewriteRules(const Transformer
 
     case TransformerLevel::Level2:
       break;
+
+    case TransformerLevel::Level3:
+      break;
+
     default:
       ORT_ENFORCE(false, "Unsupported level" + std::to_string(static_cast<uint32_t>(level)));
   }
@@ -56,6 +61,11 @@ std::vector<TransformerProviderSet> GenerateTransformers(const TransformerLevel&
       transformers.emplace_back(std::make_unique<ConvMulFusion>(), l2_execution_providers);
     } break;
 
+    case TransformerLevel::Level3: {
+      std::vector<std::string> l3_execution_providers = {onnxruntime::kCpuExecutionProvider};
+      transformers.emplace_back(std::make_unique<NchwcTransformer>(), l3_execution_providers);
+    } break;
+
     default:
       ORT_ENFORCE(false, "Unsupported level " + std::to_string(static_cast<uint32_t>(level)));
       break;
@@ -0,0 +1,426 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <deque>
+#include "core/graph/graph_utils.h"
+#include "core/graph/graph_viewer.h"
+#include "core/optimizer/nchwc_transformer.h"
+#include "core/mlas/inc/mlas.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+class NchwcTransformerImpl {
+ public:
+  explicit NchwcTransformerImpl(Graph& graph) noexcept : graph_(graph) {
+    nchwc_type_.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  }
+
+  void Transform(Node& node);
+  void Finalize(bool& modified);
+
+ private:
+  // Tracks the NCHWc version of a NodeArg that was produced by a converted node.
+  struct NchwcArgument {
+    NchwcArgument(Node& output_node, NodeArg* nchwc_arg, size_t original_uses, int64_t channels)
+        : output_node_(output_node),
+          nchwc_arg_(nchwc_arg),
+          starting_original_uses_(original_uses),
+          remaining_original_uses_(original_uses),
+          channels_(channels) {
+    }
+
+    // the node that produces the NCHWc tensor
+    Node& output_node_;
+    NodeArg* nchwc_arg_;
+    // the number of consumers of the original NodeArg, including a graph output
+    const size_t starting_original_uses_;
+    // the number of consumers of the original NodeArg that still need the NCHW tensor
+    size_t remaining_original_uses_;
+    // the number of channels of the original NodeArg
+    int64_t channels_;
+  };
+
+  size_t OriginalUses(const Node& node, int output_index) const;
+  NodeArg* NchwcInput(Node& node, int input_index);
+  void CreateNchwcArgument(Node& node, Node& nchwc_node, int64_t channels);
+  void RemoveOriginalNode(Node& node);
+
+  void TransformConv(Node& node);
+  void TransformPool(Node& node);
+  void TransformAdd(Node& node);
+  void TransformActivation(Node& node);
+
+  Graph& graph_;
+  TypeProto nchwc_type_;
+
+  std::deque<NodeIndex> removed_nodes_;
+
+  // original NodeArg to its NCHWc version, for the outputs of converted nodes
+  std::unordered_map<const NodeArg*, std::unique_ptr<NchwcArgument>> nchwc_args_;
+
+  // original NodeArg to its NCHWc version, for NCHW tensors reordered by a ReorderInput node
+  std::unordered_map<const NodeArg*, NodeArg*> reorder_inputs_;
+};
+
+size_t NchwcTransformerImpl::OriginalUses(const Node& node, int output_index) const {
+  size_t uses = 0;
+  for (auto it = node.OutputEdgesBegin(); it != node.OutputEdgesEnd(); ++it) {
+    if (it->GetSrcArgIndex() == output_index) {
+      uses++;
+    }
+  }
+
+  const NodeArg* output_arg = node.OutputDefs()[output_index];
+  for (const auto* graph_output : graph_.GetOutputs()) {
+    if (graph_output == output_arg) {
+      uses++;
+    }
+  }
+
+  return uses;
+}
+
+// Returns the NCHWc version of an input of the node, inserting a ReorderInput node for a NCHW tensor.
+NodeArg* NchwcTransformerImpl::NchwcInput(Node& node, int input_index) {
+  const NodeArg* input_arg = node.InputDefs()[input_index];
+
+  auto it = nchwc_args_.find(input_arg);
+  if (it != nchwc_args_.end()) {
+    it->second->remaining_original_uses_--;
+    return it->second->nchwc_arg_;
+  }
+
+  auto reorder_it = reorder_inputs_.find(input_arg);
+  if (reorder_it != reorder_inputs_.end()) {
+    return reorder_it->second;
+  }
+
+  NodeArg* nchwc_arg = &graph_.GetOrCreateNodeArg(graph_.GenerateNodeArgName("reorder"), &nchwc_type_);
+  Node& reorder_input_node = graph_.AddNode(graph_.GenerateNodeName("ReorderInput"),
+                                            "ReorderInput",
+                                            "ReorderInput",
+                                            std::vector<NodeArg*>{node.MutableInputDefs()[input_index]},
+                                            std::vector<NodeArg*>{nchwc_arg},
+                                            nullptr,
+                                            kMSNchwcDomain);
+  reorder_input_node.SetExecutionProviderType(kCpuExecutionProvider);
+
+  reorder_inputs_.emplace(input_arg, nchwc_arg);
+  return nchwc_arg;
+}
+
+// Records that the output of the node is now produced in the NCHWc layout by nchwc_node.
+void NchwcTransformerImpl::CreateNchwcArgument(Node& node, Node& nchwc_node, int64_t channels) {
+  const NodeArg* output_arg = node.OutputDefs()[0];
+  nchwc_args_.emplace(output_arg,
+                      std::make_unique<NchwcArgument>(nchwc_node,
+                                                      nchwc_node.MutableOutputDefs()[0],
+                                                      OriginalUses(node, 0),
+                                                      channels));
+}
+
+void NchwcTransformerImpl::RemoveOriginalNode(Node& node) {
+  // the consumers that still need the NCHW tensor are connected to a ReorderOutput node in Finalize
+  graph_utils::RemoveNodeOutputEdges(graph_, node);
+  removed_nodes_.push_front(node.Index());
+}
+
+void NchwcTransformerImpl::TransformConv(Node& node) {
+  auto& input_defs = node.MutableInputDefs();
+
+  // the filter must be a constant so that the filter shape is known
+  const TensorProto* conv_W_tensor_proto = nullptr;
+  if (!graph_.GetInitializedTensor(input_defs[1]->Name(), conv_W_tensor_proto) ||
+      conv_W_tensor_proto->data_type() != TensorProto_DataType_FLOAT ||
+      conv_W_tensor_proto->dims_size() != 4) {
+    return;
+  }
+
+  const int64_t output_channels = conv_W_tensor_proto->dims(0);
+  const int64_t input_channels = conv_W_tensor_proto->dims(1);
+
+  int64_t group_count = 1;
+  const auto* group_attr = graph_utils::GetNodeAttribute(node, "group");
+  if (group_attr != nullptr && group_attr->has_i()) {
+    group_count = group_attr->i();
+  }
+
+  // the NCHWc kernels support a single group or a depthwise convolution
+  if (group_count != 1 && (group_count != output_channels || input_channels != 1)) {
+    return;
+  }
+
+  // a convolution with few input channels, such as the first layer of an image model, is faster in the NCHW
+  // layout than with the input channels padded to the block size
+  if (group_count == 1 && nchwc_args_.find(input_defs[0]) == nchwc_args_.end() &&
+      input_channels < static_cast<int64_t>(MlasNchwcGetBlockSize())) {
+    return;
+  }
+
+  std::vector<NodeArg*> nchwc_input_defs{NchwcInput(node, 0), input_defs[1]};
+  if (input_defs.size() > 2 && input_defs[2]->Exists()) {
+    nchwc_input_defs.push_back(input_defs[2]);
+  }
+
+  NodeArg* nchwc_output_arg = &graph_.GetOrCreateNodeArg(graph_.GenerateNodeArgName(node.OutputDefs()[0]->Name()),
+                                                         &nchwc_type_);
+  Node& nchwc_node = graph_.AddNode(graph_.GenerateNodeName(node.Name()),
+                                    "Conv",
+                                    node.Description(),
+                                    nchwc_input_defs,
+                                    std::vector<NodeArg*>{nchwc_output_arg},
+                                    &node.GetAttributes(),
+                                    kMSNchwcDomain);
+  nchwc_node.SetExecutionProviderType(kCpuExecutionProvider);
+
+  CreateNchwcArgument(node, nchwc_node, output_channels);
+  RemoveOriginalNode(node);
+}
+
+void NchwcTransformerImpl::TransformPool(Node& node) {
+  auto it = nchwc_args_.find(node.InputDefs()[0]);
+  if (it == nchwc_args_.end()) {
+    return;
+  }
+
+  // the NCHWc kernels do not support the optional indices output, the column major storage order, the
+  // ceiling output size or a dilated kernel
+  const auto& output_defs = node.OutputDefs();
+  if (output_defs.size() > 1 && output_defs[1]->Exists()) {
+    return;
+  }
+
+  const auto* storage_order_attr = graph_utils::GetNodeAttribute(node, "storage_order");
+  if (storage_order_attr != nullptr && storage_order_attr->i() != 0) {
+    return;
+  }
+
+  const auto* ceil_mode_attr = graph_utils::GetNodeAttribute(node, "ceil_mode");
+  if (ceil_mode_attr != nullptr && ceil_mode_attr->i() != 0) {
+    return;
+  }
+
+  std::vector<int64_t> dilations;
+  if (graph_utils::GetRepeatedNodeAttributeValues(node, "dilations", dilations) &&
+      std::any_of(dilations.begin(), dilations.end(), [](int64_t dilation) { return dilation != 1; })) {
+    return;
+  }
+
+  std::vector<int64_t> kernel_shape;
+  if (graph_utils::GetRepeatedNodeAttributeValues(node, "kernel_shape", kernel_shape) && kernel_shape.size() != 2) {
+    return;
+  }
+
+  const int64_t channels = it->second->channels_;
+
+  NodeArg* nchwc_output_arg = &graph_.GetOrCreateNodeArg(graph_.GenerateNodeArgName(output_defs[0]->Name()),
+                                                         &nchwc_type_);
+  Node& nchwc_node = graph_.AddNode(graph_.GenerateNodeName(node.Name()),
+                                    node.OpType(),
+                                    node.Description(),
+                                    std::vector<NodeArg*>{NchwcInput(node, 0)},
+                                    std::vector<NodeArg*>{nchwc_output_arg},
+                                    nullptr,
+                                    kMSNchwcDomain);
+  nchwc_node.SetExecutionProviderType(kCpuExecutionProvider);
+
+  // copy the attributes known to the NCHWc schema
+  for (const char* attr_name : {"auto_pad", "kernel_shape", "pads", "strides", "count_include_pad"}) {
+    const auto* attr = graph_utils::GetNodeAttribute(node, attr_name);
+    if (attr != nullptr) {
+      nchwc_node.AddAttribute(attr_name, *attr);
+    }
+  }
+
+  CreateNchwcArgument(node, nchwc_node, channels);
+  RemoveOriginalNode(node);
+}
+
+// Converts an elementwise addition whose inputs are all NCHWc tensors of the same shape. The padding
+// channels of the blocked tensors are added as well, so the operator runs unchanged in the NCHWc layout.
+void NchwcTransformerImpl::TransformAdd(Node& node) {
+  const auto& input_defs = node.InputDefs();
+
+  const TensorShapeProto* shape = nullptr;
+  int64_t channels = 0;
+  for (const auto* input_def : input_defs) {
+    auto it = nchwc_args_.find(input_def);
+    if (it == nchwc_args_.end()) {
+      return;
+    }
+
+    // broadcasting is not supported, so the original shapes must be fully known and identical
+    const auto* input_shape = input_def->Shape();
+    if (input_shape == nullptr || input_shape->dim_size() != 4) {
+      return;
+    }
+    for (const auto& dim : input_shape->dim()) {
+      if (!dim.has_dim_value()) {
+        return;
+      }
+    }
+    if (shape == nullptr) {
+      shape = input_shape;
+      channels = it->second->channels_;
+    } else {
+      for (int i = 0; i < 4; i++) {
+        if (shape->dim(i).dim_value() != input_shape->dim(i).dim_value()) {
+          return;
+        }
+      }
+    }
+  }
+
+  if (shape == nullptr) {
+    return;
+  }
+
+  std::vector<NodeArg*> nchwc_input_defs;
+  for (int i = 0; i < static_cast<int>(input_defs.size()); i++) {
+    nchwc_input_defs.push_back(NchwcInput(node, i));
+  }
+
+  NodeArg* nchwc_output_arg = &graph_.GetOrCreateNodeArg(graph_.GenerateNodeArgName(node.OutputDefs()[0]->Name()),
+                                                         &nchwc_type_);
+  Node& nchwc_node = graph_.AddNode(graph_.GenerateNodeName(node.Name()),
+                                    node.OpType(),
+                                    node.Description(),
+                                    nchwc_input_defs,
+                                    std::vector<NodeArg*>{nchwc_output_arg},
+                                    &node.GetAttributes(),
+                                    node.Domain());
+  nchwc_node.SetExecutionProviderType(kCpuExecutionProvider);
+
+  CreateNchwcArgument(node, nchwc_node, channels);
+  RemoveOriginalNode(node);
+}
+
+// Fuses an activation into the NCHWc convolution that produces its input, otherwise converts the activation to
+// run on the NCHWc tensor. The activations map zero to a finite value, so the padding channels stay finite.
+void NchwcTransformerImpl::TransformActivation(Node& node) {
+  auto it = nchwc_args_.find(node.InputDefs()[0]);
+  if (it == nchwc_args_.end()) {
+    return;
+  }
+
+  auto& nchwc_input = *it->second;
+  Node& output_node = nchwc_input.output_node_;
+
+  if (output_node.OpType() == "Conv" && output_node.Domain() == kMSNchwcDomain &&
+      nchwc_input.starting_original_uses_ == 1 &&
+      graph_utils::GetNodeAttribute(output_node, "activation") == nullptr) {
+    output_node.AddAttribute("activation", node.OpType());
+    if (node.OpType() == "LeakyRelu") {
+      const auto* alpha_attr = graph_utils::GetNodeAttribute(node, "alpha");
+      if (alpha_attr != nullptr) {
+        output_node.AddAttribute("alpha", *alpha_attr);
+      }
+    }
+
+    nchwc_input.remaining_original_uses_--;
+    nchwc_args_.emplace(node.OutputDefs()[0],
+                        std::make_unique<NchwcArgument>(output_node,
+                                                        nchwc_input.nchwc_arg_,
+                                                        OriginalUses(node, 0),
+                                                        nchwc_input.channels_));
+    RemoveOriginalNode(node);
+    return;
+  }
+
+  const int64_t channels = nchwc_input.channels_;
+
+  NodeArg* nchwc_output_arg = &graph_.GetOrCreateNodeArg(graph_.GenerateNodeArgName(node.OutputDefs()[0]->Name()),
+                                                         &nchwc_type_);
+  Node& nchwc_node = graph_.AddNode(graph_.GenerateNodeName(node.Name()),
+                                    node.OpType(),
+                                    node.Description(),
+                                    std::vector<NodeArg*>{NchwcInput(node, 0)},
+                                    std::vector<NodeArg*>{nchwc_output_arg},
+                                    &node.GetAttributes(),
+                                    node.Domain());
+  nchwc_node.SetExecutionProviderType(kCpuExecutionProvider);
+
+  CreateNchwcArgument(node, nchwc_node, channels);
+  RemoveOriginalNode(node);
+}
+
+void NchwcTransformerImpl::Transform(Node& node) {
+  if (node.GetExecutionProviderType() != kCpuExecutionProvider) {
+    return;
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Conv", 1) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "FusedConv", 1, kMSDomain)) {
+    TransformConv(node);
+  } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "MaxPool", 1) ||
+             graph_utils::IsSupportedOptypeVersionAndDomain(node, "MaxPool", 8) ||
+             graph_utils::IsSupportedOptypeVersionAndDomain(node, "MaxPool", 10) ||
+             graph_utils::IsSupportedOptypeVersionAndDomain(node, "AveragePool", 1) ||
+             graph_utils::IsSupportedOptypeVersionAndDomain(node, "AveragePool", 7) ||
+             graph_utils::IsSupportedOptypeVersionAndDomain(node, "AveragePool", 10) ||
+             graph_utils::IsSupportedOptypeVersionAndDomain(node, "GlobalMaxPool", 1) ||
+             graph_utils::IsSupportedOptypeVersionAndDomain(node, "GlobalAveragePool", 1)) {
+    TransformPool(node);
+  } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Add", 7) ||
+             graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sum", 6) ||
+             graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sum", 8)) {
+    TransformAdd(node);
+  } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Relu", 6) ||
+             graph_utils::IsSupportedOptypeVersionAndDomain(node, "LeakyRelu", 6) ||
+             graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sigmoid", 6) ||
+             graph_utils::IsSupportedOptypeVersionAndDomain(node, "Tanh", 6)) {
+    TransformActivation(node);
+  }
+}
+
+void NchwcTransformerImpl::Finalize(bool& modified) {
+  // reorder the NCHWc tensors back to NCHW for the consumers that were not converted and for the graph outputs
+  for (auto& nchwc_arg : nchwc_args_) {
+    const auto& nchwc_input = *nchwc_arg.second;
+    if (nchwc_input.remaining_original_uses_ == 0) {
+      continue;
+    }
+
+    NodeArg* output_arg = graph_.GetNodeArg(nchwc_arg.first->Name());
+    Node& reorder_output_node = graph_.AddNode(graph_.GenerateNodeName("ReorderOutput"),
+                                               "ReorderOutput",
+                                               "ReorderOutput",
+                                               std::vector<NodeArg*>{nchwc_input.nchwc_arg_},
+                                               std::vector<NodeArg*>{output_arg},
+                                               nullptr,
+                                               kMSNchwcDomain);
+    reorder_output_node.AddAttribute("channels", nchwc_input.channels_);
+    reorder_output_node.SetExecutionProviderType(kCpuExecutionProvider);
+  }
+
+  for (auto index : removed_nodes_) {
+    graph_.RemoveNode(index);
+  }
+
+  if (!removed_nodes_.empty()) {
+    modified = true;
+  }
+}
+
+}  // namespace
+
+Status NchwcTransformer::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  NchwcTransformerImpl impl(graph);
+  GraphViewer graph_viewer(graph);
+
+  for (auto index : graph_viewer.GetNodesInTopologicalOrder()) {
+    auto& node = *graph.GetNode(index);
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level));
+    impl.Transform(node);
+  }
+
+  impl.Finalize(modified);
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,21 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+// Transformer that converts convolutions, pooling and the elementwise operators between them to the NCHWc
+// (channel blocked) tensor layout. Reorder nodes are only inserted at the boundaries of the converted regions,
+// so a stack of convolutions runs without converting the layout between layers.
+class NchwcTransformer : public onnxruntime::GraphTransformer {
+ public:
+  NchwcTransformer() noexcept : onnxruntime::GraphTransformer("NchwcTransformer", "Convert to the NCHWc layout") {}
+
+ private:
+  Status ApplyImpl(onnxruntime::Graph& graph, bool& modified, int graph_level) const override;
+};
+
+}  // namespace onnxruntime
@@ -6,6 +6,8 @@
 #include "core/framework/kernel_registry.h"
 #include "contrib_ops/contrib_kernels.h"
 #include "core/framework/compute_capability.h"
+#include "core/common/work_stealing_thread_pool.h"
+#include "core/mlas/inc/mlas.h"
 
 namespace onnxruntime {
 
@@ -608,9 +610,23 @@ static void RegisterCPUKernels(KernelRegistry& kernel_registry) {
   ::onnxruntime::contrib::RegisterContribKernels(kernel_registry);
 }
 
+// MLAS only sees the intra-op thread pool as an opaque type and runs its threaded work on it through these.
+static int32_t MLASCALL MlasThreadPoolGetThreadCount(MLAS_THREADPOOL* thread_pool) {
+  return thread_pool->NumThreads();
+}
+
+static void MLASCALL MlasThreadPoolParallelFor(MLAS_THREADPOOL* thread_pool, int32_t iterations,
+                                               MLAS_THREADED_ROUTINE* threaded_routine, void* context) {
+  thread_pool->ParallelFor(iterations, [threaded_routine, context](int32_t index) {
+    threaded_routine(context, index);
+  });
+}
+
 std::shared_ptr<KernelRegistry> GetCpuKernelRegistry() {
   std::shared_ptr<KernelRegistry> kernel_registry = std::make_shared<KernelRegistry>();
   RegisterCPUKernels(*kernel_registry);
+  // kernels are created from the registry, so MLAS can use their thread pool before any of them runs
+  MlasSetThreadPoolRoutines(MlasThreadPoolGetThreadCount, MlasThreadPoolParallelFor);
   return kernel_registry;
 }
 
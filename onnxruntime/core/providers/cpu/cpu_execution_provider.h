@@ -12,9 +12,10 @@ namespace onnxruntime {
 // Information needed to construct CPU execution providers.
 struct CPUExecutionProviderInfo {
   bool create_arena{true};
+  bool use_arena_thread_caches{false};
 
-  explicit CPUExecutionProviderInfo(bool use_arena)
-      : create_arena(use_arena) {}
+  explicit CPUExecutionProviderInfo(bool use_arena, bool use_thread_caches = false)
+      : create_arena(use_arena), use_arena_thread_caches(use_thread_caches) {}
 
   CPUExecutionProviderInfo() = default;
 };
@@ -29,7 +30,8 @@ class CPUExecutionProvider : public IExecutionProvider {
       : IExecutionProvider{onnxruntime::kCpuExecutionProvider} {
     DeviceAllocatorRegistrationInfo device_info{OrtMemTypeDefault,
                                                 [](int) { return std::make_unique<CPUAllocator>(); },
-                                                std::numeric_limits<size_t>::max()};
+                                                std::numeric_limits<size_t>::max(),
+                                                info.use_arena_thread_caches};
 #ifdef USE_JEMALLOC
     ORT_UNUSED_PARAMETER(info);
     //JEMalloc already has memory pool, so just use device allocator.
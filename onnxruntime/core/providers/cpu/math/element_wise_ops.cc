@@ -10,91 +10,91 @@ ONNX_CPU_OPERATOR_TYPED_KERNEL(
     Add,
     7,
     float,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()).MayInplace(0, 0).MayInplace(1, 0),
     Add<float>);
 
 ONNX_CPU_OPERATOR_TYPED_KERNEL(
     Add,
     7,
     int32_t,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<int32_t>()),
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<int32_t>()).MayInplace(0, 0).MayInplace(1, 0),
     Add<int32_t>);
 
 ONNX_CPU_OPERATOR_TYPED_KERNEL(
     Add,
     7,
     int64_t,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<int64_t>()),
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<int64_t>()).MayInplace(0, 0).MayInplace(1, 0),
     Add<int64_t>);
 
 ONNX_CPU_OPERATOR_TYPED_KERNEL(
     Sub,
     7,
     float,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()).MayInplace(0, 0).MayInplace(1, 0),
     Sub<float>);
 
 ONNX_CPU_OPERATOR_TYPED_KERNEL(
     Sub,
     7,
     int32_t,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<int32_t>()),
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<int32_t>()).MayInplace(0, 0).MayInplace(1, 0),
     Sub<int32_t>);
 
 ONNX_CPU_OPERATOR_TYPED_KERNEL(
     Sub,
     7,
     int64_t,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<int64_t>()),
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<int64_t>()).MayInplace(0, 0).MayInplace(1, 0),
     Sub<int64_t>);
 
 ONNX_CPU_OPERATOR_TYPED_KERNEL(
     Mul,
     7,
     float,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()).MayInplace(0, 0).MayInplace(1, 0),
     Mul<float>);
 
 ONNX_CPU_OPERATOR_TYPED_KERNEL(
     Mul,
     7,
     double,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<double>()),
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<double>()).MayInplace(0, 0).MayInplace(1, 0),
     Mul<double>);
 
 ONNX_CPU_OPERATOR_TYPED_KERNEL(
     Mul,
     7,
     int32_t,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<int32_t>()),
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<int32_t>()).MayInplace(0, 0).MayInplace(1, 0),
     Mul<int32_t>);
 
 ONNX_CPU_OPERATOR_TYPED_KERNEL(
     Mul,
     7,
     int64_t,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<int64_t>()),
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<int64_t>()).MayInplace(0, 0).MayInplace(1, 0),
     Mul<int64_t>);
 
 ONNX_CPU_OPERATOR_TYPED_KERNEL(
     Div,
     7,
     float,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()).MayInplace(0, 0).MayInplace(1, 0),
     Div<float>);
 
 ONNX_CPU_OPERATOR_TYPED_KERNEL(
     Div,
     7,
     int32_t,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<int32_t>()),
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<int32_t>()).MayInplace(0, 0).MayInplace(1, 0),
     Div<int32_t>);
 
 ONNX_CPU_OPERATOR_TYPED_KERNEL(
     Div,
     7,
     int64_t,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<int64_t>()),
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<int64_t>()).MayInplace(0, 0).MayInplace(1, 0),
     Div<int64_t>);
 
 #define REG_ABS_KERNEL(TYPE)                                                       \
@@ -120,63 +120,63 @@ ONNX_CPU_OPERATOR_TYPED_KERNEL(
     Neg,
     6,
     float,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()).MayInplace(0, 0),
     Neg<float>);
 
 ONNX_CPU_OPERATOR_TYPED_KERNEL(
     Neg,
     6,
     int8_t,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<int8_t>()),
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<int8_t>()).MayInplace(0, 0),
     Neg<int8_t>);
 
 ONNX_CPU_OPERATOR_TYPED_KERNEL(
     Neg,
     6,
     int32_t,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<int32_t>()),
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<int32_t>()).MayInplace(0, 0),
     Neg<int32_t>);
 
 ONNX_CPU_OPERATOR_KERNEL(
     Floor,
     6,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()).MayInplace(0, 0),
     Floor<float>);
 
 ONNX_CPU_OPERATOR_KERNEL(
     Ceil,
     6,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()).MayInplace(0, 0),
     Ceil<float>);
 
 ONNX_CPU_OPERATOR_KERNEL(
     Reciprocal,
     6,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()).MayInplace(0, 0),
     Reciprocal<float>);
 
 ONNX_CPU_OPERATOR_KERNEL(
     Sqrt,
     6,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()).MayInplace(0, 0),
     Sqrt<float>);
 
 ONNX_CPU_OPERATOR_KERNEL(
     Pow,
     7,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()).MayInplace(0, 0),
     Pow<float>);
 
 ONNX_CPU_OPERATOR_KERNEL(
     Exp,
     6,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()).MayInplace(0, 0),
     Exp<float>);
 
 ONNX_CPU_OPERATOR_KERNEL(
     Log,
     6,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()).MayInplace(0, 0),
     Log<float>);
 
 ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
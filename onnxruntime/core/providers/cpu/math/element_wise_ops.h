@@ -4,6 +4,7 @@
 #pragma once
 
 #include "core/common/common.h"
+#include "core/common/work_stealing_thread_pool.h"
 #include "core/framework/op_kernel.h"
 #include "core/util/math_cpuonly.h"
 
@@ -349,6 +350,20 @@ struct BroadcastIterator {
     return index;
   }
 
+  // Position the iterator as if AdvanceBy had been called from the start until offset elements had been
+  // consumed. offset must be a multiple of the span size the iterator is advanced by.
+  void SeekTo(size_t offset) {
+    index_ = deltas_[0] * offset;
+    size_t block = 1;  // number of elements per step of the current counter
+    for (size_t counterIndex = 0; counterIndex < counters_.size(); counterIndex++) {
+      size_t steps = offset / block;
+      if (counterIndex > 0)
+        index_ += deltas_[counterIndex] * steps;
+      counters_[counterIndex] = steps % counts_[counterIndex];
+      block *= counts_[counterIndex];
+    }
+  }
+
   void Init(int64_t axis, int64_t largest) {
     ORT_ENFORCE(axis == 1 || axis == largest, "Attempting to broadcast an axis by a dimension other than 1. ", axis, " by ", largest);
 
@@ -504,6 +519,16 @@ struct TBroadcaster {
   ConstEigenVectorMap<T0> NextEigen0() { return ConstEigenVectorMap<T0>(Next0(), span_size_); }
   ConstEigenVectorMap<T1> NextEigen1() { return ConstEigenVectorMap<T1>(Next1(), span_size_); }
 
+  // The [offset, offset + length) part of the next span, used when a span is split across threads
+  ConstEigenVectorMap<T0> NextEigen0(size_t offset, size_t length) { return ConstEigenVectorMap<T0>(Next0() + offset, length); }
+  ConstEigenVectorMap<T1> NextEigen1(size_t offset, size_t length) { return ConstEigenVectorMap<T1>(Next1() + offset, length); }
+
+  // Continue from the span starting at the given output element offset, which must be a multiple of the span size
+  void SeekTo(size_t offset) {
+    broadcaster_.iterator1_.SeekTo(offset);
+    broadcaster_.iterator2_.SeekTo(offset);
+  }
+
  private:
   const T0* Next0() { return input0_ + broadcaster_.iterator1_.AdvanceBy(span_size_); }
   const T1* Next1() { return input1_ + broadcaster_.iterator2_.AdvanceBy(span_size_); }
@@ -604,11 +629,59 @@ void BroadcastLoopSpan(TBroadcaster& bc, Output& output, Input0Scalar input0scal
   }
 }
 
+// Broadcast loop over the output elements [begin, end), with the same function forms as BroadcastLoop.
+// bc must be positioned at the span containing begin. Spans that cross begin or end are passed in part.
+template <typename TBroadcaster, typename TOutput, typename Input0Scalar, typename Input1Scalar, typename General>
+void BroadcastLoopRange(TBroadcaster& bc, TOutput* output, size_t begin, size_t end,
+                        Input0Scalar input0scalar, Input1Scalar input1scalar, General general) {
+  const size_t span_size = bc.GetSpanSize();
+  for (size_t span_begin = begin - begin % span_size; span_begin < end; span_begin += span_size) {
+    const size_t offset = std::max(begin, span_begin) - span_begin;
+    const size_t length = std::min(end, span_begin + span_size) - span_begin - offset;
+    EigenVectorMap<TOutput> output_map(output + span_begin + offset, length);
+    if (bc.IsInput0Scalar())
+      input0scalar(output_map, bc.NextScalar0(), bc.NextEigen1(offset, length));
+    else if (bc.IsInput1Scalar())
+      input1scalar(output_map, bc.NextEigen0(offset, length), bc.NextScalar1());
+    else
+      general(output_map, bc.NextEigen0(offset, length), bc.NextEigen1(offset, length));
+  }
+}
+
+// Minimum number of output elements per task for a broadcast to be split across the intra-op thread pool.
+constexpr int64_t kBroadcastMinElementsPerTask = 32 * 1024;
+
+// Runs the broadcast loop for output, splitting the output elements evenly across thread_pool when it is large
+// enough. The split is by element and not by span, so a single large span (same shapes, or a scalar and a tensor)
+// is parallelized as well as many small ones. Function forms are the same as for BroadcastLoop.
+template <typename TOutput, typename TBroadcaster, typename Input0Scalar, typename Input1Scalar, typename General>
+void ParallelBroadcastLoop(TBroadcaster& bc, Tensor& output, WorkStealingThreadPool* thread_pool,
+                           Input0Scalar input0scalar, Input1Scalar input1scalar, General general) {
+  const int64_t output_size = output.Shape().Size();
+  const int64_t tasks = std::min<int64_t>(WorkStealingThreadPool::DegreeOfParallelism(thread_pool),
+                                          output_size / kBroadcastMinElementsPerTask);
+  if (tasks <= 1) {
+    TBroadcastOutput<TOutput> broadcast_output(bc.GetSpanSize(), output);
+    BroadcastLoop(bc, broadcast_output, input0scalar, input1scalar, general);
+    return;
+  }
+
+  TOutput* output_data = output.template MutableData<TOutput>();
+  const size_t span_size = bc.GetSpanSize();
+  WorkStealingThreadPool::TryParallelFor(thread_pool, static_cast<int32_t>(tasks), [&](int32_t task) {
+    const size_t begin = static_cast<size_t>(output_size * task / tasks);
+    const size_t end = static_cast<size_t>(output_size * (task + 1) / tasks);
+    TBroadcaster task_bc(bc);
+    task_bc.SeekTo(begin - begin % span_size);
+    BroadcastLoopRange(task_bc, output_data, begin, end, input0scalar, input1scalar, general);
+  });
+}
+
 template <typename TInput, typename TOutput, typename Input0Scalar, typename Input1Scalar, typename General>
 Status BroadcastTwo(OpKernelContext& context, Input0Scalar input0scalar, Input1Scalar input1scalar, General general) {
   TBroadcaster<TInput, TInput> bc(*context.Input<Tensor>(0), *context.Input<Tensor>(1));
-  TBroadcastOutput<TOutput> output(bc.GetSpanSize(), *context.Output(0, bc.GetOutputShape()));
-  BroadcastLoop(bc, output, input0scalar, input1scalar, general);
+  Tensor& output = *context.Output(0, bc.GetOutputShape());
+  ParallelBroadcastLoop<TOutput>(bc, output, context.GetOperatorThreadPool(), input0scalar, input1scalar, general);
 
   return Status::OK();
 }
@@ -645,9 +718,7 @@ Status BroadcastVariadic(const Node& node, OpKernelContext& context, Input0Scala
       p_output = tempOutput.get();
     }
 
-    TBroadcastOutput<TOutput> output(bc.GetSpanSize(), *p_output);
-
-    BroadcastLoop(bc, output, input0scalar, input1scalar, general);
+    ParallelBroadcastLoop<TOutput>(bc, *p_output, context.GetOperatorThreadPool(), input0scalar, input1scalar, general);
 
     tempInput = std::move(tempOutput);
   }
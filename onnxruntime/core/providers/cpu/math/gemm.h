@@ -7,6 +7,7 @@
 #include "core/framework/op_kernel.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
+#include "core/mlas/inc/mlas.h"
 #include "gemm_helper.h"
 
 namespace onnxruntime {
@@ -29,6 +30,28 @@ class Gemm : public OpKernel {
     ORT_ENFORCE(info.GetAttr<float>("beta", &beta_).IsOK());
   }
 
+  // packs a constant W into the layout of the MLAS GEMM kernels
+  Status PrePack(const Tensor& tensor, int input_idx, bool& is_packed) override {
+    is_packed = false;
+    if (input_idx != 1 || tensor.Shape().NumDimensions() != 2) {
+      return Status::OK();
+    }
+
+    const size_t K = static_cast<size_t>(trans_B_ != CblasNoTrans ? tensor.Shape()[1] : tensor.Shape()[0]);
+    const size_t N = static_cast<size_t>(trans_B_ != CblasNoTrans ? tensor.Shape()[0] : tensor.Shape()[1]);
+    if (K == 0 || N == 0) {
+      return Status::OK();
+    }
+
+    auto alloc = Info().GetAllocator(0, OrtMemTypeDefault);
+    packed_b_ = BufferUniquePtr(alloc->Alloc(MlasSgemmPackBSize(N, K)), BufferDeleter(alloc));
+    MlasSgemmPackB(trans_B_, N, K, tensor.template Data<T_W>(), static_cast<size_t>(tensor.Shape()[1]),
+                   packed_b_.get());
+    packed_b_source_ = tensor.DataRaw();
+    is_packed = true;
+    return Status::OK();
+  }
+
   Status Compute(OpKernelContext* context) const override {
     const auto X = context->Input<Tensor>(0);
     const auto W = context->Input<Tensor>(1);
@@ -95,18 +118,36 @@ class Gemm : public OpKernel {
     }
 
     // W * x
-    math::Gemm<T_X, CPUMathUtil>(
-        trans_A_,
-        trans_B_,
-        M,
-        N,
-        K,
-        alpha_,
-        X->template Data<T_X>(),
-        W->template Data<T_W>(),
-        beta_,
-        y_data,
-        &CPUMathUtil::Instance());
+    if (packed_b_ && W->DataRaw() == packed_b_source_) {
+      MlasSgemm(
+          trans_A_,
+          static_cast<size_t>(M),
+          static_cast<size_t>(N),
+          static_cast<size_t>(K),
+          alpha_,
+          X->template Data<T_X>(),
+          static_cast<size_t>(trans_A_ != CblasNoTrans ? M : K),
+          packed_b_.get(),
+          beta_,
+          y_data,
+          static_cast<size_t>(N),
+          context->GetOperatorThreadPool());
+    } else {
+      math::Gemm<T_X, CPUMathUtil>(
+          trans_A_,
+          trans_B_,
+          M,
+          N,
+          K,
+          alpha_,
+          X->template Data<T_X>(),
+          W->template Data<T_W>(),
+          beta_,
+          y_data,
+          &CPUMathUtil::Instance(),
+          FLOAT_TYPE,
+          context->GetOperatorThreadPool());
+    }
 
     FuseActivation<T_Y>(activation_, y_data, M * N, leaky_relu_alpha_);
 
@@ -119,6 +160,10 @@ class Gemm : public OpKernel {
   float alpha_;
   float beta_;
 
+  BufferUniquePtr packed_b_;
+  // the constant W that was packed. An initializer that is also a graph input can be overridden by a feed.
+  const void* packed_b_source_ = nullptr;
+
 protected:
   // For fused gemm + activation
   std::string activation_;
@@ -5,6 +5,7 @@
 
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
+#include "core/mlas/inc/mlas.h"
 #include "matmul_helper.h"
 
 namespace onnxruntime {
@@ -75,7 +76,87 @@ Status MatMul<T>::Compute(OpKernelContext* ctx) const {
         right_X->template Data<T>() + helper.RightOffsets()[i],
         /* beta */ 0.0f,
         Y->template MutableData<T>() + helper.OutputOffsets()[i],
-        &CPUMathUtil::Instance());
+        &CPUMathUtil::Instance(),
+        FLOAT_TYPE,
+        ctx->GetOperatorThreadPool());
+  }
+
+  return Status::OK();
+}
+
+Status MatMul<float>::PrePack(const Tensor& tensor, int input_idx, bool& is_packed) {
+  is_packed = false;
+
+  // B can be packed if it is a single matrix, with any number of leading dimensions of 1
+  const auto& b_shape = tensor.Shape();
+  const size_t b_num_dims = b_shape.NumDimensions();
+  if (input_idx != 1 || b_num_dims < 2 || b_shape.SizeToDimension(b_num_dims - 1) != b_shape[b_num_dims - 2]) {
+    return Status::OK();
+  }
+
+  const size_t K = static_cast<size_t>(b_shape[b_num_dims - 2]);
+  const size_t N = static_cast<size_t>(b_shape[b_num_dims - 1]);
+  if (K == 0 || N == 0) {
+    return Status::OK();
+  }
+
+  auto alloc = Info().GetAllocator(0, OrtMemTypeDefault);
+  packed_b_ = BufferUniquePtr(alloc->Alloc(MlasSgemmPackBSize(N, K)), BufferDeleter(alloc));
+  MlasSgemmPackB(CblasNoTrans, N, K, tensor.Data<float>(), N, packed_b_.get());
+  packed_b_source_ = tensor.DataRaw();
+  is_packed = true;
+  return Status::OK();
+}
+
+Status MatMul<float>::Compute(OpKernelContext* ctx) const {
+  const Tensor* left_X = ctx->Input<Tensor>(0);
+  const Tensor* right_X = ctx->Input<Tensor>(1);
+
+  MatMulComputeHelper helper;
+  ORT_RETURN_IF_ERROR(helper.Compute(left_X->Shape(), right_X->Shape()));
+
+  Tensor* Y = ctx->Output(0, helper.OutputShape());
+
+  // nothing to compute for empty matrices
+  if (helper.M() == 0 || helper.N() == 0) {
+    return Status::OK();
+  }
+
+  const bool use_packed_b = packed_b_ && right_X->DataRaw() == packed_b_source_;
+
+  size_t max_len = helper.OutputOffsets().size();
+  for (size_t i = 0; i < max_len; i++) {
+    if (use_packed_b) {
+      // B is a single matrix, so all the right offsets are 0
+      MlasSgemm(
+          CblasNoTrans,
+          static_cast<size_t>(helper.M()),
+          static_cast<size_t>(helper.N()),
+          static_cast<size_t>(helper.K()),
+          /* alpha */ 1.0f,
+          left_X->Data<float>() + helper.LeftOffsets()[i],
+          static_cast<size_t>(helper.K()),
+          packed_b_.get(),
+          /* beta */ 0.0f,
+          Y->MutableData<float>() + helper.OutputOffsets()[i],
+          static_cast<size_t>(helper.N()),
+          ctx->GetOperatorThreadPool());
+    } else {
+      math::Gemm<float, CPUMathUtil>(
+          CblasNoTrans,
+          CblasNoTrans,
+          static_cast<int>(helper.M()),
+          static_cast<int>(helper.N()),
+          static_cast<int>(helper.K()),
+          /* alpha */ 1.0f,
+          left_X->Data<float>() + helper.LeftOffsets()[i],
+          right_X->Data<float>() + helper.RightOffsets()[i],
+          /* beta */ 0.0f,
+          Y->MutableData<float>() + helper.OutputOffsets()[i],
+          &CPUMathUtil::Instance(),
+          FLOAT_TYPE,
+          ctx->GetOperatorThreadPool());
+    }
   }
 
   return Status::OK();
@@ -18,4 +18,22 @@ class MatMul final : public OpKernel {
   Status Compute(OpKernelContext* context) const override;
 };
 
+template <>
+class MatMul<float> final : public OpKernel {
+ public:
+  MatMul(const OpKernelInfo& info)
+      : OpKernel(info) {
+  }
+
+  // packs a constant B into the layout of the MLAS GEMM kernels
+  Status PrePack(const Tensor& tensor, int input_idx, bool& is_packed) override;
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  BufferUniquePtr packed_b_;
+  // the constant B that was packed. An initializer that is also a graph input can be overridden by a feed.
+  const void* packed_b_source_ = nullptr;
+};
+
 }  // namespace onnxruntime
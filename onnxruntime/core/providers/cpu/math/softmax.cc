@@ -42,7 +42,7 @@ Status Softmax<float>::Compute(OpKernelContext* ctx) const {
 ONNX_CPU_OPERATOR_KERNEL(
     Softmax,
     1,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()).MayInplace(0, 0),
     Softmax<float>);
 
 }  // namespace onnxruntime
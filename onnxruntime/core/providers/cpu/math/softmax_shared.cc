@@ -61,8 +61,11 @@ common::Status SoftmaxCPU(const int64_t N,
 
   math::RowwiseMax<float, CPUMathUtil>(n, d, Xdata, rowmax, nullptr);
 
-  // Put the intermediate result X - max(X) into Y by first copying X to Y, and then subtracting max from each entry
-  gsl::copy(gsl::make_span(Xdata, nd), gsl::make_span(Ydata, nd));
+  // Put the intermediate result X - max(X) into Y by first copying X to Y, and then subtracting max from each entry.
+  // Softmax may run in place, in which case X is already in Y.
+  if (Xdata != Ydata) {
+    gsl::copy(gsl::make_span(Xdata, nd), gsl::make_span(Ydata, nd));
+  }
 
   math::Gemm<float, CPUMathUtil>(CblasNoTrans, CblasNoTrans, n, d, 1, -1, rowmax, sum_multiplier, 1, Ydata, nullptr);
 
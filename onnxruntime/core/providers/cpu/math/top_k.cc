@@ -20,8 +20,9 @@
 #include "core/common/exceptions.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/tensor.h"
-#include "core/util/math_cpuonly.h"
-#include <queue>
+#include "core/common/work_stealing_thread_pool.h"
+#include <algorithm>
+#include <utility>
 using namespace std;
 namespace onnxruntime {
 
@@ -44,16 +45,88 @@ static int64_t SizeFromDim(size_t k, const vector<int64_t>& dims) {
   return r;
 }
 
-template <typename T>
-struct ValueCmp {
-  bool operator()(
-      const pair<T, int64_t>& lhs,
-      const pair<T, int64_t>& rhs) {
-    return (
-        lhs.first > rhs.first ||
-        (lhs.first == rhs.first && lhs.second < rhs.second));
+// k up to this size is selected by insertion into a small sorted array. Most values are rejected by a single
+// comparison with the current k-th largest value, so this is a linear scan of the input.
+constexpr int64_t kTopKInsertionMax = 16;
+
+// The selection is only split across the thread pool when each task has at least this many inputs.
+constexpr int64_t kTopKMinElementsPerTask = 16384;
+
+// The order of the outputs: descending values, ties in ascending index. NaN is ordered after all other values,
+// which keeps this a strict weak ordering for std::nth_element and std::sort.
+static inline bool TopKPrecedes(float lhs, int64_t lhs_index, float rhs, int64_t rhs_index) {
+  if (lhs > rhs) return true;
+  if (lhs < rhs) return false;
+  const bool lhs_nan = std::isnan(lhs);
+  const bool rhs_nan = std::isnan(rhs);
+  if (lhs_nan != rhs_nan) return rhs_nan;
+  return lhs_index < rhs_index;
+}
+
+// Selects the k largest of x[0], x[stride], ... x[(n - 1) * stride] and writes them with their positions to
+// values and indices, out_stride elements apart, in the order of TopKPrecedes. Requires k <= n.
+static void SelectTopK(const float* x, int64_t stride, int64_t n, int64_t k, vector<pair<float, int64_t>>& candidates,
+                       float* values, int64_t* indices, int64_t out_stride) {
+  if (k <= kTopKInsertionMax) {
+    float top_values[kTopKInsertionMax];
+    int64_t top_indices[kTopKInsertionMax];
+    int64_t count = 0;
+    for (int64_t l = 0; l < n; ++l) {
+      const float value = x[l * stride];
+      if (count == k) {
+        if (!TopKPrecedes(value, l, top_values[k - 1], top_indices[k - 1])) {
+          continue;
+        }
+        --count;
+      }
+      int64_t pos = count++;
+      for (; pos > 0 && TopKPrecedes(value, l, top_values[pos - 1], top_indices[pos - 1]); --pos) {
+        top_values[pos] = top_values[pos - 1];
+        top_indices[pos] = top_indices[pos - 1];
+      }
+      top_values[pos] = value;
+      top_indices[pos] = l;
+    }
+    for (int64_t l = 0; l < k; ++l) {
+      values[l * out_stride] = top_values[l];
+      indices[l * out_stride] = top_indices[l];
+    }
+    return;
+  }
+
+  // Larger k keeps candidates in a buffer. When it is full, it is cut down to the k best and the k-th of them
+  // becomes the threshold a later value has to beat to be added, so most values only cost one comparison.
+  auto precedes = [](const pair<float, int64_t>& lhs, const pair<float, int64_t>& rhs) {
+    return TopKPrecedes(lhs.first, lhs.second, rhs.first, rhs.second);
+  };
+  const size_t capacity = static_cast<size_t>(std::max<int64_t>(4 * k, 1024));
+  candidates.clear();
+  candidates.reserve(capacity);
+  bool has_threshold = false;
+  pair<float, int64_t> threshold;
+  for (int64_t l = 0; l < n; ++l) {
+    const float value = x[l * stride];
+    if (has_threshold && !TopKPrecedes(value, l, threshold.first, threshold.second)) {
+      continue;
+    }
+    candidates.emplace_back(value, l);
+    if (candidates.size() == capacity) {
+      std::nth_element(candidates.begin(), candidates.begin() + (k - 1), candidates.end(), precedes);
+      candidates.resize(k);
+      threshold = candidates[k - 1];
+      has_threshold = true;
+    }
+  }
+
+  if (static_cast<int64_t>(candidates.size()) > k) {
+    std::nth_element(candidates.begin(), candidates.begin() + (k - 1), candidates.end(), precedes);
+  }
+  std::sort(candidates.begin(), candidates.begin() + k, precedes);
+  for (int64_t l = 0; l < k; ++l) {
+    values[l * out_stride] = candidates[l].first;
+    indices[l * out_stride] = candidates[l].second;
   }
-};
+}
 
 // Core TopK implementation
 Status TopKImpl(OpKernelContext* p_op_kernel_context, const Tensor* X, const int axis, const unsigned k) {
@@ -68,11 +141,7 @@ Status TopKImpl(OpKernelContext* p_op_kernel_context, const Tensor* X, const int
   }
 
   const int64_t rows = SizeToDim(axis_parsed, in_dims);
-  const int64_t cols = X->Shape().Size() / rows;
-  auto input_map = ConstEigenMatrixMapRowMajor<float>(
-      static_cast<const float*>(X->template Data<float>()),
-      rows,
-      cols);
+  const int64_t cols = SizeFromDim(axis_parsed, in_dims);
 
   // Resize output tensors to be the same shape as the input except
   // for the specified dimension ((i.e.) axis_parsed), which will be of size k. E.x. for an input tensor
@@ -82,45 +151,80 @@ Status TopKImpl(OpKernelContext* p_op_kernel_context, const Tensor* X, const int
   auto* Values = p_op_kernel_context->Output(0, output_linear_shape);
   auto* Indices = p_op_kernel_context->Output(1, output_linear_shape);
 
-  // Use Eigen maps to allow indexing into the 2d tensors like Values_map(i,j)
+  const float* X_data = X->template Data<float>();
+  float* values_data = Values->template MutableData<float>();
+  int64_t* indices_data = Indices->template MutableData<int64_t>();
   const int64_t reduced_cols = SizeFromDim(axis_parsed, output_linear_shape);
-  auto Values_map = EigenMatrixMapRowMajor<float>(
-      Values->template MutableData<float>(), rows, reduced_cols);
-  auto Indices_map = EigenMatrixMapRowMajor<int64_t>(
-      Indices->template MutableData<int64_t>(), rows, reduced_cols);
 
-  // This is basically the number of elements within each of the "k" rows
+  // Each (row, j) pair is an independent selection over the axis, whose elements are block_slice apart.
   const int64_t block_slice = reduced_cols / k;
-  // Sort preserving Indices
-  for (int64_t i = 0; i < rows; ++i) {
-    for (int64_t j = 0; j < block_slice; ++j) {
-      // Build a min-heap, the heap element is pair of (value, idx)
-      // the top of the heap is the smallest value
-      priority_queue<
-          pair<float, int64_t>,
-          vector<pair<float, int64_t>>,
-          ValueCmp<float>>
-          min_heap;
-      // Maintain the size of heap to be less or equal to k_, so the
-      // heap will hold the k largest Values
-      for (int64_t l = 0; l < in_dims[axis_parsed]; ++l) {
-        const auto value = input_map(i, l * block_slice + j);
-        if (min_heap.size() < k || value > min_heap.top().first) {
-          min_heap.push({value, l});
-        }
-        if (min_heap.size() > k) {
-          min_heap.pop();
+  const int64_t axis_dim = in_dims[axis_parsed];
+  const int64_t slices = rows * block_slice;
+  if (slices == 0) {
+    // a dimension other than the axis is 0, so the outputs are empty too
+    return Status::OK();
+  }
+
+  auto slice_input = [&](int64_t slice) {
+    return X_data + (slice / block_slice) * cols + slice % block_slice;
+  };
+  auto slice_output_offset = [&](int64_t slice) {
+    return (slice / block_slice) * reduced_cols + slice % block_slice;
+  };
+
+  WorkStealingThreadPool* thread_pool = p_op_kernel_context->GetOperatorThreadPool();
+  const int64_t degree = WorkStealingThreadPool::DegreeOfParallelism(thread_pool);
+
+  // With fewer slices than threads, wide slices are split into chunks. The candidates of each chunk are
+  // kept in chunk order, so selecting from them by position breaks ties by the original index.
+  const int64_t chunks = std::min(std::min(degree / slices, axis_dim / kTopKMinElementsPerTask),
+                                  axis_dim / static_cast<int64_t>(k));
+  if (chunks > 1) {
+    vector<float> candidate_values(chunks * k);
+    vector<int64_t> candidate_indices(chunks * k);
+    vector<pair<float, int64_t>> candidates;
+    for (int64_t slice = 0; slice < slices; ++slice) {
+      const float* x = slice_input(slice);
+      WorkStealingThreadPool::TryParallelFor(thread_pool, static_cast<int32_t>(chunks), [&](int32_t chunk) {
+        const int64_t begin = axis_dim * chunk / chunks;
+        const int64_t end = axis_dim * (chunk + 1) / chunks;
+        vector<pair<float, int64_t>> chunk_candidates;
+        float* chunk_values = candidate_values.data() + chunk * k;
+        int64_t* chunk_indices = candidate_indices.data() + chunk * k;
+        SelectTopK(x + begin * block_slice, block_slice, end - begin, k, chunk_candidates,
+                   chunk_values, chunk_indices, 1);
+        for (unsigned l = 0; l < k; ++l) {
+          chunk_indices[l] += begin;
         }
-      }
-      // Extract these k elements and place them in the results placeholder
-      for (int64_t l = 0; l < k; ++l) {
-        auto& pqElem = min_heap.top();
-        auto col_index = (k - l - 1) * block_slice + j;
-        Values_map(i, col_index) = pqElem.first;
-        Indices_map(i, col_index) = pqElem.second;
-        min_heap.pop();
+      });
+
+      const int64_t offset = slice_output_offset(slice);
+      SelectTopK(candidate_values.data(), 1, chunks * k, k, candidates,
+                 values_data + offset, indices_data + offset, block_slice);
+      for (unsigned l = 0; l < k; ++l) {
+        int64_t& index = indices_data[offset + l * block_slice];
+        index = candidate_indices[index];
       }
     }
+    return Status::OK();
+  }
+
+  const int64_t tasks = std::min(std::min(degree, slices), slices * axis_dim / kTopKMinElementsPerTask);
+  auto select_slices = [&](int64_t begin, int64_t end) {
+    vector<pair<float, int64_t>> candidates;
+    for (int64_t slice = begin; slice < end; ++slice) {
+      const int64_t offset = slice_output_offset(slice);
+      SelectTopK(slice_input(slice), block_slice, axis_dim, k, candidates,
+                 values_data + offset, indices_data + offset, block_slice);
+    }
+  };
+
+  if (tasks <= 1) {
+    select_slices(0, slices);
+  } else {
+    WorkStealingThreadPool::TryParallelFor(thread_pool, static_cast<int32_t>(tasks), [&](int32_t task) {
+      select_slices(slices * task / tasks, slices * (task + 1) / tasks);
+    });
   }
 
   return Status::OK();
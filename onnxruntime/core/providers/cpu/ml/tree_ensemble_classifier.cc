@@ -225,21 +225,6 @@ void TreeEnsembleClassifier<T>::Initialize() {
     else
       return std::get<1>(t1) < std::get<1>(t2);
   });
-  // make an index so we can find the leafnode data quickly when evaluating
-  int64_t field0 = -1;
-  int64_t field1 = -1;
-  for (size_t i = 0, end = leafnodedata_.size(); i < end; ++i) {
-    int64_t id0 = std::get<0>(leafnodedata_[i]);
-    int64_t id1 = std::get<1>(leafnodedata_[i]);
-    if (id0 != field0 || id1 != field1) {
-      int64_t id = id0 * kOffset_ + id1;
-      int64_t position = static_cast<int64_t>(i);
-      auto p3 = std::make_pair(id, position);
-      leafdata_map_.insert(p3);
-      field0 = id;
-      field1 = position;
-    }
-  }
 
   // treenode ids, some are roots_, and roots_ have no parents
   std::unordered_map<int64_t, int64_t> parents;  // holds count of all who point to you
@@ -291,6 +276,10 @@ void TreeEnsembleClassifier<T>::Initialize() {
   ORT_ENFORCE(base_values_.empty() ||
               base_values_.size() == static_cast<size_t>(class_count_) ||
               base_values_.size() == weights_classes_.size());
+
+  compiled_trees_ = std::make_unique<CompiledTreeEnsemble>(
+      nodes_treeids_, nodes_nodeids_, nodes_featureids_, nodes_values_, nodes_modes_,
+      nodes_truenodeids_, nodes_falsenodeids_, missing_tracks_true_, leafnodedata_, roots_);
 }
 
 template <typename T>
@@ -310,31 +299,37 @@ common::Status TreeEnsembleClassifier<T>::Compute(OpKernelContext* context) cons
   int64_t zindex = 0;
   const T* x_data = X.template Data<T>();
 
-  // for each class
+  // Scores of every class for every row, and whether the class has a score for the row at all. Classes without
+  // a base value or a vote are left out of the output when not all classes have weights.
+  const int64_t num_ids = std::max({class_count_, static_cast<int64_t>(base_values_.size()),
+                                    compiled_trees_->IdCount()});
+  std::vector<float> classes(N * num_ids, 0.f);
+  std::vector<unsigned char> has_class(N * num_ids, 0);
+  for (int64_t i = 0; i < N; ++i) {
+    // fill in base values, this might be empty but that is ok
+    for (size_t k = 0, end = base_values_.size(); k < end; ++k) {
+      classes[i * num_ids + k] = base_values_[k];
+      has_class[i * num_ids + k] = 1;
+    }
+  }
+  compiled_trees_->Evaluate(x_data, N, stride, num_ids, classes.data(), has_class.data(),
+                            context->GetOperatorThreadPool());
+
   std::vector<float> scores;
   scores.reserve(class_count_);
   for (int64_t i = 0; i < N; ++i) {
     scores.clear();
-    int64_t current_weight_0 = i * stride;
-    std::map<int64_t, float> classes;
-    // fill in base values, this might be empty but that is ok
-    for (int64_t k = 0, end = static_cast<int64_t>(base_values_.size()); k < end; ++k) {
-      auto p1 = std::make_pair<int64_t&, const float&>(k, base_values_[k]);
-      classes.insert(p1);
-    }
-    // walk each tree from its root
-    for (size_t j = 0, end = roots_.size(); j < end; ++j) {
-      ORT_RETURN_IF_ERROR(ProcessTreeNode(classes, roots_[j], x_data, current_weight_0));
-    }
+    const float* row_classes = classes.data() + i * num_ids;
+    unsigned char* row_has_class = has_class.data() + i * num_ids;
     float maxweight = 0.f;
     int64_t maxclass = -1;
     // write top class
     int write_additional_scores = -1;
     if (class_count_ > 2) {
-      for (auto& classe : classes) {
-        if (maxclass == -1 || classe.second > maxweight) {
-          maxclass = classe.first;
-          maxweight = classe.second;
+      for (int64_t k = 0; k < num_ids; ++k) {
+        if (row_has_class[k] && (maxclass == -1 || row_classes[k] > maxweight)) {
+          maxclass = k;
+          maxweight = row_classes[k];
         }
       }
       if (using_strings_) {
@@ -344,7 +339,11 @@ common::Status TreeEnsembleClassifier<T>::Compute(OpKernelContext* context) cons
       }
     } else  // binary case
     {
-      maxweight = classes.size() > 0 ? classes[0] : 0.f;  // only 1 class
+      // only 1 class. if any class has a score, class 0 is reported even if it has no score itself.
+      if (std::any_of(row_has_class, row_has_class + num_ids, [](unsigned char has) { return has != 0; })) {
+        maxweight = row_classes[0];
+        row_has_class[0] = 1;
+      }
       if (using_strings_) {
         auto* y_data = Y->template MutableData<std::string>();
         if (classlabels_strings_.size() == 2 &&
@@ -412,16 +411,13 @@ common::Status TreeEnsembleClassifier<T>::Compute(OpKernelContext* context) cons
     // for example a 10 class case where we only found 2 classes in the leaves
     if (weights_classes_.size() == static_cast<size_t>(class_count_)) {
       for (int64_t k = 0; k < class_count_; ++k) {
-        auto it_classes = classes.find(k);
-        if (it_classes != classes.end()) {
-          scores.push_back(it_classes->second);
-        } else {
-          scores.push_back(0.f);
-        }
+        scores.push_back(row_has_class[k] ? row_classes[k] : 0.f);
       }
     } else {
-      for (auto& classe : classes) {
-        scores.push_back(classe.second);
+      for (int64_t k = 0; k < num_ids; ++k) {
+        if (row_has_class[k]) {
+          scores.push_back(row_classes[k]);
+        }
       }
     }
     write_scores(scores, post_transform_, zindex, Z, write_additional_scores);
@@ -430,84 +426,5 @@ common::Status TreeEnsembleClassifier<T>::Compute(OpKernelContext* context) cons
   return Status::OK();
 }
 
-template <typename T>
-common::Status TreeEnsembleClassifier<T>::ProcessTreeNode(std::map<int64_t, float>& classes,
-                                                          int64_t treeindex,
-                                                          const T* x_data,
-                                                          int64_t feature_base) const {
-  // walk down tree to the leaf
-  NODE_MODE mode = static_cast<NODE_MODE>(nodes_modes_[treeindex]);
-  int64_t loopcount = 0;
-  int64_t root = treeindex;
-  while (mode != NODE_MODE::LEAF) {
-    T val = x_data[feature_base + nodes_featureids_[treeindex]];
-    bool tracktrue = true;
-    if (missing_tracks_true_.size() != nodes_truenodeids_.size()) {
-      tracktrue = false;
-    } else {
-      tracktrue = missing_tracks_true_[treeindex] && std::isnan(static_cast<float>(val));
-    }
-    float threshold = nodes_values_[treeindex];
-    switch (mode) {
-      case NODE_MODE::BRANCH_LEQ:
-        treeindex = val <= threshold || tracktrue ? nodes_truenodeids_[treeindex] : nodes_falsenodeids_[treeindex];
-        break;
-      case NODE_MODE::BRANCH_LT:
-        treeindex = val < threshold || tracktrue ? nodes_truenodeids_[treeindex] : nodes_falsenodeids_[treeindex];
-        break;
-      case NODE_MODE::BRANCH_GTE:
-        treeindex = val >= threshold || tracktrue ? nodes_truenodeids_[treeindex] : nodes_falsenodeids_[treeindex];
-        break;
-      case NODE_MODE::BRANCH_GT:
-        treeindex = val > threshold || tracktrue ? nodes_truenodeids_[treeindex] : nodes_falsenodeids_[treeindex];
-        break;
-      case NODE_MODE::BRANCH_EQ:
-        treeindex = val == threshold || tracktrue ? nodes_truenodeids_[treeindex] : nodes_falsenodeids_[treeindex];
-        break;
-      case NODE_MODE::BRANCH_NEQ:
-        treeindex = val != threshold || tracktrue ? nodes_truenodeids_[treeindex] : nodes_falsenodeids_[treeindex];
-        break;
-      default: {
-        std::ostringstream err_msg;
-        err_msg << "Invalid mode of value: " << static_cast<std::underlying_type<NODE_MODE>::type>(mode);
-        return Status(ONNXRUNTIME, INVALID_ARGUMENT, err_msg.str());
-      }
-    }
-    ORT_ENFORCE(treeindex >= 0);
-    treeindex = treeindex + root;
-    mode = static_cast<NODE_MODE>(nodes_modes_[treeindex]);
-    loopcount++;
-    if (loopcount > kMaxTreeDepth_) break;
-  }
-  // should be at leaf
-  int64_t id = nodes_treeids_[treeindex] * kOffset_ + nodes_nodeids_[treeindex];
-  auto it_lp = leafdata_map_.find(id);
-  if (it_lp == leafdata_map_.end()) {  // if not found, simply return
-    return Status::OK();
-  }
-  int64_t index = it_lp->second;
-  int64_t treeid = std::get<0>(leafnodedata_[index]);
-  int64_t nodeid = std::get<1>(leafnodedata_[index]);
-  while (treeid == nodes_treeids_[treeindex] && nodeid == nodes_nodeids_[treeindex]) {
-    int64_t classid = std::get<2>(leafnodedata_[index]);
-    float weight = std::get<3>(leafnodedata_[index]);
-    std::map<int64_t, float>::iterator it_classes;
-    it_classes = classes.find(classid);
-    if (it_classes != classes.end()) {
-      it_classes->second += weight;
-    } else {
-      auto p1 = std::make_pair(classid, weight);
-      classes.insert(p1);
-    }
-    ++index;
-    // some tree node will be last
-    if (index >= static_cast<int64_t>(leafnodedata_.size())) {
-      break;
-    }
-    treeid = std::get<0>(leafnodedata_[index]);
-    nodeid = std::get<1>(leafnodedata_[index]);
-  }
-  return Status::OK();
-}
 }  // namespace ml
 }  // namespace onnxruntime
@@ -0,0 +1,96 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cpu/ml/tree_ensemble_common.h"
+
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+
+namespace onnxruntime {
+namespace ml {
+
+CompiledTreeEnsemble::CompiledTreeEnsemble(const std::vector<int64_t>& nodes_treeids,
+                                           const std::vector<int64_t>& nodes_nodeids,
+                                           const std::vector<int64_t>& nodes_featureids,
+                                           const std::vector<float>& nodes_values,
+                                           const std::vector<NODE_MODE>& nodes_modes,
+                                           const std::vector<int64_t>& nodes_truenodeids,
+                                           const std::vector<int64_t>& nodes_falsenodeids,
+                                           const std::vector<int64_t>& missing_tracks_true,
+                                           const std::vector<std::tuple<int64_t, int64_t, int64_t, float>>& leaf_weights,
+                                           const std::vector<int64_t>& roots) {
+  const int64_t num_nodes = static_cast<int64_t>(nodes_treeids.size());
+  ORT_ENFORCE(num_nodes < std::numeric_limits<int32_t>::max() &&
+                  leaf_weights.size() < static_cast<size_t>(std::numeric_limits<int32_t>::max()),
+              "Tree ensemble is too large.");
+  const bool use_missing_tracks_true = missing_tracks_true.size() == nodes_truenodeids.size();
+
+  auto weights_less = [](const std::tuple<int64_t, int64_t, int64_t, float>& weight,
+                         const std::pair<int64_t, int64_t>& id) {
+    return std::get<0>(weight) < id.first || (std::get<0>(weight) == id.first && std::get<1>(weight) < id.second);
+  };
+
+  // Nodes are compiled tree by tree in the order they are reached from the root. Child node ids are relative to
+  // the first node of the tree, and the root is that first node, so the child of a node is at its id plus the
+  // index of the root.
+  std::unordered_map<int64_t, int32_t> compiled_index;  // node index -> index in nodes_, for the current tree
+  std::vector<int64_t> pending;                         // node indices that still need their children resolved
+
+  for (int64_t root : roots) {
+    compiled_index.clear();
+
+    auto get_compiled_index = [&](int64_t index) {
+      ORT_ENFORCE(index >= 0 && index < num_nodes, "Tree node index ", index, " is out of range.");
+      auto it = compiled_index.find(index);
+      if (it != compiled_index.end()) {
+        return it->second;
+      }
+
+      Node node;
+      node.feature_id = nodes_featureids[index];
+      node.value = nodes_values[index];
+      node.mode = nodes_modes[index];
+      node.missing_tracks_true = use_missing_tracks_true && missing_tracks_true[index] != 0;
+      node.true_node = node.false_node = -1;
+
+      // the weights this node votes with, if any
+      node.weights_begin = static_cast<int32_t>(weights_.size());
+      auto range_begin = std::lower_bound(leaf_weights.begin(), leaf_weights.end(),
+                                          std::make_pair(nodes_treeids[index], nodes_nodeids[index]), weights_less);
+      for (auto w = range_begin; w != leaf_weights.end() &&
+                                 std::get<0>(*w) == nodes_treeids[index] &&
+                                 std::get<1>(*w) == nodes_nodeids[index];
+           ++w) {
+        ORT_ENFORCE(std::get<2>(*w) >= 0, "Negative class or target id ", std::get<2>(*w));
+        weights_.push_back(Weight{std::get<2>(*w), std::get<3>(*w)});
+        id_count_ = std::max(id_count_, std::get<2>(*w) + 1);
+      }
+      node.weights_end = static_cast<int32_t>(weights_.size());
+
+      const int32_t compiled = static_cast<int32_t>(nodes_.size());
+      nodes_.push_back(node);
+      compiled_index[index] = compiled;
+      if (node.mode != NODE_MODE::LEAF) {
+        pending.push_back(index);
+      }
+      return compiled;
+    };
+
+    roots_.push_back(get_compiled_index(root));
+    while (!pending.empty()) {
+      const int64_t index = pending.back();
+      pending.pop_back();
+      ORT_ENFORCE(nodes_truenodeids[index] >= 0 && nodes_falsenodeids[index] >= 0,
+                  "Tree node ", index, " has a child with a negative node id.");
+      const int32_t compiled = compiled_index[index];
+      const int32_t true_node = get_compiled_index(nodes_truenodeids[index] + root);
+      const int32_t false_node = get_compiled_index(nodes_falsenodeids[index] + root);
+      nodes_[compiled].true_node = true_node;
+      nodes_[compiled].false_node = false_node;
+    }
+  }
+}
+
+}  // namespace ml
+}  // namespace onnxruntime
@@ -0,0 +1,202 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include "core/common/common.h"
+#include "core/common/work_stealing_thread_pool.h"
+#include "ml_common.h"
+
+namespace onnxruntime {
+namespace ml {
+
+/**
+Tree ensemble compiled for evaluation, shared by TreeEnsembleClassifier and TreeEnsembleRegressor.
+
+The nodes of all trees are stored in one contiguous array of structs with the child links resolved to indices
+into that array, and the weights each node votes with are stored in one array addressed by a range per node.
+Walking a tree therefore touches a single array and needs no map lookups.
+
+Rows are evaluated in blocks, applying each tree to every row of the block before moving on to the next tree so
+the nodes of a tree stay in cache. Work is split over rows, or over trees when there are too few rows to keep the
+thread pool busy.
+*/
+class CompiledTreeEnsemble {
+ public:
+  /**
+  The node attributes are those of the tree ensemble operators after the node ids have been made relative to the
+  first node id of each tree. roots holds the index of the root node of each tree.
+  leaf_weights holds (tree id, node id, class or target id, weight) tuples sorted by tree id and node id.
+  */
+  CompiledTreeEnsemble(const std::vector<int64_t>& nodes_treeids,
+                       const std::vector<int64_t>& nodes_nodeids,
+                       const std::vector<int64_t>& nodes_featureids,
+                       const std::vector<float>& nodes_values,
+                       const std::vector<NODE_MODE>& nodes_modes,
+                       const std::vector<int64_t>& nodes_truenodeids,
+                       const std::vector<int64_t>& nodes_falsenodeids,
+                       const std::vector<int64_t>& missing_tracks_true,
+                       const std::vector<std::tuple<int64_t, int64_t, int64_t, float>>& leaf_weights,
+                       const std::vector<int64_t>& roots);
+
+  size_t NumTrees() const { return roots_.size(); }
+
+  // One more than the largest class or target id a node votes for.
+  int64_t IdCount() const { return id_count_; }
+
+  /**
+  Evaluate all trees for the N rows of x, row i starting at x + i * stride.
+  The weights of the leaves each row reaches are added, in tree order, to the num_ids scores of that row in
+  scores, and the has_score flag of every id that received a weight is set. num_ids must be at least IdCount().
+  */
+  template <typename T>
+  void Evaluate(const T* x, int64_t N, int64_t stride, int64_t num_ids,
+                float* scores, unsigned char* has_score, WorkStealingThreadPool* thread_pool) const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(CompiledTreeEnsemble);
+
+  struct Node {
+    int64_t feature_id;
+    float value;
+    NODE_MODE mode;
+    bool missing_tracks_true;
+    int32_t true_node;
+    int32_t false_node;
+    int32_t weights_begin;
+    int32_t weights_end;
+  };
+
+  struct Weight {
+    int64_t id;
+    float value;
+  };
+
+  template <typename T>
+  const Node& FindLeaf(int32_t root, const T* x) const;
+
+  template <typename T>
+  void AccumulateRows(const T* x, int64_t stride, int64_t row_begin, int64_t row_end,
+                      size_t tree_begin, size_t tree_end, int64_t num_ids,
+                      float* scores, unsigned char* has_score) const;
+
+  std::vector<Node> nodes_;
+  std::vector<Weight> weights_;
+  std::vector<int32_t> roots_;
+  int64_t id_count_{0};
+
+  // Number of rows each tree is applied to before moving on to the next tree.
+  static constexpr int64_t kRowBlockSize = 64;
+  // Minimum number of tree walks for a task to be worth running on the thread pool.
+  static constexpr int64_t kMinWalksPerTask = 1024;
+  static constexpr int64_t kMaxTreeDepth = 1000;
+};
+
+template <typename T>
+const CompiledTreeEnsemble::Node& CompiledTreeEnsemble::FindLeaf(int32_t root, const T* x) const {
+  const Node* node = &nodes_[root];
+  int64_t loopcount = 0;
+  while (node->mode != NODE_MODE::LEAF) {
+    const T val = x[node->feature_id];
+    const float threshold = node->value;
+    bool take_true = node->missing_tracks_true && std::isnan(static_cast<float>(val));
+    switch (node->mode) {
+      case NODE_MODE::BRANCH_LEQ:
+        take_true = take_true || val <= threshold;
+        break;
+      case NODE_MODE::BRANCH_LT:
+        take_true = take_true || val < threshold;
+        break;
+      case NODE_MODE::BRANCH_GTE:
+        take_true = take_true || val >= threshold;
+        break;
+      case NODE_MODE::BRANCH_GT:
+        take_true = take_true || val > threshold;
+        break;
+      case NODE_MODE::BRANCH_EQ:
+        take_true = take_true || val == threshold;
+        break;
+      default:
+        take_true = take_true || val != threshold;
+        break;
+    }
+    node = &nodes_[take_true ? node->true_node : node->false_node];
+    if (++loopcount > kMaxTreeDepth) break;
+  }
+  return *node;
+}
+
+template <typename T>
+void CompiledTreeEnsemble::AccumulateRows(const T* x, int64_t stride, int64_t row_begin, int64_t row_end,
+                                          size_t tree_begin, size_t tree_end, int64_t num_ids,
+                                          float* scores, unsigned char* has_score) const {
+  for (int64_t block_begin = row_begin; block_begin < row_end; block_begin += kRowBlockSize) {
+    const int64_t block_end = std::min(block_begin + kRowBlockSize, row_end);
+    for (size_t tree = tree_begin; tree < tree_end; ++tree) {
+      const int32_t root = roots_[tree];
+      for (int64_t row = block_begin; row < block_end; ++row) {
+        const Node& leaf = FindLeaf(root, x + row * stride);
+        float* row_scores = scores + row * num_ids;
+        unsigned char* row_has_score = has_score + row * num_ids;
+        for (int32_t i = leaf.weights_begin; i < leaf.weights_end; ++i) {
+          row_scores[weights_[i].id] += weights_[i].value;
+          row_has_score[weights_[i].id] = 1;
+        }
+      }
+    }
+  }
+}
+
+template <typename T>
+void CompiledTreeEnsemble::Evaluate(const T* x, int64_t N, int64_t stride, int64_t num_ids,
+                                    float* scores, unsigned char* has_score,
+                                    WorkStealingThreadPool* thread_pool) const {
+  ORT_ENFORCE(num_ids >= id_count_, "Score buffer has ", num_ids, " entries per row but ", id_count_,
+              " are needed.");
+  const int64_t num_trees = static_cast<int64_t>(roots_.size());
+  const int64_t degree = WorkStealingThreadPool::DegreeOfParallelism(thread_pool);
+  const int64_t max_tasks = std::min(degree, N * num_trees / kMinWalksPerTask);
+
+  if (max_tasks <= 1) {
+    AccumulateRows(x, stride, 0, N, 0, roots_.size(), num_ids, scores, has_score);
+    return;
+  }
+
+  if (N >= degree) {
+    // split the rows, each task owns the scores of its rows
+    const int64_t tasks = max_tasks;
+    WorkStealingThreadPool::TryParallelFor(thread_pool, static_cast<int32_t>(tasks), [&](int32_t task) {
+      AccumulateRows(x, stride, N * task / tasks, N * (task + 1) / tasks, 0, roots_.size(),
+                     num_ids, scores, has_score);
+    });
+    return;
+  }
+
+  // Too few rows, split the trees. The first task adds to scores directly, the others to their own buffers which
+  // are then added to scores in task order.
+  const int64_t tasks = std::min(max_tasks, num_trees);
+  const int64_t buffer_size = N * num_ids;
+  std::vector<float> task_scores((tasks - 1) * buffer_size, 0.f);
+  std::vector<unsigned char> task_has_score((tasks - 1) * buffer_size, 0);
+  WorkStealingThreadPool::TryParallelFor(thread_pool, static_cast<int32_t>(tasks), [&](int32_t task) {
+    const size_t tree_begin = static_cast<size_t>(num_trees * task / tasks);
+    const size_t tree_end = static_cast<size_t>(num_trees * (task + 1) / tasks);
+    if (task == 0) {
+      AccumulateRows(x, stride, 0, N, tree_begin, tree_end, num_ids, scores, has_score);
+    } else {
+      AccumulateRows(x, stride, 0, N, tree_begin, tree_end, num_ids,
+                     task_scores.data() + (task - 1) * buffer_size,
+                     task_has_score.data() + (task - 1) * buffer_size);
+    }
+  });
+  for (int64_t task = 1; task < tasks; ++task) {
+    const float* partial_scores = task_scores.data() + (task - 1) * buffer_size;
+    const unsigned char* partial_has_score = task_has_score.data() + (task - 1) * buffer_size;
+    for (int64_t i = 0; i < buffer_size; ++i) {
+      scores[i] += partial_scores[i];
+      has_score[i] |= partial_has_score[i];
+    }
+  }
+}
+
+}  // namespace ml
+}  // namespace onnxruntime
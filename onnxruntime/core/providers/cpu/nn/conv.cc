@@ -80,7 +80,8 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
                     output_shape.GetDims().data(),
                     static_cast<size_t>(M / group_),
                     &Activation,
-                    &WorkingBufferSize);
+                    &WorkingBufferSize,
+                    context->GetOperatorThreadPool());
 
     auto working_data = WorkingBufferSize > 0 ? alloc->Alloc(sizeof(float) * WorkingBufferSize) : nullptr;
     BufferUniquePtr working_buffer(working_data, BufferDeleter(alloc));
@@ -136,7 +137,9 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
             col_buffer_data,
             0,
             Ydata + group_id * Y_offset,
-            &CPUMathUtil::Instance());
+            &CPUMathUtil::Instance(),
+            FLOAT_TYPE,
+            context->GetOperatorThreadPool());
       }
 
       if (B != nullptr) {
@@ -130,7 +130,9 @@ Status Conv<T>::Compute(OpKernelContext* context) const {
           col_buffer_data,
           0,
           Ydata + group_id * Y_offset,
-          &CPUMathUtil::Instance());
+          &CPUMathUtil::Instance(),
+          FLOAT_TYPE,
+          context->GetOperatorThreadPool());
     }
 
     if (B != nullptr) {
@@ -250,7 +250,9 @@ Status ConvTranspose<T>::Compute(OpKernelContext* context) const {
           Xdata + group_id * X_offset,
           0,
           col_buffer_data,
-          &CPUMathUtil::Instance());
+          &CPUMathUtil::Instance(),
+          FLOAT_TYPE,
+          context->GetOperatorThreadPool());
 
       // Col2im
       math::Col2im<T, CPUMathUtil, StorageOrder::NCHW>(
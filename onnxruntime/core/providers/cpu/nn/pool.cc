@@ -3,171 +3,57 @@
 
 #include "core/providers/cpu/nn/pool.h"
 #include <cmath>
+#include "core/common/work_stealing_thread_pool.h"
+#include "core/util/math_cpuonly.h"
 using namespace ::onnxruntime::common;
 
 namespace onnxruntime {
 
-template <typename T, typename PoolType>
-Status Pool<T, PoolType>::Compute(OpKernelContext* context) const {
-  const Tensor* X = context->Input<Tensor>(0);
-  const TensorShape& x_shape = X->Shape();
-
-  ORT_RETURN_IF_NOT(x_shape.NumDimensions() >= 3, "Input dimension cannot be less than 3.");
+namespace {
 
-  std::vector<int64_t> pads = pads_;
-  std::vector<int64_t> kernel_shape = kernel_shape_;
+// Elementwise passes are memory bound, so they are only split across the thread pool for large tensors.
+constexpr int64_t kPoolMinElementsPerTask = 16384;
 
-  if (global_pooling_) {
-    const auto& input_dims = x_shape.GetDims();
-    kernel_shape.assign(input_dims.begin() + 2, input_dims.end());
-    pads.assign(kernel_shape.size(), 0);
+template <typename F>
+void ParallelForRange(WorkStealingThreadPool* thread_pool, int64_t size, F fn) {
+  const int64_t tasks = std::min<int64_t>(WorkStealingThreadPool::DegreeOfParallelism(thread_pool),
+                                          size / kPoolMinElementsPerTask);
+  if (tasks <= 1) {
+    fn(0, size);
+    return;
   }
 
-  std::vector<int64_t> output_dims = PoolBase::SetOutputSize(x_shape, x_shape[1], &pads);
-  Tensor* Y = context->Output(0, TensorShape(output_dims));
-
-  const float* X_data = X->template Data<float>();
-  float* Y_data = Y->template MutableData<float>();
-
-  // The main loop
-  int64_t channels = x_shape[1];
-  int64_t height = x_shape[2];
-  int64_t width = kernel_shape.size() > 1 ? x_shape[3] : 1;
-  int64_t depth = kernel_shape.size() > 2 ? x_shape[4] : 1;
-  int64_t pooled_height = output_dims[2];
-  int64_t pooled_width = kernel_shape.size() > 1 ? output_dims[3] : 1;
-  int64_t pooled_depth = kernel_shape.size() > 2 ? output_dims[4] : 1;
-
-  switch (kernel_shape.size()) {
-    case 1: {
-      int64_t x_step = height;
-      int64_t y_step = pooled_height;
-      const int64_t total_channels = x_shape[0] * channels;
-
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-      for (int64_t c = 0; c < total_channels; ++c) {
-        const float* x_d = X_data + c * x_step;
-        float* y_d = Y_data + c * y_step;
-
-        for (int64_t ph = 0; ph < pooled_height; ++ph) {
-          int64_t hstart = ph * stride_h() - pads[0];
-          int64_t hend = std::min(hstart + kernel_shape[0], height);
-          hstart = std::max(hstart, static_cast<int64_t>(0));
-          T Yh = PoolType::Initialize();
-          for (int64_t h = hstart; h < hend; ++h) {
-            PoolType::Process(x_d[h], Yh, pool_context_);
-          }
-          if (count_include_pad_) {
-            PoolType::Finalize(kernel_shape[0], Yh, pool_context_);
-          } else {
-            PoolType::Finalize(hend - hstart, Yh, pool_context_);
-          }
-          y_d[ph] = Yh;
-        }
-      }
-
-      break;
-    }
-
-    case 2: {
-      int64_t x_step = height * width;
-      int64_t y_step = pooled_height * pooled_width;
-      const int64_t total_channels = x_shape[0] * channels;
-
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-      for (int64_t c = 0; c < total_channels; ++c) {
-        const float* x_d = X_data + c * x_step;
-        float* y_d = Y_data + c * y_step;
-
-        for (int64_t ph = 0; ph < pooled_height; ++ph) {
-          int64_t hstart = ph * stride_h() - pads[0];
-          int64_t hend = std::min(hstart + kernel_shape[0], height);
-          hstart = std::max(hstart, static_cast<int64_t>(0));
-          for (int64_t pw = 0; pw < pooled_width; ++pw) {
-            int64_t wstart = pw * stride_w() - pads[1];
-            int64_t wend = std::min(wstart + kernel_shape[1], width);
-            wstart = std::max(wstart, static_cast<int64_t>(0));
-            const int64_t pool_index = ph * pooled_width + pw;
-            T Yh = PoolType::Initialize();
-            for (int64_t h = hstart; h < hend; ++h) {
-              for (int64_t w = wstart; w < wend; ++w) {
-                const int64_t input_index = h * width + w;
-                PoolType::Process(x_d[input_index], Yh, pool_context_);
-              }
-            }
-            if (count_include_pad_) {
-              PoolType::Finalize(kernel_shape[0] * kernel_shape[1], Yh, pool_context_);
-            } else {
-              PoolType::Finalize((hend - hstart) * (wend - wstart), Yh, pool_context_);
-            }
-            y_d[pool_index] = Yh;
-          }
-        }
-      }
-
-      break;
-    }
-    case 3: {
-      int64_t x_step = height * width * depth;
-      int64_t y_step = pooled_height * pooled_width * pooled_depth;
-      const int64_t total_channels = x_shape[0] * channels;
-
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-      for (int64_t c = 0; c < total_channels; ++c) {
-        const float* x_d = X_data + c * x_step;
-        float* y_d = Y_data + c * y_step;
-
-        for (int64_t ph = 0; ph < pooled_height; ++ph) {
-          int64_t hstart = ph * stride_h() - pads[0];
-          int64_t hend = std::min(hstart + kernel_shape[0], height);
-          hstart = std::max(hstart, static_cast<int64_t>(0));
-          for (int64_t pw = 0; pw < pooled_width; ++pw) {
-            int64_t wstart = pw * stride_w() - pads[1];
-            int64_t wend = std::min(wstart + kernel_shape[1], width);
-            wstart = std::max(wstart, static_cast<int64_t>(0));
-            for (int64_t pd = 0; pd < pooled_depth; ++pd) {
-              int64_t dstart = pd * stride_d() - pads[2];
-              int64_t dend = std::min(dstart + kernel_shape[2], depth);
-              dstart = std::max(dstart, static_cast<int64_t>(0));
-              const int64_t pool_index =
-                  ph * pooled_width * pooled_depth + pw * pooled_depth + pd;
-              T Yh = PoolType::Initialize();
-              for (int64_t h = hstart; h < hend; ++h) {
-                for (int64_t w = wstart; w < wend; ++w) {
-                  for (int64_t d = dstart; d < dend; ++d) {
-                    const int64_t input_index = h * width * depth + w * depth + d;
-                    PoolType::Process(x_d[input_index], Yh, pool_context_);
-                  }
-                }
-              }
-              if (count_include_pad_) {
-                PoolType::Finalize(kernel_shape[0] * kernel_shape[1] * kernel_shape[2], Yh, pool_context_);
-              } else {
-                PoolType::Finalize(
-                    (hend - hstart) * (wend - wstart) * (dend - dstart), Yh, pool_context_);
-              }
-              y_d[pool_index] = Yh;
-            }
-          }
-        }
-      }
+  WorkStealingThreadPool::TryParallelFor(thread_pool, static_cast<int32_t>(tasks), [&](int32_t task) {
+    fn(size * task / tasks, size * (task + 1) / tasks);
+  });
+}
 
-      break;
-    }
-    default:
-      return Status(ONNXRUNTIME, INVALID_ARGUMENT, "Unsupported pooling size : ");
+}  // namespace
+
+void LpPool::PowerAbs(const float* x_data, float* y_data, int64_t size, const PoolProcessContext& cxt) {
+  ConstEigenVectorArrayMap<float> x(x_data, size);
+  EigenVectorArrayMap<float> y(y_data, size);
+  if (cxt.p_ == 1) {
+    y = x.abs();
+  } else if (cxt.p_ == 2) {
+    y = x.square();
+  } else {
+    y = x.abs().pow(static_cast<float>(cxt.p_));
   }
+}
 
-  return Status::OK();
+void LpPool::ScaledRoot(float* y_data, int64_t size, float scale, const PoolProcessContext& cxt) {
+  EigenVectorArrayMap<float> y(y_data, size);
+  if (cxt.p_ == 1) {
+    y *= scale;
+  } else if (cxt.p_ == 2) {
+    y = (y * scale).sqrt();
+  } else {
+    y = (y * scale).pow(1.0f / cxt.p_);
+  }
 }
 
-Status PoolBase::Compute(OpKernelContext* context, MLAS_POOLING_KIND kind) const {
+Status PoolBase::Compute(OpKernelContext* context, MLAS_POOLING_KIND kind, const float* input_data) const {
   const Tensor* X = context->Input<Tensor>(0);
   const TensorShape& x_shape = X->Shape();
 
@@ -193,8 +79,9 @@ Status PoolBase::Compute(OpKernelContext* context, MLAS_POOLING_KIND kind) const
            global_pooling_ ? nullptr : pads.data(),
            global_pooling_ ? nullptr : strides_.data(),
            output_dims.data(),
-           X->template Data<float>(),
-           Y->template MutableData<float>());
+           input_data != nullptr ? input_data : X->template Data<float>(),
+           Y->template MutableData<float>(),
+           context->GetOperatorThreadPool());
 
   return Status::OK();
 }
@@ -211,173 +98,140 @@ Status Pool<float, AveragePool>::Compute(OpKernelContext* context) const {
 
 template <>
 Status Pool<float, MaxPool<8 /*VERSION*/>>::Compute(OpKernelContext* context) const {
-  // Use MLAS pooling if the index output tensor is not used.
-  if (OpKernel::Node().OutputDefs().size() == 1) {
-    return PoolBase::Compute(context, MlasMaximumPooling);
-  }
+  ORT_RETURN_IF_ERROR(PoolBase::Compute(context, MlasMaximumPooling));
 
   const Tensor* X = context->Input<Tensor>(0);
   const TensorShape& x_shape = X->Shape();
 
-  ORT_RETURN_IF_NOT(x_shape.NumDimensions() >= 3, "Input dimension cannot be less than 3.");
-
   std::vector<int64_t> pads = pads_;
-  std::vector<int64_t> kernel_shape = kernel_shape_;
-
   std::vector<int64_t> output_dims = PoolBase::SetOutputSize(x_shape, x_shape[1], &pads);
-  Tensor* Y = context->Output(0, TensorShape(output_dims));
   Tensor* I = context->Output(1, TensorShape(output_dims));
+  if (I == nullptr) {
+    return Status::OK();
+  }
 
+  const Tensor* Y = context->Output(0, TensorShape(output_dims));
   const float* X_data = X->template Data<float>();
-  float* Y_data = Y->template MutableData<float>();
-  int64_t* I_data = I != nullptr ? I->template MutableData<int64_t>() : nullptr;
-
-  // The main loop
-  int64_t channels = x_shape[1];
-  int64_t height = x_shape[2];
-  int64_t width = kernel_shape.size() > 1 ? x_shape[3] : 1;
-  int64_t depth = kernel_shape.size() > 2 ? x_shape[4] : 1;
-  int64_t pooled_height = output_dims[2];
-  int64_t pooled_width = kernel_shape.size() > 1 ? output_dims[3] : 1;
-  int64_t pooled_depth = kernel_shape.size() > 2 ? output_dims[4] : 1;
-
-  switch (kernel_shape.size()) {
-    case 1: {
-      int64_t x_step = height;
-      int64_t y_step = pooled_height;
-      const int64_t total_channels = x_shape[0] * channels;
-
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-      for (int64_t c = 0; c < total_channels; ++c) {
-        const float* x_d = X_data + c * x_step;
-        float* y_d = Y_data + c * y_step;
-        int64_t* i_d = I_data ? I_data + c * y_step : nullptr;
-        for (int64_t ph = 0; ph < pooled_height; ++ph) {
-          int64_t hstart = ph * stride_h() - pads[0];
-          int64_t hend = std::min(hstart + kernel_shape[0], height);
-          hstart = std::max(hstart, static_cast<int64_t>(0));
-          float Yh = std::numeric_limits<float>::lowest();
-          int64_t h_index = -1;
-          for (int64_t h = hstart; h < hend; ++h) {
-            if (x_d[h] > Yh) {
-              Yh = x_d[h];
-              h_index = h;
-            }
-          }
-          y_d[ph] = Yh;
-          if (i_d != nullptr) i_d[ph] = c * x_step + h_index;
-        }
-      }
-
-      break;
-    }
+  const float* Y_data = Y->template Data<float>();
+  int64_t* I_data = I->template MutableData<int64_t>();
+
+  // MLAS has computed the maximum of each window, so the index is that of the first element in the window that
+  // equals it. This is the element a row major scan with '>' selects. The 1D and 2D cases are handled as 3D
+  // pooling with trailing dimensions of size 1.
+  const size_t pooling_dims = kernel_shape_.size();
+  int64_t input_shape[3] = {1, 1, 1};
+  int64_t output_shape[3] = {1, 1, 1};
+  int64_t kernel_shape[3] = {1, 1, 1};
+  int64_t strides[3] = {1, 1, 1};
+  int64_t pads_head[3] = {0, 0, 0};
+  for (size_t dim = 0; dim < pooling_dims; ++dim) {
+    input_shape[dim] = x_shape[dim + 2];
+    output_shape[dim] = output_dims[dim + 2];
+    kernel_shape[dim] = kernel_shape_[dim];
+    strides[dim] = strides_[dim];
+    pads_head[dim] = pads[dim];
+  }
 
-    case 2: {
-      int64_t x_step = height * width;
-      int64_t y_step = pooled_height * pooled_width;
-      const int64_t total_channels = x_shape[0] * channels;
-
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-      for (int64_t c = 0; c < total_channels; ++c) {
-        const float* x_d = X_data + c * x_step;
-        float* y_d = Y_data + c * y_step;
-        int64_t* i_d = I_data ? I_data + c * y_step : nullptr;
-
-        for (int64_t ph = 0; ph < pooled_height; ++ph) {
-          int64_t hstart = ph * stride_h() - pads[0];
-          int64_t hend = std::min(hstart + kernel_shape[0], height);
-          hstart = std::max(hstart, static_cast<int64_t>(0));
-          for (int64_t pw = 0; pw < pooled_width; ++pw) {
-            int64_t wstart = pw * stride_w() - pads[1];
-            int64_t wend = std::min(wstart + kernel_shape[1], width);
-            wstart = std::max(wstart, static_cast<int64_t>(0));
-            const int64_t pool_index = ph * pooled_width + pw;
-            float Yh = std::numeric_limits<float>::lowest();
-            int64_t h_index = -1;
-            int64_t w_index = -1;
-            for (int64_t h = hstart; h < hend; ++h) {
-              for (int64_t w = wstart; w < wend; ++w) {
-                const int64_t input_index = h * width + w;
-                if (x_d[input_index] > Yh) {
-                  Yh = x_d[input_index];
+  const int64_t height = input_shape[0];
+  const int64_t width = input_shape[1];
+  const int64_t depth = input_shape[2];
+  const int64_t x_step = height * width * depth;
+  const int64_t y_step = output_shape[0] * output_shape[1] * output_shape[2];
+  const int64_t total_channels = x_shape[0] * x_shape[1];
+  const bool row_major = storage_order_ == 0;
+
+  auto compute_indices = [&](int64_t c) {
+    const float* x_d = X_data + c * x_step;
+    const float* y_d = Y_data + c * y_step;
+    int64_t* i_d = I_data + c * y_step;
+
+    for (int64_t ph = 0; ph < output_shape[0]; ++ph) {
+      const int64_t hstart = std::max<int64_t>(ph * strides[0] - pads_head[0], 0);
+      const int64_t hend = std::min(ph * strides[0] - pads_head[0] + kernel_shape[0], height);
+      for (int64_t pw = 0; pw < output_shape[1]; ++pw) {
+        const int64_t wstart = std::max<int64_t>(pw * strides[1] - pads_head[1], 0);
+        const int64_t wend = std::min(pw * strides[1] - pads_head[1] + kernel_shape[1], width);
+        for (int64_t pd = 0; pd < output_shape[2]; ++pd) {
+          const int64_t dstart = std::max<int64_t>(pd * strides[2] - pads_head[2], 0);
+          const int64_t dend = std::min(pd * strides[2] - pads_head[2] + kernel_shape[2], depth);
+          const float Yh = *y_d++;
+
+          int64_t h_index = hstart;
+          int64_t w_index = wstart;
+          int64_t d_index = dstart;
+          bool found = false;
+          for (int64_t h = hstart; h < hend && !found; ++h) {
+            for (int64_t w = wstart; w < wend && !found; ++w) {
+              for (int64_t d = dstart; d < dend; ++d) {
+                if (x_d[(h * width + w) * depth + d] == Yh) {
                   h_index = h;
                   w_index = w;
+                  d_index = d;
+                  found = true;
+                  break;
                 }
               }
             }
-            y_d[pool_index] = Yh;
-            if (i_d != nullptr)
-              i_d[pool_index] = storage_order_ == 0 ? c * x_step + h_index * width + w_index
-                                                    : c * x_step + h_index + w_index * height;
           }
+          *i_d++ = row_major ? c * x_step + (h_index * width + w_index) * depth + d_index
+                             : c * x_step + h_index + w_index * height + d_index * height * width;
         }
       }
-      break;
     }
-    case 3: {
-      int64_t x_step = height * width * depth;
-      int64_t y_step = pooled_height * pooled_width * pooled_depth;
-      const int64_t total_channels = x_shape[0] * channels;
-
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-      for (int64_t c = 0; c < total_channels; ++c) {
-        const float* x_d = X_data + c * x_step;
-        float* y_d = Y_data + c * y_step;
-        int64_t* i_d = I_data ? I_data + c * y_step : nullptr;
-
-        for (int64_t ph = 0; ph < pooled_height; ++ph) {
-          int64_t hstart = ph * stride_h() - pads[0];
-          int64_t hend = std::min(hstart + kernel_shape[0], height);
-          hstart = std::max(hstart, static_cast<int64_t>(0));
-          for (int64_t pw = 0; pw < pooled_width; ++pw) {
-            int64_t wstart = pw * stride_w() - pads[1];
-            int64_t wend = std::min(wstart + kernel_shape[1], width);
-            wstart = std::max(wstart, static_cast<int64_t>(0));
-            for (int64_t pd = 0; pd < pooled_depth; ++pd) {
-              int64_t dstart = pd * stride_d() - pads[2];
-              int64_t dend = std::min(dstart + kernel_shape[2], depth);
-              dstart = std::max(dstart, static_cast<int64_t>(0));
-              const int64_t pool_index =
-                  ph * pooled_width * pooled_depth + pw * pooled_depth + pd;
-              float Yh = std::numeric_limits<float>::lowest();
-              int64_t h_index = -1;
-              int64_t w_index = -1;
-              int64_t d_index = -1;
-              for (int64_t h = hstart; h < hend; ++h) {
-                for (int64_t w = wstart; w < wend; ++w) {
-                  for (int64_t d = dstart; d < dend; ++d) {
-                    const int64_t input_index = h * width * depth + w * depth + d;
-                    if (x_d[input_index] > Yh) {
-                      Yh = x_d[input_index];
-                      h_index = h;
-                      w_index = w;
-                      d_index = d;
-                    }
-                  }
-                }
-              }
-              y_d[pool_index] = Yh;
-              if (i_d != nullptr)
-                i_d[pool_index] = storage_order_ == 0 ? c * x_step + h_index * width * depth + w_index * depth + d_index
-                                                      : c * x_step + h_index + w_index * height + d_index * height * width;
-            }
-          }
-        }
-      }
-      break;
+  };
+
+  WorkStealingThreadPool* thread_pool = context->GetOperatorThreadPool();
+  const int64_t tasks = std::min<int64_t>(WorkStealingThreadPool::DegreeOfParallelism(thread_pool), total_channels);
+  if (tasks <= 1) {
+    for (int64_t c = 0; c < total_channels; ++c) {
+      compute_indices(c);
     }
-    default:
-      return Status(ONNXRUNTIME, INVALID_ARGUMENT, "Unsupported pooling size : ");
+  } else {
+    WorkStealingThreadPool::TryParallelFor(thread_pool, static_cast<int32_t>(tasks), [&](int32_t task) {
+      for (int64_t c = total_channels * task / tasks; c < total_channels * (task + 1) / tasks; ++c) {
+        compute_indices(c);
+      }
+    });
   }
 
   return Status::OK();
-}  // namespace onnxruntime
+}
+
+template <>
+Status Pool<float, LpPool>::Compute(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  const TensorShape& x_shape = X->Shape();
+  const int64_t x_size = x_shape.Size();
+
+  ORT_RETURN_IF_NOT(x_shape.NumDimensions() >= 3, "Input dimension cannot be less than 3.");
+
+  AllocatorPtr alloc;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
+
+  auto powers_data = alloc->Alloc(sizeof(float) * x_size);
+  BufferUniquePtr powers_buffer(powers_data, BufferDeleter(alloc));
+  float* powers = static_cast<float*>(powers_buffer.get());
+
+  WorkStealingThreadPool* thread_pool = context->GetOperatorThreadPool();
+  const float* X_data = X->template Data<float>();
+  ParallelForRange(thread_pool, x_size, [&](int64_t begin, int64_t end) {
+    LpPool::PowerAbs(X_data + begin, powers + begin, end - begin, pool_context_);
+  });
+
+  ORT_RETURN_IF_ERROR(PoolBase::Compute(context, MlasAveragePoolingIncludePad, powers));
+
+  std::vector<int64_t> pads = pads_;
+  std::vector<int64_t> output_dims = PoolBase::SetOutputSize(x_shape, x_shape[1], &pads);
+  Tensor* Y = context->Output(0, TensorShape(output_dims));
+  float* Y_data = Y->template MutableData<float>();
+
+  const int64_t kernel_size = global_pooling_ ? x_shape.SizeFromDimension(2) : TensorShape(kernel_shape_).Size();
+  ParallelForRange(thread_pool, Y->Shape().Size(), [&](int64_t begin, int64_t end) {
+    LpPool::ScaledRoot(Y_data + begin, end - begin, static_cast<float>(kernel_size), pool_context_);
+  });
+
+  return Status::OK();
+}
 
 ONNX_CPU_OPERATOR_KERNEL(
     AveragePool,
@@ -79,21 +79,14 @@ class MaxPool<8 /*VERSION*/> {
   static const PoolType type = PoolType::kMaxPool;
 };
 
+// MLAS has no Lp reduction, so Lp pooling runs the MLAS average pooling that includes the padding over |x|^p.
+// The averages are scaled back up by the kernel size and raised to 1/p.
 class LpPool {
  public:
-  static float Initialize() {
-    return 0.0f;
-  }
+  static void PowerAbs(const float* x_data, float* y_data, int64_t size, const PoolProcessContext& cxt);
 
-  template <typename T>
-  static void Process(const T& x_data, T& y_data, const PoolProcessContext& cxt) {
-    y_data += static_cast<T>(std::pow(std::abs(x_data), cxt.p_));
-  }
+  static void ScaledRoot(float* y_data, int64_t size, float scale, const PoolProcessContext& cxt);
 
-  template <typename T>
-  static void Finalize(const int64_t /*size*/, T& y_data, const PoolProcessContext& cxt) {
-    y_data = static_cast<T>(std::pow(y_data, 1.0f / cxt.p_));
-  }
   static const PoolType type = PoolType::kLpPool;
 };
 
@@ -217,7 +210,8 @@ class PoolBase {
     }
   }
 
-  Status Compute(OpKernelContext* context, MLAS_POOLING_KIND kind) const;
+  // Runs the MLAS pooling over input 0, or over input_data if given, which must have the shape of input 0.
+  Status Compute(OpKernelContext* context, MLAS_POOLING_KIND kind, const float* input_data = nullptr) const;
 
  protected:
   std::string op_name_;
@@ -2,6 +2,9 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/reduction/reduction_ops.h"
+#include <algorithm>
+#include <cmath>
+#include "core/common/work_stealing_thread_pool.h"
 #include "core/providers/common.h"
 #include "core/util/math_cpuonly.h"
 using namespace std;
@@ -35,391 +38,434 @@ REGISTER_UNARY_ELEMENTWISE_KERNEL(ReduceSumSquare, 1);
 REGISTER_UNARY_ELEMENTWISE_KERNEL(ArgMax, 1);
 REGISTER_UNARY_ELEMENTWISE_KERNEL(ArgMin, 1);
 
-// When all reduce axises located at the tail of the dims, quite general cases, transpose and extra
-// copy could be skiped to improve performance, if required by check_no_transpose = true;
-// return value: true means transposedInputData is not created/copied, input tensor data could
-//               be direct use as row major matrix [block_size, blocks], where blocks is the
-//               size of each reduce.
-template <typename T>
-bool PrepareForReduce(OpKernelContext* ctx,
-                      std::vector<T>& transposedInputData,
-                      Tensor** reducedTensor,
-                      int64_t& block_size,
-                      int64_t& blocks,
-                      const std::vector<int64_t>& axes_,
-                      bool keepdims_,
-                      bool check_no_transpose = false) {
-  const Tensor* input_tensor_ptr = ctx->Input<Tensor>(0);
-  ORT_ENFORCE(input_tensor_ptr != nullptr);
-  const Tensor& input = *input_tensor_ptr;
-
-  size_t ndim = input.Shape().GetDims().size();
-  std::vector<int64_t> axes;
-  for (int64_t axis : axes_) {
-    axes.push_back(HandleNegativeAxis(axis, static_cast<int64_t>(ndim)));
+namespace {
+
+// Describes a reduction over an arbitrary set of axes in terms of strides into the input, so that it can be
+// computed directly from the input without first transposing the reduced axes next to each other.
+// Adjacent axes that are both reduced or both kept are coalesced and axes of size 1 are dropped, so the common
+// cases (reducing leading, trailing or interleaved axes) end up with only a few loop levels.
+struct ReducePlan {
+  // Number of output elements.
+  int64_t output_size = 1;
+  // Number of input elements that are folded into each output element.
+  int64_t reduce_size = 1;
+  // Length of the innermost contiguous run of the input, and whether that run is reduced or kept.
+  // If it is reduced, each output element is computed from runs of inner_size contiguous inputs. If it is kept,
+  // each group of inner_size contiguous outputs is computed from rows of inner_size contiguous inputs.
+  int64_t inner_size = 1;
+  bool inner_reduced = true;
+  // Kept dimensions other than the innermost run, and their strides in the input.
+  std::vector<int64_t> kept_dims;
+  std::vector<int64_t> kept_strides;
+  // Offset in the input of each reduced run/row, relative to the offset of the output element/row,
+  // in row-major order of the reduced dimensions.
+  std::vector<int64_t> reduced_offsets;
+};
+
+// Compute the output dimensions and the reduction plan for reducing input_dims over axes.
+// An empty axes list reduces over all dimensions.
+void PrepareForReduce(const std::vector<int64_t>& input_dims,
+                      const std::vector<int64_t>& axes,
+                      bool keepdims,
+                      std::vector<int64_t>& reduced_dims,
+                      ReducePlan& plan) {
+  const auto ndim = input_dims.size();
+  std::vector<bool> reduce_axis(ndim, axes.empty());
+  for (int64_t axis : axes) {
+    reduce_axis[HandleNegativeAxis(axis, static_cast<int64_t>(ndim))] = true;
   }
 
-  if (axes.empty()) {
-    // This is the default case for non-arg kind reductions. Reduce on all dimensions.
-    for (size_t i = 0; i < ndim; i++)
-      axes.push_back(i);
+  reduced_dims.clear();
+  for (size_t i = 0; i < ndim; ++i) {
+    if (!reduce_axis[i]) {
+      reduced_dims.push_back(input_dims[i]);
+    } else if (keepdims) {
+      reduced_dims.push_back(1);
+    }
   }
 
-  std::sort(axes.begin(), axes.end());
-
-  // If all reduced axes are located at the tail of the input shape, then copy could be skipped is required
-  bool need_copy = true;
-  if (axes.size() <= ndim && axes.front() == static_cast<int64_t>(ndim - axes.size()) 
-      && axes.back() == static_cast<int64_t>(ndim) - 1) {
-    need_copy = false;
+  // coalesce the input dimensions into alternating groups of kept and reduced dimensions
+  std::vector<std::pair<int64_t, bool>> groups;
+  for (size_t i = 0; i < ndim; ++i) {
+    if (input_dims[i] == 1) {
+      continue;
+    }
+    if (!groups.empty() && groups.back().second == reduce_axis[i]) {
+      groups.back().first *= input_dims[i];
+    } else {
+      groups.emplace_back(input_dims[i], reduce_axis[i]);
+    }
   }
-
-  vector<bool> keep_axis(ndim, true);
-  for (auto i : axes) {
-    keep_axis[i] = false;
+  if (groups.empty()) {
+    groups.emplace_back(1, true);
   }
 
-  //transpose the input so that all to-be-reduced axes are at the head
-  vector<int64_t> transposed_axes(axes.begin(), axes.end());
-  for (int i = 0; i < ndim; ++i) {
-    if (keep_axis[i]) {
-      transposed_axes.push_back(i);
+  plan = ReducePlan();
+  plan.inner_size = groups.back().first;
+  plan.inner_reduced = groups.back().second;
+  plan.reduced_offsets.push_back(0);
+
+  int64_t stride = 1;
+  for (size_t i = groups.size(); i-- > 0;) {
+    const int64_t size = groups[i].first;
+    const bool is_last = i + 1 == groups.size();
+    if (groups[i].second) {
+      plan.reduce_size *= size;
+      if (!is_last) {
+        // prepend this dimension to the reduced offsets so they stay in row-major order
+        std::vector<int64_t> offsets;
+        offsets.reserve(plan.reduced_offsets.size() * size);
+        for (int64_t j = 0; j < size; ++j) {
+          for (int64_t offset : plan.reduced_offsets) {
+            offsets.push_back(j * stride + offset);
+          }
+        }
+        plan.reduced_offsets.swap(offsets);
+      }
+    } else {
+      plan.output_size *= size;
+      if (!is_last) {
+        plan.kept_dims.insert(plan.kept_dims.begin(), size);
+        plan.kept_strides.insert(plan.kept_strides.begin(), stride);
+      }
     }
+    stride *= size;
   }
 
-  vector<int64_t> new_dims_(transposed_axes.size());
-  for (int i = 0; i < transposed_axes.size(); ++i) {
-    new_dims_[i] = input.Shape().GetDims().at(transposed_axes[i]);
+  if (plan.reduce_size == 0) {
+    // nothing to fold, each output element is the reduction of an empty set
+    plan.reduced_offsets.clear();
   }
+}
 
-  int num_axes = static_cast<int>(transposed_axes.size());
-  auto in_dims = input.Shape().GetDims();
-
-  // Measure amount of contiguous data we can copy at once
-  int64_t blocksize = 1;
-  int n_shared_idxs = 0;
-  for (int i = num_axes - 1; i >= 0; --i) {
-    if (transposed_axes[i] == i) {
-      blocksize *= new_dims_[i];
-      ++n_shared_idxs;
-    } else {
-      break;
-    }
+// Offset in the input of the first element reduced into output element (or output row) index.
+inline int64_t InputOffset(const ReducePlan& plan, int64_t index) {
+  int64_t offset = 0;
+  for (size_t i = plan.kept_dims.size(); i-- > 0;) {
+    offset += (index % plan.kept_dims[i]) * plan.kept_strides[i];
+    index /= plan.kept_dims[i];
   }
+  return offset;
+}
 
-  const T* from_data = input.template Data<T>();
-  size_t count = input.Shape().Size();
+// Minimum number of input elements reduced by a task for it to be worth running on the thread pool.
+constexpr int64_t kMinElementsPerTask = 16 * 1024;
 
-  //set to-be-reduced axes to one. squeeze is keepdims_ is false
-  int64_t first_dim = 1;
-  std::vector<int64_t> reduced_dims;
-  for (int i = 0; i < in_dims.size(); i++) {
-    if (keep_axis[i]) {
-      reduced_dims.push_back(in_dims[i]);
-    } else {
-      first_dim *= in_dims[i];
-      if (keepdims_) {
-        reduced_dims.push_back(1);
-      }
-    }
-  }
+// Number of contiguous outputs computed together when the innermost run is kept. Bounds the working set of the
+// accumulators and gives the thread pool something to split when there are only a few output rows.
+constexpr int64_t kOutputBlockSize = 1024;
 
-  *reducedTensor = ctx->Output(0, reduced_dims);
-  block_size = input.Shape().Size() / first_dim;
-  blocks = first_dim;
+int32_t ReduceTaskCount(WorkStealingThreadPool* thread_pool, int64_t units, int64_t elements_per_unit) {
+  int64_t tasks = std::min<int64_t>(units, WorkStealingThreadPool::DegreeOfParallelism(thread_pool));
+  tasks = std::min(tasks, units * elements_per_unit / kMinElementsPerTask);
+  return static_cast<int32_t>(std::max<int64_t>(tasks, 1));
+}
 
-  if (!need_copy && check_no_transpose) {
-    return true;
+// Reduce the input according to plan, parallelizing over the output.
+//
+// Aggregator provides
+//   OutT ReduceRuns(const T* input, const int64_t* offsets, size_t num_offsets, int64_t run, int64_t reduce_size)
+//     which reduces the num_offsets runs of run contiguous elements at input + offsets[i] to a single value, and
+//   void ReduceRows(OutT* output, const T* input, const int64_t* offsets, size_t num_offsets, int64_t n,
+//                   int64_t reduce_size, T* scratch)
+//     which reduces the num_offsets rows of n contiguous elements at input + offsets[i] elementwise into
+//     output[0 ... n - 1]. scratch has space for n elements.
+template <typename T, typename OutT, typename Aggregator>
+void StridedReduce(const ReducePlan& plan, const T* input, OutT* output, WorkStealingThreadPool* thread_pool) {
+  if (plan.output_size == 0) {
+    return;
   }
 
-  transposedInputData.resize(input.Shape().Size(), 0);
-  T* to_data = &transposedInputData[0];
-  if (num_axes < 2 || n_shared_idxs == num_axes) {
-    memcpy(to_data, from_data, count * sizeof(T));
-    return false;
+  const int64_t* offsets = plan.reduced_offsets.data();
+  const size_t num_offsets = plan.reduced_offsets.size();
+
+  if (plan.inner_reduced) {
+    const int64_t units = plan.output_size;
+    const int32_t tasks = ReduceTaskCount(thread_pool, units, plan.reduce_size);
+
+    WorkStealingThreadPool::TryParallelFor(thread_pool, tasks, [&](int32_t task) {
+      const int64_t begin = units * task / tasks;
+      const int64_t end = units * (task + 1) / tasks;
+      for (int64_t i = begin; i < end; ++i) {
+        output[i] = Aggregator::ReduceRuns(input + InputOffset(plan, i), offsets, num_offsets, plan.inner_size,
+                                           plan.reduce_size);
+      }
+    });
+  } else {
+    const int64_t rows = plan.output_size / plan.inner_size;
+    const int64_t block_size = std::min(plan.inner_size, kOutputBlockSize);
+    const int64_t blocks_per_row = (plan.inner_size + block_size - 1) / block_size;
+    const int64_t units = rows * blocks_per_row;
+    const int32_t tasks = ReduceTaskCount(thread_pool, units, plan.reduce_size * block_size);
+
+    WorkStealingThreadPool::TryParallelFor(thread_pool, tasks, [&](int32_t task) {
+      std::vector<T> scratch(block_size);
+      const int64_t begin = units * task / tasks;
+      const int64_t end = units * (task + 1) / tasks;
+      for (int64_t i = begin; i < end; ++i) {
+        const int64_t row = i / blocks_per_row;
+        const int64_t column = (i % blocks_per_row) * block_size;
+        const int64_t n = std::min(block_size, plan.inner_size - column);
+        Aggregator::ReduceRows(output + row * plan.inner_size + column,
+                               input + InputOffset(plan, row) + column,
+                               offsets, num_offsets, n, plan.reduce_size, scratch.data());
+      }
+    });
   }
+}
 
-  int itr_axes = num_axes - n_shared_idxs;
+// Adapts a reduction expressed as a fold of vectorized runs into an accumulator to the Aggregator interface of
+// StridedReduce. Derived provides
+//   T Init()                                    initial accumulator value
+//   T Fold(T acc, const ConstEigenVectorMap<T>& run)
+//   void FoldRow(EigenVectorMap<T>& acc, const ConstEigenVectorMap<T>& row)
+//   T Finalize(T acc, int64_t reduce_size)      value of the output from the accumulator
+template <typename T, typename Derived>
+struct FoldAggregator {
+  static T ReduceRuns(const T* input, const int64_t* offsets, size_t num_offsets, int64_t run,
+                      int64_t reduce_size) {
+    T acc = Derived::Init();
+    for (size_t i = 0; i < num_offsets; ++i) {
+      acc = Derived::Fold(acc, ConstEigenVectorMap<T>(input + offsets[i], run));
+    }
+    return Derived::Finalize(acc, reduce_size);
+  }
 
-  // Calculate strides
-  std::vector<int64_t> stride_x(itr_axes, 0);
-  for (size_t i = 0; i < itr_axes; i++) {
-    stride_x[i] = 1;
-    for (size_t j = transposed_axes[i] + 1; j < itr_axes; j++) {
-      stride_x[i] *= in_dims[j];
+  static void ReduceRows(T* output, const T* input, const int64_t* offsets, size_t num_offsets, int64_t n,
+                         int64_t reduce_size, T* /*scratch*/) {
+    EigenVectorMap<T> acc(output, n);
+    acc.setConstant(Derived::Init());
+    for (size_t i = 0; i < num_offsets; ++i) {
+      Derived::FoldRow(acc, ConstEigenVectorMap<T>(input + offsets[i], n));
+    }
+    for (int64_t j = 0; j < n; ++j) {
+      output[j] = Derived::Finalize(output[j], reduce_size);
     }
   }
+};
 
-  std::vector<int64_t> itr_idxs(itr_axes, 0);
+template <typename T>
+struct ReduceAggregatorSum : FoldAggregator<T, ReduceAggregatorSum<T>> {
+  static T Init() { return 0; }
+  static T Fold(T acc, const ConstEigenVectorMap<T>& run) { return acc + run.sum(); }
+  static void FoldRow(EigenVectorMap<T>& acc, const ConstEigenVectorMap<T>& row) { acc += row; }
+  static T Finalize(T acc, int64_t /*reduce_size*/) { return acc; }
+};
 
-  // Branch here to avoid branching within the loop
-  if (blocksize > 1) {
-    for (size_t index = 0; index < (count / blocksize); index++) {
-      int64_t from_index = 0;
-      for (int i = 0; i < itr_axes; ++i) {
-        from_index += stride_x[i] * itr_idxs[i];
-      }
+template <typename T>
+struct ReduceAggregatorMean : FoldAggregator<T, ReduceAggregatorMean<T>> {
+  static T Init() { return 0; }
+  static T Fold(T acc, const ConstEigenVectorMap<T>& run) { return acc + run.sum(); }
+  static void FoldRow(EigenVectorMap<T>& acc, const ConstEigenVectorMap<T>& row) { acc += row; }
+  static T Finalize(T acc, int64_t reduce_size) { return acc / static_cast<T>(reduce_size); }
+};
 
-      memcpy(
-          to_data + blocksize * index,
-          from_data + blocksize * from_index,
-          blocksize * sizeof(T));
+template <typename T>
+struct ReduceAggregatorLogSum : FoldAggregator<T, ReduceAggregatorLogSum<T>> {
+  static T Init() { return 0; }
+  static T Fold(T acc, const ConstEigenVectorMap<T>& run) { return acc + run.sum(); }
+  static void FoldRow(EigenVectorMap<T>& acc, const ConstEigenVectorMap<T>& row) { acc += row; }
+  static T Finalize(T acc, int64_t /*reduce_size*/) { return static_cast<T>(std::log(acc)); }
+};
 
-      ++itr_idxs[itr_axes - 1];
-      for (int i = itr_axes - 1; i >= 1; --i) {
-        auto expected_dim = new_dims_[i];
-        if (itr_idxs[i] < expected_dim) {
-          break;
-        }
-        itr_idxs[i] %= expected_dim;
-        ++itr_idxs[i - 1];
+template <typename T>
+struct ReduceAggregatorL1 : FoldAggregator<T, ReduceAggregatorL1<T>> {
+  static T Init() { return 0; }
+  static T Fold(T acc, const ConstEigenVectorMap<T>& run) { return acc + run.cwiseAbs().sum(); }
+  static void FoldRow(EigenVectorMap<T>& acc, const ConstEigenVectorMap<T>& row) { acc += row.cwiseAbs(); }
+  static T Finalize(T acc, int64_t /*reduce_size*/) { return acc; }
+};
+
+template <typename T>
+struct ReduceAggregatorSumSquare : FoldAggregator<T, ReduceAggregatorSumSquare<T>> {
+  static T Init() { return 0; }
+  static T Fold(T acc, const ConstEigenVectorMap<T>& run) { return acc + run.squaredNorm(); }
+  static void FoldRow(EigenVectorMap<T>& acc, const ConstEigenVectorMap<T>& row) { acc += row.cwiseAbs2(); }
+  static T Finalize(T acc, int64_t /*reduce_size*/) { return acc; }
+};
+
+template <typename T>
+struct ReduceAggregatorL2 : FoldAggregator<T, ReduceAggregatorL2<T>> {
+  static T Init() { return 0; }
+  static T Fold(T acc, const ConstEigenVectorMap<T>& run) { return acc + run.squaredNorm(); }
+  static void FoldRow(EigenVectorMap<T>& acc, const ConstEigenVectorMap<T>& row) { acc += row.cwiseAbs2(); }
+  static T Finalize(T acc, int64_t /*reduce_size*/) { return static_cast<T>(std::sqrt(acc)); }
+};
+
+template <typename T>
+struct ReduceAggregatorProd : FoldAggregator<T, ReduceAggregatorProd<T>> {
+  static T Init() { return 1; }
+  static T Fold(T acc, const ConstEigenVectorMap<T>& run) { return acc * run.prod(); }
+  static void FoldRow(EigenVectorMap<T>& acc, const ConstEigenVectorMap<T>& row) { acc = acc.cwiseProduct(row); }
+  static T Finalize(T acc, int64_t /*reduce_size*/) { return acc; }
+};
+
+template <typename T>
+struct ReduceAggregatorMax : FoldAggregator<T, ReduceAggregatorMax<T>> {
+  static T Init() { return std::numeric_limits<T>::lowest(); }
+  static T Fold(T acc, const ConstEigenVectorMap<T>& run) { return std::max(acc, run.maxCoeff()); }
+  static void FoldRow(EigenVectorMap<T>& acc, const ConstEigenVectorMap<T>& row) { acc = acc.cwiseMax(row); }
+  static T Finalize(T acc, int64_t /*reduce_size*/) { return acc; }
+};
+
+template <typename T>
+struct ReduceAggregatorMin : FoldAggregator<T, ReduceAggregatorMin<T>> {
+  static T Init() { return std::numeric_limits<T>::max(); }
+  static T Fold(T acc, const ConstEigenVectorMap<T>& run) { return std::min(acc, run.minCoeff()); }
+  static void FoldRow(EigenVectorMap<T>& acc, const ConstEigenVectorMap<T>& row) { acc = acc.cwiseMin(row); }
+  static T Finalize(T acc, int64_t /*reduce_size*/) { return acc; }
+};
+
+// log(sum(exp(x))) computed as max(x) + log(sum(exp(x - max(x)))) to avoid overflow, which needs two passes.
+template <typename T>
+struct ReduceAggregatorLogSumExp {
+  static T ReduceRuns(const T* input, const int64_t* offsets, size_t num_offsets, int64_t run,
+                      int64_t reduce_size) {
+    const T max_value = ReduceAggregatorMax<T>::ReduceRuns(input, offsets, num_offsets, run, reduce_size);
+    T scaled_exp_sum = 0;
+    for (size_t i = 0; i < num_offsets; ++i) {
+      const T* data = input + offsets[i];
+      for (int64_t j = 0; j < run; ++j) {
+        scaled_exp_sum += static_cast<T>(std::exp(data[j] - max_value));
       }
     }
-  } else {
-    for (size_t index = 0; index < count; index++) {
-      int64_t from_index = 0;
-      for (int i = 0; i < itr_axes; ++i) {
-        from_index += stride_x[i] * itr_idxs[i];
-      }
+    return static_cast<T>(std::log(scaled_exp_sum) + max_value);
+  }
 
-      *(to_data + index) = *(from_data + from_index);
+  static void ReduceRows(T* output, const T* input, const int64_t* offsets, size_t num_offsets, int64_t n,
+                         int64_t reduce_size, T* scratch) {
+    T* max_values = scratch;
+    ReduceAggregatorMax<T>::ReduceRows(max_values, input, offsets, num_offsets, n, reduce_size, nullptr);
+    std::fill_n(output, n, static_cast<T>(0));
+    for (size_t i = 0; i < num_offsets; ++i) {
+      const T* data = input + offsets[i];
+      for (int64_t j = 0; j < n; ++j) {
+        output[j] += static_cast<T>(std::exp(data[j] - max_values[j]));
+      }
+    }
+    for (int64_t j = 0; j < n; ++j) {
+      output[j] = static_cast<T>(std::log(output[j]) + max_values[j]);
+    }
+  }
+};
+
+// Index of the first maximum (or minimum if is_min) along the reduced elements.
+template <typename T, bool is_min>
+struct ReduceAggregatorArg {
+  static bool IsBetter(T candidate, T best) { return is_min ? candidate < best : candidate > best; }
+
+  static int64_t ReduceRuns(const T* input, const int64_t* offsets, size_t num_offsets, int64_t run,
+                            int64_t /*reduce_size*/) {
+    int64_t best_index = 0;
+    T best_value = 0;
+    for (size_t i = 0; i < num_offsets; ++i) {
+      Eigen::Index index;
+      const auto run_values = ConstEigenVectorMap<T>(input + offsets[i], run);
+      const T value = is_min ? run_values.minCoeff(&index) : run_values.maxCoeff(&index);
+      if (i == 0 || IsBetter(value, best_value)) {
+        best_value = value;
+        best_index = static_cast<int64_t>(i) * run + index;
+      }
+    }
+    return best_index;
+  }
 
-      ++itr_idxs[itr_axes - 1];
-      for (int i = itr_axes - 1; i >= 1; --i) {
-        auto expected_dim = new_dims_[i];
-        if (itr_idxs[i] < expected_dim) {
-          break;
+  static void ReduceRows(int64_t* output, const T* input, const int64_t* offsets, size_t num_offsets, int64_t n,
+                         int64_t /*reduce_size*/, T* scratch) {
+    T* best_values = scratch;
+    std::fill_n(output, n, static_cast<int64_t>(0));
+    if (num_offsets == 0) {
+      return;
+    }
+    std::copy_n(input + offsets[0], n, best_values);
+    for (size_t i = 1; i < num_offsets; ++i) {
+      const T* data = input + offsets[i];
+      for (int64_t j = 0; j < n; ++j) {
+        if (IsBetter(data[j], best_values[j])) {
+          best_values[j] = data[j];
+          output[j] = static_cast<int64_t>(i);
         }
-        itr_idxs[i] %= expected_dim;
-        ++itr_idxs[i - 1];
       }
     }
   }
-  return false;
-}
+};
 
-template <typename T>
-Status ReduceL1<T>::Compute(OpKernelContext* ctx) const {
-  std::vector<T> transposedInputData;
-  int64_t block_size, blocks;
-  Tensor* reduced;
-  PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_);
-
-  T* output_data = reduced->template MutableData<T>();
+template <typename T, typename OutT, typename Aggregator>
+Status ComputeReduce(OpKernelContext* ctx, const std::vector<int64_t>& axes, bool keepdims) {
+  const Tensor* input_tensor_ptr = ctx->Input<Tensor>(0);
+  ORT_ENFORCE(input_tensor_ptr != nullptr);
+  const Tensor& input = *input_tensor_ptr;
 
-  EigenVectorMap<T> out_vec(output_data, block_size);
-  out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).cwiseAbs().rowwise().sum();
+  std::vector<int64_t> reduced_dims;
+  ReducePlan plan;
+  PrepareForReduce(input.Shape().GetDims(), axes, keepdims, reduced_dims, plan);
 
+  Tensor* reduced = ctx->Output(0, reduced_dims);
+  StridedReduce<T, OutT, Aggregator>(plan, input.template Data<T>(), reduced->template MutableData<OutT>(),
+                                     ctx->GetOperatorThreadPool());
   return Status::OK();
 }
 
-template <typename T>
-Status ReduceL2<T>::Compute(OpKernelContext* ctx) const {
-  std::vector<T> transposedInputData;
-  int64_t block_size, blocks;
-  Tensor* reduced;
-  PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_);
-
-  T* output_data = reduced->template MutableData<T>();
+}  // namespace
 
-  EigenVectorMap<T> out_vec(output_data, block_size);
-  out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).rowwise().norm();
+template <typename T>
+Status ReduceL1<T>::Compute(OpKernelContext* ctx) const {
+  return ComputeReduce<T, T, ReduceAggregatorL1<T>>(ctx, axes_, keepdims_);
+}
 
-  return Status::OK();
+template <typename T>
+Status ReduceL2<T>::Compute(OpKernelContext* ctx) const {
+  return ComputeReduce<T, T, ReduceAggregatorL2<T>>(ctx, axes_, keepdims_);
 }
 
 template <typename T>
 Status ReduceLogSum<T>::Compute(OpKernelContext* ctx) const {
-  std::vector<T> transposedInputData;
-  int64_t block_size, blocks;
-  Tensor* reduced;
-  PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_);
-
-  T* output_data = reduced->template MutableData<T>();
-
-  EigenVectorMap<T> out_vec(output_data, block_size);
-  out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).rowwise().sum();
-  for (int j = 0; j < block_size; ++j) {
-    *(output_data) = static_cast<T>(std::log(*(output_data)));
-    ++output_data;
-  }
-
-  return Status::OK();
+  return ComputeReduce<T, T, ReduceAggregatorLogSum<T>>(ctx, axes_, keepdims_);
 }
 
 template <typename T>
 Status ReduceLogSumExp<T>::Compute(OpKernelContext* ctx) const {
-  std::vector<T> transposedInputData;
-  int64_t block_size, blocks;
-  Tensor* reduced;
-  PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_);
-
-  T* output_data = reduced->template MutableData<T>();
-
-  for (int j = 0; j < block_size; ++j) {
-    T max_value = std::numeric_limits<T>::lowest();
-    for (int i = 0; i < blocks; ++i) {
-      max_value = std::max(max_value, transposedInputData[i * block_size + j]);
-    }
-    T scaled_exp_sum = 0;
-    for (int i = 0; i < blocks; ++i) {
-      scaled_exp_sum += static_cast<T>(std::exp(transposedInputData[i * block_size + j] - max_value));
-    }
-    *(output_data++) = static_cast<T>(std::log(scaled_exp_sum) + max_value);
-  }
-  return Status::OK();
+  return ComputeReduce<T, T, ReduceAggregatorLogSumExp<T>>(ctx, axes_, keepdims_);
 }
 
 template <typename T>
 Status ReduceMax<T>::Compute(OpKernelContext* ctx) const {
-  std::vector<T> transposedInputData;
-  int64_t block_size, blocks;
-  Tensor* reduced;
-  PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_);
-
-  T* output_data = reduced->template MutableData<T>();
-
-  EigenVectorMap<T> out_vec(output_data, block_size);
-  out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).rowwise().maxCoeff();
-
-  return Status::OK();
+  return ComputeReduce<T, T, ReduceAggregatorMax<T>>(ctx, axes_, keepdims_);
 }
 
 template <typename T>
 Status ReduceMean<T>::Compute(OpKernelContext* ctx) const {
-  std::vector<T> transposedInputData;
-  int64_t block_size, blocks;
-  Tensor* reduced;
-  bool no_transpose = PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_, true);
-
-  T* output_data = reduced->template MutableData<T>();
-
-  if (no_transpose) {
-    const T* input_data = ctx->Input<Tensor>(0)->template Data<T>();
-
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-    for (int64_t i = 0; i < block_size; ++i) {
-      output_data[i] = ConstEigenVectorMap<T>(input_data + (i * blocks), blocks).mean();
-    }
-  }
-  else {
-    EigenVectorMap<T> out_vec(output_data, block_size);
-    out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).rowwise().mean();
-  }
-
-  return Status::OK();
+  return ComputeReduce<T, T, ReduceAggregatorMean<T>>(ctx, axes_, keepdims_);
 }
 
 template <typename T>
 Status ReduceMin<T>::Compute(OpKernelContext* ctx) const {
-  std::vector<T> transposedInputData;
-  int64_t block_size, blocks;
-  Tensor* reduced;
-  PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_);
-
-  T* output_data = reduced->template MutableData<T>();
-
-  EigenVectorMap<T> out_vec(output_data, block_size);
-  out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).rowwise().minCoeff();
-
-  return Status::OK();
+  return ComputeReduce<T, T, ReduceAggregatorMin<T>>(ctx, axes_, keepdims_);
 }
 
 template <typename T>
 Status ReduceProd<T>::Compute(OpKernelContext* ctx) const {
-  std::vector<T> transposedInputData;
-  int64_t block_size, blocks;
-  Tensor* reduced;
-  PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_);
-
-  T* output_data = reduced->template MutableData<T>();
-
-  EigenVectorMap<T> out_vec(output_data, block_size);
-  out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).rowwise().prod();
-
-  return Status::OK();
+  return ComputeReduce<T, T, ReduceAggregatorProd<T>>(ctx, axes_, keepdims_);
 }
 
 template <typename T>
 Status ReduceSum<T>::Compute(OpKernelContext* ctx) const {
-  std::vector<T> transposedInputData;
-  int64_t block_size, blocks;
-  Tensor* reduced;
-  bool no_transpose = PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_, true);
-
-  T* output_data = reduced->template MutableData<T>();
-
-  if (no_transpose) {
-    const T* input_data = ctx->Input<Tensor>(0)->template Data<T>();
-
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-    for (int64_t i = 0; i < block_size; ++i) {
-      output_data[i] = ConstEigenVectorMap<T>(input_data + (i * blocks), blocks).sum();
-    }
-  }
-  else {
-    EigenVectorMap<T> out_vec(output_data, block_size);
-    out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).rowwise().sum();
-  }
-
-  return Status::OK();
+  return ComputeReduce<T, T, ReduceAggregatorSum<T>>(ctx, axes_, keepdims_);
 }
 
 template <typename T>
 Status ReduceSumSquare<T>::Compute(OpKernelContext* ctx) const {
-  std::vector<T> transposedInputData;
-  int64_t block_size, blocks;
-  Tensor* reduced;
-  PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_);
-
-  T* output_data = reduced->template MutableData<T>();
-
-  EigenVectorMap<T> out_vec(output_data, block_size);
-  out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).rowwise().squaredNorm();
-
-  return Status::OK();
+  return ComputeReduce<T, T, ReduceAggregatorSumSquare<T>>(ctx, axes_, keepdims_);
 }
 
 template <typename T>
 Status ArgMax<T>::Compute(OpKernelContext* ctx) const {
-  std::vector<T> transposedInputData;
-  int64_t block_size, blocks;
-  Tensor* reduced;
-  PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_);
-
-  int64_t* output_data = reduced->template MutableData<int64_t>();
-
-  Eigen::MatrixXf::Index maxIndex;
-  auto matrixData = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks);
-  for (int i = 0; i < block_size; ++i) {
-    matrixData.row(i).maxCoeff(&maxIndex);
-    *(output_data++) = maxIndex;
-  }
-
-  return Status::OK();
+  return ComputeReduce<T, int64_t, ReduceAggregatorArg<T, false>>(ctx, axes_, keepdims_);
 }
 
 template <typename T>
 Status ArgMin<T>::Compute(OpKernelContext* ctx) const {
-  std::vector<T> transposedInputData;
-  int64_t block_size, blocks;
-  Tensor* reduced;
-  PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_);
-
-  int64_t* output_data = reduced->template MutableData<int64_t>();
-
-  Eigen::MatrixXf::Index minIndex;
-  auto matrixData = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks);
-  for (int i = 0; i < block_size; ++i) {
-    matrixData.row(i).minCoeff(&minIndex);
-    *(output_data++) = minIndex;
-  }
-
-  return Status::OK();
+  return ComputeReduce<T, int64_t, ReduceAggregatorArg<T, true>>(ctx, axes_, keepdims_);
 }
 
 }  // namespace onnxruntime
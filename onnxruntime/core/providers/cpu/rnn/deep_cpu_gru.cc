@@ -177,11 +177,7 @@ class UniDirectionalGru {
                     const ActivationFuncs::Entry& activation_func_f,
                     const ActivationFuncs::Entry& activation_func_g,
                     const float clip,
-#ifdef USE_EIGEN_THREADPOOL
-                    Eigen::NonBlockingThreadPool& ttp_);
-#else
-                    TaskThreadPool& ttp_);
-#endif
+                    WorkStealingThreadPool* ttp_);
 
   void Compute(const gsl::span<const T>& inputs,
                const gsl::span<const int>& sequence_lengths,
@@ -197,11 +193,7 @@ class UniDirectionalGru {
   AllocatorPtr allocator_;
   const logging::Logger& logger_;
 
-#ifdef USE_EIGEN_THREADPOOL
-  Eigen::NonBlockingThreadPool& ttp_;
-#else
-  TaskThreadPool& ttp_;
-#endif
+  WorkStealingThreadPool* ttp_;
 
   int seq_length_;
   int batch_size_;
@@ -292,6 +284,7 @@ Status DeepCpuGruOp::Compute(OpKernelContext* context) const {
 template <typename T>
 Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
   auto& logger = context.Logger();
+  auto* ttp = context.GetOperatorThreadPool();
 
   const Tensor& X = *context.Input<Tensor>(0);  // inputs. [seq_length, batch_size, input_size]
   const Tensor& W = *context.Input<Tensor>(1);  // weights. [num_directions, 3*hidden_size, input_size]
@@ -389,8 +382,7 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
         bias_1, initial_hidden_1,
         activation_funcs_.Entries()[0],
         activation_funcs_.Entries()[1],
-        clip_, ttp_);
-    fw->Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1, output_1, hidden_output_1);
+        clip_, ttp);
 
     std::unique_ptr<detail::UniDirectionalGru<T>> bw = std::make_unique<detail::UniDirectionalGru<T>>(
         alloc, logger,
@@ -398,9 +390,18 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
         bias_2, initial_hidden_2,
         activation_funcs_.Entries()[2],
         activation_funcs_.Entries()[3],
-        clip_, ttp_);
-    bw->Compute(input, sequence_lens_span, num_directions_, input_weights_2, recurrent_weights_2, output_2, hidden_output_2);
+        clip_, ttp);
 
+    // the directions write to disjoint parts of the outputs, so run them concurrently.
+    WorkStealingThreadPool::TryParallelFor(ttp, 2, [&](int32_t direction) {
+      if (direction == 0) {
+        fw->Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1,
+                    output_1, hidden_output_1);
+      } else {
+        bw->Compute(input, sequence_lens_span, num_directions_, input_weights_2, recurrent_weights_2,
+                    output_2, hidden_output_2);
+      }
+    });
   } else {
     std::unique_ptr<detail::UniDirectionalGru<T>> gru_p = std::make_unique<detail::UniDirectionalGru<T>>(
         alloc, logger,
@@ -408,7 +409,7 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
         bias_1, initial_hidden_1,
         activation_funcs_.Entries()[0],
         activation_funcs_.Entries()[1],
-        clip_, ttp_);
+        clip_, ttp);
 
     gru_p->Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1, output_1, hidden_output_1);
   }
@@ -439,11 +440,7 @@ UniDirectionalGru<T>::UniDirectionalGru(AllocatorPtr allocator,
                                         const ActivationFuncs::Entry& activation_func_f,
                                         const ActivationFuncs::Entry& activation_func_g,
                                         const float clip,
-#ifdef USE_EIGEN_THREADPOOL
-                                        Eigen::NonBlockingThreadPool& ttp)
-#else
-                                        TaskThreadPool& ttp)
-#endif
+                                        WorkStealingThreadPool* ttp)
     : allocator_(allocator),
       logger_(logger),
       ttp_(ttp),
@@ -604,7 +601,7 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
     if (batch_size_ % hidden_num_threads_ != 0)
       fused_hidden_rows++;
 
-    // lambda executed by Eigen::NonBlockingThreadPool
+    // lambda executed by the intra-op thread pool
     auto hidden_gemm_and_activations = [&](const int row) {
       //handling boundaries
       int local_fused_hidden_rows = fused_hidden_rows;
@@ -640,7 +637,9 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
       }
 
       for (int step = 0; step < max_sequence_length; step++) {
+#if defined(DUMP_MATRIXES)
         const std::string row_str = " [row=" + std::to_string(row) + ",seqno=" + std::to_string(step) + "]";
+#endif
 
         DumpMatrix("Ht-1" + row_str, &*prev_Ht, local_fused_hidden_rows, hidden_size_);
 
@@ -707,7 +706,9 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
           }
         }
 
+#if defined(DUMP_MATRIXES)
         std::string label = linear_before_reset_ ? "rt (.) (Ht-1 * (Rh^T) + Rbh)" : "rt (.) Ht-1";
+#endif
         DumpMatrix(label + row_str, &*cur_h_local, local_fused_hidden_rows, hidden_size_);
 
         if (linear_before_reset_) {
@@ -726,7 +727,9 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
             }
           }
         } else {
+#if defined(DUMP_MATRIXES)
           label += " * Rh^T";
+#endif
           ComputeGemm(local_fused_hidden_rows, hidden_size_, hidden_size_, alpha,
                       cur_h_local, cur_h_local_end,
                       hidden_size_,
@@ -845,7 +848,9 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
 
     // for each item in sequence run all calculations
     for (int step = 0; step < max_sequence_length; step++) {
+#if defined(DUMP_MATRIXES)
       const std::string seqno_str = " [seqno=" + std::to_string(step) + "]";
+#endif
 
       DumpMatrix("Ht-1" + seqno_str, &*prev_Ht, batch_size_, hidden_size_);
 
@@ -911,7 +916,9 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
         }
       }
 
+#if defined(DUMP_MATRIXES)
       std::string label = linear_before_reset_ ? "rt (.) (Ht-1 * (Rh^T) + Rbh)" : "rt (.) Ht-1";
+#endif
       DumpMatrix(label + seqno_str, &*cur_h_local, batch_size_, hidden_size_);
 
       if (linear_before_reset_) {
@@ -930,7 +937,9 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
           }
         }
       } else {
+#if defined(DUMP_MATRIXES)
         label += " * Rh^T";
+#endif
 
         // out_H currently contains Xt*(Wh^T).
         auto out_H = outputZRH_.begin() + out_added_offset + hidden_size_x2;
@@ -1071,10 +1080,7 @@ void UniDirectionalGru<T>::AllocateBuffers() {
 
 template <typename T>
 void UniDirectionalGru<T>::SetNumThreads() {
-  int threads = std::thread::hardware_concurrency() - 1;
-
-  if (threads < 1)
-    threads = 1;
+  int threads = WorkStealingThreadPool::DegreeOfParallelism(ttp_);
 
   hidden_num_threads_ = threads;
   batch_parallel_ = false;
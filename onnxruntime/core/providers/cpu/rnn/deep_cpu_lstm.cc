@@ -203,11 +203,7 @@ class UniDirectionalLstm {
                      const ActivationFuncs::Entry& activation_func_g,
                      const ActivationFuncs::Entry& activation_func_h,
                      const float clip,
-#ifdef USE_EIGEN_THREADPOOL
-                     Eigen::NonBlockingThreadPool& ttp);
-#else
-                     TaskThreadPool& ttp);
-#endif
+                     WorkStealingThreadPool* ttp);
 
   void Compute(const gsl::span<const T>& inputs,
                const gsl::span<const int>& sequence_lengths,
@@ -276,10 +272,12 @@ class UniDirectionalLstm {
   gsl::span<T> internal_memory_cur_, batched_internal_memory_cur_;
   gsl::span<T> batched_internal_memory_clipped_;
 
-  IAllocatorUniquePtr<T> bias_WRi_ptr_, bias_WRf_ptr_, bias_WRo_ptr_, bias_WRc_ptr_;
+  IAllocatorUniquePtr<T> bias_WRiofc_ptr_;
   IAllocatorUniquePtr<T> batched_bias_WRi_ptr_, batched_bias_WRf_ptr_, batched_bias_WRo_ptr_, batched_bias_WRc_ptr_;
   IAllocatorUniquePtr<T> peephole_i_ptr_, peephole_f_ptr_, peephole_o_ptr_;
   IAllocatorUniquePtr<T> inputs_reverse_ptr_, outputs_reverse_ptr_;
+  // the fused bias of the gates in the IOFC order of the GEMM output. bias_WR[iofc]_ are its parts.
+  gsl::span<T> bias_WRiofc_;
   gsl::span<T> bias_WRi_, bias_WRf_, bias_WRo_, bias_WRc_;
   gsl::span<T> batched_bias_WRi_, batched_bias_WRf_, batched_bias_WRo_, *batched_bias_WRc_;
   gsl::span<T> inputs_reverse_, outputs_reverse_;
@@ -299,11 +297,7 @@ class UniDirectionalLstm {
   ActivationInfo<deepcpu::ActivationFuncPtr> activation_g_;
   ActivationInfo<deepcpu::LstmMergeGatesFuncPtr> activation_h_;
 
-#ifdef USE_EIGEN_THREADPOOL
-  Eigen::NonBlockingThreadPool& ttp_;
-#else
-  TaskThreadPool& ttp_;
-#endif
+  WorkStealingThreadPool* ttp_;
 };
 
 }  // namespace detail
@@ -338,6 +332,7 @@ DeepCpuLstmOp::Compute(OpKernelContext* context) const {
 template <typename T>
 Status DeepCpuLstmOp::ComputeImpl(OpKernelContext& context) const {
   auto& logger = context.Logger();
+  auto* ttp = context.GetOperatorThreadPool();
 
   const Tensor& X = *context.Input<Tensor>(0);  // inputs. [seq_length, batch_size, input_size]
   const Tensor& W = *context.Input<Tensor>(1);  // weights. [num_directions, 4*hidden_size, input_size]
@@ -473,7 +468,7 @@ Status DeepCpuLstmOp::ComputeImpl(OpKernelContext& context) const {
                                                          activation_funcs_.Entries()[0],
                                                          activation_funcs_.Entries()[1],
                                                          activation_funcs_.Entries()[2],
-                                                         clip_, ttp_);
+                                                         clip_, ttp);
 
     bw = std::make_unique<detail::UniDirectionalLstm<T>>(alloc, logger,
                                                          seq_length, batch_size, input_size,
@@ -482,10 +477,19 @@ Status DeepCpuLstmOp::ComputeImpl(OpKernelContext& context) const {
                                                          activation_funcs_.Entries()[3],
                                                          activation_funcs_.Entries()[4],
                                                          activation_funcs_.Entries()[5],
-                                                         clip_, ttp_);
-
-    fw->Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1, output_1, hidden_output_1, last_cell_1);
-    bw->Compute(input, sequence_lens_span, num_directions_, input_weights_2, hidden_weights_2, output_2, hidden_output_2, last_cell_2);
+                                                         clip_, ttp);
+
+    // the directions write to disjoint parts of the outputs, so run them concurrently.
+    // each one still partitions its batch across the thread pool.
+    WorkStealingThreadPool::TryParallelFor(ttp, 2, [&](int32_t direction) {
+      if (direction == 0) {
+        fw->Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1,
+                    output_1, hidden_output_1, last_cell_1);
+      } else {
+        bw->Compute(input, sequence_lens_span, num_directions_, input_weights_2, hidden_weights_2,
+                    output_2, hidden_output_2, last_cell_2);
+      }
+    });
   } else {
     fw = std::make_unique<detail::UniDirectionalLstm<T>>(alloc, logger,
                                                          seq_length, batch_size, input_size,
@@ -494,7 +498,7 @@ Status DeepCpuLstmOp::ComputeImpl(OpKernelContext& context) const {
                                                          activation_funcs_.Entries()[0],
                                                          activation_funcs_.Entries()[1],
                                                          activation_funcs_.Entries()[2],
-                                                         clip_, ttp_);
+                                                         clip_, ttp);
 
     fw->Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1, output_1, hidden_output_1, last_cell_1);
   }
@@ -566,11 +570,7 @@ UniDirectionalLstm<T>::UniDirectionalLstm(AllocatorPtr allocator,
                                           const ActivationFuncs::Entry& activation_func_g,
                                           const ActivationFuncs::Entry& activation_func_h,
                                           const float clip,
-#ifdef USE_EIGEN_THREADPOOL
-                                          Eigen::NonBlockingThreadPool& ttp)
-#else
-                                          TaskThreadPool& ttp)
-#endif
+                                          WorkStealingThreadPool* ttp)
     : allocator_(allocator),
       logger_(logger),
       seq_length_(seq_length),
@@ -626,10 +626,11 @@ void UniDirectionalLstm<T>::AllocateBuffers() {
   output_iofc_ = Allocate(allocator_, hidden_size_ * 4 * batch_size_ * seq_length_, output_iofc_ptr_, fill);
 
   if (use_bias_) {
-    bias_WRi_ = Allocate(allocator_, hidden_size_, bias_WRi_ptr_);
-    bias_WRf_ = Allocate(allocator_, hidden_size_, bias_WRf_ptr_);
-    bias_WRo_ = Allocate(allocator_, hidden_size_, bias_WRo_ptr_);
-    bias_WRc_ = Allocate(allocator_, hidden_size_, bias_WRc_ptr_);
+    bias_WRiofc_ = Allocate(allocator_, hidden_size_ * 4, bias_WRiofc_ptr_);
+    bias_WRi_ = bias_WRiofc_.subspan(0, hidden_size_);
+    bias_WRo_ = bias_WRiofc_.subspan(hidden_size_, hidden_size_);
+    bias_WRf_ = bias_WRiofc_.subspan(2 * hidden_size_, hidden_size_);
+    bias_WRc_ = bias_WRiofc_.subspan(3 * hidden_size_, hidden_size_);
   }
 
   if (direction_ == kReverse) {
@@ -1019,61 +1020,78 @@ void UniDirectionalLstm<T>::GateComputations(span_T_iter& out, span_T_iter& out_
 
     // DumpMatrix("C_prev" + row_str, pCprev_hidden_size, 1, hidden_size_);
 
-    // Input Gate
-    if (use_peepholes_) {
-      deepcpu::elementwise_product(pCprev_hidden_size, SafeRawConstPointer<const T>(peephole_i_, 0, hidden_size_),
-                                   pi, hidden_size_);
-    }
-
-    const float* pBi = use_bias_ ? SafeRawConstPointer<T>(bias_WRi_, 0, hidden_size_) : nullptr;
-    clip_with_bias_ptr_(clip_, pBi, pi, hidden_size_);  // post: pi has input to f() to calculate i
-    activation_f_.func(pi, hidden_size_, activation_f_.alpha, activation_f_.beta);
-    // DumpMatrix("i" + row_str, pi, 1, hidden_size_);
+    float* pC_cur = pCprev_hidden_size;
+    if (!use_peepholes_) {
+      // without peepholes the gates only depend on the GEMM output, so the bias and clip are applied to the
+      // whole IOFC row at once, and f() to the contiguous i, o and f gates. with coupled input and forget gates
+      // f() is only applied to i and o, and the forget gate is derived from i.
+      const float* pBiofc = use_bias_ ? SafeRawConstPointer<T>(bias_WRiofc_, 0, hidden_size_x4) : nullptr;
+      clip_with_bias_ptr_(clip_, pBiofc, pi, hidden_size_x4);
+      activation_f_.func(pi, (input_forget_ ? 2 : 3) * hidden_size_, activation_f_.alpha, activation_f_.beta);
+      if (input_forget_) {
+        for (int i = 0; i < hidden_size_; i++)
+          pf[i] = 1.0f - pi[i];
+      }
+      activation_g_.func(pc, hidden_size_, activation_g_.alpha, activation_g_.beta);
 
-    // Forget Gate
-    if (input_forget_) {
-      for (int i = 0; i < hidden_size_; i++)
-        pf[i] = 1.0f - pi[i];
+      // C_current. use previous C value as input, and update in-place
+      deepcpu::merge_lstm_gates_to_memory(pCprev_hidden_size, pi, pf, pc, pC_cur, hidden_size_);
     } else {
+      // Input Gate
       if (use_peepholes_) {
-        deepcpu::elementwise_product(pCprev_hidden_size, SafeRawConstPointer<const T>(peephole_f_, 0, hidden_size_),
-                                     pf, hidden_size_);
+        deepcpu::elementwise_product(pCprev_hidden_size, SafeRawConstPointer<const T>(peephole_i_, 0, hidden_size_),
+                                     pi, hidden_size_);
       }
 
-      const float* pBf = use_bias_ ? SafeRawConstPointer<T>(bias_WRf_, 0, hidden_size_) : nullptr;
-      clip_with_bias_ptr_(clip_, pBf, pf, hidden_size_);
-      activation_f_.func(pf, hidden_size_, activation_f_.alpha, activation_f_.beta);
-    }
+      const float* pBi = use_bias_ ? SafeRawConstPointer<T>(bias_WRi_, 0, hidden_size_) : nullptr;
+      clip_with_bias_ptr_(clip_, pBi, pi, hidden_size_);  // post: pi has input to f() to calculate i
+      activation_f_.func(pi, hidden_size_, activation_f_.alpha, activation_f_.beta);
+      // DumpMatrix("i" + row_str, pi, 1, hidden_size_);
 
-    // DumpMatrix("f" + row_str, pf, 1, hidden_size_);
+      // Forget Gate
+      if (input_forget_) {
+        for (int i = 0; i < hidden_size_; i++)
+          pf[i] = 1.0f - pi[i];
+      } else {
+        if (use_peepholes_) {
+          deepcpu::elementwise_product(pCprev_hidden_size, SafeRawConstPointer<const T>(peephole_f_, 0, hidden_size_),
+                                       pf, hidden_size_);
+        }
 
-    // Block Gate
-    const float* pBc = use_bias_ ? SafeRawConstPointer<T>(bias_WRc_, 0, hidden_size_) : nullptr;
-    clip_with_bias_ptr_(clip_, pBc, pc, hidden_size_);
-    activation_g_.func(pc, hidden_size_, activation_g_.alpha, activation_g_.beta);
+        const float* pBf = use_bias_ ? SafeRawConstPointer<T>(bias_WRf_, 0, hidden_size_) : nullptr;
+        clip_with_bias_ptr_(clip_, pBf, pf, hidden_size_);
+        activation_f_.func(pf, hidden_size_, activation_f_.alpha, activation_f_.beta);
+      }
 
-    // DumpMatrix("c" + row_str, pc, 1, hidden_size_);
+      // DumpMatrix("f" + row_str, pf, 1, hidden_size_);
 
-    // C_current. use previous C value as input, and update in-place
-    float* pC_cur = pCprev_hidden_size;
+      // Block Gate
+      const float* pBc = use_bias_ ? SafeRawConstPointer<T>(bias_WRc_, 0, hidden_size_) : nullptr;
+      clip_with_bias_ptr_(clip_, pBc, pc, hidden_size_);
+      activation_g_.func(pc, hidden_size_, activation_g_.alpha, activation_g_.beta);
+
+      // DumpMatrix("c" + row_str, pc, 1, hidden_size_);
+
+      // C_current. use previous C value as input, and update in-place
 #ifdef PREVIOUS_BROKEN_VERSION
-    deepcpu::merge_lstm_gates_to_memory(pCprev_hidden_size + b * hidden_size_, pi, pf, pc, pCprev_hidden_size + b * hidden_size_, hidden_size_);
-    // DumpMatrix("C", pCprev_hidden_size + b * hidden_size_, 1, hidden_size_);
+      deepcpu::merge_lstm_gates_to_memory(pCprev_hidden_size + b * hidden_size_, pi, pf, pc, pCprev_hidden_size + b * hidden_size_, hidden_size_);
+      // DumpMatrix("C", pCprev_hidden_size + b * hidden_size_, 1, hidden_size_);
 #else
-    deepcpu::merge_lstm_gates_to_memory(pCprev_hidden_size, pi, pf, pc, pC_cur, hidden_size_);
-    // DumpMatrix("C", pC_cur, 1, hidden_size_);
+      deepcpu::merge_lstm_gates_to_memory(pCprev_hidden_size, pi, pf, pc, pC_cur, hidden_size_);
+      // DumpMatrix("C", pC_cur, 1, hidden_size_);
 #endif
 
-    // Output Gate
-    if (use_peepholes_)
-      deepcpu::elementwise_product(pCprev_hidden_size, SafeRawConstPointer<const T>(peephole_o_, 0, hidden_size_),
-                                   po, hidden_size_);
+      // Output Gate
+      if (use_peepholes_)
+        deepcpu::elementwise_product(pCprev_hidden_size, SafeRawConstPointer<const T>(peephole_o_, 0, hidden_size_),
+                                     po, hidden_size_);
 
-    // calculate 'ot'
-    const float* pBo = use_bias_ ? SafeRawConstPointer<T>(bias_WRo_, 0, hidden_size_) : nullptr;
-    clip_with_bias_ptr_(clip_, pBo, po, hidden_size_);
-    activation_f_.func(po, hidden_size_, activation_f_.alpha, activation_f_.beta);
-    // DumpMatrix("o" + row_str, po, 1, hidden_size_);
+      // calculate 'ot'
+      const float* pBo = use_bias_ ? SafeRawConstPointer<T>(bias_WRo_, 0, hidden_size_) : nullptr;
+      clip_with_bias_ptr_(clip_, pBo, po, hidden_size_);
+      activation_f_.func(po, hidden_size_, activation_f_.alpha, activation_f_.beta);
+      // DumpMatrix("o" + row_str, po, 1, hidden_size_);
+    }
 
     // calculate 'Ht'
     float* pH = SafeRawPointer<T>(batched_output + row * hidden_size_ + b * hidden_size_,
@@ -1094,8 +1112,10 @@ void UniDirectionalLstm<T>::GateComputations(span_T_iter& out, span_T_iter& out_
     // DumpMatrix("H" + row_str, pH, 1, hidden_size_);
   }
 
+#if defined(DUMP_MATRIXES)
   auto num_rows = local_fused_hidden_rows - row;
   std::string rows_str = " rows[" + std::to_string(row) + ".." + std::to_string(num_rows) + "]";
+#endif
 
   DumpMatrix("i" + rows_str, &*out, num_rows, hidden_size_, 0, hidden_size_x4);
   DumpMatrix("o" + rows_str, &*out, num_rows, hidden_size_, 1 * hidden_size_, hidden_size_x4);
@@ -1107,10 +1127,7 @@ void UniDirectionalLstm<T>::GateComputations(span_T_iter& out, span_T_iter& out_
 
 template <typename T>
 void UniDirectionalLstm<T>::SetNumThreads() {
-  int threads = std::thread::hardware_concurrency() - 1;
-
-  if (threads < 1)
-    threads = 1;
+  int threads = WorkStealingThreadPool::DegreeOfParallelism(ttp_);
 
   hidden_num_threads_ = threads;
   batch_parallel_ = false;
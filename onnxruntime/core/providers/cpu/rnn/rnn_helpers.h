@@ -18,16 +18,11 @@
 
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
+#include "core/common/work_stealing_thread_pool.h"
 #include "core/framework/allocator.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 
-#ifdef USE_EIGEN_THREADPOOL
-#include <unsupported/Eigen/CXX11/ThreadPool>
-#else
-#include "core/common/task_thread_pool.h"
-#endif
-
 namespace onnxruntime {
 class Tensor;
 class OpKernelContext;
@@ -216,13 +211,11 @@ T* SafeRawPointer(typename gsl::span<T> span, size_t offset, size_t size) {
   return span.data() + offset;
 }
 
+// Execute lambda(i) for i in [0, max) with a stride of step, using the intra-op thread pool if provided.
+// The calling thread takes part in the work.
 template <typename TLambda>
 void ExecuteLambdaInParallel(const std::string& name, TLambda lambda, int max, int step,
-#ifdef USE_EIGEN_THREADPOOL
-                             Eigen::NonBlockingThreadPool& ttp,
-#else
-                             TaskThreadPool& ttp,
-#endif
+                             WorkStealingThreadPool* ttp,
                              const ::onnxruntime::logging::Logger& logger) {
   // #define NOTHREADS to execute the lambdas directly and in order if you need to do that to debug
 
@@ -235,40 +228,16 @@ void ExecuteLambdaInParallel(const std::string& name, TLambda lambda, int max, i
     std::bind(lambda, i)();
   }
 #else
+  const int total_tasks = max / (step > 0 ? step : 1) + (max % step > 0 ? 1 : 0);
 
-#ifdef USE_EIGEN_THREADPOOL
-  ORT_UNUSED_PARAMETER(name);
-  ORT_UNUSED_PARAMETER(logger);
-
-  std::atomic<int> done(0);
-  for (int i = 0; i < max; i += step) {
-    ttp.Schedule([lambda, i, &done]() {
-      lambda(i);
-      ++done;
-    });
-  }
-
-  int totalTasks = (int)max / (step > 0 ? step : 1) + (max % step > 0 ? 1 : 0);
-  while (done != totalTasks) {
-  }
-#else
-  std::vector<std::future<void> > task_results{};
-  task_results.reserve(static_cast<size_t>(std::ceil(max / step)));
-
-  for (int i = 0; i < max; i += step) {
-    std::packaged_task<void()> task{std::bind(lambda, i)};
-    task_results.emplace_back(task.get_future());
-    ttp.RunTask(std::move(task));
-  }
   try {
-    // wait for all and propagate any exceptions
-    for (auto& future : task_results)
-      future.get();
+    WorkStealingThreadPool::TryParallelFor(ttp, total_tasks, [&lambda, step](int32_t task) {
+      lambda(task * step);
+    });
   } catch (const std::exception& ex) {
     LOGS(logger, ERROR) << name << " - exception running tasks: " << ex.what();
     throw;
   }
-#endif  // else part of #ifdef USE_EIGEN_THREADPOOLs
 #endif  // else part of #ifdef NOTHREADS
 }
 
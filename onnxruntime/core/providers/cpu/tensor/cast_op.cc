@@ -218,7 +218,8 @@ const std::vector<MLDataType> castOpTypeConstraints{
       6,                                                                                                                           \
       9,                                                                                                                           \
       in_type,                                                                                                                     \
-      KernelDefBuilder().TypeConstraint("T1", DataTypeImpl::GetTensorType<in_type>()).TypeConstraint("T2", castOpTypeConstraints), \
+      KernelDefBuilder().TypeConstraint("T1", DataTypeImpl::GetTensorType<in_type>()).TypeConstraint("T2", castOpTypeConstraints)  \
+          .MayInplace(0, 0),                                                                                                       \
       Cast<in_type>);                                                                                                              \
                                                                                                                                    \
   template <>                                                                                                                      \
@@ -3,6 +3,7 @@
 
 #include "core/providers/cpu/tensor/concat.h"
 #include "core/providers/common.h"
+#include "core/providers/cpu/tensor/strided_copy.h"
 
 namespace onnxruntime {
 
@@ -81,28 +82,19 @@ Status Concat::Compute(OpKernelContext* ctx) const {
   Prepare p;
   ORT_RETURN_IF_ERROR(PrepareForCompute(ctx, input_count, p));
 
-  auto is_string_type = ctx->Input<Tensor>(0)->DataType() == DataTypeImpl::GetType<std::string>();
-
+  // Each input is a 2-D copy: its rows of 'input_axis_pitch' values are placed 'output_axis_pitch' apart in the
+  // output, starting at the offset of the input along the concatenated axis.
   int64_t output_offset = 0;
   auto element_bytes = p.output_tensor->DataType()->Size();
+  uint8_t* output = static_cast<uint8_t*>(p.output_tensor->MutableDataRaw());
   for (int input_index = 0; input_index < input_count; input_index++) {
     const auto& prep = p.inputs[input_index];
     auto input_axis_pitch = prep.axis_pitch;
-    const uint8_t* input = static_cast<const uint8_t*>(prep.tensor->DataRaw());
     auto input_size = prep.tensor->Shape().Size();
-
-    // Copy the data across. For every 'input_axis_pitch' values copied, we move over by the 'output_axis_pitch'
-    uint8_t* output = static_cast<uint8_t*>(p.output_tensor->MutableDataRaw());
-    for (int idxCopy = 0; idxCopy < input_size / input_axis_pitch; ++idxCopy) {
-      if (is_string_type) {
-        for (int idxItem = 0; idxItem < input_axis_pitch; ++idxItem)
-          reinterpret_cast<std::string*>(output)[output_offset + idxCopy * p.output_axis_pitch + idxItem] =
-              reinterpret_cast<const std::string*>(input)[idxCopy * input_axis_pitch + idxItem];
-      } else
-        memcpy(
-            output + (output_offset + idxCopy * p.output_axis_pitch) * element_bytes,
-            input + idxCopy * input_axis_pitch * element_bytes,
-            input_axis_pitch * element_bytes);
+    if (input_size > 0) {
+      StridedCopy({input_size / input_axis_pitch, input_axis_pitch}, {input_axis_pitch, 1}, {p.output_axis_pitch, 1},
+                  p.output_tensor->DataType(), prep.tensor->DataRaw(), output + output_offset * element_bytes,
+                  ctx->GetOperatorThreadPool());
     }
     output_offset += input_axis_pitch;
   }
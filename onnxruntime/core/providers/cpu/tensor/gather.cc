@@ -4,6 +4,8 @@
 //https://github.com/onnx/onnx/blob/master/docs/Operators.md#Gather
 #include "core/providers/cpu/tensor/gather.h"
 #include "core/common/common.h"
+#include "core/common/work_stealing_thread_pool.h"
+#include "core/providers/cpu/tensor/strided_copy.h"
 
 namespace onnxruntime {
 
@@ -30,15 +32,20 @@ Status GatherBase::PrepareForCompute(OpKernelContext* context, Prepare& p) const
   return Status::OK();
 }
 
+namespace {
+// Gathers smaller than this are not worth handing to the thread pool.
+constexpr int64_t kGatherMinBytesPerTask = 64 * 1024;
+}  // namespace
+
 template <typename Tin>
-Status GatherCopyData(const Tensor* indices_tensor, const uint8_t* src_base, uint8_t* dst_base, bool is_string_type,
-                      const size_t element_bytes, const int64_t block_size, const int64_t M,
-                      const int64_t N, const int64_t data_batch_bytes, const int64_t gathered_batch_bytes,
-                      const TensorShape& input_data_shape, const int64_t axis) {
+Status GatherCopyData(const Tensor* indices_tensor, const uint8_t* src_base, uint8_t* dst_base, MLDataType element_type,
+                      const int64_t block, const int64_t M, const int64_t N,
+                      const TensorShape& input_data_shape, const int64_t axis,
+                      WorkStealingThreadPool* thread_pool) {
   const Tin* indices_data = indices_tensor->template Data<Tin>();
 
   // Check the indices first in case there's a out of bound index.
-  // We can't merge this code in the omp loop below as omp does not allow return in the loop
+  // We can't merge this code in the parallel loop below as the tasks can't return a status
   for (int64_t i = 0; i < N; ++i) {
     Tin idx = indices_data[i];
     if (idx < 0 || idx >= input_data_shape[axis]) {
@@ -47,24 +54,26 @@ Status GatherCopyData(const Tensor* indices_tensor, const uint8_t* src_base, uin
     }
   }
 
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-  for (int64_t index = 0; index < M * N; ++index) {
-    int64_t batch = index / N, i = index % N;
+  // Each index copies a block of elements out of every one of the M batches, so the copy for a single index
+  // is the same 2-D strided copy from a different place in the input.
+  const int64_t block_bytes = block * static_cast<int64_t>(element_type->Size());
+  StridedCopyPlan plan({M, block}, {input_data_shape[axis] * block, 1}, {N * block, 1}, element_type);
 
-    const int64_t src_offset_batch = batch * data_batch_bytes;
-    const int64_t dst_offset_batch = batch * gathered_batch_bytes;
-    Tin idx = indices_data[i];
-    const int64_t src_offset = src_offset_batch + idx * block_size;
-    const int64_t dst_offset = dst_offset_batch + i * block_size;
-
-    if (is_string_type) {
-      reinterpret_cast<std::string*>(dst_base)[dst_offset / element_bytes] =
-          reinterpret_cast<const std::string*>(src_base)[src_offset / element_bytes];
-    } else {
-      memcpy(dst_base + dst_offset, src_base + src_offset, block_size);
+  auto copy_indices = [&](int64_t begin, int64_t end, WorkStealingThreadPool* copy_thread_pool) {
+    for (int64_t i = begin; i < end; ++i) {
+      plan.Run(src_base + indices_data[i] * block_bytes, dst_base + i * block_bytes, copy_thread_pool);
     }
+  };
+
+  const int64_t degree = WorkStealingThreadPool::DegreeOfParallelism(thread_pool);
+  const int64_t tasks = std::min(std::min(degree, N), M * N * block_bytes / kGatherMinBytesPerTask);
+  if (tasks <= 1) {
+    // a few large blocks are split by the copy itself
+    copy_indices(0, N, thread_pool);
+  } else {
+    WorkStealingThreadPool::TryParallelFor(thread_pool, static_cast<int32_t>(tasks), [&](int32_t task) {
+      copy_indices(N * task / tasks, N * (task + 1) / tasks, nullptr);
+    });
   }
 
   return Status::OK();
@@ -76,26 +85,22 @@ Status Gather::Compute(OpKernelContext* context) const {
 
   const TensorShape& input_data_shape = p.input_tensor->Shape();
 
-  bool is_string_type = p.input_tensor->DataType() == DataTypeImpl::GetType<std::string>();
-
-  const size_t element_bytes = p.input_tensor->DataType()->Size();
   const int64_t block = input_data_shape.SizeFromDimension(p.axis + 1);
-  const int64_t block_size = block * element_bytes;
   const int64_t M = input_data_shape.SizeToDimension(p.axis);
   const int64_t N = p.indices_tensor->Shape().Size();
-  const int64_t data_batch_bytes = input_data_shape.SizeFromDimension(p.axis) * element_bytes;
-  const int64_t gathered_batch_bytes = N * block * element_bytes;
 
   const uint8_t* src_base = static_cast<const uint8_t*>(p.input_tensor->DataRaw());
   uint8_t* dst_base = static_cast<uint8_t*>(p.output_tensor->MutableDataRaw());
+  MLDataType element_type = p.input_tensor->DataType();
+  WorkStealingThreadPool* thread_pool = context->GetOperatorThreadPool();
 
   MLDataType Tind_type = p.indices_tensor->DataType();
   if (Tind_type == DataTypeImpl::GetType<int32_t>()) {
-    return GatherCopyData<int32_t>(p.indices_tensor, src_base, dst_base, is_string_type, element_bytes,
-                                   block_size, M, N, data_batch_bytes, gathered_batch_bytes, input_data_shape, p.axis);
+    return GatherCopyData<int32_t>(p.indices_tensor, src_base, dst_base, element_type, block, M, N,
+                                   input_data_shape, p.axis, thread_pool);
   } else if (Tind_type == DataTypeImpl::GetType<int64_t>()) {
-    return GatherCopyData<int64_t>(p.indices_tensor, src_base, dst_base, is_string_type, element_bytes,
-                                   block_size, M, N, data_batch_bytes, gathered_batch_bytes, input_data_shape, p.axis);
+    return GatherCopyData<int64_t>(p.indices_tensor, src_base, dst_base, element_type, block, M, N,
+                                   input_data_shape, p.axis, thread_pool);
   }
 
   return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Type for Tind not supported yet in Gather.");
@@ -8,7 +8,7 @@ namespace onnxruntime {
 ONNX_CPU_OPERATOR_KERNEL(
     Dropout,
     7,
-    KernelDefBuilder().TypeConstraint("T", {DataTypeImpl::GetTensorType<MLFloat16>(), DataTypeImpl::GetTensorType<float>(), DataTypeImpl::GetTensorType<double>()}),
+    KernelDefBuilder().TypeConstraint("T", {DataTypeImpl::GetTensorType<MLFloat16>(), DataTypeImpl::GetTensorType<float>(), DataTypeImpl::GetTensorType<double>()}).Alias(0, 0),
     IdentityOp<true>);
 
 ONNX_CPU_OPERATOR_KERNEL(
@@ -2,7 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/tensor/slice.h"
-#include "core/providers/cpu/tensor/utils.h"
+#include "core/providers/cpu/tensor/strided_copy.h"
 using namespace ::onnxruntime::common;
 using namespace std;
 
@@ -147,12 +147,17 @@ Status SliceImpl(OpKernelContext* ctx,
                  const std::vector<int64_t>& starts) {
   TensorShape output_shape(output_dims);
   auto& output_tensor = *ctx->Output(0, output_shape);
-  auto* output = output_tensor.template MutableData<T>();
-  const auto* output_end = output + output_tensor.Shape().Size();
 
-  SliceIterator<T> input_iterator(input_tensor, starts, output_tensor.Shape().GetDims());
-  while (output != output_end)
-    *output++ = *input_iterator++;
+  // The slice is a strided view of the input, starting at 'starts'
+  const auto& input_dims = input_tensor.Shape().GetDims();
+  std::vector<int64_t> input_strides = ContiguousStrides(input_dims);
+  int64_t input_offset = 0;
+  for (size_t i = 0; i < input_dims.size(); ++i)
+    input_offset += starts[i] * input_strides[i];
+
+  StridedCopy(output_dims, input_strides, ContiguousStrides(output_dims), input_tensor.DataType(),
+              input_tensor.template Data<T>() + input_offset, output_tensor.template MutableData<T>(),
+              ctx->GetOperatorThreadPool());
 
   return Status::OK();
 }
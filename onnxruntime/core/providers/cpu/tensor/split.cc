@@ -3,8 +3,7 @@
 
 #include "core/providers/cpu/tensor/split.h"
 #include "core/providers/common.h"
-#include "core/util/math.h"
-#include "core/util/math_cpuonly.h"
+#include "core/providers/cpu/tensor/strided_copy.h"
 
 #include "gsl/gsl_util"
 
@@ -31,11 +30,9 @@ Status Split::Compute(OpKernelContext* context) const {
     status = ComputeImpl<float>(*context, input);
   else if (data_type == DataTypeImpl::GetType<int32_t>())
     status = ComputeImpl<int32_t>(*context, input);
-  else if (data_type == DataTypeImpl::GetType<double>()) {
-    /* Need to update CopyMatrix to support double...
-    status = ComputeImpl<double>(*context, input); */
-    ORT_NOT_IMPLEMENTED("Split operator does not support double yet");
-  } else
+  else if (data_type == DataTypeImpl::GetType<double>())
+    status = ComputeImpl<double>(*context, input);
+  else
     ORT_THROW("Invalid data type for Split operator of ", data_type);
 
   return status;
@@ -53,11 +50,11 @@ Status Split::ComputeImpl(OpKernelContext& context, const Tensor& input) const {
   std::vector<Tensor*> outputs;
   outputs.reserve(num_outputs);
 
-  int before_dims = gsl::narrow<int>(input_shape.SizeToDimension(axis));
-  int after_dims_including_split_axis = gsl::narrow<int>(input_shape.SizeFromDimension(axis));
-  int after_dims_excluding_split = (axis + 1 == num_dimensions)
-                                       ? 1  // we multiply by this value so must be 1 not 0
-                                       : gsl::narrow<int>(input_shape.SizeFromDimension(axis + 1));
+  const int64_t before_dims = input_shape.SizeToDimension(axis);
+  const int64_t after_dims_including_split_axis = input_shape.SizeFromDimension(axis);
+  const int64_t after_dims_excluding_split = (axis + 1 == num_dimensions)
+                                                 ? 1  // we multiply by this value so must be 1 not 0
+                                                 : input_shape.SizeFromDimension(axis + 1);
 
   std::vector<int64_t> split_sizes;
 
@@ -90,22 +87,16 @@ Status Split::ComputeImpl(OpKernelContext& context, const Tensor& input) const {
 
   for (int i = 0; i < num_outputs; ++i) {
     // update size of dimension for axis we're splitting on
-    auto split_size = gsl::narrow<int>(split_sizes[i]);
+    auto split_size = split_sizes[i];
     output_dimensions[axis] = split_size;
 
     Tensor* output = context.Output(i, TensorShape{output_dimensions});
     T* output_data = output->template MutableData<T>();
 
-    ::onnxruntime::math::CopyMatrix<T>(
-        before_dims,                                       // M
-        split_size * after_dims_excluding_split,           // N
-        static_cast<const T*>(input_data + input_offset),  // A
-        after_dims_including_split_axis,                   // lda
-        static_cast<T*>(output_data),                      // B
-        split_size * after_dims_excluding_split,           // ldb
-        [](const T* src, T* dst, size_t count) {
-          memcpy(dst, src, count * sizeof(T));
-        });
+    // each output is 'before_dims' rows of the input, which are 'after_dims_including_split_axis' apart
+    const int64_t output_row_size = split_size * after_dims_excluding_split;
+    StridedCopy({before_dims, output_row_size}, {after_dims_including_split_axis, 1}, {output_row_size, 1},
+                input.DataType(), input_data + input_offset, output_data, context.GetOperatorThreadPool());
 
     input_offset += split_size * after_dims_excluding_split;  // offset by the N data we used in this iteration
   }
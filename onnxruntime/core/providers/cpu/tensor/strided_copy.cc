@@ -0,0 +1,290 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cpu/tensor/strided_copy.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#include "core/common/work_stealing_thread_pool.h"
+
+namespace onnxruntime {
+
+namespace {
+
+// Copies smaller than this are not worth handing to the thread pool.
+constexpr int64_t kStridedCopyMinBytesPerTask = 64 * 1024;
+
+// Side of the square tiles used by transposing copies. A tile row covers a 64 byte cache line.
+template <typename T>
+constexpr int64_t TileSize() {
+  return sizeof(T) >= 8 ? 8 : 64 / static_cast<int64_t>(sizeof(T));
+}
+
+template <typename T>
+inline void CopyContiguous(const T* source, T* target, int64_t count) {
+  memcpy(target, source, static_cast<size_t>(count) * sizeof(T));
+}
+
+inline void CopyContiguous(const std::string* source, std::string* target, int64_t count) {
+  std::copy(source, source + count, target);
+}
+
+template <typename T>
+inline void CopyStrided(const T* source, int64_t source_stride, T* target, int64_t target_stride, int64_t count) {
+  for (int64_t i = 0; i < count; ++i) {
+    target[i * target_stride] = source[i * source_stride];
+  }
+}
+
+// Copies a rows x cols block, target[r * target_row_stride + c * target_col_stride] =
+// source[r * source_row_stride + c * source_col_stride], one tile at a time so that the cache lines touched on the
+// strided side of the copy are reused for the whole tile.
+template <typename T>
+void CopyTiled(const T* source, int64_t source_row_stride, int64_t source_col_stride,
+               T* target, int64_t target_row_stride, int64_t target_col_stride,
+               int64_t rows, int64_t cols) {
+  constexpr int64_t kTile = TileSize<T>();
+
+  // The layout produced by Transpose: rows are contiguous in the source and columns in the target.
+  // Full tiles have a fixed trip count so the compiler can unroll them.
+  const bool transpose_layout = source_row_stride == 1 && target_col_stride == 1;
+
+  for (int64_t r0 = 0; r0 < rows; r0 += kTile) {
+    const int64_t r1 = std::min(rows, r0 + kTile);
+    for (int64_t c0 = 0; c0 < cols; c0 += kTile) {
+      const int64_t c1 = std::min(cols, c0 + kTile);
+      if (transpose_layout && r1 - r0 == kTile && c1 - c0 == kTile) {
+        const T* s = source + r0 + c0 * source_col_stride;
+        T* t = target + r0 * target_row_stride + c0;
+        for (int64_t r = 0; r < kTile; ++r) {
+          for (int64_t c = 0; c < kTile; ++c) {
+            t[r * target_row_stride + c] = s[r + c * source_col_stride];
+          }
+        }
+      } else {
+        for (int64_t r = r0; r < r1; ++r) {
+          const T* s = source + r * source_row_stride;
+          T* t = target + r * target_row_stride;
+          for (int64_t c = c0; c < c1; ++c) {
+            t[c * target_col_stride] = s[c * source_col_stride];
+          }
+        }
+      }
+    }
+  }
+}
+
+}  // namespace
+
+StridedCopyPlan::StridedCopyPlan(const std::vector<int64_t>& dims,
+                                 const std::vector<int64_t>& source_strides,
+                                 const std::vector<int64_t>& target_strides,
+                                 MLDataType element_type)
+    : element_size_(element_type->Size()),
+      is_string_(element_type == DataTypeImpl::GetType<std::string>()) {
+  ORT_ENFORCE(dims.size() == source_strides.size() && dims.size() == target_strides.size(),
+              "StridedCopyPlan requires a source and a target stride for each axis");
+
+  // Drop the axes of size 1 and fold each axis into its outer neighbour when they form a single run of
+  // elements in both buffers.
+  std::vector<Axis> axes;
+  auto append_axis = [&axes](const Axis& axis) {
+    if (!axes.empty()) {
+      Axis& outer = axes.back();
+      if (outer.source_stride == axis.source_stride * axis.dim &&
+          outer.target_stride == axis.target_stride * axis.dim) {
+        outer = {outer.dim * axis.dim, axis.source_stride, axis.target_stride};
+        return;
+      }
+    }
+    axes.push_back(axis);
+  };
+
+  for (size_t i = 0; i < dims.size(); ++i) {
+    size_ *= dims[i];
+    if (dims[i] != 1)
+      append_axis({dims[i], source_strides[i], target_strides[i]});
+  }
+
+  // Elements without a matching unsigned integer type are copied as bytes
+  if (!is_string_ && element_size_ != 1 && element_size_ != 2 && element_size_ != 4 && element_size_ != 8) {
+    const auto element_size = static_cast<int64_t>(element_size_);
+    for (auto& axis : axes) {
+      axis.source_stride *= element_size;
+      axis.target_stride *= element_size;
+    }
+    append_axis({element_size, 1, 1});
+    copy_as_bytes_ = true;
+  }
+
+  if (axes.empty())
+    axes.push_back({1, 1, 1});
+
+  inner_axis_ = axes.back();
+  axes.pop_back();
+
+  if (inner_axis_.source_stride == 1 && inner_axis_.target_stride == 1) {
+    inner_kind_ = InnerKind::kContiguous;
+  } else {
+    inner_kind_ = InnerKind::kStrided;
+
+    // Look for the innermost axis that is contiguous in the buffer where the innermost axis is not.
+    // Copying those two axes together is a 2-D transpose.
+    for (size_t i = axes.size(); i-- > 0;) {
+      if ((inner_axis_.target_stride == 1 && axes[i].source_stride == 1) ||
+          (inner_axis_.source_stride == 1 && axes[i].target_stride == 1)) {
+        tile_axis_ = axes[i];
+        axes.erase(axes.begin() + i);
+        inner_kind_ = InnerKind::kTransposed;
+        break;
+      }
+    }
+  }
+
+  outer_axes_ = std::move(axes);
+}
+
+void StridedCopyPlan::Run(const void* source, void* target, WorkStealingThreadPool* thread_pool) const {
+  if (size_ == 0)
+    return;
+
+  if (is_string_) {
+    RunTyped(static_cast<const std::string*>(source), static_cast<std::string*>(target), thread_pool);
+    return;
+  }
+
+  switch (copy_as_bytes_ ? 1 : element_size_) {
+    case sizeof(uint64_t):
+      RunTyped(static_cast<const uint64_t*>(source), static_cast<uint64_t*>(target), thread_pool);
+      break;
+    case sizeof(uint32_t):
+      RunTyped(static_cast<const uint32_t*>(source), static_cast<uint32_t*>(target), thread_pool);
+      break;
+    case sizeof(uint16_t):
+      RunTyped(static_cast<const uint16_t*>(source), static_cast<uint16_t*>(target), thread_pool);
+      break;
+    default:
+      RunTyped(static_cast<const uint8_t*>(source), static_cast<uint8_t*>(target), thread_pool);
+      break;
+  }
+}
+
+template <typename T>
+void StridedCopyPlan::RunTyped(const T* source, T* target, WorkStealingThreadPool* thread_pool) const {
+  int64_t outer_count = 1;
+  for (const auto& axis : outer_axes_)
+    outer_count *= axis.dim;
+
+  // The axis that is divided when there are fewer outer iterations than tasks
+  const int64_t split_dim = inner_kind_ == InnerKind::kTransposed ? tile_axis_.dim : inner_axis_.dim;
+
+  const int64_t tasks = std::min(static_cast<int64_t>(WorkStealingThreadPool::DegreeOfParallelism(thread_pool)),
+                                 size_ * static_cast<int64_t>(element_size_) / kStridedCopyMinBytesPerTask);
+  if (tasks <= 1) {
+    RunUnits(source, target, 0, outer_count, 1, split_dim);
+    return;
+  }
+
+  int64_t parts = 1;
+  int64_t part_size = split_dim;
+  if (tasks > outer_count) {
+    parts = std::min(split_dim, (tasks + outer_count - 1) / outer_count);
+    part_size = (split_dim + parts - 1) / parts;
+    if (inner_kind_ == InnerKind::kTransposed) {
+      // keep the parts aligned to whole tiles
+      constexpr int64_t kTile = TileSize<T>();
+      part_size = (part_size + kTile - 1) / kTile * kTile;
+    }
+    parts = (split_dim + part_size - 1) / part_size;
+  }
+
+  const int64_t units = outer_count * parts;
+  const int64_t task_count = std::min(tasks, units);
+  WorkStealingThreadPool::TryParallelFor(thread_pool, static_cast<int32_t>(task_count), [&](int32_t task) {
+    RunUnits(source, target, units * task / task_count, units * (task + 1) / task_count, parts, part_size);
+  });
+}
+
+// A unit of work is one part of the split axis for one position in the outer axes.
+template <typename T>
+void StridedCopyPlan::RunUnits(const T* source, T* target, int64_t begin, int64_t end,
+                               int64_t parts, int64_t part_size) const {
+  if (begin >= end)
+    return;
+
+  const size_t rank = outer_axes_.size();
+  std::vector<int64_t> index(rank);
+  int64_t source_offset = 0;
+  int64_t target_offset = 0;
+  int64_t outer = begin / parts;
+  for (size_t i = rank; i-- > 0;) {
+    const Axis& axis = outer_axes_[i];
+    index[i] = outer % axis.dim;
+    outer /= axis.dim;
+    source_offset += index[i] * axis.source_stride;
+    target_offset += index[i] * axis.target_stride;
+  }
+
+  const int64_t split_dim = inner_kind_ == InnerKind::kTransposed ? tile_axis_.dim : inner_axis_.dim;
+  int64_t part = begin % parts;
+
+  for (int64_t unit = begin; unit < end; ++unit) {
+    const int64_t first = part * part_size;
+    const int64_t count = std::min(part_size, split_dim - first);
+    const T* s = source + source_offset;
+    T* t = target + target_offset;
+
+    switch (inner_kind_) {
+      case InnerKind::kContiguous:
+        CopyContiguous(s + first, t + first, count);
+        break;
+      case InnerKind::kStrided:
+        CopyStrided(s + first * inner_axis_.source_stride, inner_axis_.source_stride,
+                    t + first * inner_axis_.target_stride, inner_axis_.target_stride, count);
+        break;
+      case InnerKind::kTransposed:
+        CopyTiled(s + first * tile_axis_.source_stride, tile_axis_.source_stride, inner_axis_.source_stride,
+                  t + first * tile_axis_.target_stride, tile_axis_.target_stride, inner_axis_.target_stride,
+                  count, inner_axis_.dim);
+        break;
+    }
+
+    if (++part == parts) {
+      part = 0;
+      for (size_t i = rank; i-- > 0;) {
+        const Axis& axis = outer_axes_[i];
+        source_offset += axis.source_stride;
+        target_offset += axis.target_stride;
+        if (++index[i] < axis.dim)
+          break;
+        index[i] = 0;
+        source_offset -= axis.source_stride * axis.dim;
+        target_offset -= axis.target_stride * axis.dim;
+      }
+    }
+  }
+}
+
+std::vector<int64_t> ContiguousStrides(const std::vector<int64_t>& dims) {
+  std::vector<int64_t> strides(dims.size());
+  int64_t stride = 1;
+  for (size_t i = dims.size(); i-- > 0;) {
+    strides[i] = stride;
+    stride *= dims[i];
+  }
+  return strides;
+}
+
+void StridedCopy(const std::vector<int64_t>& dims,
+                 const std::vector<int64_t>& source_strides,
+                 const std::vector<int64_t>& target_strides,
+                 MLDataType element_type,
+                 const void* source,
+                 void* target,
+                 WorkStealingThreadPool* thread_pool) {
+  StridedCopyPlan(dims, source_strides, target_strides, element_type).Run(source, target, thread_pool);
+}
+
+}  // namespace onnxruntime
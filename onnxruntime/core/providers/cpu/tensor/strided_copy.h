@@ -0,0 +1,85 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/data_types.h"
+
+namespace onnxruntime {
+
+class WorkStealingThreadPool;
+
+/**
+A copy of an N-D block of elements between two buffers, each with its own per-axis strides (in elements).
+This is the data movement primitive shared by Transpose, Slice, Concat, Split and Gather.
+
+The plan is built once and can be run against any number of source/target pairs with the same layout:
+  - axes of size 1 are dropped and axes that are contiguous with the next inner axis in both buffers are
+    coalesced, so e.g. a Concat of NCHW tensors on C is a 2-D copy of contiguous runs.
+  - when the innermost axis is contiguous in both buffers each row is copied with memcpy.
+  - when the innermost axis is contiguous in only one of the buffers and some outer axis is contiguous in
+    the other, the copy is a transpose of those two axes and is done in cache sized tiles.
+  - large copies are split across the thread pool, if any.
+*/
+class StridedCopyPlan {
+ public:
+  StridedCopyPlan(const std::vector<int64_t>& dims,
+                  const std::vector<int64_t>& source_strides,
+                  const std::vector<int64_t>& target_strides,
+                  MLDataType element_type);
+
+  // Number of elements copied by each Run
+  int64_t Size() const { return size_; }
+
+  void Run(const void* source, void* target, WorkStealingThreadPool* thread_pool = nullptr) const;
+
+ private:
+  enum class InnerKind {
+    kContiguous,  // the innermost axis is contiguous in both buffers
+    kStrided,     // the innermost axis is copied element by element
+    kTransposed,  // the innermost axis and tile_axis_ are copied as a blocked 2-D transpose
+  };
+
+  struct Axis {
+    int64_t dim;
+    int64_t source_stride;
+    int64_t target_stride;
+  };
+
+  template <typename T>
+  void RunTyped(const T* source, T* target, WorkStealingThreadPool* thread_pool) const;
+
+  template <typename T>
+  void RunUnits(const T* source, T* target, int64_t begin, int64_t end, int64_t parts, int64_t part_size) const;
+
+  size_t element_size_;
+  bool is_string_;
+  bool copy_as_bytes_ = false;
+  int64_t size_ = 1;
+
+  std::vector<Axis> outer_axes_;  // the axes iterated around the inner copy, outermost first
+  Axis inner_axis_{1, 1, 1};
+  Axis tile_axis_{1, 0, 0};  // only used by kTransposed
+  InnerKind inner_kind_ = InnerKind::kContiguous;
+};
+
+/**
+Strides, in elements, of a dense row-major buffer with the given dims. Unlike TensorPitches this handles rank 0.
+*/
+std::vector<int64_t> ContiguousStrides(const std::vector<int64_t>& dims);
+
+/**
+Convenience wrapper that builds a StridedCopyPlan and runs it once.
+*/
+void StridedCopy(const std::vector<int64_t>& dims,
+                 const std::vector<int64_t>& source_strides,
+                 const std::vector<int64_t>& target_strides,
+                 MLDataType element_type,
+                 const void* source,
+                 void* target,
+                 WorkStealingThreadPool* thread_pool = nullptr);
+
+}  // namespace onnxruntime
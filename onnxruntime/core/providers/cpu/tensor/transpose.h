@@ -13,9 +13,10 @@ class TransposeBase {
  public:
   /**
   Transpose the input Tensor into the output Tensor using the provided permutations.
-  Both Tensors must have the same data type. 
+  Both Tensors must have the same data type. Large copies are split across thread_pool when one is provided.
   */
-  static Status DoTranspose(const std::vector<int64_t>& permutations, const Tensor& input, Tensor& output);
+  static Status DoTranspose(const std::vector<int64_t>& permutations, const Tensor& input, Tensor& output,
+                            WorkStealingThreadPool* thread_pool = nullptr);
 
  protected:
   TransposeBase(const OpKernelInfo& info) {
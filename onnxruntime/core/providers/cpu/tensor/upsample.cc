@@ -3,6 +3,8 @@
 
 #include "core/providers/cpu/tensor/upsample.h"
 #include <math.h>  //for fabs
+#include <cstring>
+#include "core/common/work_stealing_thread_pool.h"
 
 using namespace ::onnxruntime::common;
 using namespace std;
@@ -29,63 +31,113 @@ ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<uint8_t>()),
     Upsample<uint8_t>);
 
-template <typename T>
-void UpsampleNearest2x(
-    int64_t batch_size,
-    int64_t num_channels,
-    int64_t input_height,
-    int64_t input_width,
-    const T* input,
-    T* output) {
-  const int64_t output_height = input_height * 2;
-  const int64_t output_width = input_width * 2;
-  for (int64_t n = 0; n < batch_size; ++n) {
-    for (int64_t c = 0; c < num_channels; ++c) {
-      for (int64_t y = 0; y < output_height; ++y) {
-        const int64_t in_y = y / 2;
-        for (int64_t x = 0; x < input_width; ++x) {
-          const T v = input[in_y * input_width + x];
-          const int64_t oidx = output_width * y + x * 2;
-          output[oidx + 0] = v;
-          output[oidx + 1] = v;
-        }
-      }
-      input += input_height * input_width;
-      output += output_height * output_width;
+namespace {
+
+// The work is split across the thread pool by N x C planes, and only if the output is large enough.
+constexpr int64_t kUpsampleMinElementsPerTask = 16384;
+
+template <typename F>
+void ParallelForPlanes(WorkStealingThreadPool* thread_pool, int64_t planes, int64_t plane_size, F fn) {
+  const int64_t tasks = std::min(std::min<int64_t>(WorkStealingThreadPool::DegreeOfParallelism(thread_pool), planes),
+                                 planes * plane_size / kUpsampleMinElementsPerTask);
+  if (tasks <= 1) {
+    for (int64_t plane = 0; plane < planes; ++plane) {
+      fn(plane);
+    }
+    return;
+  }
+
+  WorkStealingThreadPool::TryParallelFor(thread_pool, static_cast<int32_t>(tasks), [&](int32_t task) {
+    for (int64_t plane = planes * task / tasks; plane < planes * (task + 1) / tasks; ++plane) {
+      fn(plane);
     }
+  });
+}
+
+// Computes the two source coordinates of each output coordinate for linear interpolation, scaled by stride,
+// and the weights of the other source.
+void ComputeLinearTable(int64_t output_size, int64_t input_size, float scale, int64_t stride,
+                        std::vector<int64_t>& in1, std::vector<int64_t>& in2,
+                        std::vector<float>& d1, std::vector<float>& d2) {
+  in1.resize(output_size);
+  in2.resize(output_size);
+  d1.resize(output_size);
+  d2.resize(output_size);
+
+  for (int64_t i = 0; i < output_size; ++i) {
+    float in = std::min(i / scale, static_cast<float>(input_size - 1));
+    const int64_t i1 = std::min(static_cast<int64_t>(in), input_size - 1);
+    const int64_t i2 = std::min(i1 + 1, input_size - 1);
+    if (i1 == i2) {
+      d1[i] = 0.5f;
+      d2[i] = 0.5f;
+    } else {
+      d1[i] = std::abs(in - i1);
+      d2[i] = std::abs(in - i2);
+    }
+    in1[i] = i1 * stride;
+    in2[i] = i2 * stride;
   }
 }
 
+// Upsamples the block of the output for one coordinate of dimension dim - 1. A block whose source is the same
+// as that of the block before it is copied instead of gathered again.
 template <typename T>
-Status UpsampleNearest(const T* input,
-                       T* output,
-                       const TensorShape& input_shape,
-                       const TensorShape& output_shape,
-                       const vector<float>& scales) {
-  if (!input || !output)
-    return Status(ONNXRUNTIME, FAIL, "Upsample: input/output value is nullptr");
-  if (input_shape.NumDimensions() != output_shape.NumDimensions())
-    return Status(ONNXRUNTIME, FAIL, "Upsample: input/output value's dimension mismatch");
-  auto n_dim = input_shape.NumDimensions();
-  if (scales.size() == 4 && scales[0] == 1 && scales[1] == 1 && scales[2] == 2 && scales[3] == 2) {
-    UpsampleNearest2x<T>(input_shape[0], input_shape[1], input_shape[2], input_shape[3], input, output);
-  } else {
-    for (size_t i = 0, size = output_shape.Size(); i < size; i++) {
-      size_t old_idx = 0;
-      size_t cur_idx = i;
+void UpsampleNearestBlock(const T* input, T* output, size_t dim, const UpsampleTables& tables,
+                          const std::vector<int64_t>& output_strides) {
+  const std::vector<int64_t>& offsets = tables.nearest_offsets[dim];
+  const int64_t output_size = tables.output_dims[dim];
 
-      int64_t base = 1;
-      for (int64_t j = static_cast<int64_t>(n_dim - 1); j >= 0; j--) {
-        auto tmp = cur_idx % output_shape[j];
-        old_idx += (std::min(static_cast<int64_t>(tmp / scales[j]), input_shape[j] - 1)) * base;
-        base *= input_shape[j];
-        cur_idx /= output_shape[j];
-      }
+  if (dim + 1 == tables.output_dims.size()) {
+    for (int64_t i = 0; i < output_size; ++i) {
+      output[i] = input[offsets[i]];
+    }
+    return;
+  }
 
-      output[i] = input[old_idx];
+  const int64_t block_size = output_strides[dim];
+  for (int64_t i = 0; i < output_size; ++i) {
+    if (i > 0 && offsets[i] == offsets[i - 1]) {
+      memcpy(output + i * block_size, output + (i - 1) * block_size, block_size * sizeof(T));
+    } else {
+      UpsampleNearestBlock(input + offsets[i], output + i * block_size, dim + 1, tables, output_strides);
     }
   }
-  return Status::OK();
+}
+
+}  // namespace
+
+template <typename T>
+void UpsampleNearest(const T* input, T* output, const UpsampleTables& tables, WorkStealingThreadPool* thread_pool) {
+  const std::vector<int64_t>& output_dims = tables.output_dims;
+  const size_t n_dim = output_dims.size();
+  if (n_dim == 0) {
+    output[0] = input[0];
+    return;
+  }
+
+  std::vector<int64_t> output_strides(n_dim, 1);
+  for (size_t j = n_dim - 1; j-- > 0;) {
+    output_strides[j] = output_strides[j + 1] * output_dims[j + 1];
+  }
+
+  // the planes are the (N, C) coordinates of the output, or the rows of a 2-D output.
+  const size_t plane_dims = std::min<size_t>(2, n_dim - 1);
+  int64_t planes = 1;
+  for (size_t j = 0; j < plane_dims; ++j) {
+    planes *= output_dims[j];
+  }
+  const int64_t plane_size = plane_dims > 0 ? output_strides[plane_dims - 1] : output_strides[0] * output_dims[0];
+
+  ParallelForPlanes(thread_pool, planes, plane_size, [&](int64_t plane) {
+    int64_t input_offset = 0;
+    int64_t remaining = plane;
+    for (size_t j = plane_dims; j-- > 0;) {
+      input_offset += tables.nearest_offsets[j][remaining % output_dims[j]];
+      remaining /= output_dims[j];
+    }
+    UpsampleNearestBlock(input + input_offset, output + plane * plane_size, plane_dims, tables, output_strides);
+  });
 }
 
 //This is a generic upsample in linear mode for N-D tensor.
@@ -145,61 +197,83 @@ Status upsampleLiner(const T* input,
 }
 
 template <typename T>
-void upsampleBilinear(
-    int64_t batch_size,
-    int64_t num_channels,
-    int64_t input_height,
-    int64_t input_width,
-    float height_scale,
-    float width_scale,
-    const T* Xdata,
-    T* Ydata) {
-  int64_t output_width = static_cast<int64_t>(input_width * width_scale);
-  int64_t output_height = static_cast<int64_t>(input_height * height_scale);
-
-  for (int64_t n = 0; n < batch_size; ++n) {
-    for (int64_t c = 0; c < num_channels; ++c) {
-      for (int64_t y = 0; y < output_height; ++y) {
-        float in_y = std::min(y / height_scale, static_cast<float>(input_height - 1));
-        const int64_t in_y1 = std::min(static_cast<int64_t>(in_y), input_height - 1);
-        const int64_t in_y2 = std::min(in_y1 + 1, input_height - 1);
-        float dy1 = fabs(in_y - in_y1);
-        float dy2 = fabs(in_y - in_y2);
-        if (in_y1 == in_y2) {
-          dy1 = 0.5f;
-          dy2 = 0.5f;
-        }
-
-        const int64_t input_width_mul_y1 = input_width * in_y1;
-        const int64_t input_width_mul_y2 = input_width * in_y2;
-
-        for (int64_t x = 0; x < output_width; ++x) {
-          float in_x = std::min(x / width_scale, static_cast<float>(input_width - 1));
-          const int64_t in_x1 = std::min(static_cast<int64_t>(in_x), input_width - 1);
-          const int64_t in_x2 = std::min(in_x1 + 1, input_width - 1);
-
-          float dx1 = std::abs(in_x - in_x1);
-          float dx2 = std::abs(in_x - in_x2);
-          if (in_x1 == in_x2) {
-            dx1 = 0.5f;
-            dx2 = 0.5f;
-          }
-
-          T X11 = Xdata[input_width_mul_y1 + in_x1];
-          T X21 = Xdata[input_width_mul_y1 + in_x2];
-          T X12 = Xdata[input_width_mul_y2 + in_x1];
-          T X22 = Xdata[input_width_mul_y2 + in_x2];
-
-          Ydata[output_width * y + x] = static_cast<T>(dx2 * dy2 * X11 +
-                                                       dx1 * dy2 * X21 +
-                                                       dx2 * dy1 * X12 +
-                                                       dx1 * dy1 * X22);
-        }
+void UpsampleBilinear(int64_t planes,
+                      int64_t input_height,
+                      int64_t input_width,
+                      const UpsampleTables& tables,
+                      const T* Xdata,
+                      T* Ydata,
+                      WorkStealingThreadPool* thread_pool) {
+  const int64_t output_height = tables.output_dims[2];
+  const int64_t output_width = tables.output_dims[3];
+
+  const int64_t* in_x1 = tables.in_x1.data();
+  const int64_t* in_x2 = tables.in_x2.data();
+  const float* dx1 = tables.dx1.data();
+  const float* dx2 = tables.dx2.data();
+
+  ParallelForPlanes(thread_pool, planes, output_height * output_width, [&](int64_t plane) {
+    const T* X = Xdata + plane * input_height * input_width;
+    T* Y = Ydata + plane * output_height * output_width;
+
+    for (int64_t y = 0; y < output_height; ++y) {
+      const T* X1 = X + tables.in_y1[y];
+      const T* X2 = X + tables.in_y2[y];
+      const float dy1 = tables.dy1[y];
+      const float dy2 = tables.dy2[y];
+      T* Yrow = Y + output_width * y;
+
+      for (int64_t x = 0; x < output_width; ++x) {
+        Yrow[x] = static_cast<T>(dx2[x] * dy2 * X1[in_x1[x]] +
+                                 dx1[x] * dy2 * X1[in_x2[x]] +
+                                 dx2[x] * dy1 * X2[in_x1[x]] +
+                                 dx1[x] * dy1 * X2[in_x2[x]]);
+      }
+    }
+  });
+}
+
+template <typename T>
+std::shared_ptr<const UpsampleTables> Upsample<T>::GetTables(const std::vector<int64_t>& input_dims,
+                                                             const std::vector<float>& scales) const {
+  {
+    std::lock_guard<OrtMutex> lock(tables_mutex_);
+    if (tables_ != nullptr && tables_->input_dims == input_dims && tables_->scales == scales) {
+      return tables_;
+    }
+  }
+
+  auto tables = std::make_shared<UpsampleTables>();
+  tables->input_dims = input_dims;
+  tables->scales = scales;
+
+  const size_t n_dim = input_dims.size();
+  for (size_t i = 0; i < n_dim; i++) {
+    tables->output_dims.push_back(static_cast<int64_t>(scales[i] * input_dims[i]));
+  }
+  const std::vector<int64_t>& output_dims = tables->output_dims;
+
+  if (mode_ == UpsampleMode::NN) {
+    tables->nearest_offsets.resize(n_dim);
+    int64_t input_stride = 1;
+    for (size_t j = n_dim; j-- > 0;) {
+      std::vector<int64_t>& offsets = tables->nearest_offsets[j];
+      offsets.resize(output_dims[j]);
+      for (int64_t i = 0; i < output_dims[j]; ++i) {
+        offsets[i] = std::min(static_cast<int64_t>(i / scales[j]), input_dims[j] - 1) * input_stride;
       }
-      Xdata += input_height * input_width;
-      Ydata += output_width * output_height;
+      input_stride *= input_dims[j];
     }
+  } else {
+    ComputeLinearTable(output_dims[2], input_dims[2], scales[2], input_dims[3],
+                       tables->in_y1, tables->in_y2, tables->dy1, tables->dy2);
+    ComputeLinearTable(output_dims[3], input_dims[3], scales[3], 1,
+                       tables->in_x1, tables->in_x2, tables->dx1, tables->dx2);
   }
+
+  std::lock_guard<OrtMutex> lock(tables_mutex_);
+  tables_ = tables;
+  return tables;
 }
 
 template <typename T>
@@ -212,26 +286,25 @@ Status Upsample<T>::BaseCompute(OpKernelContext* context, const std::vector<floa
     return Status(ONNXRUNTIME, INVALID_ARGUMENT, "Upsample: input tensor's dimension does not match the scales.");
   }
 
-  std::vector<int64_t> Y_dims;
-  for (std::size_t i = 0; i < dims.size(); i++) {
-    Y_dims.push_back(static_cast<int64_t>(scales[i] * dims[i]));
-  }
-  Tensor* Y = context->Output(0, Y_dims);
+  //What's the correct behavior of linear mode is not clear right now,
+  //Only support bilinear with 4D tensor to keep consistent with previous behavior
+  if (mode_ == UpsampleMode::LINEAR && dims.size() != 4)
+    return Status(ONNXRUNTIME, FAIL, "Upsample: linear mode upsample only support 4-D tensor with NCHW layout");
+
+  std::shared_ptr<const UpsampleTables> tables = GetTables(dims, scales);
+  Tensor* Y = context->Output(0, tables->output_dims);
 
   switch (mode_) {
     case UpsampleMode::NN:
-      return UpsampleNearest<T>(X->template Data<T>(), Y->template MutableData<T>(), X->Shape(), Y->Shape(), scales);
+      UpsampleNearest<T>(X->template Data<T>(), Y->template MutableData<T>(), *tables,
+                         context->GetOperatorThreadPool());
+      return Status::OK();
     case UpsampleMode::LINEAR: {
-      //What's the correct behavior of linear mode is not clear right now,
-      //Only support bilinear with 4D tensor to keep consistent with previous behavior
-      if (dims.size() != 4)
-        return Status(ONNXRUNTIME, FAIL, "Upsample: linear mode upsample only support 4-D tensor with NCHW layout");
-
       const int64_t batch_size = dims[0], num_channels = dims[1];
       const int64_t input_height = dims[2], input_width = dims[3];
 
-      upsampleBilinear(batch_size, num_channels, input_height, input_width,
-                       scales[2], scales[3], X->template Data<T>(), Y->template MutableData<T>());
+      UpsampleBilinear(batch_size * num_channels, input_height, input_width, *tables,
+                       X->template Data<T>(), Y->template MutableData<T>(), context->GetOperatorThreadPool());
       return Status::OK();
     }
     default:
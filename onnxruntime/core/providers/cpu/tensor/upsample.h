@@ -3,7 +3,9 @@
 
 #pragma once
 
+#include <memory>
 #include "core/framework/op_kernel.h"
+#include "core/platform/ort_mutex.h"
 
 namespace onnxruntime {
 
@@ -79,6 +81,21 @@ class UpsampleBase {
   }
 };
 
+// Interpolation tables for one input shape and set of scales, so the per element loops only do lookups.
+struct UpsampleTables {
+  std::vector<int64_t> input_dims;
+  std::vector<float> scales;
+  std::vector<int64_t> output_dims;
+
+  // nearest mode: for each dimension, the offset in the input of the source of each output coordinate.
+  std::vector<std::vector<int64_t>> nearest_offsets;
+
+  // linear mode: the two source rows (as offsets in the input plane) and columns of each output row and
+  // column, with the weight of the other source.
+  std::vector<int64_t> in_y1, in_y2, in_x1, in_x2;
+  std::vector<float> dy1, dy2, dx1, dx2;
+};
+
 template <typename T>
 class Upsample : public UpsampleBase, public OpKernel {
  public:
@@ -88,6 +105,15 @@ class Upsample : public UpsampleBase, public OpKernel {
   Status Compute(OpKernelContext* context) const override;
 
   Status BaseCompute(OpKernelContext* context, const std::vector<float>& scales) const;
+
+ private:
+  std::shared_ptr<const UpsampleTables> GetTables(const std::vector<int64_t>& input_dims,
+                                                  const std::vector<float>& scales) const;
+
+  // tables for the most recent input shape. Compute() can be called concurrently, so tables_ is
+  // guarded by tables_mutex_ and a caller keeps the tables it is using alive.
+  mutable std::shared_ptr<const UpsampleTables> tables_;
+  mutable OrtMutex tables_mutex_;
 };
 
 }  // namespace onnxruntime
@@ -65,6 +65,10 @@ ORT_API(void, OrtDisableCpuMemArena, _In_ OrtSessionOptions* options) {
   options->value.enable_cpu_mem_arena = false;
 }
 
+ORT_API(void, OrtSetSessionArenaShrinkHighWaterMark, _In_ OrtSessionOptions* options, size_t high_water_mark) {
+  options->value.arena_shrink_high_water_mark = high_water_mark;
+}
+
 ///< logger id to use for session output
 ORT_API(void, OrtSetSessionLogId, _In_ OrtSessionOptions* options, const char* logid) {
   options->value.session_logid = logid;
@@ -77,7 +81,7 @@ ORT_API(void, OrtSetSessionLogVerbosityLevel, _In_ OrtSessionOptions* options, u
 
 // Set Graph optimization level.
 // Returns 0 on success and -1 otherwise
-// Available options are : 0, 1, 2.
+// Available options are : 0, 1, 2, 3.
 ORT_API(int, OrtSetSessionGraphOptimizationLevel, _In_ OrtSessionOptions* options, uint32_t graph_optimization_level) {
   if (graph_optimization_level >= static_cast<uint32_t>(onnxruntime::TransformerLevel::MaxTransformerLevel)){
     return -1;
@@ -92,3 +96,49 @@ ORT_API(int, OrtSetSessionThreadPoolSize, _In_ OrtSessionOptions* options, int s
   options->value.session_thread_pool_size = session_thread_pool_size;
   return 0;
 }
+
+///How many threads a kernel may use to parallelize a single node.
+ORT_API(int, OrtSetSessionIntraOpNumThreads, _In_ OrtSessionOptions* options, int intra_op_num_threads) {
+  if (intra_op_num_threads < 0) return -1;
+  options->value.intra_op_num_threads = intra_op_num_threads;
+  return 0;
+}
+
+///How many RunAsync calls run concurrently.
+ORT_API(int, OrtSetSessionRunAsyncThreadPoolSize, _In_ OrtSessionOptions* options, int run_async_thread_pool_size) {
+  if (run_async_thread_pool_size < 0) return -1;
+  options->value.run_async_thread_pool_size = run_async_thread_pool_size;
+  return 0;
+}
+
+ORT_API(void, OrtEnableSharedIntraOpThreadPool, _In_ OrtSessionOptions* options) {
+  options->value.use_shared_intra_op_thread_pool = true;
+}
+
+ORT_API(void, OrtDisableSharedIntraOpThreadPool, _In_ OrtSessionOptions* options) {
+  options->value.use_shared_intra_op_thread_pool = false;
+}
+
+ORT_API(void, OrtEnableMemoryMappedInitializers, _In_ OrtSessionOptions* options) {
+  options->value.use_memory_mapped_initializers = true;
+}
+
+ORT_API(void, OrtDisableMemoryMappedInitializers, _In_ OrtSessionOptions* options) {
+  options->value.use_memory_mapped_initializers = false;
+}
+
+ORT_API(void, OrtEnableSharedInitializers, _In_ OrtSessionOptions* options) {
+  options->value.use_shared_initializers = true;
+}
+
+ORT_API(void, OrtDisableSharedInitializers, _In_ OrtSessionOptions* options) {
+  options->value.use_shared_initializers = false;
+}
+
+ORT_API(void, OrtSetOptimizedModelCacheDir, _In_ OrtSessionOptions* options, _In_opt_ const ORTCHAR_T* cache_dir) {
+  if (cache_dir == nullptr) {
+    options->value.optimized_model_cache_dir.clear();
+  } else {
+    options->value.optimized_model_cache_dir = cache_dir;
+  }
+}
@@ -0,0 +1,383 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/batching_session.h"
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+#include "core/framework/tensor.h"
+#include "core/session/IOBinding.h"
+
+namespace onnxruntime {
+
+struct BatchingSession::Request {
+  const std::vector<std::string>* feed_names;
+  const std::vector<MLValue>* feeds;
+  const std::vector<std::string>* output_names;
+  std::vector<MLValue>* fetches;
+
+  // size of the first dimension of the feeds
+  int64_t batch_size;
+  // requests with the same signature can be executed in one batch
+  std::string signature;
+  std::chrono::steady_clock::time_point enqueue_time;
+
+  Status status;
+  bool done = false;
+};
+
+namespace {
+
+bool IsStringTensor(const Tensor& tensor) {
+  return tensor.DataType() == DataTypeImpl::GetType<std::string>();
+}
+
+// Copy the samples [src_offset, src_offset + num_samples) of 'src' to 'dst' at 'dst_offset'.
+void CopySamples(const Tensor& src, int64_t src_offset, Tensor& dst, int64_t dst_offset, int64_t num_samples) {
+  const int64_t sample_size = src.Shape().SizeFromDimension(1);
+  if (IsStringTensor(src)) {
+    const std::string* src_data = src.Data<std::string>() + src_offset * sample_size;
+    std::string* dst_data = dst.MutableData<std::string>() + dst_offset * sample_size;
+    std::copy(src_data, src_data + num_samples * sample_size, dst_data);
+  } else {
+    const size_t sample_bytes = static_cast<size_t>(sample_size) * src.DataType()->Size();
+    memcpy(static_cast<char*>(dst.MutableDataRaw()) + dst_offset * sample_bytes,
+           static_cast<const char*>(src.DataRaw()) + src_offset * sample_bytes,
+           num_samples * sample_bytes);
+  }
+}
+
+MLValue MakeTensorValue(std::unique_ptr<Tensor> tensor) {
+  return MLValue{tensor.release(), DataTypeImpl::GetType<Tensor>(), DataTypeImpl::GetType<Tensor>()->GetDeleteFunc()};
+}
+
+// Get the batch size and signature of a request, or return false if its feeds can't be batched.
+bool GetBatchInfo(const std::vector<std::string>& feed_names, const std::vector<MLValue>& feeds,
+                  const std::vector<std::string>& output_names, int64_t& batch_size, std::string& signature) {
+  if (feeds.empty() || feed_names.size() != feeds.size()) {
+    return false;
+  }
+
+  std::ostringstream signature_stream;
+  batch_size = -1;
+  for (size_t i = 0; i < feeds.size(); ++i) {
+    if (!feeds[i].IsTensor()) {
+      return false;
+    }
+    const Tensor& tensor = feeds[i].Get<Tensor>();
+    const auto& dims = tensor.Shape().GetDims();
+    if (dims.empty() || dims[0] <= 0 || (batch_size >= 0 && dims[0] != batch_size) ||
+        strcmp(tensor.Location().name, CPU) != 0) {
+      return false;
+    }
+    batch_size = dims[0];
+
+    signature_stream << feed_names[i] << ':' << tensor.DataType();
+    for (size_t j = 1; j < dims.size(); ++j) {
+      signature_stream << ',' << dims[j];
+    }
+    signature_stream << ';';
+  }
+
+  signature_stream << "->";
+  for (const auto& output_name : output_names) {
+    signature_stream << output_name << ';';
+  }
+  signature = signature_stream.str();
+  return true;
+}
+
+}  // namespace
+
+BatchingSession::BatchingSession(InferenceSession& session, const BatchingOptions& options)
+    : session_(session), options_(options), allocator_(std::make_shared<CPUAllocator>()) {
+  ORT_ENFORCE(options_.max_batch_size > 0, "Invalid max_batch_size: ", options_.max_batch_size);
+  ORT_ENFORCE(options_.max_queue_delay_micros >= 0,
+              "Invalid max_queue_delay_micros: ", options_.max_queue_delay_micros);
+  ORT_ENFORCE(options_.num_batch_threads > 0, "Invalid num_batch_threads: ", options_.num_batch_threads);
+  stats_.batch_size_histogram.resize(options_.max_batch_size + 1);
+  for (int i = 0; i < options_.num_batch_threads; ++i) {
+    threads_.emplace_back(&BatchingSession::BatchLoop, this);
+  }
+}
+
+BatchingSession::~BatchingSession() {
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    stop_ = true;
+  }
+  queue_cv_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+common::Status BatchingSession::Run(const std::vector<std::string>& feed_names, const std::vector<MLValue>& feeds,
+                                    const std::vector<std::string>& output_names, std::vector<MLValue>& fetches) {
+  Request request;
+  if (!GetBatchInfo(feed_names, feeds, output_names, request.batch_size, request.signature) ||
+      request.batch_size > options_.max_batch_size) {
+    {
+      std::lock_guard<OrtMutex> lock(mutex_);
+      ++stats_.num_requests;
+      ++stats_.num_unbatched_requests;
+    }
+    RunOptions run_options;
+    return session_.Run(run_options, feed_names, feeds, output_names, &fetches);
+  }
+
+  request.feed_names = &feed_names;
+  request.feeds = &feeds;
+  request.output_names = &output_names;
+  request.fetches = &fetches;
+
+  // a request that can't run must not be merged into a batch, where it would fail the other requests
+  Status status = ValidateRequest(request);
+  if (!status.IsOK()) {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    ++stats_.num_requests;
+    ++stats_.num_unbatched_requests;
+    return status;
+  }
+
+  request.enqueue_time = std::chrono::steady_clock::now();
+
+  std::unique_lock<OrtMutex> lock(mutex_);
+  if (stop_) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "BatchingSession is being destroyed");
+  }
+  queue_.push_back(&request);
+  queue_cv_.notify_all();
+  done_cv_.wait(lock, [&request]() { return request.done; });
+  return request.status;
+}
+
+BatchingStats BatchingSession::GetStats() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return stats_;
+}
+
+int64_t BatchingSession::QueuedSamples(const std::string& signature) const {
+  int64_t num_samples = 0;
+  for (const Request* request : queue_) {
+    if (request->signature == signature) {
+      num_samples += request->batch_size;
+    }
+  }
+  return num_samples;
+}
+
+common::Status BatchingSession::ValidateRequest(const Request& request) const {
+  auto model_inputs = session_.GetModelInputs();
+  ORT_RETURN_IF_ERROR(model_inputs.first);
+
+  const auto& feed_names = *request.feed_names;
+  for (const NodeArg* input : *model_inputs.second) {
+    auto it = std::find(feed_names.cbegin(), feed_names.cend(), input->Name());
+    if (it == feed_names.cend()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Missing required input: ", input->Name());
+    }
+    const Tensor& feed = (*request.feeds)[it - feed_names.cbegin()].Get<Tensor>();
+
+    const ONNX_NAMESPACE::TypeProto* type = input->TypeAsProto();
+    if (type == nullptr || !type->has_tensor_type()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input ", input->Name(), " is not a tensor");
+    }
+    if (feed.DataType() != DataTypeImpl::TypeFromProto(*type)->AsTensorType()->GetElementType()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Unexpected element type for input ", input->Name());
+    }
+
+    // the first dimension is the batch dimension, the others must match the model
+    const ONNX_NAMESPACE::TensorShapeProto* shape = input->Shape();
+    if (shape == nullptr) {
+      continue;
+    }
+    const auto& dims = feed.Shape().GetDims();
+    bool compatible = shape->dim_size() == static_cast<int>(dims.size());
+    for (size_t i = 1; compatible && i < dims.size(); ++i) {
+      const auto& dim = shape->dim(static_cast<int>(i));
+      compatible = !dim.has_dim_value() || dim.dim_value() == dims[i];
+    }
+    if (!compatible) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input ", input->Name(), " with shape ", feed.Shape(),
+                             " doesn't match the shape of the model input");
+    }
+  }
+  return Status::OK();
+}
+
+void BatchingSession::BatchLoop() {
+  std::unique_lock<OrtMutex> lock(mutex_);
+  for (;;) {
+    // one thread at a time forms a batch from the front of the queue, the others execute theirs meanwhile
+    queue_cv_.wait(lock, [this]() { return (stop_ && queue_.empty()) || (!forming_ && !queue_.empty()); });
+    if (queue_.empty()) {
+      return;
+    }
+    forming_ = true;
+
+    // wait for the batch of the oldest request to fill up, or for its delay to expire.
+    // when stopping, the queued requests are executed right away.
+    const Request* oldest = queue_.front();
+    const auto deadline = oldest->enqueue_time + std::chrono::microseconds(options_.max_queue_delay_micros);
+    while (!stop_ && QueuedSamples(oldest->signature) < options_.max_batch_size) {
+      const auto now = std::chrono::steady_clock::now();
+      if (now >= deadline || queue_cv_.wait_for(lock, deadline - now) == std::cv_status::timeout) {
+        break;
+      }
+    }
+
+    // take the oldest request and the compatible requests that fit in its batch, in arrival order
+    std::vector<Request*> batch;
+    int64_t num_samples = 0;
+    for (auto it = queue_.begin(); it != queue_.end();) {
+      Request* request = *it;
+      if (request->signature == oldest->signature && num_samples + request->batch_size <= options_.max_batch_size) {
+        num_samples += request->batch_size;
+        batch.push_back(request);
+        it = queue_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+
+    // let another thread form the next batch while this one executes
+    forming_ = false;
+    queue_cv_.notify_all();
+
+    lock.unlock();
+    ExecuteBatch(batch);
+    lock.lock();
+  }
+}
+
+void BatchingSession::ExecuteBatch(std::vector<Request*>& batch) {
+  const auto start_time = std::chrono::steady_clock::now();
+
+  // nothing to concatenate for a single request
+  Status status = batch.size() == 1 ? RunRequest(*batch[0]) : RunBatch(batch);
+  if (status.IsOK()) {
+    for (Request* request : batch) {
+      request->status = status;
+    }
+  } else if (batch.size() == 1) {
+    batch[0]->status = status;
+  } else {
+    // find out which requests the error belongs to, so that the others still succeed
+    for (Request* request : batch) {
+      request->fetches->clear();
+      request->status = RunRequest(*request);
+    }
+  }
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  int64_t num_samples = 0;
+  for (Request* request : batch) {
+    const int64_t queue_delay = std::chrono::duration_cast<std::chrono::microseconds>(
+                                    start_time - request->enqueue_time)
+                                    .count();
+    stats_.total_queue_delay_micros += queue_delay;
+    stats_.max_queue_delay_micros = std::max(stats_.max_queue_delay_micros, queue_delay);
+    num_samples += request->batch_size;
+
+    if (!request->status.IsOK()) {
+      request->fetches->clear();
+    }
+    request->done = true;
+  }
+  stats_.num_requests += batch.size();
+  ++stats_.num_batches;
+  stats_.num_batched_samples += num_samples;
+  ++stats_.batch_size_histogram[num_samples];
+  done_cv_.notify_all();
+}
+
+common::Status BatchingSession::RunRequest(const Request& request) {
+  try {
+    RunOptions run_options;
+    return session_.Run(run_options, *request.feed_names, *request.feeds, *request.output_names, request.fetches);
+  } catch (const std::exception& ex) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exception running a request: ", ex.what());
+  }
+}
+
+common::Status BatchingSession::RunBatch(const std::vector<Request*>& batch) {
+  try {
+    return RunBatchImpl(batch);
+  } catch (const std::exception& ex) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exception running a batch: ", ex.what());
+  }
+}
+
+common::Status BatchingSession::RunBatchImpl(const std::vector<Request*>& batch) {
+  std::unique_ptr<IOBinding> io_binding;
+  ORT_RETURN_IF_ERROR(session_.NewIOBinding(&io_binding));
+
+  int64_t num_samples = 0;
+  for (const Request* request : batch) {
+    num_samples += request->batch_size;
+  }
+
+  // concatenate the feeds. IOBinding copies them to the location the session needs them at.
+  const Request& first = *batch[0];
+  AllocatorPtr feed_allocator = io_binding->GetCPUAllocator(0, kCpuExecutionProvider);
+  for (size_t i = 0; i < first.feeds->size(); ++i) {
+    const Tensor& first_tensor = (*first.feeds)[i].Get<Tensor>();
+    std::vector<int64_t> dims = first_tensor.Shape().GetDims();
+    dims[0] = num_samples;
+    auto tensor = std::make_unique<Tensor>(first_tensor.DataType(), TensorShape(dims), feed_allocator);
+
+    int64_t offset = 0;
+    for (const Request* request : batch) {
+      CopySamples((*request->feeds)[i].Get<Tensor>(), 0, *tensor, offset, request->batch_size);
+      offset += request->batch_size;
+    }
+    ORT_RETURN_IF_ERROR(io_binding->BindInput((*first.feed_names)[i], MakeTensorValue(std::move(tensor))));
+  }
+  ORT_RETURN_IF_ERROR(io_binding->SynchronizeInputs());
+
+  for (const auto& output_name : *first.output_names) {
+    ORT_RETURN_IF_ERROR(io_binding->BindOutput(output_name, MLValue()));
+  }
+
+  RunOptions run_options;
+  ORT_RETURN_IF_ERROR(session_.Run(run_options, *io_binding));
+
+  // split the fetches
+  const auto& outputs = io_binding->GetOutputs();
+  for (const Request* request : batch) {
+    request->fetches->clear();
+    request->fetches->reserve(outputs.size());
+  }
+  for (size_t i = 0; i < outputs.size(); ++i) {
+    const std::string& output_name = (*first.output_names)[i];
+    if (!outputs[i].IsTensor()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Batched output ", output_name, " is not a tensor");
+    }
+    const Tensor& output = outputs[i].Get<Tensor>();
+    const auto& output_dims = output.Shape().GetDims();
+    if (output_dims.empty() || output_dims[0] != num_samples) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Output ", output_name, " with shape ", output.Shape(),
+                             " of a batch of ", num_samples, " samples has no batch dimension");
+    }
+    if (strcmp(output.Location().name, CPU) != 0) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Batched output ", output_name, " is not on CPU");
+    }
+
+    std::vector<int64_t> dims = output_dims;
+    int64_t offset = 0;
+    for (Request* request : batch) {
+      dims[0] = request->batch_size;
+      auto tensor = std::make_unique<Tensor>(output.DataType(), TensorShape(dims), allocator_);
+      CopySamples(output, offset, *tensor, 0, request->batch_size);
+      offset += request->batch_size;
+      request->fetches->push_back(MakeTensorValue(std::move(tensor)));
+    }
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
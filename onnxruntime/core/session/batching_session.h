@@ -0,0 +1,117 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <deque>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/status.h"
+#include "core/framework/allocator.h"
+#include "core/framework/ml_value.h"
+#include "core/platform/ort_mutex.h"
+#include "core/session/inference_session.h"
+
+namespace onnxruntime {
+
+struct BatchingOptions {
+  // Most samples, counted along the first dimension of the feeds, executed as one batch.
+  int max_batch_size = 16;
+
+  // How long the oldest queued request waits for others to join its batch before the batch is executed.
+  int64_t max_queue_delay_micros = 1000;
+
+  // Threads that form and execute batches. While one of them executes a batch the next one can form, and up to
+  // this many batches run concurrently. Each batch uses the intra-op thread pool of the session.
+  int num_batch_threads = 2;
+};
+
+struct BatchingStats {
+  uint64_t num_requests = 0;
+  // requests executed on their own because their feeds can't be concatenated with others, or rejected because
+  // their feeds don't match the model inputs
+  uint64_t num_unbatched_requests = 0;
+
+  uint64_t num_batches = 0;
+  uint64_t num_batched_samples = 0;
+  // batch_size_histogram[n] is the number of batches of n samples
+  std::vector<uint64_t> batch_size_histogram;
+
+  // time the batched requests spent in the queue
+  int64_t total_queue_delay_micros = 0;
+  int64_t max_queue_delay_micros = 0;
+
+  double AverageBatchSize() const {
+    return num_batches == 0 ? 0. : static_cast<double>(num_batched_samples) / num_batches;
+  }
+
+  double AverageQueueDelayMicros() const {
+    const uint64_t num_batched_requests = num_requests - num_unbatched_requests;
+    return num_batched_requests == 0 ? 0. : static_cast<double>(total_queue_delay_micros) / num_batched_requests;
+  }
+};
+
+/**
+Front end of an InferenceSession that executes concurrent Run calls as batches.
+
+Requests are checked against the model inputs and queued. A batching thread concatenates the feeds of compatible
+requests along their first dimension, executes the model once through an IOBinding, and splits the fetches back
+along the first dimension. If a batch fails, its requests are executed again one by one, so that an error is only
+reported to the requests that cause it.
+Requests are compatible if they have the same feed and output names, and feeds of the same types and shapes except
+for the first dimension. A batch is executed once it holds BatchingOptions::max_batch_size samples, or when the oldest
+request in it has waited BatchingOptions::max_queue_delay_micros.
+
+The model must treat the first dimension of every feed and fetch as the batch dimension. Requests with feeds that
+aren't CPU tensors, or whose feeds don't agree on the first dimension, are executed on their own.
+*/
+class BatchingSession {
+ public:
+  // 'session' must be initialized and outlive the BatchingSession.
+  BatchingSession(InferenceSession& session, const BatchingOptions& options);
+
+  // Executes the queued requests and waits for them.
+  ~BatchingSession();
+
+  /**
+  Run the model on 'feeds' as part of a batch. Blocks until the batch has been executed.
+  Thread-safe. Requests are only batched if they are issued concurrently.
+  */
+  common::Status Run(const std::vector<std::string>& feed_names, const std::vector<MLValue>& feeds,
+                     const std::vector<std::string>& output_names, std::vector<MLValue>& fetches);
+
+  BatchingStats GetStats() const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(BatchingSession);
+
+  struct Request;
+
+  void BatchLoop();
+  int64_t QueuedSamples(const std::string& signature) const;
+  common::Status ValidateRequest(const Request& request) const;
+  void ExecuteBatch(std::vector<Request*>& batch);
+  common::Status RunRequest(const Request& request);
+  common::Status RunBatch(const std::vector<Request*>& batch);
+  common::Status RunBatchImpl(const std::vector<Request*>& batch);
+
+  InferenceSession& session_;
+  const BatchingOptions options_;
+  AllocatorPtr allocator_;
+
+  mutable OrtMutex mutex_;
+  OrtCondVar queue_cv_;
+  OrtCondVar done_cv_;
+  std::deque<Request*> queue_;  // GUARDED_BY(mutex_)
+  bool forming_ = false;        // GUARDED_BY(mutex_), a thread is forming a batch from the front of the queue
+  bool stop_ = false;           // GUARDED_BY(mutex_)
+  BatchingStats stats_;         // GUARDED_BY(mutex_)
+
+  std::vector<std::thread> threads_;
+};
+
+}  // namespace onnxruntime
@@ -7,19 +7,21 @@
 
 #include "core/session/inference_session.h"
 
+#include <algorithm>
 #include <memory>
 #include <sstream>
 #include <unordered_set>
 #include <list>
 
 #include "core/common/logging/logging.h"
-#include "core/common/task_thread_pool.h"
+#include "core/common/work_stealing_thread_pool.h"
 #include "core/platform/notification.h"
 #include "core/platform/ort_mutex.h"
 #include "core/graph/graph_viewer.h"
 #include "core/graph/graph_utils.h"
 #include "core/graph/model.h"
 #include "core/framework/allocatormgr.h"
+#include "core/framework/bfc_arena.h"
 #include "core/framework/customregistry.h"
 #include "core/framework/environment.h"
 #include "core/framework/error_code_helper.h"
@@ -45,6 +47,7 @@
 #include "core/providers/cpu/cpu_execution_provider.h"
 #include "core/framework/custom_ops_author.h"
 #include "core/session/IOBinding.h"
+#include "core/session/optimized_model_cache.h"
 #include "core/util/protobuf_parsing_utils.h"
 #include "core/optimizer/rule_based_graph_transformer.h"
 #include "core/optimizer/graph_transformer_utils.h"
@@ -179,11 +182,28 @@ InferenceSession::InferenceSession(const SessionOptions& session_options, loggin
 #ifdef USE_EIGEN_THREADPOOL
     thread_pool_ = std::make_unique<Eigen::NonBlockingThreadPool>(pool_size);
 #else
-    thread_pool_ = std::make_unique<TaskThreadPool>(pool_size);
+    thread_pool_ = std::make_unique<WorkStealingThreadPool>(pool_size);
 #endif
   }
 
   session_state_.SetThreadPool(thread_pool_.get());
+
+  if (session_options_.intra_op_num_threads == 0 && session_options_.use_shared_intra_op_thread_pool) {
+    session_state_.SetIntraOpThreadPool(Environment::GetSharedIntraOpThreadPool());
+  } else {
+    // the thread running a kernel also does work, so the pool needs one less thread.
+    int intra_op_num_threads = session_options_.intra_op_num_threads == 0
+                                   ? static_cast<int>(std::thread::hardware_concurrency())
+                                   : session_options_.intra_op_num_threads;
+    if (intra_op_num_threads > 1) {
+      intra_op_thread_pool_ = std::make_unique<WorkStealingThreadPool>(intra_op_num_threads - 1);
+    }
+
+    session_state_.SetIntraOpThreadPool(intra_op_thread_pool_.get());
+  }
+
+  session_state_.SetMaxNumMemoryPatterns(session_options_.max_num_memory_patterns);
+
   session_profiler_.Initialize(session_logger_);
   session_state_.SetProfiler(session_profiler_);
   if (session_options.enable_profiling) {
@@ -191,7 +211,11 @@ InferenceSession::InferenceSession(const SessionOptions& session_options, loggin
   }
 }
 
-InferenceSession::~InferenceSession() = default;
+InferenceSession::~InferenceSession() {
+  // queued RunAsync calls use the session, so they must finish before anything is destroyed
+  std::unique_lock<OrtMutex> lock(async_runs_mutex_);
+  async_runs_done_.wait(lock, [this]() { return num_pending_async_runs_ == 0; });
+}
 
 common::Status InferenceSession::RegisterExecutionProvider(std::unique_ptr<IExecutionProvider> p_exec_provider) {
   if (p_exec_provider == nullptr) {
@@ -211,6 +235,7 @@ common::Status InferenceSession::RegisterGraphTransformer(std::unique_ptr<onnxru
   if (p_graph_transformer == nullptr) {
     return Status(common::ONNXRUNTIME, common::FAIL, "Received nullptr for graph transformer");
   }
+  has_custom_transformers_ = true;
   return graph_transformation_mgr_.Register(std::move(p_graph_transformer), level, providers);
 }
 
@@ -389,7 +414,8 @@ common::Status InferenceSession::TransformGraph(onnxruntime::Graph& graph,
                                                 const ExecutionProviders& providers,
                                                 KernelRegistryManager& kernel_registry_manager,
                                                 const InsertCastTransformer& insert_cast_transformer,
-                                                SessionState& session_state) {
+                                                SessionState& session_state,
+                                                bool graph_is_optimized) {
   // The transformer order:
   // 1. built-in graph rewriter
   // 2. each execution provider's transformer
@@ -398,7 +424,9 @@ common::Status InferenceSession::TransformGraph(onnxruntime::Graph& graph,
   // 5. insert cast nodes.
 
   // first apply global(execution provider independent),  level 1(default/system/basic) graph to graph optimizations
-  ORT_RETURN_IF_ERROR(graph_transformer_mgr.ApplyTransformers(graph, TransformerLevel::Level1));
+  if (!graph_is_optimized) {
+    ORT_RETURN_IF_ERROR(graph_transformer_mgr.ApplyTransformers(graph, TransformerLevel::Level1));
+  }
 
   // Do partitioning based on execution providers' capability.
   GraphPartitioner partitioner(kernel_registry_manager, providers);
@@ -406,8 +434,15 @@ common::Status InferenceSession::TransformGraph(onnxruntime::Graph& graph,
 
   // apply transformers except default transformers
   // Default transformers are required for correctness and they are owned and run by inference session
-  for (int i = static_cast<int>(TransformerLevel::Level1); i < static_cast<int>(TransformerLevel::MaxTransformerLevel); i++) {
-    ORT_RETURN_IF_ERROR(graph_transformer_mgr.ApplyTransformers(graph, static_cast<TransformerLevel>(i)));
+  if (!graph_is_optimized) {
+    for (int i = static_cast<int>(TransformerLevel::Level1); i < static_cast<int>(TransformerLevel::MaxTransformerLevel); i++) {
+      ORT_RETURN_IF_ERROR(graph_transformer_mgr.ApplyTransformers(graph, static_cast<TransformerLevel>(i)));
+    }
+
+    // the cast and copy nodes inserted below depend on the node placement, which is redone when loading the model
+    if (!optimized_model_cache_key_.empty()) {
+      SaveOptimizedModel();
+    }
   }
 
   bool modified = false;
@@ -440,6 +475,61 @@ common::Status InferenceSession::TransformGraph(onnxruntime::Graph& graph,
   return common::Status::OK();
 }
 
+bool InferenceSession::LoadOptimizedModel() {
+  // the cache key doesn't cover custom schemas and kernels, which the transformers may depend on
+  if (model_location_.empty() || has_custom_transformers_ || HasLocalSchema()) {
+    LOGS(*session_logger_, INFO) << "The optimized model cache is only used for models loaded from a file, "
+                                 << "without transformers registered through RegisterGraphTransformer "
+                                 << "and without custom ops or registries.";
+    return false;
+  }
+
+  std::vector<std::string> provider_types;
+  for (auto& provider_ptr : execution_providers_) {
+    provider_types.push_back(provider_ptr->Type());
+  }
+
+  std::string key;
+  Status status = OptimizedModelCache::ComputeKey(Env::Default(), model_location_, provider_types,
+                                                  static_cast<int>(session_options_.graph_optimization_level),
+                                                  transformers_to_enable_, key);
+  if (!status.IsOK()) {
+    LOGS(*session_logger_, WARNING) << "Not using the optimized model cache: " << status.ErrorMessage();
+    return false;
+  }
+
+  OptimizedModelCache cache{session_options_.optimized_model_cache_dir};
+  std::shared_ptr<onnxruntime::Model> optimized_model;
+  status = cache.Load(key, nullptr, optimized_model);
+  if (!status.IsOK()) {
+    // typically there is no cached model yet. Save it once optimized.
+    VLOGS(*session_logger_, 1) << "No optimized model in the cache: " << status.ErrorMessage();
+    optimized_model_cache_key_ = key;
+    return false;
+  }
+
+  LOGS(*session_logger_, INFO) << "Using the optimized model " << ToMBString(cache.GetModelPath(key));
+  model_->MainGraph().CleanAllInitializedTensors();
+  original_model_ = std::move(model_);
+  model_ = std::move(optimized_model);
+  // initializers are loaded from the optimized model file
+  model_location_ = cache.GetModelPath(key);
+  return true;
+}
+
+void InferenceSession::SaveOptimizedModel() {
+  if (!OptimizedModelCache::CanCache(model_->MainGraph())) {
+    LOGS(*session_logger_, INFO) << "The optimized model can't be cached.";
+    return;
+  }
+
+  OptimizedModelCache cache{session_options_.optimized_model_cache_dir};
+  Status status = cache.Save(*model_, optimized_model_cache_key_);
+  if (!status.IsOK()) {
+    LOGS(*session_logger_, WARNING) << "Failed to cache the optimized model: " << status.ErrorMessage();
+  }
+}
+
 /// Create SessionState instance for each subgraph as we need that for the GraphPartitioner
 /// This will be initialized by InitializeSubgraphSessions.
 common::Status InferenceSession::CreateSubgraphSessionState(Graph& graph, SessionState& session_state) {
@@ -452,6 +542,7 @@ common::Status InferenceSession::CreateSubgraphSessionState(Graph& graph, Sessio
       auto subgraph_session_state = std::make_unique<SessionState>(execution_providers_);
       subgraph_session_state->SetProfiler(session_profiler_);
       subgraph_session_state->SetLogger(*session_logger_);
+      subgraph_session_state->SetIntraOpThreadPool(session_state.GetIntraOpThreadPool());
 
       // recurse
       ORT_RETURN_IF_ERROR(CreateSubgraphSessionState(*subgraph, *subgraph_session_state));
@@ -485,7 +576,9 @@ common::Status InferenceSession::InitializeSubgraphSessions(Graph& graph, Sessio
       ORT_RETURN_IF_ERROR(initializer.CreatePlan(&node, node.ImplicitInputDefs(),
                                                  session_options_.enable_sequential_execution));
 
-      ORT_RETURN_IF_ERROR(initializer.InitializeAndSave(&node.ImplicitInputDefs()));
+      ORT_RETURN_IF_ERROR(initializer.InitializeAndSave(&node.ImplicitInputDefs(),
+                                                        session_options_.use_memory_mapped_initializers,
+                                                        session_options_.use_shared_initializers));
 
       // LOGS(*session_logger_, VERBOSE) << std::make_pair(subgraph_info.session_state->GetExecutionPlan(),
       //                                                   &*subgraph_info.session_state);
@@ -518,7 +611,8 @@ common::Status InferenceSession::Initialize() {
     // Register default CPUExecutionProvider if user didn't provide it through the Register() calls
     if (!execution_providers_.Get(onnxruntime::kCpuExecutionProvider)) {
       LOGS(*session_logger_, INFO) << "Adding default CPU execution provider.";
-      CPUExecutionProviderInfo epi{session_options_.enable_cpu_mem_arena};
+      CPUExecutionProviderInfo epi{session_options_.enable_cpu_mem_arena,
+                                   session_options_.enable_cpu_mem_arena_thread_caches};
       ORT_RETURN_IF_ERROR(execution_providers_.Add(onnxruntime::kCpuExecutionProvider,
                                                    std::make_unique<CPUExecutionProvider>(epi)));
     }
@@ -526,8 +620,6 @@ common::Status InferenceSession::Initialize() {
     // add predefined transformers
     AddPredefinedTransformers(graph_transformation_mgr_, session_options_.graph_optimization_level, transformers_to_enable_);
 
-    onnxruntime::Graph& graph = model_->MainGraph();
-
     // Collect the kernel registries from execution provider instances;
     // There are 2 kinds of kernel registries with priority from high to low as below,
     // 1. Custom execution provider type specific kernel registries.
@@ -538,6 +630,11 @@ common::Status InferenceSession::Initialize() {
     // Register 2nd registries into KernelRegistryManager.
     ORT_RETURN_IF_ERROR(kernel_registry_manager_.RegisterKernels(execution_providers_));
 
+    // skip the graph transformations if an earlier session saved the optimized model
+    const bool graph_is_optimized = !session_options_.optimized_model_cache_dir.empty() && LoadOptimizedModel();
+
+    onnxruntime::Graph& graph = model_->MainGraph();
+
     SessionStateInitializer session_initializer{model_location_, graph, session_state_, execution_providers_,
                                                 kernel_registry_manager_};
 
@@ -548,13 +645,16 @@ common::Status InferenceSession::Initialize() {
     ORT_RETURN_IF_ERROR(TransformGraph(graph, graph_transformation_mgr_,
                                        execution_providers_, kernel_registry_manager_,
                                        insert_cast_transformer_,
-                                       session_state_));
+                                       session_state_,
+                                       graph_is_optimized));
 
     // now that all the transforms are done, call Resolve on the main graph. this will recurse into the subgraphs.
     ORT_RETURN_IF_ERROR(graph.Resolve());
 
     ORT_RETURN_IF_ERROR(session_initializer.CreatePlan(nullptr, {}, session_options_.enable_sequential_execution));
-    ORT_RETURN_IF_ERROR(session_initializer.InitializeAndSave(nullptr));
+    ORT_RETURN_IF_ERROR(session_initializer.InitializeAndSave(nullptr,
+                                                              session_options_.use_memory_mapped_initializers,
+                                                              session_options_.use_shared_initializers));
 
     // handle any subgraphs
     ORT_RETURN_IF_ERROR(InitializeSubgraphSessions(graph, session_state_));
@@ -769,14 +869,142 @@ Status InferenceSession::Run(const RunOptions& run_options,
     ORT_CHECK_AND_SET_RETVAL(xp->OnRunEnd());
   }
 
-  --current_num_runs_;
+  if (--current_num_runs_ == 0 &&
+      session_options_.arena_shrink_high_water_mark != std::numeric_limits<size_t>::max()) {
+    ShrinkArenasAbove(session_options_.arena_shrink_high_water_mark);
+  }
   if (session_profiler_.FEnabled()) {
     session_profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "model_run", tp);
+    RecordArenaStats();
   }
 
   return retval;
 }
 
+void InferenceSession::RecordArenaStats() {
+  for (auto& xp : execution_providers_) {
+    for (const IAllocator* allocator : xp->GetAllocators()) {
+      const auto* arena = dynamic_cast<const BFCArena*>(allocator);
+      if (arena == nullptr) {
+        continue;
+      }
+
+      AllocatorStats stats;
+      arena->GetStats(&stats);
+      const int64_t num_cacheable_allocs = stats.num_cache_hits + stats.num_cache_misses;
+      auto tp = session_profiler_.StartTime();
+      session_profiler_.EndTimeAndRecordEvent(
+          profiling::SESSION_EVENT, "arena_stats", tp,
+          {{"allocator", arena->Info().ToString()},
+           {"bytes_in_use", std::to_string(stats.bytes_in_use)},
+           {"max_bytes_in_use", std::to_string(stats.max_bytes_in_use)},
+           {"total_allocated_bytes", std::to_string(stats.total_allocated_bytes)},
+           {"num_allocs", std::to_string(stats.num_allocs)},
+           {"fragmentation", std::to_string(stats.Fragmentation())},
+           {"bytes_in_thread_caches", std::to_string(stats.bytes_in_thread_caches)},
+           {"thread_cache_hit_rate",
+            std::to_string(num_cacheable_allocs > 0
+                               ? static_cast<double>(stats.num_cache_hits) / num_cacheable_allocs
+                               : 0.0)}});
+    }
+  }
+}
+
+size_t InferenceSession::ShrinkArenasAbove(size_t high_water_mark) {
+  size_t released_bytes = 0;
+  for (auto& xp : execution_providers_) {
+    for (const IAllocator* allocator : xp->GetAllocators()) {
+      auto arena = std::dynamic_pointer_cast<BFCArena>(
+          xp->GetAllocator(allocator->Info().id, allocator->Info().mem_type));
+      if (arena == nullptr) {
+        continue;
+      }
+
+      AllocatorStats stats;
+      arena->GetStats(&stats);
+      if (static_cast<size_t>(stats.total_allocated_bytes) > high_water_mark) {
+        released_bytes += arena->Shrink(high_water_mark);
+      }
+    }
+  }
+  return released_bytes;
+}
+
+common::Status InferenceSession::ShrinkArenas(size_t* released_bytes) {
+  size_t released = ShrinkArenasAbove(0);
+  LOGS(*session_logger_, INFO) << "Released " << released << " bytes of the memory arenas";
+  if (released_bytes != nullptr) {
+    *released_bytes = released;
+  }
+  return Status::OK();
+}
+
+common::Status InferenceSession::RunAsync(const RunOptions* run_options,
+                                          const std::vector<std::string>& feed_names,
+                                          const std::vector<MLValue>& feeds,
+                                          const std::vector<std::string>& output_names,
+                                          RunAsyncCallback callback) {
+  if (!callback) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "RunAsync requires a callback");
+  }
+
+  WorkStealingThreadPool* thread_pool;
+  {
+    std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
+    if (!is_inited_) {
+      LOGS(*session_logger_, ERROR) << "Session was not initialized";
+      return Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+    }
+
+    if (run_async_thread_pool_ == nullptr) {
+      int pool_size = session_options_.run_async_thread_pool_size;
+      if (pool_size == 0) {
+        // a run with its own intra-op thread pool keeps intra_op_num_threads threads busy, the one running it
+        // included, so only run as many calls concurrently as the hardware threads allow for. Always allow for
+        // some concurrency though, or RunAsync would just queue up runs behind each other.
+        const int num_hardware_threads = static_cast<int>(std::thread::hardware_concurrency());
+        pool_size = std::max(num_hardware_threads / std::max(session_options_.intra_op_num_threads, 1), 2);
+      }
+      run_async_thread_pool_ = std::make_unique<WorkStealingThreadPool>(pool_size);
+    }
+    thread_pool = run_async_thread_pool_.get();
+  }
+
+  {
+    std::lock_guard<OrtMutex> lock(async_runs_mutex_);
+    ++num_pending_async_runs_;
+  }
+
+  thread_pool->Schedule([this, run_options, feed_names, feeds, output_names, callback = std::move(callback)]() {
+    std::vector<MLValue> fetches;
+    Status status;
+    if (run_options != nullptr) {
+      status = Run(*run_options, feed_names, feeds, output_names, &fetches);
+    } else {
+      RunOptions default_run_options;
+      status = Run(default_run_options, feed_names, feeds, output_names, &fetches);
+    }
+    if (!status.IsOK()) {
+      fetches.clear();
+    }
+
+    try {
+      callback(status, fetches);
+    } catch (const std::exception& ex) {
+      LOGS(*session_logger_, ERROR) << "Exception in RunAsync callback: " << ex.what();
+    } catch (...) {
+      LOGS(*session_logger_, ERROR) << "Unknown exception in RunAsync callback";
+    }
+
+    std::lock_guard<OrtMutex> lock(async_runs_mutex_);
+    if (--num_pending_async_runs_ == 0) {
+      async_runs_done_.notify_all();
+    }
+  });
+
+  return Status::OK();
+}
+
 common::Status InferenceSession::Run(const NameMLValMap& feeds,
                                      const std::vector<std::string>& output_names,
                                      std::vector<MLValue>* p_fetches) {
@@ -1040,6 +1268,10 @@ void InferenceSession::AddPredefinedTransformers(GraphTransformerManager& transf
   if ((graph_optimization_level >= TransformerLevel::Level2) || !custom_list.empty()) {
     add_transformers(TransformerLevel::Level2, {onnxruntime::kCpuExecutionProvider}, "Level2");
   }
+
+  if ((graph_optimization_level >= TransformerLevel::Level3) || !custom_list.empty()) {
+    add_transformers(TransformerLevel::Level3, {onnxruntime::kCpuExecutionProvider}, "Level3");
+  }
 }
 
 common::Status InferenceSession::WaitForNotification(Notification* p_executor_done, int64_t timeout_in_ms) {
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <functional>
+#include <limits>
 #include <string>
 #include <unordered_map>
 
@@ -59,6 +61,14 @@ struct SessionOptions {
   // set this option to false if you don't want it.
   bool enable_cpu_mem_arena = true;
 
+  // Keep per thread caches of small free chunks in front of the CPU memory arena, so that concurrent Run calls
+  // and the parallel executor don't serialize on the arena lock for small tensors.
+  bool enable_cpu_mem_arena_thread_caches = false;
+
+  // After a Run, when no other Run is in progress, return unused regions of an arena to the system until it holds
+  // at most this many bytes. 0 shrinks the arenas after every Run. The default never shrinks them.
+  size_t arena_shrink_high_water_mark = std::numeric_limits<size_t>::max();
+
   // the prefix of the profile file. The current time will be appended to the file name.
   std::basic_string<ORTCHAR_T> profile_file_prefix = ORT_TSTR("onnxruntime_profile_");
 
@@ -72,6 +82,41 @@ struct SessionOptions {
 
   // How many threads in the session thread pool.
   int session_thread_pool_size = 0;
+
+  // How many threads, including the thread calling Run, kernels may use to parallelize a single node.
+  // The session creates its own intra-op thread pool for them. 1 runs every kernel single threaded.
+  // 0 uses the shared intra-op thread pool, see use_shared_intra_op_thread_pool.
+  int intra_op_num_threads = 0;
+
+  // With intra_op_num_threads 0, use the intra-op thread pool owned by the Environment, which has a thread per
+  // hardware thread and is shared by all such sessions, so that many sessions in one process don't oversubscribe
+  // the machine. Otherwise the session creates a pool with a thread per hardware thread of its own.
+  bool use_shared_intra_op_thread_pool = true;
+
+  // Use CPU initializers in place from read-only memory mappings of the files they are stored in, instead of
+  // copying them into buffers owned by the session. This applies to external data, and to raw_data when the model
+  // is loaded from a file. Sessions of the same model in one process share the mapped pages.
+  bool use_memory_mapped_initializers = false;
+
+  // Share CPU initializers with other sessions in the process that set this and have initializers with the same
+  // name and content, e.g. sessions of the same model. They then hold one copy of the weights, and sessions after
+  // the first skip deserializing them. Initializers that are memory mapped are shared through the mapping instead.
+  bool use_shared_initializers = false;
+
+  // Directory where models are saved after graph optimization, so that later sessions of the same model, with the
+  // same execution providers and optimization settings, load the optimized model instead of optimizing it again.
+  // Only used for models loaded from a file, in sessions without custom transformers, ops or registries.
+  // Empty disables the cache.
+  std::basic_string<ORTCHAR_T> optimized_model_cache_dir;
+
+  // How many memory patterns are cached. Inputs whose dimensions round up to the same powers of two share a
+  // pattern, and the least recently used pattern is dropped when a new one doesn't fit. 0 means no limit.
+  size_t max_num_memory_patterns = 16;
+
+  // How many RunAsync calls run concurrently. Further calls are queued. 0 uses the number of hardware threads divided
+  // by intra_op_num_threads, as each run also uses that many intra-op threads, but at least 2. With the default
+  // intra_op_num_threads of 0 that is the number of hardware threads.
+  int run_async_thread_pool_size = 0;
 };
 
 /**
@@ -229,6 +274,26 @@ class InferenceSession {
   common::Status Run(const RunOptions& run_options, IOBinding& io_binding);
   common::Status Run(IOBinding& io_binding);
 
+  /**
+    * Called once a run started by RunAsync has finished, with the status of the run and the fetches in the order
+    * of output_names. The fetches are empty if the run failed.
+    */
+  using RunAsyncCallback = std::function<void(const common::Status& status, std::vector<MLValue>& fetches)>;
+
+  /**
+    * Queue a run of a pre-loaded and pre-initialized model on a thread pool owned by the session, and return
+    * without waiting for it. See SessionOptions::run_async_thread_pool_size.
+    * @param run_options nullptr to use the defaults. Otherwise it must stay alive until the callback is invoked.
+    * @param callback invoked on a thread of the session's pool once the run has finished. It must not destroy the
+    *        session. The destructor of the session waits for the queued and running calls.
+    * @return OK if the run was queued. Errors of the run itself are passed to the callback.
+    */
+  common::Status RunAsync(const RunOptions* run_options,
+                          const std::vector<std::string>& feed_names,
+                          const std::vector<MLValue>& feeds,
+                          const std::vector<std::string>& output_names,
+                          RunAsyncCallback callback);
+
   /**
     * @return pair.first = OK; FAIL otherwise. pair.second is non-NULL when pair.first = OK.
     * @note lifetime of the returned pointer is valid as long as the Session object is live.
@@ -277,6 +342,13 @@ class InferenceSession {
     */
   std::string EndProfiling();
 
+  /**
+    * Return the regions of the memory arenas that have no memory in use to the system. Memory held by the caches
+    * of other threads than the calling one, see enable_cpu_mem_arena_thread_caches, is not released.
+    * @param released_bytes if not null, receives the number of bytes released.
+    */
+  common::Status ShrinkArenas(size_t* released_bytes = nullptr);
+
  protected:
   /**
     * Load an ONNX model.
@@ -332,6 +404,13 @@ class InferenceSession {
   const logging::Logger& CreateLoggerForRun(const RunOptions& run_options,
                                             std::unique_ptr<logging::Logger>& new_run_logger);
 
+  // Record the statistics of the arenas of the execution providers in the profile.
+  void RecordArenaStats();
+
+  // Shrink the arenas of the execution providers that hold more than high_water_mark bytes back to that size,
+  // as far as their unused regions allow.
+  size_t ShrinkArenasAbove(size_t high_water_mark);
+
   common::Status Load(std::function<common::Status(std::shared_ptr<Model>&)> loader, const std::string& event_name);
 
   common::Status TransformGraph(onnxruntime::Graph& graph,
@@ -339,7 +418,13 @@ class InferenceSession {
                                 const ExecutionProviders& providers,
                                 KernelRegistryManager& kernel_registry_manager,
                                 const InsertCastTransformer& insert_cast_transformer,
-                                SessionState& session_state);
+                                SessionState& session_state,
+                                bool graph_is_optimized);
+
+  // Replace model_ with its optimized version from the cache. Returns false if there is none.
+  bool LoadOptimizedModel();
+
+  void SaveOptimizedModel();
 
   common::Status CreateSubgraphSessionState(Graph& graph, SessionState& session_state);
 
@@ -376,6 +461,17 @@ class InferenceSession {
   // .i.e This list overrides both SessionOptions.graph_optimization_level and predefined transformers.
   std::vector<std::string> transformers_to_enable_;
 
+  // Whether transformers were registered through RegisterGraphTransformer. They can't be part of the key of the
+  // optimized model cache, so the cache isn't used then.
+  bool has_custom_transformers_ = false;
+
+  // Key of the optimized model in the cache, set when it should be saved after the graph transformations
+  std::string optimized_model_cache_key_;
+
+  // The model as loaded, without its initializers, when model_ was replaced by the optimized model from the cache.
+  // The model metadata refers to its graph.
+  std::shared_ptr<onnxruntime::Model> original_model_;
+
   /// Logging manager if provided.
   logging::LoggingManager* logging_manager_;
 
@@ -408,9 +504,20 @@ class InferenceSession {
 #ifdef USE_EIGEN_THREADPOOL
   std::unique_ptr<Eigen::NonBlockingThreadPool> thread_pool_;
 #else
-  std::unique_ptr<TaskThreadPool> thread_pool_;
+  std::unique_ptr<WorkStealingThreadPool> thread_pool_;
 #endif
 
+  // Intra-op thread pool for this session. Not created if the session uses the Environment's shared pool.
+  std::unique_ptr<WorkStealingThreadPool> intra_op_thread_pool_;
+
+  // Thread pool running the RunAsync calls. Created by the first call.
+  std::unique_ptr<WorkStealingThreadPool> run_async_thread_pool_;  // GUARDED_BY(session_mutex_)
+
+  // RunAsync calls that were queued and haven't returned from their callback yet
+  int num_pending_async_runs_ = 0;  // GUARDED_BY(async_runs_mutex_)
+  OrtMutex async_runs_mutex_;
+  OrtCondVar async_runs_done_;
+
   // Number of concurrently running executors
   std::atomic<int> current_num_runs_;
 
@@ -0,0 +1,143 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/optimized_model_cache.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+#include "core/framework/mapped_file.h"
+#include "core/framework/path_lib.h"
+#include "core/graph/graph.h"
+
+// set by the build from VERSION_NUMBER
+#ifndef ORT_VERSION
+#define ORT_VERSION "unknown"
+#endif
+
+namespace onnxruntime {
+
+namespace {
+
+// Bumped whenever the content of cached models changes in a way the onnxruntime version doesn't capture.
+constexpr int kCacheFormatVersion = 1;
+
+inline uint64_t RotateLeft(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+// 64-bit hash processing 8 bytes at a time, so hashing large models is bound by memory bandwidth.
+uint64_t HashBytes(const char* data, size_t length, uint64_t seed) {
+  constexpr uint64_t kMul1 = 0x9E3779B97F4A7C15ULL;
+  constexpr uint64_t kMul2 = 0xC2B2AE3D27D4EB4FULL;
+  uint64_t h = seed ^ (length * kMul1);
+  size_t i = 0;
+  for (; i + 8 <= length; i += 8) {
+    uint64_t word;
+    memcpy(&word, data + i, sizeof(word));
+    h ^= RotateLeft(word * kMul2, 31) * kMul1;
+    h = RotateLeft(h, 27) * kMul1 + 0x52DCE729;
+  }
+  for (; i < length; ++i) {
+    h ^= static_cast<uint8_t>(data[i]) * kMul2;
+    h = RotateLeft(h, 11) * kMul1;
+  }
+  h ^= h >> 33;
+  h *= kMul2;
+  h ^= h >> 29;
+  return h;
+}
+
+}  // namespace
+
+common::Status OptimizedModelCache::ComputeKey(const Env& env, const std::basic_string<ORTCHAR_T>& model_path,
+                                               const std::vector<std::string>& provider_types,
+                                               int optimization_level,
+                                               const std::vector<std::string>& transformers_to_enable,
+                                               std::string& key) {
+  std::shared_ptr<const MappedFile> model_file;
+  ORT_RETURN_IF_ERROR(MappedFile::Open(env, model_path, model_file));
+
+  std::ostringstream description;
+  description << "onnxruntime " << ORT_VERSION << "\n"
+              << "format " << kCacheFormatVersion << "\n"
+              << "model " << model_file->Length() << " "
+              << HashBytes(model_file->Data(), model_file->Length(), 0) << "\n"
+              << "level " << optimization_level << "\n";
+  for (const auto& provider_type : provider_types) {
+    description << "provider " << provider_type << "\n";
+  }
+  for (const auto& transformer : transformers_to_enable) {
+    description << "transformer " << transformer << "\n";
+  }
+
+  // two differently seeded hashes of the description make a 128-bit key
+  const std::string text = description.str();
+  std::ostringstream key_stream;
+  key_stream << std::hex << std::setfill('0')
+             << std::setw(16) << HashBytes(text.data(), text.size(), 0x243F6A8885A308D3ULL)
+             << std::setw(16) << HashBytes(text.data(), text.size(), 0x13198A2E03707344ULL);
+  key = key_stream.str();
+  return Status::OK();
+}
+
+bool OptimizedModelCache::CanCache(Graph& graph) {
+  for (const auto& entry : graph.GetAllInitializedTensors()) {
+    // external data is located relative to the original model
+    if (entry.second->data_location() == ONNX_NAMESPACE::TensorProto_DataLocation_EXTERNAL) {
+      return false;
+    }
+  }
+
+  for (auto& node : graph.Nodes()) {
+    // nodes fused by an execution provider refer to functions that aren't saved with the model
+    if (node.NodeType() == Node::Type::Fused) {
+      return false;
+    }
+    // Node::ToProto saves the subgraph attributes as loaded, without the changes made by the transformers
+    if (!node.GetAttributeNameToMutableSubgraphMap().empty()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::basic_string<ORTCHAR_T> OptimizedModelCache::GetModelPath(const std::string& key) const {
+  return ConcatPathComponent<ORTCHAR_T>(cache_dir_, ToWideString(key + ".onnx"));
+}
+
+common::Status OptimizedModelCache::Load(const std::string& key,
+                                         const IOnnxRuntimeOpSchemaRegistryList* local_registries,
+                                         std::shared_ptr<Model>& model) const {
+  return Model::Load(GetModelPath(key), model, local_registries);
+}
+
+common::Status OptimizedModelCache::Save(Model& model, const std::string& key) const {
+  // unique within the process, and across processes through the pid
+  static std::atomic<int> save_count{0};
+  const std::basic_string<ORTCHAR_T> model_path = GetModelPath(key);
+  const std::basic_string<ORTCHAR_T> temp_path =
+      model_path + ToWideString(".tmp" + std::to_string(Env::Default().GetSelfPid()) + "_" +
+                                std::to_string(save_count++));
+
+  ORT_RETURN_IF_ERROR(Model::Save(model, temp_path));
+#ifdef _WIN32
+  // _wrename doesn't replace an existing file, which another session may have saved meanwhile
+  (void)_wremove(model_path.c_str());
+  const int ret = _wrename(temp_path.c_str(), model_path.c_str());
+#else
+  const int ret = std::rename(temp_path.c_str(), model_path.c_str());
+#endif
+  if (ret != 0) {
+#ifdef _WIN32
+    (void)_wremove(temp_path.c_str());
+#else
+    (void)std::remove(temp_path.c_str());
+#endif
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to save the optimized model as ", ToMBString(model_path));
+  }
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
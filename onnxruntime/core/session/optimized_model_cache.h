@@ -0,0 +1,62 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/status.h"
+#include "core/graph/model.h"
+#include "core/platform/env.h"
+
+namespace onnxruntime {
+
+/**
+Directory of models saved after graph optimization, so later sessions of the same model can skip the optimizations.
+
+A cached model is identified by a key derived from the content of the original model file and from everything the
+optimizations depend on: the execution providers, the optimization level, the custom transformer list and the
+onnxruntime version. Models are saved after all graph transformers ran, but before the copy and cast nodes that
+depend on the node placement are inserted. Graph partitioning is deterministic and cheap, so it is redone when a
+cached model is loaded.
+*/
+class OptimizedModelCache {
+ public:
+  explicit OptimizedModelCache(const std::basic_string<ORTCHAR_T>& cache_dir) : cache_dir_(cache_dir) {}
+
+  /**
+  Compute the key of the optimized version of the model at 'model_path'.
+  */
+  static common::Status ComputeKey(const Env& env, const std::basic_string<ORTCHAR_T>& model_path,
+                                   const std::vector<std::string>& provider_types, int optimization_level,
+                                   const std::vector<std::string>& transformers_to_enable, std::string& key);
+
+  /**
+  Whether 'graph' can be saved to the cache and loaded again as is. Graphs with subgraphs, with nodes fused by
+  execution providers or with initializers in external data files can't be.
+  */
+  static bool CanCache(Graph& graph);
+
+  // Path of the cached model with the given key.
+  std::basic_string<ORTCHAR_T> GetModelPath(const std::string& key) const;
+
+  /**
+  Load the cached model with the given key. Fails if there is none.
+  */
+  common::Status Load(const std::string& key, const IOnnxRuntimeOpSchemaRegistryList* local_registries,
+                      std::shared_ptr<Model>& model) const;
+
+  /**
+  Save 'model' with the given key. The model is written to a temporary file first and then renamed, so concurrent
+  sessions never see a partially written model.
+  */
+  common::Status Save(Model& model, const std::string& key) const;
+
+ private:
+  std::basic_string<ORTCHAR_T> cache_dir_;
+};
+
+}  // namespace onnxruntime
@@ -41,6 +41,8 @@ extern "C" {
 
 namespace onnxruntime {
 
+class WorkStealingThreadPool;
+
 enum StorageOrder {
   UNKNOWN = 0,
   NHWC = 1,
@@ -204,7 +206,9 @@ void Gemm(
     Provider* provider,
     //Caffe2 use this type to control on GPU, what presicion do we want to do the calculation
     //But not sure is this a good design for us. Keep it here for now.
-    MLDataType math_type = FLOAT_TYPE);
+    MLDataType math_type = FLOAT_TYPE,
+    // Optional intra-op thread pool used by backends that can run in parallel.
+    WorkStealingThreadPool* threadpool = nullptr);
 
 // We also provide a gemm that has explicit lda, ldb and ldc specified.
 // In most cases you probably want to use the function above, though.
@@ -223,7 +227,8 @@ void GemmEx(
     T beta,
     T* C,
     int ldc,
-    Provider* provider);
+    Provider* provider,
+    WorkStealingThreadPool* threadpool = nullptr);
 
 // GemmBatched provides a simple abstraction into library routines
 template <typename T, class Provider>
@@ -141,8 +141,10 @@ void Gemm<float, CPUMathUtil>(
     const float beta,
     float* C,
     CPUMathUtil* /*provider*/,
-    MLDataType /*math_type*/) {
+    MLDataType /*math_type*/,
+    WorkStealingThreadPool* threadpool) {
 #if defined(USE_MKLDNN)
+  ORT_UNUSED_PARAMETER(threadpool);
   int lda = (int)((TransA == CblasTrans) ? M : K);
   int ldb = (int)((TransB == CblasTrans) ? K : N);
   int M_ = (int)M;
@@ -161,8 +163,9 @@ void Gemm<float, CPUMathUtil>(
 #elif defined(USE_MLAS)
   int lda = (int)((TransA == CblasNoTrans) ? K : M);
   int ldb = (int)((TransB == CblasNoTrans) ? N : K);
-  MlasSgemm(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, N);
+  MlasSgemm(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, N, threadpool);
 #else
+  ORT_UNUSED_PARAMETER(threadpool);
   GemmEigen<float>(TransA, TransB, M, N, K, alpha, A, B, beta, C);
 #endif
 }
@@ -180,7 +183,8 @@ void Gemm<double, CPUMathUtil>(
     const float beta,
     double* C,
     CPUMathUtil* /*provider*/,
-    MLDataType /*math_type*/) {
+    MLDataType /*math_type*/,
+    WorkStealingThreadPool* /*threadpool*/) {
   // No double precision Gemm offering from MLAS or MKLDNN. Directly fallback to Eigen.
   GemmEigen<double>(TransA, TransB, M, N, K, alpha, A, B, beta, C);
 }
@@ -198,7 +202,8 @@ void Gemm<int32_t, CPUMathUtil>(
     const float beta,
     int32_t* C,
     CPUMathUtil* /*provider*/,
-    MLDataType /*math_type*/) {
+    MLDataType /*math_type*/,
+    WorkStealingThreadPool* /*threadpool*/) {
     // No int32_t Gemm offering from MLAS or MKLDNN. Directly fallback to Eigen.
     GemmEigen<int32_t>(TransA, TransB, M, N, K, alpha, A, B, beta, C);
 }
@@ -216,7 +221,8 @@ void Gemm<uint32_t, CPUMathUtil>(
     const float beta,
     uint32_t* C,
     CPUMathUtil* /*provider*/,
-    MLDataType /*math_type*/) {
+    MLDataType /*math_type*/,
+    WorkStealingThreadPool* /*threadpool*/) {
     // No uint32_t Gemm offering from MLAS or MKLDNN. Directly fallback to Eigen.
     GemmEigen<uint32_t>(TransA, TransB, M, N, K, alpha, A, B, beta, C);
 }
@@ -234,7 +240,8 @@ void Gemm<int64_t, CPUMathUtil>(
     const float beta,
     int64_t* C,
     CPUMathUtil* /*provider*/,
-    MLDataType /*math_type*/) {
+    MLDataType /*math_type*/,
+    WorkStealingThreadPool* /*threadpool*/) {
     // No int64_t Gemm offering from MLAS or MKLDNN. Directly fallback to Eigen.
     GemmEigen<int64_t>(TransA, TransB, M, N, K, alpha, A, B, beta, C);
 }
@@ -252,7 +259,8 @@ void Gemm<uint64_t, CPUMathUtil>(
     const float beta,
     uint64_t* C,
     CPUMathUtil* /*provider*/,
-    MLDataType /*math_type*/) {
+    MLDataType /*math_type*/,
+    WorkStealingThreadPool* /*threadpool*/) {
     // No uint64_t Gemm offering from MLAS or MKLDNN. Directly fallback to Eigen.
     GemmEigen<uint64_t>(TransA, TransB, M, N, K, alpha, A, B, beta, C);
 }
@@ -272,8 +280,10 @@ void GemmEx<float, CPUMathUtil>(
     const float beta,
     float* C,
     const int ldc,
-    CPUMathUtil*) {
+    CPUMathUtil*,
+    WorkStealingThreadPool* threadpool) {
 #if defined(USE_MKLDNN)
+  ORT_UNUSED_PARAMETER(threadpool);
   // mkldnn_sgemm expects col major matrices, so we need to swap the operands A and B
   auto status = mkldnn_sgemm(TransB == CblasNoTrans ? "N" : "T",
                              TransA == CblasNoTrans ? "N" : "T",
@@ -285,8 +295,9 @@ void GemmEx<float, CPUMathUtil>(
     ORT_THROW("mkldnn_sgemm failed with status: ", status);
   }
 #elif defined(USE_MLAS)
-  MlasSgemm(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
+  MlasSgemm(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc, threadpool);
 #else
+  ORT_UNUSED_PARAMETER(threadpool);
   using OuterStride = Eigen::OuterStride<Eigen::Dynamic>;
   using StridedMap = Eigen::Map<Eigen::MatrixXf, 0, OuterStride>;
   using ConstStridedMap = Eigen::Map<const Eigen::MatrixXf, 0, OuterStride>;
@@ -438,7 +449,8 @@ void Gemm<float, CPUMathUtil>(
     const float beta,
     float* C,
     CPUMathUtil* /*context*/,
-    MLDataType /*math_type*/) {
+    MLDataType /*math_type*/,
+    WorkStealingThreadPool* /*threadpool*/) {
   int lda = gsl::narrow_cast<int>((TransA == CblasNoTrans) ? K : M);
   int ldb = gsl::narrow_cast<int>((TransB == CblasNoTrans) ? N : K);
   cblas_sgemm(CblasRowMajor, TransA, TransB,
@@ -462,7 +474,8 @@ void Gemm<double, CPUMathUtil>(
     const float beta,
     double* C,
     CPUMathUtil* /*provider*/,
-    MLDataType /*math_type*/) {
+    MLDataType /*math_type*/,
+    WorkStealingThreadPool* /*threadpool*/) {
     int lda = gsl::narrow_cast<int>((TransA == CblasNoTrans) ? K : M);
     int ldb = gsl::narrow_cast<int>((TransB == CblasNoTrans) ? N : K);
     cblas_dgemm(CblasRowMajor, TransA, TransB,
@@ -486,7 +499,8 @@ void Gemm<int32_t, CPUMathUtil>(
     const float beta,
     int32_t* C,
     CPUMathUtil* /*provider*/,
-    MLDataType /*math_type*/) {
+    MLDataType /*math_type*/,
+    WorkStealingThreadPool* /*threadpool*/) {
     // No int32_t Gemm offering from MKLML. Directly fallback to Eigen.
     GemmEigen<int32_t>(TransA, TransB, M, N, K, alpha, A, B, beta, C);
 }
@@ -504,7 +518,8 @@ void Gemm<uint32_t, CPUMathUtil>(
     const float beta,
     uint32_t* C,
     CPUMathUtil* /*provider*/,
-    MLDataType /*math_type*/) {
+    MLDataType /*math_type*/,
+    WorkStealingThreadPool* /*threadpool*/) {
    // No uint32_t Gemm offering from MKLML. Directly fallback to Eigen.
     GemmEigen<uint32_t>(TransA, TransB, M, N, K, alpha, A, B, beta, C);
 }
@@ -522,7 +537,8 @@ void Gemm<int64_t, CPUMathUtil>(
     const float beta,
     int64_t* C,
     CPUMathUtil* /*provider*/,
-    MLDataType /*math_type*/) {
+    MLDataType /*math_type*/,
+    WorkStealingThreadPool* /*threadpool*/) {
     // No int64_t Gemm offering from MKLML. Directly fallback to Eigen.
     GemmEigen<int64_t>(TransA, TransB, M, N, K, alpha, A, B, beta, C);
 }
@@ -540,7 +556,8 @@ void Gemm<uint64_t, CPUMathUtil>(
     const float beta,
     uint64_t* C,
     CPUMathUtil* /*provider*/,
-    MLDataType /*math_type*/) {
+    MLDataType /*math_type*/,
+    WorkStealingThreadPool* /*threadpool*/) {
     // No uint64_t Gemm offering from MKLML. Directly fallback to Eigen.
     GemmEigen<uint64_t>(TransA, TransB, M, N, K, alpha, A, B, beta, C);
 }
@@ -560,7 +577,8 @@ void GemmEx<float, CPUMathUtil>(
     const float beta,
     float* C,
     const int ldc,
-    CPUMathUtil* /*context*/) {
+    CPUMathUtil* /*context*/,
+    WorkStealingThreadPool* /*threadpool*/) {
   cblas_sgemm(CblasRowMajor, TransA, TransB, M, N, K, alpha, A, lda, B, ldb,
               beta, C, ldc);
 }
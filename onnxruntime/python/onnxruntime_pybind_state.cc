@@ -254,7 +254,23 @@ Set this option to false if you don't want it. Default is True.)pbdoc")
                      R"pbdoc(Applies to session load, initialization, etc. Default is 0.)pbdoc")
       .def_readwrite("session_thread_pool_size", &SessionOptions::session_thread_pool_size,
                      R"pbdoc(How many threads in the session thread pool. Default is 0 to let onnxruntime choose.
-This parameter is unused unless *enable_sequential_execution* is false.)pbdoc");
+This parameter is unused unless *enable_sequential_execution* is false.)pbdoc")
+      .def_readwrite("intra_op_num_threads", &SessionOptions::intra_op_num_threads,
+                     R"pbdoc(How many threads an operator may use to parallelize its own work, including the calling thread.
+The session then creates its own thread pool. 1 runs every operator single threaded.
+Default is 0 to use the thread pool shared between sessions, see *use_shared_intra_op_thread_pool*.)pbdoc")
+      .def_readwrite("use_shared_intra_op_thread_pool", &SessionOptions::use_shared_intra_op_thread_pool,
+                     R"pbdoc(Share one intra-op thread pool between all sessions in the process that set this. Default is true.
+Only applies when *intra_op_num_threads* is 0. Otherwise the session creates a thread pool of its own.)pbdoc")
+      .def_readwrite("use_memory_mapped_initializers", &SessionOptions::use_memory_mapped_initializers,
+                     R"pbdoc(Use initializers in place from read-only memory mappings of the model file or of their external
+data files instead of copying them. Sessions of the same model share the mapped pages. Default is false.)pbdoc")
+      .def_readwrite("use_shared_initializers", &SessionOptions::use_shared_initializers,
+                     R"pbdoc(Share initializers with the other sessions in the process that set this and have initializers with
+the same name and content, e.g. sessions of the same model, so the weights are held once. Default is false.)pbdoc")
+      .def_readwrite("optimized_model_cache_dir", &SessionOptions::optimized_model_cache_dir,
+                     R"pbdoc(Directory where models are saved after graph optimization, so that later sessions of the same
+model with the same providers and optimization settings skip the optimizations. Default is empty, which disables it.)pbdoc");
 
   py::class_<RunOptions>(m, "RunOptions", R"pbdoc(Configuration information for a single Run.)pbdoc")
       .def(py::init())
@@ -0,0 +1,116 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/common/work_stealing_thread_pool.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(WorkStealingThreadPoolTest, RunsAllTasks) {
+  WorkStealingThreadPool pool(4);
+  std::atomic<int> count{0};
+  constexpr int num_tasks = 1000;
+
+  for (int i = 0; i < num_tasks; ++i) {
+    pool.Schedule([&count]() { count++; });
+  }
+
+  // the calling thread helps until the queues are drained
+  while (pool.RunPendingTask()) {
+  }
+
+  while (count < num_tasks) {
+    std::this_thread::yield();
+  }
+
+  EXPECT_EQ(count, num_tasks);
+}
+
+TEST(WorkStealingThreadPoolTest, NestedScheduleFromWorker) {
+  WorkStealingThreadPool pool(2);
+  std::atomic<int> count{0};
+  constexpr int fan_out = 64;
+
+  pool.Schedule([&pool, &count]() {
+    EXPECT_GE(pool.CurrentThreadId(), 0);
+    for (int i = 0; i < fan_out; ++i) {
+      pool.Schedule([&count]() { count++; });
+    }
+    count++;
+  });
+
+  while (count < fan_out + 1) {
+    std::this_thread::yield();
+  }
+
+  EXPECT_EQ(pool.CurrentThreadId(), -1);
+  EXPECT_EQ(count, fan_out + 1);
+}
+
+TEST(WorkStealingThreadPoolTest, CallerOnlyPool) {
+  // with no worker threads all work is done by threads calling RunPendingTask
+  WorkStealingThreadPool pool(0);
+  int count = 0;
+
+  pool.Schedule([&count]() { count++; });
+  pool.Schedule([&count]() { count++; });
+
+  EXPECT_TRUE(pool.RunPendingTask());
+  EXPECT_TRUE(pool.RunPendingTask());
+  EXPECT_FALSE(pool.RunPendingTask());
+  EXPECT_EQ(count, 2);
+}
+
+TEST(WorkStealingThreadPoolTest, ParallelFor) {
+  WorkStealingThreadPool pool(3);
+  std::vector<int> values(1000, 0);
+
+  pool.ParallelFor(static_cast<int32_t>(values.size()), [&values](int32_t i) { values[i] = i * 2; });
+
+  for (int i = 0; i < static_cast<int>(values.size()); ++i) {
+    ASSERT_EQ(values[i], i * 2);
+  }
+}
+
+TEST(WorkStealingThreadPoolTest, NestedParallelFor) {
+  WorkStealingThreadPool pool(2);
+  std::atomic<int> count{0};
+
+  pool.ParallelFor(8, [&pool, &count](int32_t) {
+    pool.ParallelFor(16, [&count](int32_t) { count++; });
+  });
+
+  EXPECT_EQ(count, 8 * 16);
+}
+
+TEST(WorkStealingThreadPoolTest, ParallelForPropagatesException) {
+  WorkStealingThreadPool pool(2);
+
+  EXPECT_THROW(pool.ParallelFor(100, [](int32_t i) {
+    if (i == 42) {
+      throw std::runtime_error("failed");
+    }
+  }),
+               std::runtime_error);
+}
+
+TEST(WorkStealingThreadPoolTest, TryParallelForWithoutPool) {
+  std::vector<int> values(10, 0);
+
+  WorkStealingThreadPool::TryParallelFor(nullptr, 10, [&values](int32_t i) { values[i] = i; });
+
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(values[i], i);
+  }
+  EXPECT_EQ(WorkStealingThreadPool::DegreeOfParallelism(nullptr), 1);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
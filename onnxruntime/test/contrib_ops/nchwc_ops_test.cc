@@ -0,0 +1,165 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+#include "core/mlas/inc/mlas.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+int64_t NchwcChannels(int64_t channels) {
+  const auto block_size = static_cast<int64_t>(MlasNchwcGetBlockSize());
+  return (channels + block_size - 1) / block_size * block_size;
+}
+
+// Returns a sequence of values that are exactly representable, so that the sums computed by the kernels and by
+// the reference implementation are identical.
+std::vector<float> TestValues(size_t count, size_t seed) {
+  std::vector<float> values(count);
+  for (size_t i = 0; i < count; i++) {
+    values[i] = static_cast<float>(static_cast<int>((i * 7 + seed) % 13) - 6) * 0.125f;
+  }
+  return values;
+}
+
+// Converts a NCHW tensor to the NCHWc layout, zero filling the padding channels.
+std::vector<float> ToNchwc(const std::vector<float>& nchw, const std::vector<int64_t>& shape) {
+  const int64_t block_size = static_cast<int64_t>(MlasNchwcGetBlockSize());
+  const int64_t N = shape[0];
+  const int64_t C = shape[1];
+  const int64_t spatial_size = shape[2] * shape[3];
+  const int64_t nchwc_channels = NchwcChannels(C);
+
+  std::vector<float> nchwc(static_cast<size_t>(N * nchwc_channels * spatial_size), 0.0f);
+  for (int64_t n = 0; n < N; n++) {
+    for (int64_t c = 0; c < C; c++) {
+      for (int64_t i = 0; i < spatial_size; i++) {
+        const int64_t block_offset = (n * nchwc_channels + c / block_size * block_size) * spatial_size;
+        nchwc[block_offset + i * block_size + c % block_size] = nchw[(n * C + c) * spatial_size + i];
+      }
+    }
+  }
+  return nchwc;
+}
+
+// Computes a two dimensional convolution with a single group or a depthwise convolution in the NCHW layout.
+std::vector<float> ReferenceConv(const std::vector<float>& X, const std::vector<int64_t>& X_shape,
+                                 const std::vector<float>& W, const std::vector<int64_t>& W_shape,
+                                 const std::vector<float>& B, int64_t pad, int64_t stride, bool relu,
+                                 std::vector<int64_t>& Y_shape) {
+  const int64_t C = X_shape[1], H = X_shape[2], Wd = X_shape[3];
+  const int64_t M = W_shape[0], KC = W_shape[1], KH = W_shape[2], KW = W_shape[3];
+  const int64_t OH = (H + 2 * pad - KH) / stride + 1;
+  const int64_t OW = (Wd + 2 * pad - KW) / stride + 1;
+  const bool depthwise = KC != C;
+  Y_shape = {X_shape[0], M, OH, OW};
+
+  std::vector<float> Y(static_cast<size_t>(X_shape[0] * M * OH * OW));
+  for (int64_t n = 0; n < X_shape[0]; n++) {
+    for (int64_t m = 0; m < M; m++) {
+      for (int64_t oh = 0; oh < OH; oh++) {
+        for (int64_t ow = 0; ow < OW; ow++) {
+          float sum = B.empty() ? 0.0f : B[m];
+          for (int64_t kc = 0; kc < KC; kc++) {
+            const int64_t c = depthwise ? m : kc;
+            for (int64_t kh = 0; kh < KH; kh++) {
+              for (int64_t kw = 0; kw < KW; kw++) {
+                const int64_t ih = oh * stride + kh - pad;
+                const int64_t iw = ow * stride + kw - pad;
+                if (ih >= 0 && ih < H && iw >= 0 && iw < Wd) {
+                  sum += X[((n * C + c) * H + ih) * Wd + iw] * W[((m * KC + kc) * KH + kh) * KW + kw];
+                }
+              }
+            }
+          }
+          Y[((n * M + m) * OH + oh) * OW + ow] = (relu && sum < 0.0f) ? 0.0f : sum;
+        }
+      }
+    }
+  }
+  return Y;
+}
+
+void RunNchwcConvTest(int64_t channels, int64_t filter_count, int64_t group, bool relu, bool constant_filter) {
+  const std::vector<int64_t> X_shape = {1, channels, 6, 7};
+  const std::vector<int64_t> W_shape = {filter_count, channels / group, 3, 3};
+  const std::vector<float> X = TestValues(static_cast<size_t>(channels * 6 * 7), 1);
+  const std::vector<float> W = TestValues(static_cast<size_t>(filter_count * (channels / group) * 9), 2);
+  const std::vector<float> B = TestValues(static_cast<size_t>(filter_count), 3);
+
+  std::vector<int64_t> Y_shape;
+  const std::vector<float> Y = ReferenceConv(X, X_shape, W, W_shape, B, 1, 1, relu, Y_shape);
+
+  OpTester test("Conv", 1, onnxruntime::kMSNchwcDomain);
+  test.AddAttribute("pads", std::vector<int64_t>{1, 1, 1, 1});
+  test.AddAttribute("group", group);
+  if (relu) {
+    test.AddAttribute("activation", "Relu");
+  }
+  test.AddInput<float>("X", {1, NchwcChannels(channels), 6, 7}, ToNchwc(X, X_shape));
+  test.AddInput<float>("W", W_shape, W, constant_filter);
+  test.AddInput<float>("B", {filter_count}, B, constant_filter);
+  test.AddOutput<float>("Y", {1, NchwcChannels(filter_count), Y_shape[2], Y_shape[3]}, ToNchwc(Y, Y_shape));
+  test.Run();
+}
+
+}  // namespace
+
+TEST(NchwcOpTest, ReorderInputOutput) {
+  const std::vector<int64_t> shape = {2, 11, 3, 2};
+  const std::vector<float> X = TestValues(2 * 11 * 3 * 2, 0);
+  const std::vector<int64_t> nchwc_shape = {2, NchwcChannels(11), 3, 2};
+
+  OpTester reorder_input("ReorderInput", 1, onnxruntime::kMSNchwcDomain);
+  reorder_input.AddInput<float>("X", shape, X);
+  reorder_input.AddOutput<float>("Y", nchwc_shape, ToNchwc(X, shape));
+  reorder_input.Run();
+
+  OpTester reorder_output("ReorderOutput", 1, onnxruntime::kMSNchwcDomain);
+  reorder_output.AddAttribute("channels", int64_t{11});
+  reorder_output.AddInput<float>("X", nchwc_shape, ToNchwc(X, shape));
+  reorder_output.AddOutput<float>("Y", shape, X);
+  reorder_output.Run();
+}
+
+TEST(NchwcOpTest, Conv) {
+  RunNchwcConvTest(12, 20, 1, false, false);
+  RunNchwcConvTest(12, 20, 1, true, true);
+  RunNchwcConvTest(16, 8, 1, false, true);
+}
+
+TEST(NchwcOpTest, DepthwiseConv) {
+  RunNchwcConvTest(12, 12, 12, false, false);
+  RunNchwcConvTest(12, 12, 12, true, true);
+}
+
+TEST(NchwcOpTest, Pool) {
+  const std::vector<int64_t> shape = {1, 3, 2, 4};
+  const std::vector<float> X = {1, 2, 3, 4,
+                                5, 6, 7, 8,
+
+                                -1, -2, -3, -4,
+                                -5, -6, -7, -8,
+
+                                0, 2, 0, 2,
+                                4, 0, 4, 0};
+  const std::vector<int64_t> nchwc_shape = {1, NchwcChannels(3), 2, 4};
+
+  OpTester max_pool("MaxPool", 1, onnxruntime::kMSNchwcDomain);
+  max_pool.AddAttribute("kernel_shape", std::vector<int64_t>{2, 2});
+  max_pool.AddAttribute("strides", std::vector<int64_t>{2, 2});
+  max_pool.AddInput<float>("X", nchwc_shape, ToNchwc(X, shape));
+  max_pool.AddOutput<float>("Y", {1, NchwcChannels(3), 1, 2}, ToNchwc({6, 8, -1, -3, 4, 4}, {1, 3, 1, 2}));
+  max_pool.Run();
+
+  OpTester global_average_pool("GlobalAveragePool", 1, onnxruntime::kMSNchwcDomain);
+  global_average_pool.AddInput<float>("X", nchwc_shape, ToNchwc(X, shape));
+  global_average_pool.AddOutput<float>("Y", {1, NchwcChannels(3), 1, 1}, ToNchwc({4.5f, -4.5f, 1.5f}, {1, 3, 1, 1}));
+  global_average_pool.Run();
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -124,15 +124,21 @@ typedef std::unordered_map<const onnxruntime::NodeArg*, TensorShapeProto*> Shape
 
 class SequentialPlannerTestContext : public ISequentialPlannerContext {
  public:
-  SequentialPlannerTestContext(ShapeMap* shape_map) : shape_map_(shape_map) {}
+  SequentialPlannerTestContext(ShapeMap* shape_map, bool enable_parallel_execution = false)
+      : shape_map_(shape_map), enable_parallel_execution_(enable_parallel_execution) {}
 
   virtual TensorShapeProto* GetShape(const onnxruntime::NodeArg& arg) const override {
     auto iter = shape_map_->find(&arg);
     return (shape_map_->end() != iter) ? iter->second : nullptr;
   }
 
+  bool EnableParallelExecution() const override {
+    return enable_parallel_execution_;
+  }
+
  private:
   ShapeMap* shape_map_;
+  bool enable_parallel_execution_;
 };
 
 class PlannerTest : public ::testing::Test {
@@ -149,6 +155,7 @@ class PlannerTest : public ::testing::Test {
 
   std::unique_ptr<::onnxruntime::KernelDef> std_kernel_;       // a unary kernel with no-aliasing and no-in-place
   std::unique_ptr<::onnxruntime::KernelDef> in_place_kernel_;  // a unary kernel with in-place
+  std::unique_ptr<::onnxruntime::KernelDef> alias_kernel_;     // a unary kernel whose output aliases its input
 
   std::unordered_map<std::string, onnxruntime::NodeArg*> name_to_arg_;
   std::vector<std::unique_ptr<UnaryNode>> nodes_;
@@ -163,6 +170,7 @@ class PlannerTest : public ::testing::Test {
   PlannerTest() : model_("test"), graph_{model_.MainGraph()}, state_{execution_providers_} {
     std_kernel_ = KernelDefBuilder().SetName("Transpose").Build();
     in_place_kernel_ = KernelDefBuilder().SetName("Clip").MayInplace(0, 0).Build();
+    alias_kernel_ = KernelDefBuilder().SetName("Identity").Alias(0, 0).Build();
     CPUExecutionProviderInfo epi;
     auto execution_provider = std::make_unique<CPUExecutionProvider>(epi);
     execution_providers_.Add("CPUExecutionProvider", std::move(execution_provider));
@@ -193,6 +201,10 @@ class PlannerTest : public ::testing::Test {
     return AddNode(*in_place_kernel_, input, output);
   }
 
+  onnxruntime::Node* AddAliasNode(std::string& input, std::string& output) {
+    return AddNode(*alias_kernel_, input, output);
+  }
+
   void BindKernel(onnxruntime::Node* p_node, ::onnxruntime::KernelDef& kernel_def) {
     auto info = std::make_unique<OpKernelInfo>(*p_node,
                                                kernel_def,
@@ -215,7 +227,8 @@ class PlannerTest : public ::testing::Test {
     }
   }
 
-  void CreatePlan(const std::vector<const NodeArg*>& outer_scope_node_args = {}) {
+  void CreatePlan(const std::vector<const NodeArg*>& outer_scope_node_args = {},
+                  bool enable_parallel_execution = false) {
     EXPECT_EQ(graph_.Resolve(), Status::OK());
     state_.SetGraphViewer(std::make_unique<GraphViewer>(graph_));
 
@@ -237,7 +250,7 @@ class PlannerTest : public ::testing::Test {
     auto status = kernel_registry_manager.RegisterKernels(execution_providers);
     EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
 
-    SequentialPlannerTestContext test_context(&shape_map_);
+    SequentialPlannerTestContext test_context(&shape_map_, enable_parallel_execution);
     status = SequentialPlanner::CreatePlan(nullptr, GraphViewer(graph_), outer_scope_node_args, execution_providers,
                                            kernel_registry_manager, mlvalue_name_idx_map, test_context, plan_);
 
@@ -413,6 +426,136 @@ TEST_F(PlannerTest, InPlaceSizeMismatchTest) {
   CheckFreed(3, {X2});
 }
 
+// AliasOfInputTest: Check that an aliasing operator returns a view of a graph input, and that the view is not
+// updated in place since the caller owns the buffer.
+TEST_F(PlannerTest, AliasOfInputTest) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), X3("X3"), X4("X4");
+
+  // graph structure:
+  AddAliasNode(X1, X2);    // aliasing operator; X1: input; X2: view of X1
+  AddInplaceNode(X2, X3);  // may-in-place operator; X3: temporary
+  AddNormalNode(X3, X4);   // no in-place operator; X4: output
+
+  // simulate shape-inference results:
+  Shape shape1{"M", "N"};
+  auto shape = &shape1.value;
+  SetShape({{X1, shape}, {X2, shape}, {X3, shape}, {X4, shape}});
+
+  CreatePlan();
+
+  // check allocation kind:
+  CheckAllocKind(X1, AllocKind::kPreExisting);
+  CheckAllocKind(X2, AllocKind::kReuse);
+  CheckAllocKind(X3, AllocKind::kAllocate);
+  CheckAllocKind(X4, AllocKind::kAllocateOutput);
+
+  // the input and its view are never freed
+  CheckFreed(0, {});
+  CheckFreed(1, {});
+  CheckFreed(2, {X3});
+}
+
+// AliasOfInitializerTest: Same as AliasOfInputTest, for an initializer.
+TEST_F(PlannerTest, AliasOfInitializerTest) {
+  // tensor variables:
+  std::string W("W"), X("X"), Y("Y"), Z("Z");
+
+  // graph structure:
+  ONNX_NAMESPACE::TensorProto tensor;
+  tensor.add_dims(1);
+  tensor.add_float_data(1.0f);
+  tensor.set_data_type(TensorProto_DataType_FLOAT);
+  tensor.set_name("W");
+  GetGraph().AddInitializedTensor(tensor);
+
+  AddAliasNode(W, X);    // aliasing operator; X: view of W
+  AddInplaceNode(X, Y);  // may-in-place operator; Y: temporary
+  AddNormalNode(Y, Z);   // no in-place operator; Z: output
+
+  // simulate shape-inference results:
+  Shape shape1{1};
+  auto shape = &shape1.value;
+  SetShape({{W, shape}, {X, shape}, {Y, shape}, {Z, shape}});
+
+  CreatePlan();
+
+  // check allocation kind:
+  CheckAllocKind(W, AllocKind::kAllocateStatically);
+  CheckAllocKind(X, AllocKind::kReuse);
+  CheckAllocKind(Y, AllocKind::kAllocate);
+  CheckAllocKind(Z, AllocKind::kAllocateOutput);
+
+  CheckFreed(0, {});
+  CheckFreed(1, {});
+  CheckFreed(2, {Y});
+}
+
+// ParallelChainTest: Check that buffers are still reused along a chain of nodes under parallel execution.
+TEST_F(PlannerTest, ParallelChainTest) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), X3("X3"), X4("X4"), X5("X5");
+
+  // graph structure:
+  AddNormalNode(X1, X2);
+  AddNormalNode(X2, X3);
+  AddNormalNode(X3, X4);
+  AddNormalNode(X4, X5);
+
+  // simulate shape-inference results:
+  Shape shape1{"M", "N"};
+  auto shape = &shape1.value;
+  SetShape({{X1, shape}, {X2, shape}, {X3, shape}, {X4, shape}, {X5, shape}});
+
+  CreatePlan({}, true);
+
+  // X4 reuses X2, which is no longer used once the node producing X4 runs
+  CheckAllocKind(X1, AllocKind::kPreExisting);
+  CheckAllocKind(X2, AllocKind::kAllocate);
+  CheckAllocKind(X3, AllocKind::kAllocate);
+  CheckAllocKind(X4, AllocKind::kReuse);
+  CheckAllocKind(X5, AllocKind::kAllocateOutput);
+
+  CheckFreed(0, {});
+  CheckFreed(1, {});
+  CheckFreed(2, {X3});
+  CheckFreed(3, {X2});
+}
+
+// ParallelInPlaceTest: Check that under parallel execution an input is only updated in-place, or a buffer reused
+// or released, once all the nodes using it have completed, which is not implied by the execution order.
+TEST_F(PlannerTest, ParallelInPlaceTest) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), X3("X3"), X4("X4"), X5("X5"), X6("X6");
+
+  // graph structure. the execution order is X1->X2, X2->X3, X3->X5, X2->X4, X4->X6 but the nodes consuming X2
+  // may run concurrently.
+  AddNormalNode(X1, X2);   // X2: temporary used by two independent nodes
+  AddInplaceNode(X2, X4);  // may-in-place operator; X4: temporary
+  AddNormalNode(X2, X3);   // no in-place operator; X3: temporary
+  AddNormalNode(X4, X6);   // X6: output
+  AddNormalNode(X3, X5);   // X5: output
+
+  // simulate shape-inference results:
+  Shape shape1{"M", "N"};
+  auto shape = &shape1.value;
+  SetShape({{X1, shape}, {X2, shape}, {X3, shape}, {X4, shape}, {X5, shape}, {X6, shape}});
+
+  CreatePlan({}, true);
+
+  // X4 can't be computed in-place in X2, nor reuse X3, as the nodes reading them may still be running
+  CheckAllocKind(X2, AllocKind::kAllocate);
+  CheckAllocKind(X3, AllocKind::kAllocate);
+  CheckAllocKind(X4, AllocKind::kAllocate);
+
+  // X2 is released with the frame, as no node runs after both of its readers
+  CheckFreed(0, {});
+  CheckFreed(1, {});
+  CheckFreed(2, {X3});
+  CheckFreed(3, {});
+  CheckFreed(4, {X4});
+}
+
 // Test operator<< to output details of an allocation & execution plan.
 TEST_F(PlannerTest, PlanOutputTest) {
   // tensor variables:
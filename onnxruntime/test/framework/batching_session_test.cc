@@ -0,0 +1,218 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/batching_session.h"
+
+#include <sstream>
+#include <thread>
+
+#include "core/framework/tensor.h"
+#include "core/graph/model.h"
+#include "test_utils.h"
+#include "test/test_environment.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+// Y = X * X. X has no shape, or the shape [N, 2] if with_batch_shape is set.
+static void LoadSquareModel(InferenceSession& session_object, bool with_batch_shape = false) {
+  Model model("SquareModel");
+  auto& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  if (with_batch_shape) {
+    auto* shape = float_tensor.mutable_tensor_type()->mutable_shape();
+    shape->add_dim()->set_dim_param("N");
+    shape->add_dim()->set_dim_value(2);
+  }
+  auto& x = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  graph.AddNode("square", "Mul", "Y = X * X", {&x, &x}, {&y});
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  std::stringstream model_stream;
+  ASSERT_TRUE(model.ToProto().SerializeToOstream(&model_stream));
+  ASSERT_TRUE(session_object.Load(model_stream).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+}
+
+static MLValue CreateInput(const std::vector<int64_t>& dims, const std::vector<float>& values) {
+  MLValue ml_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), dims, values, &ml_value);
+  return ml_value;
+}
+
+static void VerifySquares(const std::vector<MLValue>& fetches, const std::vector<int64_t>& expected_dims,
+                          const std::vector<float>& values) {
+  ASSERT_EQ(fetches.size(), 1u);
+  const Tensor& y = fetches[0].Get<Tensor>();
+  ASSERT_EQ(y.Shape().GetDims(), expected_dims);
+  ASSERT_EQ(static_cast<size_t>(y.Shape().Size()), values.size());
+  for (size_t i = 0; i < values.size(); ++i) {
+    EXPECT_EQ(y.Data<float>()[i], values[i] * values[i]);
+  }
+}
+
+TEST(BatchingSessionTests, ConcurrentRequestsAreBatched) {
+  SessionOptions so;
+  so.session_logid = "BatchingSessionTests.ConcurrentRequestsAreBatched";
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  LoadSquareModel(session_object);
+
+  constexpr int num_threads = 4;
+  BatchingOptions options;
+  options.max_batch_size = num_threads;
+  // long enough for all threads to queue their request, the batch is executed once it is full
+  options.max_queue_delay_micros = 10 * 1000 * 1000;
+  BatchingSession batching_session{session_object, options};
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&batching_session, t]() {
+      const std::vector<float> values = {static_cast<float>(t), static_cast<float>(t) + 0.5f};
+      std::vector<MLValue> fetches;
+      auto status = batching_session.Run({"X"}, {CreateInput({1, 2}, values)}, {"Y"}, fetches);
+      ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+      VerifySquares(fetches, {1, 2}, values);
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  const BatchingStats stats = batching_session.GetStats();
+  EXPECT_EQ(stats.num_requests, static_cast<uint64_t>(num_threads));
+  EXPECT_EQ(stats.num_unbatched_requests, 0u);
+  EXPECT_EQ(stats.num_batches, 1u);
+  EXPECT_EQ(stats.batch_size_histogram[num_threads], 1u);
+  EXPECT_EQ(stats.AverageBatchSize(), static_cast<double>(num_threads));
+}
+
+TEST(BatchingSessionTests, IncompatibleRequests) {
+  SessionOptions so;
+  so.session_logid = "BatchingSessionTests.IncompatibleRequests";
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  LoadSquareModel(session_object);
+
+  BatchingOptions options;
+  options.max_batch_size = 4;
+  options.max_queue_delay_micros = 1000;
+  BatchingSession batching_session{session_object, options};
+
+  // requests with different sample shapes go to different batches
+  std::thread thread1([&batching_session]() {
+    const std::vector<float> values = {1.0f, 2.0f, 3.0f, 4.0f};
+    std::vector<MLValue> fetches;
+    ASSERT_TRUE(batching_session.Run({"X"}, {CreateInput({2, 2}, values)}, {"Y"}, fetches).IsOK());
+    VerifySquares(fetches, {2, 2}, values);
+  });
+  std::thread thread2([&batching_session]() {
+    const std::vector<float> values = {1.0f, 2.0f, 3.0f};
+    std::vector<MLValue> fetches;
+    ASSERT_TRUE(batching_session.Run({"X"}, {CreateInput({1, 3}, values)}, {"Y"}, fetches).IsOK());
+    VerifySquares(fetches, {1, 3}, values);
+  });
+  thread1.join();
+  thread2.join();
+
+  // more samples than fit in a batch, and scalars, are run on their own
+  {
+    const std::vector<float> values(10, 3.0f);
+    std::vector<MLValue> fetches;
+    ASSERT_TRUE(batching_session.Run({"X"}, {CreateInput({5, 2}, values)}, {"Y"}, fetches).IsOK());
+    VerifySquares(fetches, {5, 2}, values);
+  }
+  {
+    std::vector<MLValue> fetches;
+    ASSERT_TRUE(batching_session.Run({"X"}, {CreateInput({}, {3.0f})}, {"Y"}, fetches).IsOK());
+    VerifySquares(fetches, {}, {3.0f});
+  }
+
+  const BatchingStats stats = batching_session.GetStats();
+  EXPECT_EQ(stats.num_requests, 4u);
+  EXPECT_EQ(stats.num_unbatched_requests, 2u);
+  EXPECT_EQ(stats.num_batches, 2u);
+  EXPECT_EQ(stats.num_batched_samples, 3u);
+}
+
+TEST(BatchingSessionTests, InvalidRequestIsRejectedAlone) {
+  SessionOptions so;
+  so.session_logid = "BatchingSessionTests.InvalidRequestIsRejectedAlone";
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  LoadSquareModel(session_object, true);
+
+  constexpr int num_threads = 3;
+  BatchingOptions options;
+  options.max_batch_size = num_threads;
+  options.max_queue_delay_micros = 10 * 1000 * 1000;
+  BatchingSession batching_session{session_object, options};
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&batching_session, t]() {
+      const std::vector<float> values = {static_cast<float>(t), static_cast<float>(t) + 0.5f};
+      std::vector<MLValue> fetches;
+      auto status = batching_session.Run({"X"}, {CreateInput({1, 2}, values)}, {"Y"}, fetches);
+      ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+      VerifySquares(fetches, {1, 2}, values);
+    });
+  }
+
+  // the samples of the model have 2 elements, so this request fails on its own
+  threads.emplace_back([&batching_session]() {
+    std::vector<MLValue> fetches;
+    auto status = batching_session.Run({"X"}, {CreateInput({1, 3}, {1.0f, 2.0f, 3.0f})}, {"Y"}, fetches);
+    EXPECT_EQ(status.Code(), common::INVALID_ARGUMENT);
+    EXPECT_TRUE(fetches.empty());
+  });
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  const BatchingStats stats = batching_session.GetStats();
+  EXPECT_EQ(stats.num_requests, static_cast<uint64_t>(num_threads + 1));
+  EXPECT_EQ(stats.num_unbatched_requests, 1u);
+  EXPECT_EQ(stats.num_batches, 1u);
+  EXPECT_EQ(stats.batch_size_histogram[num_threads], 1u);
+}
+
+TEST(BatchingSessionTests, BatchesRunConcurrently) {
+  SessionOptions so;
+  so.session_logid = "BatchingSessionTests.BatchesRunConcurrently";
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  LoadSquareModel(session_object);
+
+  BatchingOptions options;
+  options.max_batch_size = 2;
+  options.max_queue_delay_micros = 100;
+  options.num_batch_threads = 4;
+  BatchingSession batching_session{session_object, options};
+
+  constexpr int num_threads = 8;
+  constexpr int num_runs = 50;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&batching_session, t]() {
+      for (int r = 0; r < num_runs; ++r) {
+        const std::vector<float> values = {static_cast<float>(t), static_cast<float>(r)};
+        std::vector<MLValue> fetches;
+        auto status = batching_session.Run({"X"}, {CreateInput({1, 2}, values)}, {"Y"}, fetches);
+        ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+        VerifySquares(fetches, {1, 2}, values);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  const BatchingStats stats = batching_session.GetStats();
+  EXPECT_EQ(stats.num_requests, static_cast<uint64_t>(num_threads * num_runs));
+  EXPECT_EQ(stats.num_batched_samples, static_cast<uint64_t>(num_threads * num_runs));
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -4,6 +4,7 @@
 #include "core/framework/bfc_arena.h"
 #include "gtest/gtest.h"
 #include <cstdlib>
+#include <thread>
 
 namespace onnxruntime {
 namespace test {
@@ -234,5 +235,148 @@ TEST(BFCArenaTest, TestReserve) {
   a.GetStats(&stats);
   EXPECT_EQ(stats.total_allocated_bytes, 1048576);
 }
+
+TEST(BFCArenaTest, Shrink) {
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30);
+
+  // the first region is kept in use, the larger allocations extend the arena by new regions
+  void* small_ptr = a.Alloc(256);
+  std::vector<void*> large_ptrs;
+  for (int i = 0; i < 4; i++) {
+    large_ptrs.push_back(a.Alloc(4 << 20));
+  }
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  const int64_t peak_allocated_bytes = stats.total_allocated_bytes;
+
+  // nothing can be released while the memory is in use
+  EXPECT_EQ(a.Shrink(), 0u);
+
+  for (void* ptr : large_ptrs) {
+    a.Free(ptr);
+  }
+  const size_t released_bytes = a.Shrink();
+  EXPECT_GE(released_bytes, size_t{4 << 20} * 4);
+
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, peak_allocated_bytes - static_cast<int64_t>(released_bytes));
+  EXPECT_EQ(stats.bytes_in_use, 256);
+
+  // the arena grows again on demand
+  void* ptr = a.Alloc(4 << 20);
+  EXPECT_NE(ptr, nullptr);
+  a.Free(ptr);
+  a.Free(small_ptr);
+
+  EXPECT_GT(a.Shrink(), 0u);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, 0);
+}
+
+TEST(BFCArenaTest, ShrinkToTarget) {
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30);
+
+  std::vector<void*> ptrs;
+  for (int i = 0; i < 4; i++) {
+    ptrs.push_back(a.Alloc(4 << 20));
+  }
+  for (void* ptr : ptrs) {
+    a.Free(ptr);
+  }
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  const auto allocated_bytes = static_cast<size_t>(stats.total_allocated_bytes);
+
+  // already below the target
+  EXPECT_EQ(a.Shrink(allocated_bytes), 0u);
+
+  // only the regions needed to get under the target are released
+  const size_t target_bytes = allocated_bytes - 1;
+  const size_t released_bytes = a.Shrink(target_bytes);
+  EXPECT_GT(released_bytes, 0u);
+  a.GetStats(&stats);
+  EXPECT_LE(static_cast<size_t>(stats.total_allocated_bytes), target_bytes);
+  EXPECT_GT(stats.total_allocated_bytes, 0);
+
+  EXPECT_GT(a.Shrink(0), 0u);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, 0);
+}
+
+TEST(BFCArenaTest, ThreadCache) {
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30, true);
+
+  void* first_ptr = a.Alloc(1000);
+  a.Free(first_ptr);
+  // the freed chunk stays in the cache of this thread
+  void* second_ptr = a.Alloc(1000);
+  EXPECT_EQ(first_ptr, second_ptr);
+
+  // a chunk freed by another thread goes back to the cache it was allocated from
+  std::thread([&a, second_ptr]() { a.Free(second_ptr); }).join();
+  void* third_ptr = a.Alloc(1000);
+  EXPECT_EQ(first_ptr, third_ptr);
+  a.Free(third_ptr);
+
+  // large allocations bypass the caches
+  void* large_ptr = a.Alloc(1 << 20);
+  a.Free(large_ptr);
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_cache_hits, 2);
+  EXPECT_EQ(stats.num_cache_misses, 1);
+  EXPECT_EQ(stats.num_allocs, 2);
+  EXPECT_EQ(stats.bytes_in_thread_caches, 1024);
+  EXPECT_EQ(stats.bytes_in_use, 1024);
+}
+
+TEST(BFCArenaTest, ThreadCacheConcurrentAllocations) {
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30, true);
+
+  // each thread frees half of its chunks and hands the others to the next thread to free
+  const int num_threads = 4;
+  std::vector<std::vector<void*>> handed_over(num_threads);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&a, &handed_over, t]() {
+      for (int i = 0; i < 1000; i++) {
+        size_t size = 1 + (i * 37 + t * 101) % (96 << 10);
+        auto* ptr = static_cast<unsigned char*>(a.Alloc(size));
+        ASSERT_NE(ptr, nullptr);
+        ptr[0] = ptr[size - 1] = static_cast<unsigned char>(t);
+        if (i % 2 == 0) {
+          a.Free(ptr);
+        } else {
+          handed_over[t].push_back(ptr);
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  threads.clear();
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&a, &handed_over, t, num_threads]() {
+      for (void* ptr : handed_over[(t + 1) % num_threads]) {
+        a.Free(ptr);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // the threads exited, so the caches returned all free chunks
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_thread_caches, 0);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+  EXPECT_GT(stats.num_cache_hits + stats.num_cache_misses, 0);
+}
 }  // namespace test
 }  // namespace onnxruntime
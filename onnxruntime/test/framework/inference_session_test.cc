@@ -4,16 +4,27 @@
 #include "core/session/inference_session.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
 #include <functional>
+#include <future>
 #include <iterator>
+#include <mutex>
+#include <sstream>
 #include <thread>
 #include <fstream>
 
 #include <google/protobuf/io/zero_copy_stream_impl.h>
 #include "core/common/logging/logging.h"
 #include "core/common/profiler.h"
+#include "core/framework/bfc_arena.h"
 #include "core/framework/compute_capability.h"
+#include "core/framework/customregistry.h"
+#include "core/framework/environment.h"
 #include "core/framework/execution_provider.h"
 #include "core/framework/kernel_registry.h"
 #include "core/framework/op_kernel.h"
@@ -26,6 +37,7 @@
 #include "core/providers/cpu/cpu_execution_provider.h"
 #include "core/providers/cpu/math/element_wise_ops.h"
 #include "core/session/IOBinding.h"
+#include "core/session/optimized_model_cache.h"
 #include "dummy_provider.h"
 #include "test_utils.h"
 #include "test/capturing_sink.h"
@@ -335,6 +347,291 @@ TEST(InferenceSessionTests, DisableCPUArena) {
   RunModel(session_object, run_options);
 }
 
+TEST(InferenceSessionTests, ParallelExecution) {
+  SessionOptions so;
+
+  so.session_logid = "InferenceSessionTests.ParallelExecution";
+  so.enable_sequential_execution = false;
+  so.session_thread_pool_size = 2;
+
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  RunOptions run_options;
+  run_options.run_tag = "parallel execution";
+  RunModel(session_object, run_options);
+  RunModel(session_object, run_options);
+}
+
+TEST(InferenceSessionTests, IntraOpThreadPool) {
+  // 1 runs kernels single threaded and creates no pool
+  for (int intra_op_num_threads : {1, 4}) {
+    SessionOptions so;
+
+    so.session_logid = "InferenceSessionTests.IntraOpThreadPool";
+    so.intra_op_num_threads = intra_op_num_threads;
+
+    InferenceSession session_object{so, &DefaultLoggingManager()};
+    ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+    ASSERT_TRUE(session_object.Initialize().IsOK());
+
+    RunOptions run_options;
+    RunModel(session_object, run_options);
+  }
+}
+
+class InferenceSessionGetIntraOpThreadPoolWrapper : public InferenceSession {
+ public:
+  using InferenceSession::InferenceSession;
+
+  WorkStealingThreadPool* GetIntraOpThreadPool() const {
+    return session_state_.GetIntraOpThreadPool();
+  }
+};
+
+TEST(InferenceSessionTests, SharedIntraOpThreadPool) {
+  // sessions share the Environment's pool by default
+  SessionOptions so;
+
+  so.session_logid = "InferenceSessionTests.SharedIntraOpThreadPool";
+  so.enable_sequential_execution = false;
+
+  InferenceSessionGetIntraOpThreadPoolWrapper session_object_1{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object_1.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object_1.Initialize().IsOK());
+
+  InferenceSessionGetIntraOpThreadPoolWrapper session_object_2{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object_2.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object_2.Initialize().IsOK());
+
+  EXPECT_EQ(session_object_1.GetIntraOpThreadPool(), Environment::GetSharedIntraOpThreadPool());
+  EXPECT_EQ(session_object_2.GetIntraOpThreadPool(), Environment::GetSharedIntraOpThreadPool());
+
+  // an explicit thread count gets the session a pool of its own
+  SessionOptions own_pool_so;
+  own_pool_so.intra_op_num_threads = 4;
+  InferenceSessionGetIntraOpThreadPoolWrapper own_pool_session_object{own_pool_so, &DefaultLoggingManager()};
+  ASSERT_NE(own_pool_session_object.GetIntraOpThreadPool(), nullptr);
+  EXPECT_NE(own_pool_session_object.GetIntraOpThreadPool(), Environment::GetSharedIntraOpThreadPool());
+
+  RunOptions run_options;
+  std::thread other_run([&session_object_2, &run_options]() { RunModel(session_object_2, run_options); });
+  RunModel(session_object_1, run_options);
+  other_run.join();
+}
+
+class InferenceSessionGetInitializerWrapper : public InferenceSession {
+ public:
+  using InferenceSession::InferenceSession;
+
+  const void* GetInitializerData(const std::string& name) const {
+    int mlvalue_index;
+    if (!session_state_.GetMLValueNameIdxMap().GetIdx(name, mlvalue_index).IsOK()) return nullptr;
+    const auto& initializers = session_state_.GetInitializedTensors();
+    auto it = initializers.find(mlvalue_index);
+    return it == initializers.end() ? nullptr : it->second.Get<Tensor>().DataRaw();
+  }
+};
+
+// Y = X * W, where W is stored as raw_data at a 4 byte aligned offset of the model file
+static void CreateMulModelWithRawDataInitializer(const std::string& model_path,
+                                                 const std::vector<float>& w = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f}) {
+  Model model("MulModelWithRawDataInitializer");
+  auto& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TensorProto tensor_proto;
+  tensor_proto.add_dims(3);
+  tensor_proto.add_dims(2);
+  tensor_proto.set_data_type(TensorProto_DataType_FLOAT);
+  tensor_proto.set_raw_data(w.data(), w.size() * sizeof(float));
+  tensor_proto.set_name("W");
+  graph.AddInitializedTensor(tensor_proto);
+
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  auto& x = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& w_arg = graph.GetOrCreateNodeArg("W", &float_tensor);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  graph.AddNode("mul", "Mul", "X * W", {&x, &w_arg}, {&y});
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  // the doc string is serialized before the graph, pad it until the raw data is aligned
+  auto model_proto = model.ToProto();
+  const std::string raw_data = tensor_proto.raw_data();
+  std::string serialized;
+  for (;;) {
+    ASSERT_TRUE(model_proto.SerializeToString(&serialized));
+    if (serialized.find(raw_data) % sizeof(float) == 0) break;
+    model_proto.set_doc_string(model_proto.doc_string() + " ");
+  }
+  std::ofstream out(model_path, std::ios::binary);
+  out.write(serialized.data(), serialized.size());
+  ASSERT_TRUE(out.good());
+}
+
+TEST(InferenceSessionTests, MemoryMappedInitializers) {
+  const std::string model_path = "inference_session_test_mmap_initializers.onnx";
+  CreateMulModelWithRawDataInitializer(model_path);
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.MemoryMappedInitializers";
+  so.use_memory_mapped_initializers = true;
+
+  {
+    InferenceSessionGetInitializerWrapper session_object_1{so, &DefaultLoggingManager()};
+    ASSERT_TRUE(session_object_1.Load(model_path).IsOK());
+    ASSERT_TRUE(session_object_1.Initialize().IsOK());
+
+    InferenceSessionGetInitializerWrapper session_object_2{so, &DefaultLoggingManager()};
+    ASSERT_TRUE(session_object_2.Load(model_path).IsOK());
+    ASSERT_TRUE(session_object_2.Initialize().IsOK());
+
+    // both sessions use the same mapped pages
+    const void* w_data = session_object_1.GetInitializerData("W");
+    ASSERT_NE(w_data, nullptr);
+    EXPECT_EQ(w_data, session_object_2.GetInitializerData("W"));
+
+    RunOptions run_options;
+    RunModel(session_object_1, run_options);
+    RunModel(session_object_2, run_options);
+  }
+
+  std::remove(model_path.c_str());
+}
+
+TEST(InferenceSessionTests, SharedInitializers) {
+  const std::string model_path = "inference_session_test_shared_initializers.onnx";
+  const std::string other_model_path = "inference_session_test_shared_initializers_other.onnx";
+  CreateMulModelWithRawDataInitializer(model_path);
+  // same initializer name and shape, different values
+  CreateMulModelWithRawDataInitializer(other_model_path, {6.0f, 5.0f, 4.0f, 3.0f, 2.0f, 1.0f});
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.SharedInitializers";
+  so.use_shared_initializers = true;
+
+  {
+    InferenceSessionGetInitializerWrapper session_object_1{so, &DefaultLoggingManager()};
+    ASSERT_TRUE(session_object_1.Load(model_path).IsOK());
+    ASSERT_TRUE(session_object_1.Initialize().IsOK());
+
+    InferenceSessionGetInitializerWrapper session_object_2{so, &DefaultLoggingManager()};
+    ASSERT_TRUE(session_object_2.Load(model_path).IsOK());
+    ASSERT_TRUE(session_object_2.Initialize().IsOK());
+
+    InferenceSessionGetInitializerWrapper other_session_object{so, &DefaultLoggingManager()};
+    ASSERT_TRUE(other_session_object.Load(other_model_path).IsOK());
+    ASSERT_TRUE(other_session_object.Initialize().IsOK());
+
+    const void* w_data = session_object_1.GetInitializerData("W");
+    ASSERT_NE(w_data, nullptr);
+    EXPECT_EQ(w_data, session_object_2.GetInitializerData("W"));
+    EXPECT_NE(w_data, other_session_object.GetInitializerData("W"));
+
+    RunOptions run_options;
+    RunModel(session_object_1, run_options);
+    RunModel(session_object_2, run_options);
+  }
+
+  {
+    // the data outlives the session that created it
+    auto session_object_1 = std::make_unique<InferenceSessionGetInitializerWrapper>(so, &DefaultLoggingManager());
+    ASSERT_TRUE(session_object_1->Load(model_path).IsOK());
+    ASSERT_TRUE(session_object_1->Initialize().IsOK());
+
+    InferenceSessionGetInitializerWrapper session_object_2{so, &DefaultLoggingManager()};
+    ASSERT_TRUE(session_object_2.Load(model_path).IsOK());
+    ASSERT_TRUE(session_object_2.Initialize().IsOK());
+    session_object_1.reset();
+
+    RunOptions run_options;
+    RunModel(session_object_2, run_options);
+  }
+
+  std::remove(model_path.c_str());
+  std::remove(other_model_path.c_str());
+}
+
+TEST(InferenceSessionTests, OptimizedModelCache) {
+  const std::string model_path = "inference_session_test_optimized_model_cache.onnx";
+  const std::string other_model_path = "inference_session_test_optimized_model_cache_other.onnx";
+  CreateMulModelWithRawDataInitializer(model_path);
+  CreateMulModelWithRawDataInitializer(other_model_path, {6.0f, 5.0f, 4.0f, 3.0f, 2.0f, 1.0f});
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.OptimizedModelCache";
+  so.optimized_model_cache_dir = ORT_TSTR(".");
+
+  std::string key;
+  ASSERT_TRUE(OptimizedModelCache::ComputeKey(Env::Default(), ToWideString(model_path), {kCpuExecutionProvider},
+                                              static_cast<int>(so.graph_optimization_level), {}, key)
+                  .IsOK());
+  const std::string cached_model_path = ToMBString(OptimizedModelCache(so.optimized_model_cache_dir).GetModelPath(key));
+  std::remove(cached_model_path.c_str());
+
+  {
+    // the first session saves the optimized model
+    InferenceSession session_object{so, &DefaultLoggingManager()};
+    ASSERT_TRUE(session_object.Load(model_path).IsOK());
+    ASSERT_TRUE(session_object.Initialize().IsOK());
+    std::ifstream cached_model(cached_model_path, std::ios::binary);
+    ASSERT_TRUE(cached_model.good());
+
+    RunOptions run_options;
+    RunModel(session_object, run_options);
+  }
+
+  // replace the cached model, to tell whether later sessions use it
+  std::remove(cached_model_path.c_str());
+  ASSERT_EQ(std::rename(other_model_path.c_str(), cached_model_path.c_str()), 0);
+
+  {
+    InferenceSessionGetInitializerWrapper session_object{so, &DefaultLoggingManager()};
+    ASSERT_TRUE(session_object.Load(model_path).IsOK());
+    ASSERT_TRUE(session_object.Initialize().IsOK());
+    const float* w_data = static_cast<const float*>(session_object.GetInitializerData("W"));
+    ASSERT_NE(w_data, nullptr);
+    EXPECT_EQ(w_data[0], 6.0f);
+  }
+
+  {
+    // a different optimization level doesn't use the cached model
+    SessionOptions other_so = so;
+    other_so.graph_optimization_level = TransformerLevel::Level2;
+    InferenceSessionGetInitializerWrapper session_object{other_so, &DefaultLoggingManager()};
+    ASSERT_TRUE(session_object.Load(model_path).IsOK());
+    ASSERT_TRUE(session_object.Initialize().IsOK());
+    const float* w_data = static_cast<const float*>(session_object.GetInitializerData("W"));
+    ASSERT_NE(w_data, nullptr);
+    EXPECT_EQ(w_data[0], 1.0f);
+
+    std::string other_key;
+    ASSERT_TRUE(OptimizedModelCache::ComputeKey(Env::Default(), ToWideString(model_path), {kCpuExecutionProvider},
+                                                static_cast<int>(other_so.graph_optimization_level), {}, other_key)
+                    .IsOK());
+    EXPECT_NE(key, other_key);
+    std::remove(ToMBString(OptimizedModelCache(so.optimized_model_cache_dir).GetModelPath(other_key)).c_str());
+  }
+
+  {
+    // the key doesn't cover custom registries, so a session with one doesn't use the cached model
+    InferenceSessionGetInitializerWrapper session_object{so, &DefaultLoggingManager()};
+    ASSERT_TRUE(session_object.RegisterCustomRegistry(std::make_shared<CustomRegistry>()).IsOK());
+    ASSERT_TRUE(session_object.Load(model_path).IsOK());
+    ASSERT_TRUE(session_object.Initialize().IsOK());
+    const float* w_data = static_cast<const float*>(session_object.GetInitializerData("W"));
+    ASSERT_NE(w_data, nullptr);
+    EXPECT_EQ(w_data[0], 1.0f);
+  }
+
+  std::remove(cached_model_path.c_str());
+  std::remove(model_path.c_str());
+}
+
 #ifdef ORT_RUN_EXTERNAL_ONNX_TESTS
 static bool Compare(const InputDefList& f_arg, const InputDefList& s_arg) {
   if (f_arg.size() != s_arg.size()) {
@@ -562,6 +859,346 @@ TEST(InferenceSessionTests, MultipleSessionsNoTimeout) {
   thread2.join();
 }
 
+TEST(InferenceSessionTests, RunAsync) {
+  SessionOptions so;
+
+  so.session_logid = "InferenceSessionTests.RunAsync";
+  so.run_async_thread_pool_size = 2;
+
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  std::vector<int64_t> dims_mul_x = {3, 2};
+  std::vector<float> values_mul_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  MLValue ml_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), dims_mul_x, values_mul_x,
+                       &ml_value);
+
+  std::vector<int64_t> expected_dims_mul_y = {3, 2};
+  std::vector<float> expected_values_mul_y = {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f};
+
+  // more runs than threads, so some are queued
+  constexpr int num_runs = 8;
+  std::vector<std::promise<std::vector<MLValue>>> results(num_runs);
+  for (auto& result : results) {
+    Status st = session_object.RunAsync(nullptr, {"X"}, {ml_value}, {"Y"},
+                                        [&result](const Status& status, std::vector<MLValue>& fetches) {
+                                          EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+                                          result.set_value(fetches);
+                                        });
+    ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+  }
+
+  for (auto& result : results) {
+    VerifyOutputs(result.get_future().get(), expected_dims_mul_y, expected_values_mul_y);
+  }
+
+  // errors of the run are passed to the callback
+  std::promise<Status> failed_run;
+  ASSERT_TRUE(session_object.RunAsync(nullptr, {"X"}, {ml_value}, {"NotAnOutput"},
+                                      [&failed_run](const Status& status, std::vector<MLValue>& fetches) {
+                                        EXPECT_TRUE(fetches.empty());
+                                        failed_run.set_value(status);
+                                      })
+                  .IsOK());
+  EXPECT_FALSE(failed_run.get_future().get().IsOK());
+
+  // exceptions thrown by the callback don't take down the thread pool
+  std::promise<void> throwing_run;
+  ASSERT_TRUE(session_object.RunAsync(nullptr, {"X"}, {ml_value}, {"Y"},
+                                      [&throwing_run](const Status&, std::vector<MLValue>&) {
+                                        throwing_run.set_value();
+                                        throw 42;
+                                      })
+                  .IsOK());
+  throwing_run.get_future().get();
+
+  std::promise<std::vector<MLValue>> next_run;
+  ASSERT_TRUE(session_object.RunAsync(nullptr, {"X"}, {ml_value}, {"Y"},
+                                      [&next_run](const Status& status, std::vector<MLValue>& fetches) {
+                                        EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+                                        next_run.set_value(fetches);
+                                      })
+                  .IsOK());
+  VerifyOutputs(next_run.get_future().get(), expected_dims_mul_y, expected_values_mul_y);
+}
+
+TEST(InferenceSessionTests, RunAsyncDefaultThreadPoolSize) {
+  SessionOptions so;
+
+  so.session_logid = "InferenceSessionTests.RunAsyncDefaultThreadPoolSize";
+
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  std::vector<int64_t> dims_mul_x = {3, 2};
+  std::vector<float> values_mul_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  MLValue ml_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), dims_mul_x, values_mul_x,
+                       &ml_value);
+
+  // with the default options runs are not serialized, so both callbacks can be running at the same time
+  std::mutex mutex;
+  std::condition_variable cv;
+  int num_started = 0;
+  std::atomic<int> num_concurrent{0};
+  std::vector<std::promise<void>> results(2);
+  for (auto& result : results) {
+    ASSERT_TRUE(session_object.RunAsync(nullptr, {"X"}, {ml_value}, {"Y"},
+                                        [&](const Status& status, std::vector<MLValue>&) {
+                                          EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+                                          std::unique_lock<std::mutex> lock(mutex);
+                                          ++num_started;
+                                          cv.notify_all();
+                                          if (cv.wait_for(lock, std::chrono::seconds(10),
+                                                          [&num_started]() { return num_started == 2; })) {
+                                            ++num_concurrent;
+                                          }
+                                          result.set_value();
+                                        })
+                    .IsOK());
+  }
+
+  for (auto& result : results) {
+    result.get_future().get();
+  }
+  EXPECT_EQ(num_concurrent, 2);
+}
+
+TEST(InferenceSessionTests, RunAsyncWaitsOnDestruction) {
+  SessionOptions so;
+
+  so.session_logid = "InferenceSessionTests.RunAsyncWaitsOnDestruction";
+  so.run_async_thread_pool_size = 1;
+
+  std::vector<int64_t> dims_mul_x = {3, 2};
+  std::vector<float> values_mul_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  MLValue ml_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), dims_mul_x, values_mul_x,
+                       &ml_value);
+
+  std::atomic<int> num_callbacks{0};
+  {
+    InferenceSession session_object{so, &DefaultLoggingManager()};
+    ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+    ASSERT_TRUE(session_object.Initialize().IsOK());
+
+    for (int i = 0; i < 4; ++i) {
+      ASSERT_TRUE(session_object.RunAsync(nullptr, {"X"}, {ml_value}, {"Y"},
+                                          [&num_callbacks](const Status& status, std::vector<MLValue>&) {
+                                            EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+                                            ++num_callbacks;
+                                          })
+                      .IsOK());
+    }
+  }
+
+  EXPECT_EQ(num_callbacks, 4);
+}
+
+class InferenceSessionGetArenaWrapper : public InferenceSession {
+ public:
+  using InferenceSession::InferenceSession;
+
+  // bytes held by the memory arenas of the session's execution providers
+  int64_t ArenaAllocatedBytes() const {
+    int64_t allocated_bytes = 0;
+    for (const auto& xp : session_state_.GetExecutionProviders()) {
+      for (const IAllocator* allocator : xp->GetAllocators()) {
+        const auto* arena = dynamic_cast<const BFCArena*>(allocator);
+        if (arena != nullptr) {
+          AllocatorStats stats;
+          arena->GetStats(&stats);
+          allocated_bytes += stats.total_allocated_bytes;
+        }
+      }
+    }
+    return allocated_bytes;
+  }
+};
+
+// Y = Relu(Relu(X)), where X has 1M elements, so that the arena is extended by regions that are unused after a Run
+static void RunReluChainModel(InferenceSession& session_object) {
+  Model model("ReluChainModel");
+  auto& graph = model.MainGraph();
+
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1 << 20);
+  auto& x = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& t = graph.GetOrCreateNodeArg("T", &float_tensor);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  graph.AddNode("relu_1", "Relu", "T = Relu(X)", {&x}, {&t});
+  graph.AddNode("relu_2", "Relu", "Y = Relu(T)", {&t}, {&y});
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  std::stringstream model_stream;
+  ASSERT_TRUE(model.ToProto().SerializeToOstream(&model_stream));
+  ASSERT_TRUE(session_object.Load(model_stream).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  std::vector<float> values_x(1 << 20, 1.0f);
+  MLValue ml_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {1 << 20}, values_x,
+                       &ml_value);
+  NameMLValMap feeds{{"X", ml_value}};
+  std::vector<MLValue> fetches;
+  status = session_object.Run(RunOptions(), feeds, {"Y"}, &fetches);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  ASSERT_EQ(fetches.size(), 1u);
+  EXPECT_EQ(fetches[0].Get<Tensor>().Data<float>()[0], 1.0f);
+}
+
+TEST(InferenceSessionTests, ShrinkArenas) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.ShrinkArenas";
+
+  // without a high water mark the arena keeps the memory of the run
+  InferenceSessionGetArenaWrapper session_object{so, &DefaultLoggingManager()};
+  RunReluChainModel(session_object);
+  const int64_t working_set_bytes = session_object.ArenaAllocatedBytes();
+  ASSERT_GT(working_set_bytes, int64_t{4 << 20});
+
+  // an explicit shrink returns the unused regions
+  size_t released_bytes = 0;
+  ASSERT_TRUE(session_object.ShrinkArenas(&released_bytes).IsOK());
+  EXPECT_GT(released_bytes, 0u);
+  EXPECT_EQ(session_object.ArenaAllocatedBytes(), working_set_bytes - static_cast<int64_t>(released_bytes));
+
+  // an arena that does not go above the mark is left alone
+  so.arena_shrink_high_water_mark = static_cast<size_t>(working_set_bytes);
+  InferenceSessionGetArenaWrapper session_at_mark{so, &DefaultLoggingManager()};
+  RunReluChainModel(session_at_mark);
+  EXPECT_EQ(session_at_mark.ArenaAllocatedBytes(), working_set_bytes);
+
+  // an arena above the mark only gives back enough regions to get under it
+  so.arena_shrink_high_water_mark = static_cast<size_t>(working_set_bytes) - 1;
+  InferenceSessionGetArenaWrapper session_above_mark{so, &DefaultLoggingManager()};
+  RunReluChainModel(session_above_mark);
+  const int64_t shrunk_bytes = session_above_mark.ArenaAllocatedBytes();
+  EXPECT_LT(shrunk_bytes, working_set_bytes);
+
+  // a mark of 0 releases everything that is unused after each run
+  so.arena_shrink_high_water_mark = 0;
+  InferenceSessionGetArenaWrapper session_without_mark{so, &DefaultLoggingManager()};
+  RunReluChainModel(session_without_mark);
+  EXPECT_LE(session_without_mark.ArenaAllocatedBytes(), shrunk_bytes);
+}
+
+class InferenceSessionGetPlanWrapper : public InferenceSession {
+ public:
+  using InferenceSession::InferenceSession;
+
+  // whether the value named 'name' is planned to be computed in place in the buffer of 'input_name'
+  bool ReusesBufferOf(const std::string& name, const std::string& input_name) const {
+    int mlvalue_index, input_mlvalue_index;
+    const auto& mlvalue_name_idx_map = session_state_.GetMLValueNameIdxMap();
+    if (!mlvalue_name_idx_map.GetIdx(name, mlvalue_index).IsOK() ||
+        !mlvalue_name_idx_map.GetIdx(input_name, input_mlvalue_index).IsOK()) {
+      return false;
+    }
+
+    const auto& allocation_plan = session_state_.GetExecutionPlan()->allocation_plan;
+    const auto& input_plan = allocation_plan[input_mlvalue_index];
+    const int input_buffer = input_plan.alloc_kind == AllocKind::kReuse ? input_plan.reused_buffer
+                                                                        : input_mlvalue_index;
+    return allocation_plan[mlvalue_index].alloc_kind == AllocKind::kReuse &&
+           allocation_plan[mlvalue_index].reused_buffer == input_buffer;
+  }
+};
+
+// Y = -(B + Softmax(-X)) and Z = Cast<float>(Cast<float16>(Cast<int16>(X))), where Softmax, the Add through its
+// input 1 and the int16 to float16 Cast can run in place
+static void LoadInPlaceModel(InferenceSession& session_object) {
+  Model model("InPlaceModel");
+  auto& graph = model.MainGraph();
+
+  auto tensor_type = [](TensorProto_DataType elem_type, const std::vector<int64_t>& dims) {
+    TypeProto type;
+    type.mutable_tensor_type()->set_elem_type(elem_type);
+    for (auto dim : dims) {
+      type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+    }
+    return type;
+  };
+  TypeProto float_tensor = tensor_type(TensorProto_DataType_FLOAT, {2, 3});
+  TypeProto float_vector = tensor_type(TensorProto_DataType_FLOAT, {3});
+  TypeProto int16_tensor = tensor_type(TensorProto_DataType_INT16, {2, 3});
+  TypeProto float16_tensor = tensor_type(TensorProto_DataType_FLOAT16, {2, 3});
+
+  auto& x = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& b = graph.GetOrCreateNodeArg("B", &float_vector);
+  auto& neg_x = graph.GetOrCreateNodeArg("NegX", &float_tensor);
+  auto& softmax = graph.GetOrCreateNodeArg("Softmax", &float_tensor);
+  auto& sum = graph.GetOrCreateNodeArg("Sum", &float_tensor);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  graph.AddNode("neg_x", "Neg", "NegX = -X", {&x}, {&neg_x});
+  graph.AddNode("softmax", "Softmax", "Softmax = Softmax(NegX)", {&neg_x}, {&softmax});
+  graph.AddNode("add", "Add", "Sum = B + Softmax", {&b, &softmax}, {&sum});
+  graph.AddNode("neg_sum", "Neg", "Y = -Sum", {&sum}, {&y});
+
+  auto& x_int16 = graph.GetOrCreateNodeArg("XInt16", &int16_tensor);
+  auto& x_float16 = graph.GetOrCreateNodeArg("XFloat16", &float16_tensor);
+  auto& z = graph.GetOrCreateNodeArg("Z", &float_tensor);
+  graph.AddNode("to_int16", "Cast", "XInt16 = Cast(X)", {&x}, {&x_int16})
+      .AddAttribute("to", int64_t{TensorProto_DataType_INT16});
+  graph.AddNode("to_float16", "Cast", "XFloat16 = Cast(XInt16)", {&x_int16}, {&x_float16})
+      .AddAttribute("to", int64_t{TensorProto_DataType_FLOAT16});
+  graph.AddNode("to_float", "Cast", "Z = Cast(XFloat16)", {&x_float16}, {&z})
+      .AddAttribute("to", int64_t{TensorProto_DataType_FLOAT});
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  std::stringstream model_stream;
+  ASSERT_TRUE(model.ToProto().SerializeToOstream(&model_stream));
+  ASSERT_TRUE(session_object.Load(model_stream).IsOK());
+  status = session_object.Initialize();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+}
+
+TEST(InferenceSessionTests, InPlaceKernels) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.InPlaceKernels";
+  InferenceSessionGetPlanWrapper session_object{so, &DefaultLoggingManager()};
+  LoadInPlaceModel(session_object);
+
+  EXPECT_TRUE(session_object.ReusesBufferOf("Softmax", "NegX"));
+  EXPECT_TRUE(session_object.ReusesBufferOf("Sum", "Softmax"));
+  EXPECT_TRUE(session_object.ReusesBufferOf("XFloat16", "XInt16"));
+
+  const std::vector<float> values_x = {1.0f, 2.0f, 3.0f, -1.0f, 0.0f, 1.0f};
+  const std::vector<float> values_b = {0.5f, -1.0f, 2.0f};
+  MLValue ml_value_x, ml_value_b;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {2, 3}, values_x,
+                       &ml_value_x);
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {3}, values_b, &ml_value_b);
+  NameMLValMap feeds{{"X", ml_value_x}, {"B", ml_value_b}};
+  std::vector<MLValue> fetches;
+  auto status = session_object.Run(RunOptions(), feeds, {"Y", "Z"}, &fetches);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  ASSERT_EQ(fetches.size(), 2u);
+
+  const float* y = fetches[0].Get<Tensor>().Data<float>();
+  const float* z = fetches[1].Get<Tensor>().Data<float>();
+  for (int row = 0; row < 2; ++row) {
+    float sum_exp = 0.0f;
+    for (int col = 0; col < 3; ++col) {
+      sum_exp += std::exp(-values_x[row * 3 + col]);
+    }
+    for (int col = 0; col < 3; ++col) {
+      const int i = row * 3 + col;
+      EXPECT_NEAR(y[i], -(values_b[col] + std::exp(-values_x[i]) / sum_exp), 1e-5f);
+      EXPECT_EQ(z[i], values_x[i]);
+    }
+  }
+  // the feeds are never updated in place
+  EXPECT_EQ(ml_value_x.Get<Tensor>().Data<float>()[0], values_x[0]);
+  EXPECT_EQ(ml_value_b.Get<Tensor>().Data<float>()[0], values_b[0]);
+}
+
 TEST(InferenceSessionTests, PreAllocateOutputVector) {
   SessionOptions so;
 
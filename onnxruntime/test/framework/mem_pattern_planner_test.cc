@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/framework/mem_pattern_planner.h"
+#include <random>
 #include "gtest/gtest.h"
 
 namespace onnxruntime {
@@ -34,5 +35,67 @@ TEST(MemPatternPlannerTest, TraceAllocaitonTest) {
   EXPECT_EQ(pattern.GetBlock(5)->offset_, 1024 + 256 + 512);
   EXPECT_EQ(pattern.GetBlock(6)->offset_, 1024);
 }
+
+TEST(MemPatternPlannerTest, OfflinePlacementTest) {
+  MemPatternPlanner planner;
+  planner.TraceAllocation(0, 100);
+  planner.TraceAllocation(1, 50);
+  planner.TraceFree(0);
+  planner.TraceAllocation(2, 150);
+
+  // the online placement can't reuse the freed block for the larger one
+  auto pattern = planner.GenerateMemPattern();
+  EXPECT_EQ(pattern.PeakSize(), 100 + 50 + 150);
+  EXPECT_EQ(pattern.LowerBoundSize(), 50 + 150);
+
+  auto offline_pattern = planner.GenerateOfflineMemPattern();
+  EXPECT_EQ(offline_pattern.PeakSize(), 50 + 150);
+  EXPECT_EQ(offline_pattern.LowerBoundSize(), 50 + 150);
+  EXPECT_EQ(offline_pattern.GetBlock(2)->offset_, 0);
+  EXPECT_EQ(offline_pattern.GetBlock(0)->offset_, 0);
+  EXPECT_EQ(offline_pattern.GetBlock(1)->offset_, 150);
+}
+
+TEST(MemPatternPlannerTest, OfflinePlacementRandomTest) {
+  std::default_random_engine random_engine(1234);
+  std::uniform_int_distribution<size_t> size_distribution(1, 4096);
+  std::bernoulli_distribution free_distribution(0.5);
+
+  MemPatternPlanner planner;
+  std::vector<int> live;
+  // the lifetime of each block in trace steps, as [start, end)
+  std::vector<std::pair<size_t, size_t>> lifetimes;
+  size_t step = 0;
+  for (int i = 0; i < 200; i++) {
+    planner.TraceAllocation(i, size_distribution(random_engine));
+    lifetimes.emplace_back(step++, std::numeric_limits<size_t>::max());
+    live.push_back(i);
+    while (!live.empty() && free_distribution(random_engine)) {
+      size_t position = size_distribution(random_engine) % live.size();
+      planner.TraceFree(live[position]);
+      lifetimes[live[position]].second = step++;
+      live.erase(live.begin() + position);
+    }
+  }
+
+  auto pattern = planner.GenerateMemPattern();
+  auto offline_pattern = planner.GenerateOfflineMemPattern();
+  EXPECT_EQ(pattern.LowerBoundSize(), offline_pattern.LowerBoundSize());
+  EXPECT_GE(offline_pattern.PeakSize(), offline_pattern.LowerBoundSize());
+
+  // blocks that are in use at the same time must not share memory
+  for (int i = 0; i < 200; i++) {
+    const MemoryBlock* block_i = offline_pattern.GetBlock(i);
+    EXPECT_LE(block_i->offset_ + block_i->size_, offline_pattern.PeakSize());
+    for (int j = 0; j < i; j++) {
+      if (lifetimes[i].first >= lifetimes[j].second || lifetimes[j].first >= lifetimes[i].second)
+        continue;
+      const MemoryBlock* block_j = offline_pattern.GetBlock(j);
+      EXPECT_TRUE(block_i->offset_ >= block_j->offset_ + block_j->size_ ||
+                  block_j->offset_ >= block_i->offset_ + block_i->size_)
+          << "blocks " << i << " and " << j << " overlap";
+    }
+  }
+}
 }  // namespace test
 }  // namespace onnxruntime
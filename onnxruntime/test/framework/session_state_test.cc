@@ -70,5 +70,39 @@ TEST(SessionStateTest, AddGetKernelTest) {
   std::cout << "orig: " << orig_num_outputs << " new: " << test_kernel->Node().OutputDefs().size() << std::endl;
   EXPECT_EQ(orig_num_outputs, test_kernel->Node().OutputDefs().size());
 }
+
+TEST(SessionStateTest, MemoryPatternCacheTest) {
+  ExecutionProviders execution_providers;
+  SessionState s{execution_providers};
+  s.SetMaxNumMemoryPatterns(2);
+
+  auto shapes = [](int64_t batch, int64_t sequence) {
+    return std::vector<TensorShape>{TensorShape({batch, sequence})};
+  };
+
+  EXPECT_EQ(s.GetMemoryPatternGroup(shapes(1, 10)), nullptr);
+  ASSERT_TRUE(s.UpdateMemoryPatternGroupCache(shapes(1, 10), std::make_unique<MemoryPatternGroup>()).IsOK());
+  auto patterns_10 = s.GetMemoryPatternGroup(shapes(1, 10));
+  ASSERT_NE(patterns_10, nullptr);
+
+  // smaller inputs in the same bucket use the pattern, larger ones need a new pattern
+  EXPECT_EQ(s.GetMemoryPatternGroup(shapes(1, 9)), patterns_10);
+  EXPECT_EQ(s.GetMemoryPatternGroup(shapes(1, 12)), nullptr);
+  ASSERT_TRUE(s.UpdateMemoryPatternGroupCache(shapes(1, 12), std::make_unique<MemoryPatternGroup>()).IsOK());
+  auto patterns_12 = s.GetMemoryPatternGroup(shapes(1, 9));
+  ASSERT_NE(patterns_12, nullptr);
+  EXPECT_NE(patterns_12, patterns_10);
+  EXPECT_EQ(s.GetMemoryPatternGroup(shapes(1, 16)), nullptr);
+  EXPECT_EQ(s.GetMemoryPatternGroup(shapes(1, 17)), nullptr);
+  EXPECT_EQ(s.GetMemoryPatternGroup(shapes(10, 1)), nullptr);
+
+  // the least recently used pattern is dropped
+  ASSERT_TRUE(s.UpdateMemoryPatternGroupCache(shapes(1, 20), std::make_unique<MemoryPatternGroup>()).IsOK());
+  EXPECT_NE(s.GetMemoryPatternGroup(shapes(1, 12)), nullptr);
+  ASSERT_TRUE(s.UpdateMemoryPatternGroupCache(shapes(1, 40), std::make_unique<MemoryPatternGroup>()).IsOK());
+  EXPECT_NE(s.GetMemoryPatternGroup(shapes(1, 12)), nullptr);
+  EXPECT_EQ(s.GetMemoryPatternGroup(shapes(1, 20)), nullptr);
+  EXPECT_NE(s.GetMemoryPatternGroup(shapes(1, 40)), nullptr);
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -2,6 +2,11 @@
 // Licensed under the MIT License.
 
 #include "core/framework/tensorprotoutils.h"
+
+#include <cstdio>
+#include <fstream>
+
+#include "core/framework/tensor.h"
 #include "core/graph/onnx_protobuf.h"
 #include "gtest/gtest.h"
 
@@ -71,5 +76,109 @@ TEST(TensorParseTest, TensorUtilsTest) {
   status = UnpackTensorWrapper(bool_tensor_proto, string_data, 2);
   EXPECT_FALSE(status.IsOK());
 }
+
+TEST(TensorParseTest, MappedExternalData) {
+  const std::string data_file = "tensorutils_test_mapped_external_data.bin";
+  const std::vector<float> values = {1.1f, 2.2f, 3.3f, 4.4f, 5.5f, 6.6f};
+  {
+    // the tensor starts after 16 bytes of something else
+    std::vector<char> file_data(16, 'x');
+    file_data.insert(file_data.end(), reinterpret_cast<const char*>(values.data()),
+                     reinterpret_cast<const char*>(values.data() + values.size()));
+    std::ofstream out(data_file, std::ios::binary);
+    out.write(file_data.data(), file_data.size());
+    ASSERT_TRUE(out.good());
+  }
+
+  TensorProto tensor_proto;
+  tensor_proto.set_data_type(TensorProto_DataType_FLOAT);
+  tensor_proto.add_dims(2);
+  tensor_proto.add_dims(3);
+  tensor_proto.set_data_location(TensorProto_DataLocation_EXTERNAL);
+  auto* location = tensor_proto.add_external_data();
+  location->set_key("location");
+  location->set_value(data_file);
+  auto* offset = tensor_proto.add_external_data();
+  offset->set_key("offset");
+  offset->set_value("16");
+
+  const OrtAllocatorInfo cpu_info(CPU, OrtDeviceAllocator, 0, OrtMemTypeDefault);
+  MLValue value_1, value_2;
+  OrtCallback deleter_1, deleter_2;
+  bool mapped = false;
+  auto status = TensorProtoToMappedMLValue(Env::Default(), nullptr, tensor_proto, cpu_info, value_1, deleter_1, mapped);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  ASSERT_TRUE(mapped);
+  status = TensorProtoToMappedMLValue(Env::Default(), nullptr, tensor_proto, cpu_info, value_2, deleter_2, mapped);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  ASSERT_TRUE(mapped);
+
+  // both tensors point into the same mapping of the file
+  const Tensor& tensor = value_1.Get<Tensor>();
+  EXPECT_EQ(tensor.Shape(), TensorShape({2, 3}));
+  EXPECT_EQ(tensor.DataRaw(), value_2.Get<Tensor>().DataRaw());
+  EXPECT_EQ(values, std::vector<float>(tensor.Data<float>(), tensor.Data<float>() + values.size()));
+
+  // a length that doesn't match the tensor is an error
+  auto* length = tensor_proto.add_external_data();
+  length->set_key("length");
+  length->set_value("20");
+  MLValue value_3;
+  OrtCallback deleter_3;
+  status = TensorProtoToMappedMLValue(Env::Default(), nullptr, tensor_proto, cpu_info, value_3, deleter_3, mapped);
+  EXPECT_FALSE(status.IsOK());
+
+  deleter_1.f(deleter_1.param);
+  deleter_2.f(deleter_2.param);
+  std::remove(data_file.c_str());
+}
+
+TEST(TensorParseTest, MappedRawData) {
+  const std::string model_file = "tensorutils_test_mapped_raw_data.onnx";
+  const std::vector<float> values = {1.1f, 2.2f, 3.3f, 4.4f};
+
+  ModelProto model_proto;
+  TensorProto* initializer = model_proto.mutable_graph()->add_initializer();
+  initializer->set_name("W");
+  initializer->set_data_type(TensorProto_DataType_FLOAT);
+  initializer->add_dims(4);
+  initializer->set_raw_data(values.data(), values.size() * sizeof(float));
+  // the doc string is serialized before the graph, pad it until the raw data is aligned
+  std::string serialized;
+  for (;;) {
+    ASSERT_TRUE(model_proto.SerializeToString(&serialized));
+    if (serialized.find(initializer->raw_data()) % sizeof(float) == 0) break;
+    model_proto.set_doc_string(model_proto.doc_string() + " ");
+  }
+  {
+    std::ofstream out(model_file, std::ios::binary);
+    out.write(serialized.data(), serialized.size());
+    ASSERT_TRUE(out.good());
+  }
+
+  const OrtAllocatorInfo cpu_info(CPU, OrtDeviceAllocator, 0, OrtMemTypeDefault);
+  const std::basic_string<ORTCHAR_T> model_path = ToWideString(model_file);
+  MLValue value;
+  OrtCallback deleter;
+  bool mapped = false;
+  auto status = TensorProtoToMappedMLValue(Env::Default(), model_path.c_str(), *initializer, cpu_info, value, deleter,
+                                           mapped);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  ASSERT_TRUE(mapped);
+  const Tensor& tensor = value.Get<Tensor>();
+  EXPECT_NE(tensor.DataRaw(), static_cast<const void*>(initializer->raw_data().data()));
+  EXPECT_EQ(values, std::vector<float>(tensor.Data<float>(), tensor.Data<float>() + values.size()));
+  deleter.f(deleter.param);
+
+  // an initializer that no longer matches the file is not mapped
+  TensorProto changed = *initializer;
+  const float changed_values[] = {1.1f, 2.2f, 3.3f, 5.5f};
+  changed.set_raw_data(changed_values, sizeof(changed_values));
+  status = TensorProtoToMappedMLValue(Env::Default(), model_path.c_str(), changed, cpu_info, value, deleter, mapped);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  EXPECT_FALSE(mapped);
+
+  std::remove(model_file.c_str());
+}
 }  // namespace test
 }  // namespace onnxruntime
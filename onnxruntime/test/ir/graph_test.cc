@@ -824,6 +824,44 @@ TEST(TypeInferenceTest, VariadicOutput) {
   CheckTensorEltType(Z.TypeAsProto(), TensorProto_DataType_FLOAT);
 }
 
+// Test that removed initializers are dropped from the GraphProto, and replacing one doesn't duplicate it
+TEST(ResolvingGraphTest, RemovedInitializerIsNotSaved) {
+  Model model("graph_1");
+  auto& graph = model.MainGraph();
+
+  for (const char* name : {"A", "B", "C"}) {
+    ONNX_NAMESPACE::TensorProto weight;
+    weight.set_data_type(TensorProto_DataType_FLOAT);
+    weight.add_dims(1);
+    weight.add_float_data(1.0f);
+    weight.set_name(name);
+    graph.AddInitializedTensor(weight);
+  }
+
+  // replace B the way the fusion transformers do
+  graph.RemoveInitializedTensor("B");
+  ONNX_NAMESPACE::TensorProto new_weight;
+  new_weight.set_data_type(TensorProto_DataType_FLOAT);
+  new_weight.add_dims(1);
+  new_weight.add_float_data(2.0f);
+  new_weight.set_name("B");
+  graph.AddInitializedTensor(new_weight);
+  graph.RemoveInitializedTensor("A");
+
+  const auto& initializers = graph.ToGraphProto().initializer();
+  ASSERT_EQ(initializers.size(), 2);
+  EXPECT_EQ(initializers.Get(0).name(), "C");
+  EXPECT_EQ(initializers.Get(1).name(), "B");
+  EXPECT_EQ(initializers.Get(1).float_data(0), 2.0f);
+
+  // the initializers still in use are unaffected
+  const TensorProto* tensor = nullptr;
+  ASSERT_TRUE(graph.GetInitializedTensor("C", tensor));
+  EXPECT_EQ(tensor, &initializers.Get(0));
+  ASSERT_TRUE(graph.GetInitializedTensor("B", tensor));
+  EXPECT_EQ(tensor->float_data(0), 2.0f);
+}
+
 // Test that Graph::Resolve identifies name-duplication across initializer and node-output-arg
 TEST(NameResolutionTest, DuplicateName) {
   Model model("graph_1");
@@ -18,6 +18,7 @@ Abstract:
 #include <memory.h>
 #include <algorithm>
 #include <limits>
+#include <vector>
 #include <mlas.h>
 
 #if defined(_WIN32)
@@ -240,7 +241,7 @@ TrialSgemm(
         CReference[f] = -0.5f;
     }
 
-    MlasSgemm(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
+    MlasSgemm(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc, nullptr);
     ReferenceSgemm(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, CReference, ldc);
 
     for (size_t f = 0; f < M * N; f++) {
@@ -249,6 +250,25 @@ TrialSgemm(
             printf("mismatch TransA=%d, TransB=%d, M=%zd, N=%zd, K=%zd, alpha=%f, beta=%f!\n", TransA, TransB, M, N, K, alpha, beta);
         }
     }
+
+    //
+    // Repeat the operation with matrix B packed in advance.
+    //
+
+    std::vector<uint8_t> PackedB(MlasSgemmPackBSize(N, K));
+    MlasSgemmPackB(TransB, N, K, B, ldb, PackedB.data());
+
+    for (size_t f = 0; f < M * N; f++) {
+        C[f] = -0.5f;
+    }
+
+    MlasSgemm(TransA, M, N, K, alpha, A, lda, PackedB.data(), beta, C, ldc, nullptr);
+
+    for (size_t f = 0; f < M * N; f++) {
+        if (C[f] != CReference[f]) {
+            printf("mismatch packed TransA=%d, TransB=%d, M=%zd, N=%zd, K=%zd, alpha=%f, beta=%f!\n", TransA, TransB, M, N, K, alpha, beta);
+        }
+    }
 }
 
 void
@@ -439,7 +459,7 @@ ReferenceConv2D(
             }
 
             MlasSgemm(CblasNoTrans, CblasNoTrans, FilterCount, OutputSize, K, 1.0f,
-                filter, K, Im2Col, OutputSize, 0.0f, Output, OutputSize);
+                filter, K, Im2Col, OutputSize, 0.0f, Output, OutputSize, nullptr);
 
             //
             // Apply the bias.
@@ -516,7 +536,8 @@ TrialConv2D(
                     OutputShape,
                     FilterCount,
                     &Activation,
-                    &WorkingBufferSize);
+                    &WorkingBufferSize,
+                    nullptr);
 
     size_t OutputHeight = size_t(OutputHeight64);
     size_t OutputWidth = size_t(OutputWidth64);
@@ -573,6 +594,107 @@ TrialConv2D(
     }
 }
 
+void
+ReferenceQgemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const uint8_t* A,
+    size_t lda,
+    uint8_t offa,
+    const uint8_t* B,
+    size_t ldb,
+    uint8_t offb,
+    int32_t* C,
+    size_t ldc
+    )
+{
+    for (size_t m = 0; m < M; m++) {
+
+        for (size_t n = 0; n < N; n++) {
+
+            const uint8_t* a = A + (m * lda);
+            const uint8_t* b = B + n;
+            int32_t* c = C + (m * ldc) + n;
+            int32_t sum = 0;
+
+            for (size_t k = 0; k < K; k++) {
+                sum += ((int32_t(*b) - offb) * (int32_t(*a) - offa));
+                b += ldb;
+                a += 1;
+            }
+
+            *c = sum;
+        }
+    }
+}
+
+void
+TrialQgemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    uint8_t offa,
+    uint8_t offb
+    )
+{
+    std::vector<uint8_t> A(M * K);
+    std::vector<uint8_t> B(K * N);
+    std::vector<int32_t> C(M * N);
+    std::vector<int32_t> CReference(M * N);
+
+    for (size_t f = 0; f < A.size(); f++) {
+        A[f] = uint8_t(f * 7 + 3);
+    }
+
+    for (size_t f = 0; f < B.size(); f++) {
+        B[f] = uint8_t(f * 13 + 5);
+    }
+
+    std::fill_n(C.data(), C.size(), -1);
+
+    MlasQgemm(M, N, K, A.data(), K, offa, B.data(), N, offb, C.data(), N, nullptr);
+    ReferenceQgemm(M, N, K, A.data(), K, offa, B.data(), N, offb, CReference.data(), N);
+
+    for (size_t f = 0; f < M * N; f++) {
+        if (C[f] != CReference[f]) {
+            printf("mismatch Qgemm M=%zd, N=%zd, K=%zd, offa=%d, offb=%d!\n", M, N, K, int(offa), int(offb));
+            break;
+        }
+    }
+}
+
+void
+ExecuteQgemmTests(
+    void
+    )
+{
+    static const uint8_t offsets[] = { 0, 1, 128, 255 };
+
+    for (size_t a = 0; a < _countof(offsets); a++) {
+        for (size_t b = 0; b < _countof(offsets); b++) {
+            for (size_t M = 1; M < 20; M++) {
+                for (size_t N = 1; N < 40; N += 3) {
+                    for (size_t K = 1; K < 40; K += 5) {
+                        TrialQgemm(M, N, K, offsets[a], offsets[b]);
+                    }
+                }
+            }
+        }
+    }
+
+    for (size_t M = 16; M < 160; M += 32) {
+        for (size_t N = 16; N < 300; N += 47) {
+            static const size_t ks[] = { 1, 2, 3, 16, 255, 256, 257, 512, 600 };
+            for (size_t k = 0; k < _countof(ks); k++) {
+                TrialQgemm(M, N, ks[k], 3, 200);
+                TrialQgemm(M + 1, N + 1, ks[k], 200, 3);
+            }
+        }
+        printf("Qgemm M %zd\n", M);
+    }
+}
+
 void
 ExecuteConvTests(
     void
@@ -601,6 +723,17 @@ ExecuteConvTests(
         TrialConv2D(b, 1, 64, 11, 11, 128, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1);
     }
 
+    for (unsigned i = 1; i <= 40; i += 3) {
+        for (unsigned k = 1; k <= 5; k += 2) {
+            for (unsigned s = 1; s <= 2; s++) {
+                TrialConv2D(1, 32, 1, i, i, 1, k, k, 0, 0, 0, 0, 1, 1, s, s);
+                TrialConv2D(2, 16, 1, i, i + 3, 1, k, k, k / 2, k / 2, k / 2, k / 2, 1, 1, s, s);
+                TrialConv2D(1, 8, 1, i + 5, i, 2, k, k, 1, 2, 2, 1, 1, 1, s, s);
+                TrialConv2D(3, 5, 1, i, i, 3, k, k, k / 2, k / 2, k / 2, k / 2, 2, 2, s, s);
+            }
+        }
+    }
+
     for (unsigned ic = 0; ic < _countof(cs); ic++) {
         for (unsigned ih = 0; ih < _countof(is); ih++) {
             for (unsigned iw = 0; iw < _countof(is); iw++) {
@@ -975,7 +1108,7 @@ TrialPool2D(
     float* Output = BufferOutput.GetBuffer(OutputBufferElements);
     float* OutputReference = BufferOutputReference.GetBuffer(OutputBufferElements);
 
-    MlasPool(MlasMaximumPooling, 2, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output);
+    MlasPool(MlasMaximumPooling, 2, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output, nullptr);
     ReferenceMaximumPool2D(InputShape, KernelShape, Padding, StrideShape, Input, OutputReference);
 
     if (memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0) {
@@ -983,7 +1116,7 @@ TrialPool2D(
             InputChannels, InputHeight, InputWidth, KernelHeight, KernelWidth);
     }
 
-    MlasPool(MlasAveragePoolingExcludePad, 2, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output);
+    MlasPool(MlasAveragePoolingExcludePad, 2, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output, nullptr);
     ReferenceAveragePool2D(InputShape, KernelShape, Padding, StrideShape, Input, OutputReference, false);
 
     if (memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0) {
@@ -991,7 +1124,7 @@ TrialPool2D(
             InputChannels, InputHeight, InputWidth, KernelHeight, KernelWidth);
     }
 
-    MlasPool(MlasAveragePoolingIncludePad, 2, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output);
+    MlasPool(MlasAveragePoolingIncludePad, 2, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output, nullptr);
     ReferenceAveragePool2D(InputShape, KernelShape, Padding, StrideShape, Input, OutputReference, true);
 
     if (memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0) {
@@ -1042,7 +1175,7 @@ TrialPool3D(
     float* Output = BufferOutput.GetBuffer(OutputBufferElements);
     float* OutputReference = BufferOutputReference.GetBuffer(OutputBufferElements);
 
-    MlasPool(MlasMaximumPooling, 3, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output);
+    MlasPool(MlasMaximumPooling, 3, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output, nullptr);
     ReferenceMaximumPool3D(InputShape, KernelShape, Padding, StrideShape, Input, OutputReference);
 
     if (memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0) {
@@ -1050,7 +1183,7 @@ TrialPool3D(
             InputChannels, InputDepth, InputHeight, InputWidth, KernelDepth, KernelHeight, KernelWidth);
     }
 
-    MlasPool(MlasAveragePoolingExcludePad, 3, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output);
+    MlasPool(MlasAveragePoolingExcludePad, 3, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output, nullptr);
     ReferenceAveragePool3D(InputShape, KernelShape, Padding, StrideShape, Input, OutputReference, false);
 
     if (memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0) {
@@ -1058,7 +1191,7 @@ TrialPool3D(
             InputChannels, InputDepth, InputHeight, InputWidth, KernelDepth, KernelHeight, KernelWidth);
     }
 
-    MlasPool(MlasAveragePoolingIncludePad, 3, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output);
+    MlasPool(MlasAveragePoolingIncludePad, 3, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output, nullptr);
     ReferenceAveragePool3D(InputShape, KernelShape, Padding, StrideShape, Input, OutputReference, true);
 
     if (memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0) {
@@ -1152,6 +1285,268 @@ ExecutePool3DTests(
     }
 }
 
+void
+TrialNchwcConv2D(
+    size_t BatchCount,
+    size_t GroupCount,
+    size_t InputChannels,
+    size_t InputHeight,
+    size_t InputWidth,
+    size_t FilterCount,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    size_t PaddingLeftHeight,
+    size_t PaddingLeftWidth,
+    size_t PaddingRightHeight,
+    size_t PaddingRightWidth,
+    size_t DilationHeight,
+    size_t DilationWidth,
+    size_t StrideHeight,
+    size_t StrideWidth
+    )
+{
+    int64_t OutputHeight64 =
+        ((int64_t(InputHeight) + int64_t(PaddingLeftHeight) + int64_t(PaddingRightHeight)) -
+        (int64_t(DilationHeight) * (int64_t(KernelHeight) - 1) + 1)) / int64_t(StrideHeight) + 1;
+    int64_t OutputWidth64 =
+        ((int64_t(InputWidth) + int64_t(PaddingLeftWidth) + int64_t(PaddingRightWidth)) -
+        (int64_t(DilationWidth) * (int64_t(KernelWidth) - 1) + 1)) / int64_t(StrideWidth) + 1;
+
+    if (OutputHeight64 <= 0 || OutputWidth64 <= 0) {
+        return;
+    }
+
+    //
+    // The NCHWc convolution supports a single group or a depthwise convolution.
+    //
+
+    const size_t BlockSize = MlasNchwcGetBlockSize();
+
+    size_t TotalInputChannels = GroupCount * InputChannels;
+    size_t TotalFilterCount = GroupCount * FilterCount;
+    size_t NchwcInputChannels = (TotalInputChannels + BlockSize - 1) & ~(BlockSize - 1);
+    size_t NchwcFilterCount = (TotalFilterCount + BlockSize - 1) & ~(BlockSize - 1);
+
+    size_t OutputHeight = size_t(OutputHeight64);
+    size_t OutputWidth = size_t(OutputWidth64);
+
+    int64_t InputShape[] = { int64_t(BatchCount), int64_t(TotalInputChannels), int64_t(InputHeight), int64_t(InputWidth) };
+    int64_t FilterShape[] = { int64_t(TotalFilterCount), int64_t(InputChannels), int64_t(KernelHeight), int64_t(KernelWidth) };
+    int64_t OutputShape[] = { int64_t(BatchCount), int64_t(TotalFilterCount), OutputHeight64, OutputWidth64 };
+
+    int64_t NchwcInputShape[] = { int64_t(BatchCount), int64_t(NchwcInputChannels), int64_t(InputHeight), int64_t(InputWidth) };
+    int64_t NchwcOutputShape[] = { int64_t(BatchCount), int64_t(NchwcFilterCount), OutputHeight64, OutputWidth64 };
+
+    int64_t KernelShape[] = { int64_t(KernelHeight), int64_t(KernelWidth) };
+    int64_t DilationShape[] = { int64_t(DilationHeight), int64_t(DilationWidth) };
+    int64_t Padding[] = { int64_t(PaddingLeftHeight), int64_t(PaddingLeftWidth), int64_t(PaddingRightHeight), int64_t(PaddingRightWidth) };
+    int64_t StrideShape[] = { int64_t(StrideHeight), int64_t(StrideWidth) };
+
+    size_t InputSize = InputHeight * InputWidth;
+    size_t KernelSize = KernelHeight * KernelWidth;
+    size_t OutputSize = OutputHeight * OutputWidth;
+
+    size_t InputBufferElements = BatchCount * TotalInputChannels * InputSize;
+    size_t FilterBufferElements = TotalFilterCount * InputChannels * KernelSize;
+    size_t BiasBufferElements = TotalFilterCount;
+    size_t OutputBufferElements = BatchCount * TotalFilterCount * OutputSize;
+
+    size_t NchwcInputBufferElements = BatchCount * NchwcInputChannels * InputSize;
+    size_t NchwcFilterBufferElements = NchwcFilterCount * KernelSize *
+        ((GroupCount > 1) ? 1 : (InputChannels + BlockSize - 1) & ~(BlockSize - 1));
+    size_t NchwcOutputBufferElements = BatchCount * NchwcFilterCount * OutputSize;
+
+    MatrixGuardBuffer BufferInput(InputBufferElements, true);
+    MatrixGuardBuffer BufferFilter(FilterBufferElements, true);
+    MatrixGuardBuffer BufferBias(BiasBufferElements, true);
+    MatrixGuardBuffer BufferOutput(OutputBufferElements, false);
+    MatrixGuardBuffer BufferOutputReference(OutputBufferElements, false);
+    MatrixGuardBuffer BufferNchwcInput(NchwcInputBufferElements, false);
+    MatrixGuardBuffer BufferNchwcFilter(NchwcFilterBufferElements, false);
+    MatrixGuardBuffer BufferNchwcBias(NchwcFilterCount, false);
+    MatrixGuardBuffer BufferNchwcOutput(NchwcOutputBufferElements, false);
+
+    const float* Input = BufferInput.GetBuffer(InputBufferElements);
+    const float* Filter = BufferFilter.GetBuffer(FilterBufferElements);
+    const float* Bias = BufferBias.GetBuffer(BiasBufferElements);
+    float* Output = BufferOutput.GetBuffer(OutputBufferElements);
+    float* OutputReference = BufferOutputReference.GetBuffer(OutputBufferElements);
+    float* NchwcInput = BufferNchwcInput.GetBuffer(NchwcInputBufferElements);
+    float* NchwcFilter = BufferNchwcFilter.GetBuffer(NchwcFilterBufferElements);
+    float* NchwcBias = BufferNchwcBias.GetBuffer(NchwcFilterCount);
+    float* NchwcOutput = BufferNchwcOutput.GetBuffer(NchwcOutputBufferElements);
+
+    MlasReorderInput(InputShape, Input, NchwcInput);
+
+    if (GroupCount > 1) {
+        MlasReorderFilterOIHWBo(FilterShape, Filter, NchwcFilter);
+    } else {
+        MlasReorderFilterOIHWBiBo(FilterShape, Filter, NchwcFilter);
+    }
+
+    std::fill_n(NchwcBias, NchwcFilterCount, 0.0f);
+    std::copy_n(Bias, TotalFilterCount, NchwcBias);
+
+    MLAS_ACTIVATION Activation;
+    Activation.ActivationKind = MlasIdentityActivation;
+
+    MlasNchwcConv(NchwcInputShape,
+                  KernelShape,
+                  DilationShape,
+                  Padding,
+                  StrideShape,
+                  NchwcOutputShape,
+                  GroupCount,
+                  NchwcInput,
+                  NchwcFilter,
+                  NchwcBias,
+                  NchwcOutput,
+                  &Activation,
+                  nullptr);
+
+    MlasReorderOutput(OutputShape, NchwcOutput, Output);
+
+    ReferenceConv2D(BatchCount,
+                    GroupCount,
+                    InputChannels,
+                    InputHeight, InputWidth,
+                    FilterCount,
+                    KernelHeight, KernelWidth,
+                    PaddingLeftHeight, PaddingLeftWidth,
+                    DilationHeight, DilationWidth,
+                    StrideHeight, StrideWidth,
+                    OutputHeight, OutputWidth,
+                    Input,
+                    Filter,
+                    Bias,
+                    OutputReference);
+
+    if (memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0) {
+        printf("mismatch: nchwc batch=%zd,group=%zd,input(%zd,%zd,%zd),filter=%zd,kernel(%zd,%zd)!!!\n",
+            BatchCount, GroupCount, InputChannels, InputHeight, InputWidth, FilterCount,
+            KernelHeight, KernelWidth);
+    }
+}
+
+void
+TrialNchwcPool2D(
+    size_t BatchCount,
+    size_t InputChannels,
+    size_t InputHeight,
+    size_t InputWidth,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    size_t PaddingLeftHeight,
+    size_t PaddingLeftWidth,
+    size_t PaddingRightHeight,
+    size_t PaddingRightWidth,
+    size_t StrideHeight,
+    size_t StrideWidth
+    )
+{
+    const size_t BlockSize = MlasNchwcGetBlockSize();
+
+    size_t NchwcChannels = (InputChannels + BlockSize - 1) & ~(BlockSize - 1);
+
+    int64_t InputShape[] = { int64_t(BatchCount), int64_t(InputChannels), int64_t(InputHeight), int64_t(InputWidth) };
+    int64_t KernelShape[] = { int64_t(KernelHeight), int64_t(KernelWidth) };
+    int64_t Padding[] = { int64_t(PaddingLeftHeight), int64_t(PaddingLeftWidth), int64_t(PaddingRightHeight), int64_t(PaddingRightWidth) };
+    int64_t StrideShape[] = { int64_t(StrideHeight), int64_t(StrideWidth) };
+    int64_t OutputShape[] = { int64_t(BatchCount), int64_t(InputChannels), 0, 0 };
+
+    OutputShape[2] = (InputShape[2] + Padding[0] + Padding[2] - KernelShape[0]) / StrideShape[0] + 1;
+    OutputShape[3] = (InputShape[3] + Padding[1] + Padding[3] - KernelShape[1]) / StrideShape[1] + 1;
+
+    int64_t NchwcInputShape[] = { InputShape[0], int64_t(NchwcChannels), InputShape[2], InputShape[3] };
+    int64_t NchwcOutputShape[] = { OutputShape[0], int64_t(NchwcChannels), OutputShape[2], OutputShape[3] };
+
+    size_t InputBufferElements = size_t(InputShape[0] * InputShape[1] * InputShape[2] * InputShape[3]);
+    size_t OutputBufferElements = size_t(OutputShape[0] * OutputShape[1] * OutputShape[2] * OutputShape[3]);
+    size_t NchwcInputBufferElements = size_t(NchwcInputShape[0] * NchwcInputShape[1] * NchwcInputShape[2] * NchwcInputShape[3]);
+    size_t NchwcOutputBufferElements = size_t(NchwcOutputShape[0] * NchwcOutputShape[1] * NchwcOutputShape[2] * NchwcOutputShape[3]);
+
+    MatrixGuardBuffer BufferInput(InputBufferElements, true);
+    MatrixGuardBuffer BufferOutput(OutputBufferElements, false);
+    MatrixGuardBuffer BufferOutputReference(OutputBufferElements, false);
+    MatrixGuardBuffer BufferNchwcInput(NchwcInputBufferElements, false);
+    MatrixGuardBuffer BufferNchwcOutput(NchwcOutputBufferElements, false);
+
+    const float* Input = BufferInput.GetBuffer(InputBufferElements);
+    float* Output = BufferOutput.GetBuffer(OutputBufferElements);
+    float* OutputReference = BufferOutputReference.GetBuffer(OutputBufferElements);
+    float* NchwcInput = BufferNchwcInput.GetBuffer(NchwcInputBufferElements);
+    float* NchwcOutput = BufferNchwcOutput.GetBuffer(NchwcOutputBufferElements);
+
+    MlasReorderInput(InputShape, Input, NchwcInput);
+
+    MlasNchwcPool(MlasMaximumPooling, NchwcInputShape, KernelShape, Padding, StrideShape, NchwcOutputShape, NchwcInput, NchwcOutput, nullptr);
+    MlasReorderOutput(OutputShape, NchwcOutput, Output);
+    ReferenceMaximumPool2D(InputShape, KernelShape, Padding, StrideShape, Input, OutputReference);
+
+    if (memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0) {
+        printf("mismatch: nchwc maximum input(%zd,%zd,%zd),kernel(%zd,%zd)!!!\n",
+            InputChannels, InputHeight, InputWidth, KernelHeight, KernelWidth);
+    }
+
+    MlasNchwcPool(MlasAveragePoolingExcludePad, NchwcInputShape, KernelShape, Padding, StrideShape, NchwcOutputShape, NchwcInput, NchwcOutput, nullptr);
+    MlasReorderOutput(OutputShape, NchwcOutput, Output);
+    ReferenceAveragePool2D(InputShape, KernelShape, Padding, StrideShape, Input, OutputReference, false);
+
+    if (memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0) {
+        printf("mismatch: nchwc averageexcpad input(%zd,%zd,%zd),kernel(%zd,%zd)!!!\n",
+            InputChannels, InputHeight, InputWidth, KernelHeight, KernelWidth);
+    }
+
+    MlasNchwcPool(MlasAveragePoolingIncludePad, NchwcInputShape, KernelShape, Padding, StrideShape, NchwcOutputShape, NchwcInput, NchwcOutput, nullptr);
+    MlasReorderOutput(OutputShape, NchwcOutput, Output);
+    ReferenceAveragePool2D(InputShape, KernelShape, Padding, StrideShape, Input, OutputReference, true);
+
+    if (memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0) {
+        printf("mismatch: nchwc averageincpad input(%zd,%zd,%zd),kernel(%zd,%zd)!!!\n",
+            InputChannels, InputHeight, InputWidth, KernelHeight, KernelWidth);
+    }
+}
+
+void
+ExecuteNchwcTests(
+    void
+    )
+{
+    static const unsigned cs[] = { 3, 8, 20, 32 };
+    static const unsigned is[] = { 17, 11, 5, 1 };
+
+    for (unsigned ic = 0; ic < _countof(cs); ic++) {
+        for (unsigned ih = 0; ih < _countof(is); ih++) {
+            for (unsigned iw = 0; iw < _countof(is); iw++) {
+                fprintf(stderr, "Handling NCHWc %dx%dx%d\n", cs[ic], is[ih], is[iw]);
+                for (unsigned fc = 0; fc < _countof(cs); fc++) {
+                    for (unsigned k = 1; k <= 5; k += 2) {
+                        for (unsigned p = 0; p <= k / 2; p++) {
+                            for (unsigned d = 1; d <= 2; d++) {
+                                for (unsigned s = 1; s <= 2; s++) {
+                                    TrialNchwcConv2D(1, 1, cs[ic], is[ih], is[iw], cs[fc], k, k, p, p, p, p, d, d, s, s);
+                                    TrialNchwcConv2D(2, 1, cs[ic], is[ih], is[iw], cs[fc], k, 1, p, 0, 0, p, d, 1, s, 1);
+                                }
+                            }
+                        }
+                    }
+                }
+                for (unsigned k = 1; k <= 5; k += 2) {
+                    for (unsigned s = 1; s <= 2; s++) {
+                        TrialNchwcConv2D(1, cs[ic], 1, is[ih], is[iw], 1, k, k, k / 2, k / 2, k / 2, k / 2, 1, 1, s, s);
+                        TrialNchwcConv2D(2, cs[ic], 1, is[ih], is[iw], 1, k, k, 0, 1, 1, 0, 2, 2, s, s);
+                        if (k <= is[ih] && k <= is[iw]) {
+                            TrialNchwcPool2D(2, cs[ic], is[ih], is[iw], k, k, k / 2, k / 2, k / 2, k / 2, s, s);
+                            TrialNchwcPool2D(1, cs[ic], is[ih], is[iw], k, k, 0, 0, 0, 0, s, s);
+                        }
+                    }
+                }
+                TrialNchwcPool2D(1, cs[ic], is[ih], is[iw], is[ih], is[iw], 0, 0, 0, 0, 1, 1);
+            }
+        }
+    }
+}
+
 #if 0
 #if defined(_WIN32)
 
@@ -1190,7 +1585,7 @@ EvaluateThreadingPerformance(
                 DWORD start = GetTickCount();
                 DWORD stop;
                 do {
-                    MlasSgemm(CblasNoTrans, CblasNoTrans, M, N, K, 1.0f, A, K, B, N, 0.0f, C, N);
+                    MlasSgemm(CblasNoTrans, CblasNoTrans, M, N, K, 1.0f, A, K, B, N, 0.0f, C, N, nullptr);
                     stop = GetTickCount();
                     NumberIterations++;
                 } while ((stop - start) <= 5000);
@@ -1210,7 +1605,7 @@ EvaluateThreadingPerformance(
 
                     start = GetTickCount();
                     for (size_t iters = 0; iters < NumberIterations; iters++) {
-                        MlasSgemm(CblasNoTrans, CblasNoTrans, M, N, K, 1.0f, A, K, B, N, 0.0f, C, N);
+                        MlasSgemm(CblasNoTrans, CblasNoTrans, M, N, K, 1.0f, A, K, B, N, 0.0f, C, N, nullptr);
                         stop = GetTickCount();
                         if ((stop - start) > 20000) {
                             break;
@@ -1239,7 +1634,9 @@ main(
     )
 {
 //    ExecuteSgemmTests();
+    ExecuteQgemmTests();
     ExecuteConvTests();
+    ExecuteNchwcTests();
 //    ExecutePool2DTests();
 //    ExecutePool3DTests();
 //    EvaluateThreadingPerformance();
@@ -0,0 +1,89 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <benchmark/benchmark.h>
+#include <core/graph/model.h>
+#include <core/framework/allocator.h>
+#include <core/framework/ml_value.h>
+#include <core/framework/tensor.h>
+#include <core/session/inference_session.h>
+#include <core/graph/onnx_protobuf.h>
+#include <sstream>
+
+using namespace onnxruntime;
+
+#define BM_BREAK_IF_ERROR(expr)                                                 \
+  do {                                                                          \
+    auto _status = (expr);                                                      \
+    if ((!_status.IsOK())) state.SkipWithError(_status.ErrorMessage().c_str()); \
+  } while (0)
+
+// Build an inception-style fan-out graph: X feeds 'width' independent chains of 'depth' small element-wise
+// nodes whose results are combined by a single Sum node.
+static std::string CreateFanOutModel(int64_t width, int64_t depth, int64_t num_elements) {
+  Model model("fan_out");
+  auto& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(num_elements);
+
+  auto& input_arg = graph.GetOrCreateNodeArg("X", &float_tensor);
+  std::vector<NodeArg*> branch_outputs;
+  for (int64_t b = 0; b < width; ++b) {
+    NodeArg* prev = &input_arg;
+    for (int64_t d = 0; d < depth; ++d) {
+      std::string name = "b" + std::to_string(b) + "_d" + std::to_string(d);
+      auto& out = graph.GetOrCreateNodeArg(name, &float_tensor);
+      graph.AddNode(name, (d % 2 == 0) ? "Relu" : "Sigmoid", "", {prev}, {&out});
+      prev = &out;
+    }
+    branch_outputs.push_back(prev);
+  }
+
+  auto& output_arg = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  graph.AddNode("sum", "Sum", "", branch_outputs, {&output_arg});
+
+  if (!graph.Resolve().IsOK()) throw std::runtime_error("resolve fan out graph failed");
+  return model.ToProto().SerializeAsString();
+}
+
+static void BM_FanOutGraph(benchmark::State& state, bool sequential) {
+  const int64_t width = state.range(0);
+  const int64_t num_elements = state.range(1);
+  std::istringstream model_stream(CreateFanOutModel(width, 4, num_elements));
+
+  SessionOptions so;
+  so.enable_sequential_execution = sequential;
+  InferenceSession session{so};
+  BM_BREAK_IF_ERROR(session.Load(model_stream));
+  BM_BREAK_IF_ERROR(session.Initialize());
+
+  auto allocator = std::make_shared<CPUAllocator>();
+  std::vector<float> input_data(num_elements, 0.5f);
+  std::unique_ptr<Tensor> input = std::make_unique<Tensor>(DataTypeImpl::GetType<float>(),
+                                                           TensorShape({num_elements}),
+                                                           input_data.data(), allocator->Info());
+  MLValue input_value;
+  input_value.Init(input.release(), DataTypeImpl::GetType<Tensor>(),
+                   DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+  NameMLValMap feeds{{"X", input_value}};
+  std::vector<std::string> output_names{"Y"};
+
+  for (auto _ : state) {
+    std::vector<MLValue> fetches;
+    BM_BREAK_IF_ERROR(session.Run(feeds, output_names, &fetches));
+  }
+}
+
+static void BM_FanOutGraph_Sequential(benchmark::State& state) {
+  BM_FanOutGraph(state, true);
+}
+
+static void BM_FanOutGraph_Parallel(benchmark::State& state) {
+  BM_FanOutGraph(state, false);
+}
+
+// {width, elements per tensor}
+BENCHMARK(BM_FanOutGraph_Sequential)->Args({8, 256})->Args({32, 256})->Args({32, 16384})->UseRealTime();
+BENCHMARK(BM_FanOutGraph_Parallel)->Args({8, 256})->Args({32, 256})->Args({32, 16384})->UseRealTime();
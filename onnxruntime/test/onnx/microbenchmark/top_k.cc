@@ -0,0 +1,99 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <benchmark/benchmark.h>
+#include <core/graph/model.h>
+#include <core/framework/allocator.h>
+#include <core/framework/ml_value.h>
+#include <core/framework/tensor.h>
+#include <core/session/inference_session.h>
+#include <core/graph/onnx_protobuf.h>
+#include <random>
+#include <sstream>
+
+using namespace onnxruntime;
+
+#define BM_BREAK_IF_ERROR(expr)                                                 \
+  do {                                                                          \
+    auto _status = (expr);                                                      \
+    if ((!_status.IsOK())) state.SkipWithError(_status.ErrorMessage().c_str()); \
+  } while (0)
+
+// Build a graph with a single TopK over the last axis of a [rows, width] input, with K as a second input.
+static std::string CreateTopKModel(int64_t rows, int64_t width) {
+  Model model("top_k");
+  auto& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(rows);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(width);
+
+  ONNX_NAMESPACE::TypeProto k_tensor;
+  k_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_INT64);
+  k_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+  ONNX_NAMESPACE::TypeProto values_tensor;
+  values_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  ONNX_NAMESPACE::TypeProto indices_tensor;
+  indices_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_INT64);
+
+  auto& input_arg = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& k_arg = graph.GetOrCreateNodeArg("K", &k_tensor);
+  auto& values_arg = graph.GetOrCreateNodeArg("Values", &values_tensor);
+  auto& indices_arg = graph.GetOrCreateNodeArg("Indices", &indices_tensor);
+  graph.AddNode("top_k", "TopK", "", {&input_arg, &k_arg}, {&values_arg, &indices_arg});
+
+  if (!graph.Resolve().IsOK()) throw std::runtime_error("resolve top k graph failed");
+  return model.ToProto().SerializeAsString();
+}
+
+template <typename T>
+static MLValue CreateInput(std::vector<T>& data, const std::vector<int64_t>& dims,
+                           const std::shared_ptr<IAllocator>& allocator) {
+  std::unique_ptr<Tensor> tensor = std::make_unique<Tensor>(DataTypeImpl::GetType<T>(), TensorShape(dims),
+                                                            data.data(), allocator->Info());
+  MLValue value;
+  value.Init(tensor.release(), DataTypeImpl::GetType<Tensor>(), DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+  return value;
+}
+
+static void BM_TopK(benchmark::State& state) {
+  const int64_t rows = state.range(0);
+  const int64_t width = state.range(1);
+  std::vector<int64_t> k{state.range(2)};
+  std::istringstream model_stream(CreateTopKModel(rows, width));
+
+  SessionOptions so;
+  InferenceSession session{so};
+  BM_BREAK_IF_ERROR(session.Load(model_stream));
+  BM_BREAK_IF_ERROR(session.Initialize());
+
+  std::vector<float> input_data(rows * width);
+  std::mt19937 generator(0);
+  std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+  for (auto& value : input_data) {
+    value = distribution(generator);
+  }
+
+  auto allocator = std::make_shared<CPUAllocator>();
+  NameMLValMap feeds{{"X", CreateInput(input_data, {rows, width}, allocator)},
+                     {"K", CreateInput(k, {1}, allocator)}};
+  std::vector<std::string> output_names{"Values", "Indices"};
+
+  for (auto _ : state) {
+    std::vector<MLValue> fetches;
+    BM_BREAK_IF_ERROR(session.Run(feeds, output_names, &fetches));
+  }
+  state.SetItemsProcessed(state.iterations() * rows * width);
+}
+
+// {rows, width, k}
+BENCHMARK(BM_TopK)
+    ->Args({1, 1000000, 10})
+    ->Args({1, 1000000, 1000})
+    ->Args({64, 1000000, 10})
+    ->Args({64, 1000000, 100})
+    ->Args({1024, 1000, 5})
+    ->Args({1024, 1000, 50})
+    ->UseRealTime();
@@ -15,6 +15,7 @@
 #include "core/optimizer/conv_activation_fusion.h"
 #include "core/optimizer/matmul_add_fusion.h"
 #include "core/optimizer/gemm_activation_fusion.h"
+#include "core/optimizer/nchwc_transformer.h"
 #include "core/framework/data_types.h"
 #include "core/framework/ml_value.h"
 #include "core/util/math.h"
@@ -361,5 +362,129 @@ TEST(GraphTransformationTests, FuseConvBnAddMulFloat16) {
   ASSERT_EQ(expected_values_prod, found);
 }
 
+// X -> Conv -> Relu -> depthwise Conv -> Add (with the Relu output) -> MaxPool -> Y
+static void CreateNchwcConvModel(std::string& serialized_model) {
+  Model model("NchwcConvModel");
+  auto& graph = model.MainGraph();
+
+  auto add_initializer = [&graph](const std::string& name, const std::vector<int64_t>& dims) -> NodeArg& {
+    ONNX_NAMESPACE::TensorProto tensor_proto;
+    int64_t size = 1;
+    for (auto dim : dims) {
+      tensor_proto.add_dims(dim);
+      size *= dim;
+    }
+    tensor_proto.set_data_type(TensorProto_DataType_FLOAT);
+    for (int64_t i = 0; i < size; i++) {
+      tensor_proto.add_float_data(static_cast<float>((i * 7) % 13 - 6) * 0.0625f);
+    }
+    tensor_proto.set_name(name);
+    graph.AddInitializedTensor(tensor_proto);
+
+    TypeProto tensor_type;
+    tensor_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    for (auto dim : dims) {
+      tensor_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+    }
+    return graph.GetOrCreateNodeArg(name, &tensor_type);
+  };
+
+  TypeProto input_type;
+  input_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  for (int64_t dim : {1, 16, 8, 8}) {
+    input_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+  }
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+
+  auto& x = graph.GetOrCreateNodeArg("X", &input_type);
+  auto& w1 = add_initializer("W1", {24, 16, 3, 3});
+  auto& b1 = add_initializer("B1", {24});
+  auto& w2 = add_initializer("W2", {24, 1, 3, 3});
+  auto& conv1 = graph.GetOrCreateNodeArg("conv1", &float_tensor);
+  auto& relu = graph.GetOrCreateNodeArg("relu", &float_tensor);
+  auto& conv2 = graph.GetOrCreateNodeArg("conv2", &float_tensor);
+  auto& add = graph.GetOrCreateNodeArg("add", &float_tensor);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_tensor);
+
+  graph.AddNode("conv1", "Conv", "", {&x, &w1, &b1}, {&conv1}).AddAttribute("pads", std::vector<int64_t>{1, 1, 1, 1});
+  graph.AddNode("relu", "Relu", "", {&conv1}, {&relu});
+  auto& conv2_node = graph.AddNode("conv2", "Conv", "", {&relu, &w2}, {&conv2});
+  conv2_node.AddAttribute("pads", std::vector<int64_t>{1, 1, 1, 1});
+  conv2_node.AddAttribute("group", int64_t{24});
+  graph.AddNode("add", "Add", "", {&conv2, &relu}, {&add});
+  auto& pool_node = graph.AddNode("pool", "MaxPool", "", {&add}, {&y});
+  pool_node.AddAttribute("kernel_shape", std::vector<int64_t>{2, 2});
+  pool_node.AddAttribute("strides", std::vector<int64_t>{2, 2});
+
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  ASSERT_TRUE(model.ToProto().SerializeToString(&serialized_model));
+}
+
+static void RunNchwcConvModel(const std::string& serialized_model, TransformerLevel level, std::vector<float>& output) {
+  SessionOptions so;
+  so.session_logid = "GraphTransformationTests.NchwcTransformer";
+  so.graph_optimization_level = level;
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  std::istringstream model_istream(serialized_model);
+  ASSERT_TRUE(session_object.Load(model_istream).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  std::vector<float> values_x(16 * 8 * 8);
+  for (size_t i = 0; i < values_x.size(); i++) {
+    values_x[i] = static_cast<float>(static_cast<int>(i % 11) - 5) * 0.25f;
+  }
+  MLValue ml_value_x;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {1, 16, 8, 8}, values_x, &ml_value_x);
+  NameMLValMap feeds;
+  feeds.insert(std::make_pair("X", ml_value_x));
+
+  std::vector<MLValue> fetches;
+  ASSERT_TRUE(session_object.Run(RunOptions(), feeds, {"Y"}, &fetches).IsOK());
+
+  auto& rtensor = fetches.front().Get<Tensor>();
+  ASSERT_EQ(TensorShape({1, 24, 4, 4}), rtensor.Shape());
+  output.assign(rtensor.template Data<float>(), rtensor.template Data<float>() + rtensor.Shape().Size());
+}
+
+TEST(GraphTransformationTests, NchwcTransformer) {
+  std::string serialized_model;
+  CreateNchwcConvModel(serialized_model);
+
+  ONNX_NAMESPACE::ModelProto model_proto;
+  ASSERT_TRUE(model_proto.ParseFromString(serialized_model));
+  Model model(model_proto);
+  Graph& graph = model.MainGraph();
+  ASSERT_TRUE(graph.Resolve().IsOK());
+  for (auto& node : graph.Nodes()) {
+    node.SetExecutionProviderType(kCpuExecutionProvider);
+  }
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(std::make_unique<NchwcTransformer>(), TransformerLevel::Level3,
+                                    {kCpuExecutionProvider});
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level3).IsOK());
+
+  // the Relu is fused into the first convolution and only the graph input and output are reordered
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["ReorderInput"], 1);
+  ASSERT_EQ(op_to_count["ReorderOutput"], 1);
+  ASSERT_EQ(op_to_count["Conv"], 2);
+  ASSERT_EQ(op_to_count["Relu"], 0);
+  ASSERT_EQ(op_to_count["Add"], 1);
+  ASSERT_EQ(op_to_count["MaxPool"], 1);
+
+  std::vector<float> expected_output;
+  RunNchwcConvModel(serialized_model, TransformerLevel::Level2, expected_output);
+  std::vector<float> output;
+  RunNchwcConvModel(serialized_model, TransformerLevel::Level3, output);
+
+  ASSERT_EQ(expected_output.size(), output.size());
+  for (size_t i = 0; i < output.size(); i++) {
+    EXPECT_NEAR(expected_output[i], output[i], 1e-4f) << "index " << i;
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
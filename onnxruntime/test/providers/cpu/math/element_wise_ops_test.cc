@@ -156,6 +156,43 @@ TEST(MathOpTest, Add_Broadcast_2x1x1_3x4) {
   test.Run();
 }
 
+TEST(MathOpTest, Add_Broadcast_Large) {
+  // large enough for the output to be split across the intra-op thread pool, with the split points falling
+  // inside the broadcast spans
+  const int64_t N = 33, C = 65, W = 97;
+  std::vector<float> a(N * C * W), b(C), expected(N * C * W);
+  for (size_t i = 0; i < a.size(); ++i)
+    a[i] = static_cast<float>(i % 101);
+  for (int64_t c = 0; c < C; ++c)
+    b[c] = static_cast<float>(1000 * c);
+  for (int64_t n = 0; n < N; ++n)
+    for (int64_t c = 0; c < C; ++c)
+      for (int64_t w = 0; w < W; ++w)
+        expected[(n * C + c) * W + w] = a[(n * C + c) * W + w] + b[c];
+
+  OpTester test("Add");
+  test.AddInput<float>("A", {N, C, W}, a);
+  test.AddInput<float>("B", {C, 1}, b);
+  test.AddOutput<float>("C", {N, C, W}, expected);
+  test.Run();
+}
+
+TEST(MathOpTest, Mul_Large) {
+  const int64_t size = 123457;
+  std::vector<float> a(size), b(size), expected(size);
+  for (int64_t i = 0; i < size; ++i) {
+    a[i] = static_cast<float>(i % 7);
+    b[i] = static_cast<float>(i % 11);
+    expected[i] = a[i] * b[i];
+  }
+
+  OpTester test("Mul");
+  test.AddInput<float>("A", {size}, a);
+  test.AddInput<float>("B", {size}, b);
+  test.AddOutput<float>("C", {size}, expected);
+  test.Run();
+}
+
 TEST(MathOpTest, Sub_int32) {
   OpTester test("Sub");
   test.AddInput<int32_t>("A", {3}, {1, 4, 3});
@@ -100,6 +100,30 @@ TEST(GemmOpTest, GemmTrans) {
   test.Run();
 }
 
+// a constant B is pre-packed by the CPU kernel
+TEST(GemmOpTest, GemmTransBConstant) {
+  OpTester test("Gemm");
+
+  test.AddAttribute("transA", (int64_t)0);
+  test.AddAttribute("transB", (int64_t)1);
+  test.AddAttribute("alpha", 1.0f);
+  test.AddAttribute("beta", 1.0f);
+
+  test.AddInput<float>("A", {2, 4},
+                       {1.0f, 2.0f, 3.0f, 4.0f,
+                        -1.0f, -2.0f, -3.0f, -4.0f});
+  test.AddInput<float>("B", {3, 4},
+                       {1.0f, 0.0f, 0.0f, 1.0f,
+                        0.0f, 1.0f, 1.0f, 0.0f,
+                        2.0f, 2.0f, 2.0f, 2.0f},
+                       true);
+  test.AddInput<float>("C", {3}, {1.0f, 2.0f, 3.0f});
+  test.AddOutput<float>("Y", {2, 3},
+                        {6.0f, 7.0f, 23.0f,
+                         -4.0f, -3.0f, -17.0f});
+  test.Run();
+}
+
 TEST(GemmOpTest, GemmAlphaBeta) {
   OpTester test("Gemm");
 
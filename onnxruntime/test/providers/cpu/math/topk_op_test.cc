@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <numeric>
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
@@ -267,5 +269,51 @@ TEST(TopKOperator, InvalidKOpset10) {
           "value of k should be greater than 0");
 }
 
+// Runs TopK over each row of a 2-D input, computing the expected outputs with a stable sort so that ties are
+// ordered by the lower index.
+static void RunSortedReferenceTest(int64_t k, const std::vector<float>& input_vals, int64_t rows) {
+  const int64_t cols = static_cast<int64_t>(input_vals.size()) / rows;
+  std::vector<float> expected_vals;
+  std::vector<int64_t> expected_indices;
+  for (int64_t i = 0; i < rows; ++i) {
+    std::vector<int64_t> order(cols);
+    std::iota(order.begin(), order.end(), int64_t{0});
+    const float* row = input_vals.data() + i * cols;
+    std::stable_sort(order.begin(), order.end(), [row](int64_t lhs, int64_t rhs) { return row[lhs] > row[rhs]; });
+    for (int64_t l = 0; l < k; ++l) {
+      expected_vals.push_back(row[order[l]]);
+      expected_indices.push_back(order[l]);
+    }
+  }
+  RunTest(10, k, input_vals, {rows, cols}, expected_vals, expected_indices, {rows, k});
+}
+
+TEST(TopKOperator, TopLargeKWithTiesOpset10) {
+  std::vector<float> input_vals(3 * 200);
+  for (size_t i = 0; i < input_vals.size(); ++i) {
+    input_vals[i] = static_cast<float>((i * 37) % 11);
+  }
+  RunSortedReferenceTest(50, input_vals, 3);
+}
+
+TEST(TopKOperator, TopKWideRowOpset10) {
+  std::vector<float> input_vals(2 * 100000);
+  for (size_t i = 0; i < input_vals.size(); ++i) {
+    input_vals[i] = static_cast<float>((i * 7919) % 100003) * 0.5f;
+  }
+  RunSortedReferenceTest(5, input_vals, 2);
+  RunSortedReferenceTest(100, input_vals, 2);
+}
+
+TEST(TopKOperator, EmptyTrailingDimOpset10) {
+  std::vector<float> input_vals = {};
+  std::vector<int64_t> input_dimensions = {2, 5, 0};
+  std::vector<float> expected_vals = {};
+  std::vector<int64_t> expected_indices = {};
+  std::vector<int64_t> expected_dimensions = {2, 1, 0};
+  int64_t axis = 1;
+  RunTest(10, 1, input_vals, input_dimensions, expected_vals, expected_indices, expected_dimensions, axis);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
\ No newline at end of file
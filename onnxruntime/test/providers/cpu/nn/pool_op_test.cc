@@ -207,6 +207,36 @@ TEST(PoolTest, MaxPool1D_8_With_Index) {
   MaxPool1D_8_WithIndexTest(1 /*storage_order*/);
 }
 
+static void MaxPool_8_WithIndexPadsTest(int64_t storage_order) {
+  OpTester test("MaxPool", 8);
+
+  test.AddAttribute("auto_pad", "");
+  test.AddAttribute("strides", std::vector<int64_t>{2, 2});
+  test.AddAttribute("pads", vector<int64_t>{1, 1, 1, 1});
+  test.AddAttribute("kernel_shape", vector<int64_t>{3, 3});
+  test.AddAttribute("storage_order", storage_order);
+
+  std::vector<float> x_vals = {1, 5, 2, 0,
+                               3, 6, 4, 8,
+                               7, 6, 9, 1,
+                               2, 0, 3, 4};
+  std::vector<int64_t> x_dims = {1, 1, 4, 4};
+  std::vector<int64_t> expected_dims = {1, 1, 2, 2};
+  std::vector<float> expected_vals = {6, 8, 7, 9};
+  std::vector<int64_t> expected_indices_row = {5, 7, 8, 10};
+  std::vector<int64_t> expected_indices_col = {5, 13, 2, 10};
+
+  test.AddInput<float>("X", x_dims, x_vals);
+  test.AddOutput<float>("Y", expected_dims, expected_vals);
+  test.AddOutput<int64_t>("Indices", expected_dims, storage_order == 0 ? expected_indices_row : expected_indices_col);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kMklDnnExecutionProvider});
+}
+
+TEST(PoolTest, MaxPool_8_With_Index_Pads) {
+  MaxPool_8_WithIndexPadsTest(0 /*storage_order*/);
+  MaxPool_8_WithIndexPadsTest(1 /*storage_order*/);
+}
+
 TEST(PoolTest, GlobalMaxPool) {
   OpTester test("GlobalMaxPool");
 
@@ -847,6 +877,20 @@ TEST(PoolTest, LpPool) {
   test.Run();
 }
 
+TEST(PoolTest, LpPool1D_Pads) {
+  OpTester test("LpPool");
+
+  test.AddAttribute("auto_pad", "");
+  test.AddAttribute("strides", std::vector<int64_t>{1});
+  test.AddAttribute("pads", vector<int64_t>{1, 0});
+  test.AddAttribute("kernel_shape", vector<int64_t>{2});
+  test.AddAttribute("p", static_cast<int64_t>(2));
+
+  test.AddInput<float>("X", {1, 1, 4}, {1, 2, 3, -4});
+  test.AddOutput<float>("Y", {1, 1, 4}, {1.0f, std::sqrt(5.0f), std::sqrt(13.0f), 5.0f});
+  test.Run();
+}
+
 TEST(PoolTest, GlobalLpPool) {
   OpTester test("GlobalLpPool");
   test.AddAttribute("p", static_cast<int64_t>(3));
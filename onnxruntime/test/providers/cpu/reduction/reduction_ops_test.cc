@@ -696,6 +696,51 @@ TEST(ReductionOpTest, ReduceSum_axes02) {
   test.Run();
 }
 
+TEST(ReductionOpTest, ReduceSum_interleaved_axes_large) {
+  // large enough for the reduction to be split across the intra-op thread pool
+  const std::vector<int64_t> dims{8, 64, 16, 32};
+  std::vector<float> data(8 * 64 * 16 * 32);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<float>(i % 13);
+  }
+
+  std::vector<float> expected(8 * 16, 0.0f);
+  for (int64_t a = 0; a < 8; ++a)
+    for (int64_t b = 0; b < 64; ++b)
+      for (int64_t c = 0; c < 16; ++c)
+        for (int64_t d = 0; d < 32; ++d)
+          expected[a * 16 + c] += data[((a * 64 + b) * 16 + c) * 32 + d];
+
+  OpTester test("ReduceSum");
+  test.AddAttribute("axes", std::vector<int64_t>{1, 3});
+  test.AddAttribute("keepdims", (int64_t)1);
+  test.AddInput<float>("data", dims, data);
+  test.AddOutput<float>("reduced", {8, 1, 16, 1}, expected);
+  test.Run();
+}
+
+TEST(ReductionOpTest, ReduceMean_leading_axis_large) {
+  const std::vector<int64_t> dims{256, 3, 128};
+  std::vector<float> data(256 * 3 * 128);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<float>(i % 17);
+  }
+
+  std::vector<float> expected(3 * 128, 0.0f);
+  for (int64_t a = 0; a < 256; ++a)
+    for (int64_t i = 0; i < 3 * 128; ++i)
+      expected[i] += data[a * 3 * 128 + i];
+  for (auto& v : expected)
+    v /= 256.0f;
+
+  OpTester test("ReduceMean");
+  test.AddAttribute("axes", std::vector<int64_t>{0});
+  test.AddAttribute("keepdims", (int64_t)0);
+  test.AddInput<float>("data", dims, data);
+  test.AddOutput<float>("reduced", {3, 128}, expected);
+  test.Run();
+}
+
 TEST(ReductionOpTest, ReduceSum_int32) {
   OpTester test("ReduceSum");
   test.AddAttribute("axes", std::vector<int64_t>{0, 2});
@@ -1036,6 +1081,28 @@ TEST(ReductionOpTest, ArgMax2D) {
   test.Run();
 }
 
+TEST(ReductionOpTest, ArgMax_middle_axis_large) {
+  const std::vector<int64_t> dims{16, 100, 40};
+  std::vector<float> data(16 * 100 * 40);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<float>((i * 7919) % 1009);
+  }
+
+  std::vector<int64_t> expected(16 * 40, 0);
+  for (int64_t a = 0; a < 16; ++a)
+    for (int64_t c = 0; c < 40; ++c)
+      for (int64_t b = 1; b < 100; ++b)
+        if (data[(a * 100 + b) * 40 + c] > data[(a * 100 + expected[a * 40 + c]) * 40 + c])
+          expected[a * 40 + c] = b;
+
+  OpTester test("ArgMax");
+  test.AddAttribute("axis", (int64_t)1);
+  test.AddAttribute("keepdims", (int64_t)0);
+  test.AddInput<float>("data", dims, data);
+  test.AddOutput<int64_t>("reduced", {16, 40}, expected);
+  test.Run();
+}
+
 TEST(ReductionOpTest, ArgMin) {
   OpTester test("ArgMin");
   test.AddAttribute("axis", (int64_t)0);
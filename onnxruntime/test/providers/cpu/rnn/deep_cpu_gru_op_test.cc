@@ -31,10 +31,12 @@ static void RunGruTest(const std::vector<float>& X_data,
                        // copy the following vectors as we may modify them
                        std::vector<string> activations = {"sigmoid", "tanh"},
                        std::vector<float> activation_alphas = {},
-                       std::vector<float> activation_betas = {}) {
+                       std::vector<float> activation_betas = {},
+                       int intra_op_num_threads = 0) {
   OpTester test("GRU");
 
   test.AddShapeToTensorData();
+  test.SetIntraOpNumThreads(intra_op_num_threads);
 
   int num_directions = (direction == "bidirectional") ? 2 : 1;
 
@@ -321,7 +323,8 @@ class DeepCpuGruOpTestContext {
                const std::vector<int>& sequence_length,
                const std::vector<float>* initial_h,
                const std::vector<float>& expected_Y,
-               const std::vector<float>& expected_Y_h);
+               const std::vector<float>& expected_Y_h,
+               int intra_op_num_threads = 0);
 
  private:
   const int input_size_;
@@ -456,7 +459,8 @@ void DeepCpuGruOpTestContext::RunTest(const std::vector<float>& X,
                                       const std::vector<int>& sequence_lens,
                                       const std::vector<float>* initial_h,
                                       const std::vector<float>& expected_Y,
-                                      const std::vector<float>& expected_Y_h) {
+                                      const std::vector<float>& expected_Y_h,
+                                      int intra_op_num_threads) {
   // run with and without output_sequence
   ::onnxruntime::test::RunGruTest(X, gru_input_weights_, gru_recurrent_weights_,
                                   expected_Y, expected_Y_h,
@@ -470,7 +474,8 @@ void DeepCpuGruOpTestContext::RunTest(const std::vector<float>& X,
                                   false,
                                   activation_func_names_,
                                   alphas_,
-                                  betas_);
+                                  betas_,
+                                  intra_op_num_threads);
 
   ::onnxruntime::test::RunGruTest(X, gru_input_weights_, gru_recurrent_weights_,
                                   expected_Y, expected_Y_h,
@@ -484,7 +489,8 @@ void DeepCpuGruOpTestContext::RunTest(const std::vector<float>& X,
                                   false,
                                   activation_func_names_,
                                   alphas_,
-                                  betas_);
+                                  betas_,
+                                  intra_op_num_threads);
 }
 
 TEST(GRUTest, ONNXRuntime_TestGRUOpForwardBasic) {
@@ -682,6 +688,40 @@ TEST(GRUTest, ONNXRuntime_TestGRUOpSingleBatchMultipleHiddenThreads) {
   ctx.RunTest(X, batch_size, seq_length, sequence_length, &initial_h, expected_Y, expected_Y_h);
 }
 
+// the directions of a bidirectional GRU run concurrently when there is a thread pool
+TEST(GRUTest, ONNXRuntime_TestGRUOpBidirectionalMultipleHiddenThreads) {
+  const std::string direction = "bidirectional";
+  const std::vector<std::string> activations = {"sigmoid", "tanh", "sigmoid", "tanh"};
+
+  DeepCpuGruOpTestContext ctx(direction, activations, true, {}, {}, /*large_hidden*/ true);
+
+  const int batch_size = 1;
+  const int seq_length = 1;
+  std::vector<float> X = {0.1f, -0.2f};
+  std::vector<int> sequence_length = {1};
+  std::vector<float> initial_h(2 * 32, 0.5f);
+
+  // both directions have the same weights, and with a single step they see the same input
+  std::vector<float> expected_Y_direction =
+      {
+          0.40203814648622f, 0.416614999456787f, 0.426893838272102f, 0.438425099258723f,
+          0.449074949310697f, 0.405161353080481f, 0.41381287883561f, 0.428113160854675f,
+          0.438710576166608f, 0.449253502147958f, 0.402300128581669f, 0.417112500336769f,
+          0.425382986540999f, 0.439390099095881f, 0.450276939756071f, 0.404653232879823f,
+          0.414327989766397f, 0.428845403314675f, 0.436736277602997f, 0.45043439079097f,
+          0.402560202956173f, 0.416113639384501f, 0.426141512516655f, 0.44034669402871f,
+          0.447861672303443f, 0.40490822137737f, 0.414839135658386f, 0.42737488368901f,
+          0.437727744598091f, 0.451604294166264f, 0.40203814648622f, 0.416614999456787f};
+  std::vector<float> expected_Y(expected_Y_direction);
+  expected_Y.insert(expected_Y.end(), expected_Y_direction.cbegin(), expected_Y_direction.cend());
+  std::vector<float> expected_Y_h(expected_Y);
+
+  for (int intra_op_num_threads : {1, 4}) {
+    ctx.RunTest(X, batch_size, seq_length, sequence_length, &initial_h, expected_Y, expected_Y_h,
+                intra_op_num_threads);
+  }
+}
+
 TEST(GRUTest, ONNXRuntime_TestGRUPositiveActivationClipping) {
   const std::string direction = "forward";
   const std::vector<std::string> activations = {"sigmoid", "tanh"};
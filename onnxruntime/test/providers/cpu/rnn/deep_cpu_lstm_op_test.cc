@@ -3,6 +3,8 @@
 
 #include "gtest/gtest.h"
 
+#include <algorithm>
+#include <cmath>
 #include <iterator>
 #include <vector>
 
@@ -45,8 +47,10 @@ static void RunLstmTest(const std::vector<float>& X_data,
                         // copy the following vectors as we may modify them
                         std::vector<string> activations = {},
                         std::vector<float> activation_alphas = {},
-                        std::vector<float> activation_betas = {}) {
+                        std::vector<float> activation_betas = {},
+                        int intra_op_num_threads = 0) {
   OpTester test("LSTM");
+  test.SetIntraOpNumThreads(intra_op_num_threads);
 
   int num_directions = (direction == "bidirectional") ? 2 : 1;
 
@@ -471,6 +475,120 @@ TEST(LSTMTest, LargeBatchWithClip) {
   LargeBatchWithClip(Y_h_data, 4.f);
 }
 
+// Reference LSTM with the default activations. X is [seq_length, batch_size, input_size], the other inputs use the
+// layout of the LSTM inputs, and Y, Y_h and Y_c are returned in the layout of the LSTM outputs.
+static void ComputeReferenceLstm(const std::vector<float>& X, const std::vector<float>& W,
+                                 const std::vector<float>& R, const std::vector<float>& B,
+                                 const std::vector<float>* P,
+                                 int seq_length, int batch_size, int input_size, int hidden_size,
+                                 int num_directions, float clip, bool input_forget,
+                                 std::vector<float>& Y, std::vector<float>& Y_h, std::vector<float>& Y_c) {
+  auto sigmoid = [](double x) { return 1.0 / (1.0 + std::exp(-x)); };
+  auto clip_value = [clip](double x) { return std::min(std::max(x, -double{clip}), double{clip}); };
+
+  Y.assign(seq_length * num_directions * batch_size * hidden_size, 0.f);
+  Y_h.assign(num_directions * batch_size * hidden_size, 0.f);
+  Y_c.assign(num_directions * batch_size * hidden_size, 0.f);
+
+  for (int d = 0; d < num_directions; d++) {
+    const float* W_d = W.data() + d * 4 * hidden_size * input_size;
+    const float* R_d = R.data() + d * 4 * hidden_size * hidden_size;
+    const float* B_d = B.data() + d * 8 * hidden_size;
+    const float* P_d = P ? P->data() + d * 3 * hidden_size : nullptr;
+
+    for (int b = 0; b < batch_size; b++) {
+      std::vector<double> H(hidden_size, 0.0), C(hidden_size, 0.0), gates(4 * hidden_size);
+
+      for (int step = 0; step < seq_length; step++) {
+        const int t = d == 0 ? step : seq_length - 1 - step;
+        const float* x = X.data() + (t * batch_size + b) * input_size;
+
+        // gates in IOFC order
+        for (int g = 0; g < 4 * hidden_size; g++) {
+          double sum = B_d[g] + B_d[4 * hidden_size + g];
+          for (int k = 0; k < input_size; k++) sum += W_d[g * input_size + k] * x[k];
+          for (int k = 0; k < hidden_size; k++) sum += R_d[g * hidden_size + k] * H[k];
+          gates[g] = sum;
+        }
+
+        for (int h = 0; h < hidden_size; h++) {
+          const double i = sigmoid(clip_value(gates[h] + (P_d ? P_d[h] * C[h] : 0.0)));
+          const double f = input_forget ? 1.0 - i
+                                        : sigmoid(clip_value(gates[2 * hidden_size + h] +
+                                                             (P_d ? P_d[2 * hidden_size + h] * C[h] : 0.0)));
+          const double c = std::tanh(clip_value(gates[3 * hidden_size + h]));
+          C[h] = f * C[h] + i * c;
+          const double o = sigmoid(clip_value(gates[hidden_size + h] + (P_d ? P_d[hidden_size + h] * C[h] : 0.0)));
+          H[h] = o * std::tanh(C[h]);
+          Y[((t * num_directions + d) * batch_size + b) * hidden_size + h] = static_cast<float>(H[h]);
+        }
+      }
+
+      for (int h = 0; h < hidden_size; h++) {
+        Y_h[(d * batch_size + b) * hidden_size + h] = static_cast<float>(H[h]);
+        Y_c[(d * batch_size + b) * hidden_size + h] = static_cast<float>(C[h]);
+      }
+    }
+  }
+}
+
+// Without peepholes the gates are computed over the whole fused gate buffer, with them gate by gate. Zero peephole
+// weights take the gate by gate path but must produce the same result, so check both paths against a reference, with
+// a hidden size that isn't a multiple of the vector width of the activations, and with and without a thread pool
+// that runs the directions of a bidirectional LSTM concurrently.
+TEST(LSTMTest, FusedAndUnfusedGateComputations) {
+  const int seq_length = 3, batch_size = 3, input_size = 5, hidden_size = 17;
+
+  // deterministic values in [-0.5, 0.5)
+  auto generate = [](size_t count, unsigned seed) {
+    std::vector<float> values(count);
+    for (auto& value : values) {
+      seed = seed * 1103515245u + 12345u;
+      value = static_cast<float>((seed >> 16) & 0x7fff) / 32768.f - 0.5f;
+    }
+    return values;
+  };
+
+  for (const std::string direction : {"forward", "reverse", "bidirectional"}) {
+    const int num_directions = direction == "bidirectional" ? 2 : 1;
+
+    const std::vector<float> X = generate(seq_length * batch_size * input_size, 1);
+    const std::vector<float> W = generate(num_directions * 4 * hidden_size * input_size, 2);
+    const std::vector<float> R = generate(num_directions * 4 * hidden_size * hidden_size, 3);
+    const std::vector<float> B = generate(num_directions * 8 * hidden_size, 4);
+    const std::vector<float> zero_P(num_directions * 3 * hidden_size, 0.f);
+    const std::vector<float> P = generate(num_directions * 3 * hidden_size, 5);
+
+    for (bool input_forget : {false, true}) {
+      for (float clip : {9999.f, 0.25f}) {
+        std::vector<float> Y, Y_h, Y_c;
+        ComputeReferenceLstm(X, W, R, B, nullptr, seq_length, batch_size, input_size, hidden_size,
+                             num_directions, clip, input_forget, Y, Y_h, Y_c);
+
+        std::vector<float> peephole_Y, peephole_Y_h, peephole_Y_c;
+        ComputeReferenceLstm(X, W, R, B, &P, seq_length, batch_size, input_size, hidden_size,
+                             num_directions, clip, input_forget, peephole_Y, peephole_Y_h, peephole_Y_c);
+
+        for (int intra_op_num_threads : {1, 4}) {
+          // fused
+          RunLstmTest(X, W, R, Y, Y_h, Y_c, input_size, batch_size, hidden_size, seq_length,
+                      &B, nullptr, nullptr, nullptr, nullptr, direction, clip, true, input_forget,
+                      {}, {}, {}, intra_op_num_threads);
+
+          // gate by gate
+          RunLstmTest(X, W, R, Y, Y_h, Y_c, input_size, batch_size, hidden_size, seq_length,
+                      &B, &zero_P, nullptr, nullptr, nullptr, direction, clip, true, input_forget,
+                      {}, {}, {}, intra_op_num_threads);
+
+          RunLstmTest(X, W, R, peephole_Y, peephole_Y_h, peephole_Y_c, input_size, batch_size, hidden_size,
+                      seq_length, &B, &P, nullptr, nullptr, nullptr, direction, clip, true, input_forget,
+                      {}, {}, {}, intra_op_num_threads);
+        }
+      }
+    }
+  }
+}
+
 // ONNXRuntime tests
 class LstmOpContext2x1x2x2 {
  public:
@@ -81,6 +81,28 @@ TEST(SplitOperatorTest, Axis0EqualSplitInt32) {
   RunTest<int32_t>(axis, {}, input, outputs);
 }
 
+TEST(SplitOperatorTest, Axis1UnequalSplitDouble) {
+  const int64_t axis = 1;
+  std::vector<ShapeAndData<double>> outputs;
+
+  // input shape and data
+  ShapeAndData<double> input = {{2, 4},  // shape
+                                {1., 2., 3., 4.,
+                                 5., 6., 7., 8.}};
+
+  std::vector<int64_t> splits{3, 1};
+
+  outputs.push_back({{2, 3},
+                     {1., 2., 3.,
+                      5., 6., 7.}});
+
+  outputs.push_back({{2, 1},
+                     {4.,
+                      8.}});
+
+  RunTest<double>(axis, splits, input, outputs);
+}
+
 TEST(SplitOperatorTest, Axis0UnequalSplit) {
   const int64_t axis = 0;
   std::vector<ShapeAndFloatData> outputs;
@@ -188,5 +188,58 @@ TEST(TransposeOpTest, ThreeDimStr) {
   TransposeTest(input_shape, input_vals, &perm, expected_shape, expected_vals);
 }
 
+// Transposes a tensor with generated values and compares against a reference computed element by element.
+// The shapes are chosen so that the tiled copy sees both full and partial tiles.
+template <typename T>
+void TransposeReferenceTest(const std::vector<int64_t>& input_shape, const std::vector<int64_t>& perm) {
+  const size_t rank = input_shape.size();
+  std::vector<int64_t> input_strides(rank), output_shape(rank);
+  int64_t size = 1;
+  for (size_t i = rank; i-- > 0;) {
+    input_strides[i] = size;
+    size *= input_shape[i];
+  }
+  for (size_t i = 0; i < rank; ++i)
+    output_shape[i] = input_shape[perm[i]];
+
+  std::vector<T> input_vals(size);
+  for (int64_t i = 0; i < size; ++i)
+    input_vals[i] = static_cast<T>(i % 251);
+
+  std::vector<T> expected_vals(size);
+  std::vector<int64_t> index(rank, 0);
+  for (int64_t i = 0; i < size; ++i) {
+    int64_t offset = 0;
+    for (size_t j = 0; j < rank; ++j)
+      offset += index[j] * input_strides[perm[j]];
+    expected_vals[i] = input_vals[offset];
+    for (size_t j = rank; j-- > 0;) {
+      if (++index[j] < output_shape[j])
+        break;
+      index[j] = 0;
+    }
+  }
+
+  OpTester test("Transpose");
+  test.AddAttribute("perm", perm);
+  test.AddInput<T>("X", input_shape, input_vals);
+  test.AddOutput<T>("Y", output_shape, expected_vals);
+  test.Run();
+}
+
+TEST(TransposeOpTest, TiledTranspose) {
+  TransposeReferenceTest<float>({37, 53}, {1, 0});
+  TransposeReferenceTest<float>({2, 5, 19, 37}, {0, 2, 3, 1});
+  TransposeReferenceTest<float>({2, 19, 37, 5}, {0, 3, 1, 2});
+  TransposeReferenceTest<uint8_t>({3, 70, 67}, {0, 2, 1});
+  TransposeReferenceTest<int64_t>({11, 3, 17}, {2, 1, 0});
+}
+
+TEST(TransposeOpTest, MixedPermutation) {
+  TransposeReferenceTest<float>({3, 4, 5, 6, 7}, {1, 0, 4, 2, 3});
+  TransposeReferenceTest<int32_t>({2, 3, 4, 5}, {0, 2, 1, 3});
+  TransposeReferenceTest<double>({1, 6, 1, 9}, {3, 2, 1, 0});
+}
+
 }  // namespace test
 }  // namespace onnxruntime
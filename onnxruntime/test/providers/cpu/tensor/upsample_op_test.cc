@@ -351,6 +351,29 @@ TEST(UpsampleOpTest, UpsampleOpNearestTest_1D) {
   test.Run();
 }
 
+TEST(UpsampleOpTest, UpsampleOpNearestTest_3D_NonIntegerScales) {
+  OpTester test("Upsample");
+
+  std::vector<float> scales{1.0f, 2.5f, 1.5f};
+  test.AddAttribute("mode", "nearest");
+  test.AddAttribute("scales", scales);
+
+  std::vector<float> X = {1.0f, 2.0f,
+                          3.0f, 4.0f};
+
+  test.AddInput<float>("X", {1, 2, 2}, X);
+
+  std::vector<float> Y = {
+      1.0f, 1.0f, 2.0f,
+      1.0f, 1.0f, 2.0f,
+      1.0f, 1.0f, 2.0f,
+      3.0f, 3.0f, 4.0f,
+      3.0f, 3.0f, 4.0f};
+
+  test.AddOutput<float>("Y", {1, 5, 3}, Y);
+  test.Run();
+}
+
 TEST(UpsampleOpTest, UpsampleOpNearest2XTest_opset9) {
   OpTester test("Upsample", 9);
 
@@ -406,6 +406,7 @@ void OpTester::Run(ExpectResult expect_result,
     SessionOptions so;
     so.session_logid = op_;
     so.session_log_verbosity_level = 1;
+    so.intra_op_num_threads = intra_op_num_threads_;
 
     static const std::string all_provider_types[] = {
         kCpuExecutionProvider,
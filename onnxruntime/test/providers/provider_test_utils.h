@@ -164,6 +164,13 @@ class OpTester {
     return *this;
   }
 
+  // Set how many threads kernels may use to parallelize a node, see SessionOptions::intra_op_num_threads.
+  // Default is 0 to use the intra-op thread pool shared between sessions.
+  OpTester& SetIntraOpNumThreads(int intra_op_num_threads) {
+    intra_op_num_threads_ = intra_op_num_threads;
+    return *this;
+  }
+
   // We have an initializer_list and vector version of the Add functions because std::vector is specialized for
   // bool and we can't get the raw data out. So those cases must use an initializer_list
   template <typename T>
@@ -322,6 +329,7 @@ class OpTester {
   int opset_version_;
   bool add_shape_to_tensor_data_ = true;
   int add_symbolic_dim_to_tensor_data_ = -1;
+  int intra_op_num_threads_ = 0;
   std::vector<Data> input_data_;
   std::vector<Data> output_data_;
   std::vector<size_t> initializer_index_;
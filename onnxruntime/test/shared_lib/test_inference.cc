@@ -7,6 +7,7 @@
 #include <vector>
 #include <iostream>
 #include <atomic>
+#include <future>
 #include <gtest/gtest.h>
 #include "test_allocator.h"
 #include "test_fixture.h"
@@ -155,6 +156,56 @@ INSTANTIATE_TEST_CASE_P(CApiTestWithProviders,
                         CApiTestWithProvider,
                         ::testing::Values(0, 1, 2, 3, 4));
 
+// user_data is a std::promise receiving the output, or nullptr if the run failed
+static void ORT_API_CALL RunAsyncCallback(void* user_data, OrtValue** outputs, size_t num_outputs, OrtStatus* status) {
+  auto* promise = static_cast<std::promise<OrtValue*>*>(user_data);
+  if (status != nullptr) {
+    OrtReleaseStatus(status);
+    promise->set_value(nullptr);
+  } else {
+    EXPECT_EQ(num_outputs, 1u);
+    promise->set_value(outputs[0]);
+  }
+}
+
+TEST_F(CApiTest, run_async) {
+  SessionOptionsWrapper sf(env);
+  std::unique_ptr<OrtSession, decltype(&OrtReleaseSession)>
+      inference_session(sf.OrtCreateSession(MODEL_URI), OrtReleaseSession);
+
+  std::unique_ptr<MockedOrtAllocator> default_allocator(std::make_unique<MockedOrtAllocator>());
+  std::vector<float> values_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  std::unique_ptr<OrtValue, decltype(&OrtReleaseValue)> value_x(
+      OrtCreateTensorAsOrtValue(default_allocator.get(), {3, 2}, ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT), OrtReleaseValue);
+  void* raw_data;
+  ORT_THROW_ON_ERROR(OrtGetTensorMutableData(value_x.get(), &raw_data));
+  memcpy(raw_data, values_x.data(), values_x.size() * sizeof(values_x[0]));
+
+  const char* input_names[] = {"X"};
+  const OrtValue* inputs[] = {value_x.get()};
+  const char* output_names[] = {"Y"};
+
+  std::promise<OrtValue*> result;
+  ORT_THROW_ON_ERROR(OrtRunAsync(inference_session.get(), nullptr, input_names, inputs, 1, output_names, 1,
+                                 RunAsyncCallback, &result));
+
+  std::unique_ptr<OrtValue, decltype(&OrtReleaseValue)> value_y(result.get_future().get(), OrtReleaseValue);
+  ASSERT_NE(value_y, nullptr);
+  float* f;
+  ORT_THROW_ON_ERROR(OrtGetTensorMutableData(value_y.get(), (void**)&f));
+  std::vector<float> expected_values_y = {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f};
+  for (size_t i = 0; i != expected_values_y.size(); ++i) {
+    ASSERT_EQ(expected_values_y[i], f[i]);
+  }
+
+  // a failed run reports its status to the callback
+  std::promise<OrtValue*> failed_result;
+  const char* bad_output_names[] = {"NotAnOutput"};
+  ORT_THROW_ON_ERROR(OrtRunAsync(inference_session.get(), nullptr, input_names, inputs, 1, bad_output_names, 1,
+                                 RunAsyncCallback, &failed_result));
+  ASSERT_EQ(failed_result.get_future().get(), nullptr);
+}
+
 struct OrtTensorDimensions : std::vector<int64_t> {
   OrtTensorDimensions(const OrtCustomOpApi& ort, OrtValue* value) {
     OrtTensorTypeAndShapeInfo* info;